@@ -0,0 +1,119 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "../PhysicsSimulation/StepTimeHistogram.h"
+
+/** The distribution of a duration over the measured steps, in microseconds */
+struct BenchmarkDurationStats
+{
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+/**
+* Helpers to write the benchmarks' reports. The reports are small JSON
+* documents, so they are written by hand.
+*/
+namespace BenchmarkReport
+{
+    /** @return A histogram's distribution, in microseconds */
+    inline BenchmarkDurationStats GetDurationStats
+        (const StepTimeHistogram& histogram)
+    {
+        const auto toMicroseconds = [](std::uint64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / 1000.0;
+        };
+
+        BenchmarkDurationStats durationStats;
+        durationStats.mean = histogram.GetMean() / 1000.0;
+        durationStats.p50 = toMicroseconds(histogram.GetValueAtPercentile(50));
+        durationStats.p90 = toMicroseconds(histogram.GetValueAtPercentile(90));
+        durationStats.p99 = toMicroseconds(histogram.GetValueAtPercentile(99));
+        durationStats.p999 = toMicroseconds
+            (histogram.GetValueAtPercentile(99.9));
+        durationStats.max = toMicroseconds(histogram.GetMax());
+        return durationStats;
+    }
+
+    /**
+    * Appends a quoted JSON string value. The value is escaped, as it may be
+    * a service's response (e.g. on errors).
+    */
+    inline void AppendJsonQuoted(std::string& json, std::string_view value)
+    {
+        json += "\"";
+        for(const char character : value)
+        {
+            if(character == '"' || character == '\\')
+            {
+                json += '\\';
+                json += character;
+            }
+            else if(static_cast<unsigned char>(character) < 0x20)
+            {
+                char escapedCharacter[8];
+                std::snprintf(escapedCharacter, sizeof(escapedCharacter),
+                    "\\u%04x", static_cast<unsigned int>(character));
+                json += escapedCharacter;
+            }
+            else
+            {
+                json += character;
+            }
+        }
+        json += "\"";
+    }
+
+    /** Appends a JSON string, followed by the separator */
+    inline void AppendJsonString(std::string& json, std::string_view key,
+        std::string_view value, const char* separator = ",")
+    {
+        AppendJsonQuoted(json, key);
+        json += ":";
+        AppendJsonQuoted(json, value);
+        json += separator;
+    }
+
+    /** Appends a JSON number, followed by the separator */
+    inline void AppendJsonNumber(std::string& json, std::string_view key,
+        double value, const char* separator = ",")
+    {
+        char number[64];
+        std::snprintf(number, sizeof(number), "%.3f", value);
+
+        json += "\"";
+        json += key;
+        json += "\":";
+        json += number;
+        json += separator;
+    }
+
+    /** Appends a JSON object with a duration's distribution */
+    inline void AppendJsonDurationStats(std::string& json,
+        std::string_view key, const BenchmarkDurationStats& durationStats,
+        const char* separator = ",")
+    {
+        json += "\"";
+        json += key;
+        json += "\":{";
+        AppendJsonNumber(json, "mean", durationStats.mean);
+        AppendJsonNumber(json, "p50", durationStats.p50);
+        AppendJsonNumber(json, "p90", durationStats.p90);
+        AppendJsonNumber(json, "p99", durationStats.p99);
+        AppendJsonNumber(json, "p999", durationStats.p999);
+        AppendJsonNumber(json, "max", durationStats.max, "");
+        json += "}";
+        json += separator;
+    }
+}
+
+#endif
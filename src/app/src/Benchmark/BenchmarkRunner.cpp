@@ -0,0 +1,400 @@
+#include "BenchmarkRunner.h"
+#include "../PhysicsSimulation/PhysicsServiceImpl.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+using namespace BenchmarkReport;
+
+namespace
+{
+    /** The start of the "Init" message's response when it succeeds */
+    constexpr std::string_view initSuccessPrefix =
+        "Physics system initialized";
+
+    /** The step message, without any step acknowledgement */
+    constexpr std::string_view plainStepMessage = "Step\nMessageEnd\n";
+
+    /**
+    * @return The step message acknowledging a step response, as a client
+    * on the delta step response format would once it decoded the response
+    */
+    std::string BuildAcknowledgingStepMessage(std::string_view stepResponse)
+    {
+        // The binary step responses start with their little-endian step
+        // number
+        if(stepResponse.size() < 4)
+        {
+            return std::string(plainStepMessage);
+        }
+
+        std::uint32_t stepNumber = 0;
+        for(size_t i = 0; i < 4; i++)
+        {
+            stepNumber |= static_cast<std::uint32_t>
+                (static_cast<unsigned char>(stepResponse[i])) << (8 * i);
+        }
+
+        return "Step\nack;" + std::to_string(stepNumber) + "\nMessageEnd\n";
+    }
+
+    /** @return The elapsed time since a time point, in nanoseconds */
+    std::uint64_t GetNanosecondsSince
+        (std::chrono::steady_clock::time_point startTime)
+    {
+        return static_cast<std::uint64_t>
+            (std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now() - startTime).count());
+    }
+
+    /**
+    * @return The value of a measure on a "name;value" lines response, or 0
+    * if it is not on the response
+    */
+    double GetMeasureValue(std::string_view measures,
+        std::string_view measureName)
+    {
+        size_t lineStart = 0;
+        while(lineStart < measures.size())
+        {
+            size_t lineEnd = measures.find('\n', lineStart);
+            if(lineEnd == std::string_view::npos)
+            {
+                lineEnd = measures.size();
+            }
+
+            const std::string_view line =
+                measures.substr(lineStart, lineEnd - lineStart);
+            if(line.size() > measureName.size()
+                && line.substr(0, measureName.size()) == measureName
+                && line[measureName.size()] == ';')
+            {
+                return std::strtod(std::string(line.substr
+                    (measureName.size() + 1)).c_str(), nullptr);
+            }
+
+            lineStart = lineEnd + 1;
+        }
+
+        return 0.0;
+    }
+
+    /** @return The duration measures named "<prefix>MeanUs" and so on */
+    BenchmarkDurationStats GetDurationMeasures(std::string_view measures,
+        const std::string& measurePrefix)
+    {
+        BenchmarkDurationStats durationStats;
+        durationStats.mean = GetMeasureValue(measures, measurePrefix 
+            + "MeanUs");
+        durationStats.p50 = GetMeasureValue(measures, measurePrefix + "P50Us");
+        durationStats.p90 = GetMeasureValue(measures, measurePrefix + "P90Us");
+        durationStats.p99 = GetMeasureValue(measures, measurePrefix + "P99Us");
+        durationStats.p999 = GetMeasureValue(measures, measurePrefix 
+            + "P999Us");
+        durationStats.max = GetMeasureValue(measures, measurePrefix + "MaxUs");
+        return durationStats;
+    }
+
+    /**
+    * Resets the process' peak resident memory (Linux only), so the next
+    * reads of "VmHWM" only count what comes after.
+    *
+    * @return True if the peak was reset
+    */
+    bool ResetPeakResidentMemory()
+    {
+        // Writing "5" resets the peak resident memory (see "proc(5)")
+        std::ofstream clearRefsFile("/proc/self/clear_refs");
+        clearRefsFile << "5";
+        clearRefsFile.flush();
+        return clearRefsFile.good();
+    }
+
+    /**
+    * @return The process' peak resident memory since it was last reset, in
+    * KiB, or 0 if it could not be read
+    */
+    std::uint64_t ReadPeakResidentKibibytes()
+    {
+        constexpr std::string_view peakResidentPrefix = "VmHWM:";
+
+        std::ifstream statusFile("/proc/self/status");
+        std::string statusLine;
+        while(std::getline(statusFile, statusLine))
+        {
+            if(statusLine.compare(0, peakResidentPrefix.size(),
+                peakResidentPrefix) == 0)
+            {
+                return std::strtoull(statusLine.c_str()
+                    + peakResidentPrefix.size(), nullptr, 10);
+            }
+        }
+
+        return 0;
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner
+    (const PhysicsServiceConfig& physicsServiceConfig,
+    const BenchmarkSettings& settings)
+    : physicsServiceConfig(physicsServiceConfig), settings(settings)
+{
+    physicsServiceImplementation = new PhysicsServiceImpl();
+    physicsServiceImplementation->SetServiceConfig(physicsServiceConfig);
+
+    messageHandlerParser.registerPhysicsServiceHandlers
+        (physicsServiceImplementation);
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+    delete physicsServiceImplementation;
+}
+
+BenchmarkResult BenchmarkRunner::Run(std::string_view scenarioName)
+{
+    BenchmarkResult result;
+    result.scenarioName = scenarioName;
+    result.stepCount = settings.stepCount;
+
+    // Every scenario runs on the same process, so the peak resident memory
+    // of the previous runs is dropped
+    const bool bResetPeakResidentMemory = ResetPeakResidentMemory();
+
+    std::unique_ptr<BenchmarkScenario> scenario =
+        BenchmarkScenario::Create(scenarioName, settings);
+    if(!scenario)
+    {
+        result.error = "Unknown scenario: " + std::string(scenarioName);
+        return result;
+    }
+
+    // Negotiate the step responses as a client would
+    const std::string negotiationMessages[] =
+    {
+        "SetStepResponseFormat\n" + settings.stepResponseFormat
+            + "\nMessageEnd\n",
+        "SetStepResponseMode\n" + settings.stepResponseMode
+            + "\nMessageEnd\n",
+        std::string("SetStepPipelining\n") + (settings.bPipelinedStepping
+            ? "enabled" : "disabled") + "\nMessageEnd\n"
+    };
+
+    for(const std::string& negotiationMessage : negotiationMessages)
+    {
+        SendMessage(negotiationMessage, result.error);
+        if(!result.error.empty())
+        {
+            return result;
+        }
+    }
+
+    const std::string initMessage = scenario->BuildInitMessage();
+    result.bodyCount = settings.bodyCount;
+    result.floorCount = scenario->GetInitialBodyCount() - settings.bodyCount;
+
+    if(result.bodyCount + result.floorCount > physicsServiceConfig.maxBodies)
+    {
+        result.error = "The scenario has more bodies than maxBodies";
+        return result;
+    }
+
+    const auto initStartTime = std::chrono::steady_clock::now();
+    const std::string_view initResponse = 
+        SendMessage(initMessage, result.error);
+    result.initMilliseconds = static_cast<double>
+        (GetNanosecondsSince(initStartTime)) / 1e6;
+
+    if(initResponse.compare(0, initSuccessPrefix.size(), initSuccessPrefix)
+        != 0)
+    {
+        result.error = "Init failed: " + std::string(initResponse);
+        return result;
+    }
+
+    // On the delta format, each step acknowledges the previous response, so
+    // the responses are delta compressed as they would be for a client
+    constexpr std::string_view deltaFormatName = "delta";
+    const bool bAcknowledgeSteps = settings.stepResponseFormat.compare(0,
+        deltaFormatName.size(), deltaFormatName) == 0;
+    std::string stepMessage(plainStepMessage);
+    std::vector<std::string> preStepMessages;
+
+    std::uint32_t stepIndex = 0;
+    for(; stepIndex < settings.warmupStepCount; stepIndex++)
+    {
+        preStepMessages.clear();
+        scenario->BuildPreStepMessages(stepIndex, preStepMessages);
+
+        for(const std::string& preStepMessage : preStepMessages)
+        {
+            SendMessage(preStepMessage, result.error);
+        }
+
+        const std::string_view stepResponse =
+            SendMessage(stepMessage, result.error);
+        if(!result.error.empty())
+        {
+            return result;
+        }
+
+        if(bAcknowledgeSteps)
+        {
+            stepMessage = BuildAcknowledgingStepMessage(stepResponse);
+        }
+    }
+
+    // Only the measured steps are on the service's measures
+    SendMessage("GetSimulationMeasures\nreset\nMessageEnd\n", result.error);
+
+    StepTimeHistogram stepMessageHistogram;
+    std::uint64_t preStepMessagesNanoseconds = 0;
+    std::uint64_t totalResponseBytes = 0;
+
+    const auto measuredStartTime = std::chrono::steady_clock::now();
+
+    for(std::uint32_t i = 0; i < settings.stepCount; i++, stepIndex++)
+    {
+        // The messages are built before the clock starts
+        preStepMessages.clear();
+        scenario->BuildPreStepMessages(stepIndex, preStepMessages);
+
+        const auto preStepMessagesStartTime =
+            std::chrono::steady_clock::now();
+        for(const std::string& preStepMessage : preStepMessages)
+        {
+            SendMessage(preStepMessage, result.error);
+        }
+        preStepMessagesNanoseconds +=
+            GetNanosecondsSince(preStepMessagesStartTime);
+
+        const auto stepStartTime = std::chrono::steady_clock::now();
+        const std::string_view stepResponse =
+            SendMessage(stepMessage, result.error);
+        stepMessageHistogram.Record(GetNanosecondsSince(stepStartTime));
+
+        if(!result.error.empty())
+        {
+            return result;
+        }
+
+        totalResponseBytes += stepResponse.size();
+        result.bytesPerFrameMax = std::max<std::uint64_t>
+            (result.bytesPerFrameMax, stepResponse.size());
+
+        if(bAcknowledgeSteps)
+        {
+            stepMessage = BuildAcknowledgingStepMessage(stepResponse);
+        }
+    }
+
+    const double measuredSeconds = static_cast<double>
+        (GetNanosecondsSince(measuredStartTime)) / 1e9;
+
+    // Waits for any pipelined step, so every step is on the measures
+    const std::string_view simulationMeasures = SendMessage
+        ("GetSimulationMeasures\nMessageEnd\n", result.error);
+
+    result.physicsStepMicroseconds =
+        GetDurationMeasures(simulationMeasures, "stepTime");
+    result.serializationMicroseconds =
+        GetDurationMeasures(simulationMeasures, "serializationTime");
+    result.tempAllocatorPeakBytes = static_cast<std::uint64_t>
+        (GetMeasureValue(simulationMeasures, "tempAllocatorPeakBytes"));
+
+    result.stepMessageMicroseconds = GetDurationStats(stepMessageHistogram);
+
+    if(settings.stepCount > 0)
+    {
+        result.stepsPerSecond = measuredSeconds > 0.0
+            ? settings.stepCount / measuredSeconds : 0.0;
+        result.preStepMessagesMeanMicroseconds = static_cast<double>
+            (preStepMessagesNanoseconds) / 1000.0 / settings.stepCount;
+        result.bytesPerFrameMean = static_cast<double>(totalResponseBytes)
+            / settings.stepCount;
+    }
+
+    // Without the reset, the peak would be the whole process' one
+    if(bResetPeakResidentMemory)
+    {
+        result.peakResidentKibibytes = ReadPeakResidentKibibytes();
+    }
+
+    return result;
+}
+
+std::string BenchmarkRunner::ToJson
+    (const std::vector<BenchmarkResult>& results) const
+{
+    std::string json = "{\"config\":{";
+    AppendJsonNumber(json, "maxBodies", physicsServiceConfig.maxBodies);
+    AppendJsonNumber(json, "physicsWorkerThreads",
+        physicsServiceConfig.GetResolvedPhysicsWorkerThreadCount());
+    AppendJsonNumber(json, "numVelocitySteps",
+        physicsServiceConfig.physicsSettings.mNumVelocitySteps);
+    AppendJsonNumber(json, "numPositionSteps",
+        physicsServiceConfig.physicsSettings.mNumPositionSteps);
+    AppendJsonNumber(json, "warmupSteps", settings.warmupStepCount);
+    AppendJsonNumber(json, "seed", settings.seed);
+    AppendJsonString(json, "stepResponseFormat", settings.stepResponseFormat);
+    AppendJsonString(json, "stepResponseMode", settings.stepResponseMode);
+    AppendJsonString(json, "stepPipelining", settings.bPipelinedStepping
+        ? "enabled" : "disabled", "");
+    json += "},\"results\":[";
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+
+        json += "{";
+        AppendJsonString(json, "scenario", result.scenarioName);
+        if(!result.error.empty())
+        {
+            AppendJsonString(json, "error", result.error, "");
+            json += i + 1 < results.size() ? "}," : "}";
+            continue;
+        }
+
+        AppendJsonNumber(json, "bodies", result.bodyCount);
+        AppendJsonNumber(json, "floors", result.floorCount);
+        AppendJsonNumber(json, "steps", result.stepCount);
+        AppendJsonNumber(json, "initMs", result.initMilliseconds);
+        AppendJsonNumber(json, "stepsPerSecond", result.stepsPerSecond);
+        AppendJsonDurationStats(json, "physicsStepUs",
+            result.physicsStepMicroseconds);
+        AppendJsonDurationStats(json, "stepMessageUs",
+            result.stepMessageMicroseconds);
+        AppendJsonDurationStats(json, "serializationUs",
+            result.serializationMicroseconds);
+        AppendJsonNumber(json, "preStepMessagesMeanUs",
+            result.preStepMessagesMeanMicroseconds);
+        AppendJsonNumber(json, "bytesPerFrameMean", result.bytesPerFrameMean);
+        AppendJsonNumber(json, "bytesPerFrameMax",
+            static_cast<double>(result.bytesPerFrameMax));
+        AppendJsonNumber(json, "tempAllocatorPeakBytes",
+            static_cast<double>(result.tempAllocatorPeakBytes));
+        AppendJsonNumber(json, "peakRssKiB",
+            static_cast<double>(result.peakResidentKibibytes), "");
+        json += i + 1 < results.size() ? "}," : "}";
+    }
+
+    json += "]}\n";
+    return json;
+}
+
+std::string_view BenchmarkRunner::SendMessage(std::string_view message,
+    std::string& outError)
+{
+    const std::string_view response = messageHandlerParser.handleMessage
+        (message, responseBuffer, &clientConnectionSettings);
+
+    constexpr std::string_view errorPrefix = "Error";
+    if(outError.empty()
+        && response.compare(0, errorPrefix.size(), errorPrefix) == 0)
+    {
+        outError = response;
+    }
+
+    return response;
+}
@@ -0,0 +1,141 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "BenchmarkScenario.h"
+#include "../Communication/ClientConnectionSettings.h"
+#include "../Communication/MessageHandling/MessageHandlerParser.h"
+#include "../PhysicsSimulation/PhysicsServiceConfig.h"
+
+class PhysicsServiceImpl;
+
+/** The measures of a scenario's run */
+struct BenchmarkResult
+{
+    /** The scenario's name */
+    std::string scenarioName;
+
+    /** The error that stopped the run, or empty if it finished */
+    std::string error;
+
+    /** The number of spheres and floors on the initial world */
+    std::uint32_t bodyCount = 0;
+    std::uint32_t floorCount = 0;
+
+    /** The number of measured steps */
+    std::uint32_t stepCount = 0;
+
+    /** How long the "Init" message took */
+    double initMilliseconds = 0.0;
+
+    /** The measured steps per second, with every message sent per step */
+    double stepsPerSecond = 0.0;
+
+    /** The physics update's times (from "GetSimulationMeasures") */
+    BenchmarkDurationStats physicsStepMicroseconds;
+
+    /**
+    * The "Step" message's times: the physics update and the step response's
+    * serialization
+    */
+    BenchmarkDurationStats stepMessageMicroseconds;
+
+    /**
+    * The step responses' serialization times: the extraction of the body
+    * states and their encoding (from "GetSimulationMeasures")
+    */
+    BenchmarkDurationStats serializationMicroseconds;
+
+    /** The mean time of the messages sent before each step (e.g. churn) */
+    double preStepMessagesMeanMicroseconds = 0.0;
+
+    /** The size of the step responses */
+    double bytesPerFrameMean = 0.0;
+    std::uint64_t bytesPerFrameMax = 0;
+
+    /** The temp allocator's peak usage on the measured steps */
+    std::uint64_t tempAllocatorPeakBytes = 0;
+
+    /**
+    * The process' peak resident memory during the run. The peak is reset
+    * when the run starts, so the runs before it are not counted. 0 if the
+    * peak could not be read
+    */
+    std::uint64_t peakResidentKibibytes = 0;
+};
+
+/**
+* Runs benchmark scenarios in-process: the scenarios' messages are handled
+* by a "MessageHandlerParser" with every handler of the service, as the
+* socket server does, without the network. Every run re-initializes the
+* same physics service, with the same config.
+*/
+class BenchmarkRunner final
+{
+public:
+    /**
+    * @param physicsServiceConfig The (validated) physics service config
+    * @param settings The benchmark's settings
+    */
+    BenchmarkRunner(const PhysicsServiceConfig& physicsServiceConfig,
+        const BenchmarkSettings& settings);
+
+    ~BenchmarkRunner();
+
+    /**
+    * Runs a scenario: initializes its world, runs the warm-up steps, resets
+    * the measures and runs the measured steps.
+    *
+    * @param scenarioName The scenario's name
+    *
+    * @return The run's measures. Has the error if it did not finish
+    */
+    BenchmarkResult Run(std::string_view scenarioName);
+
+    /**
+    * Writes the runs' measures as JSON, with the config they ran with.
+    *
+    * @param results The runs' measures
+    *
+    * @return The JSON document
+    */
+    std::string ToJson(const std::vector<BenchmarkResult>& results) const;
+
+private:
+    /**
+    * Sends a message to the service.
+    *
+    * @param message The message (delimited, with the "MessageEnd" line)
+    * @param outError The error, if the response is an error
+    *
+    * @return The service's response. The view is valid until the next 
+    * message is sent
+    */
+    std::string_view SendMessage(std::string_view message, 
+        std::string& outError);
+
+    /** The physics service config */
+    PhysicsServiceConfig physicsServiceConfig;
+
+    /** The benchmark's settings */
+    BenchmarkSettings settings;
+
+    /** The physics service the scenarios run on */
+    PhysicsServiceImpl* physicsServiceImplementation = nullptr;
+
+    /** The parser with every handler of the service */
+    MessageHandlerParser messageHandlerParser;
+
+    /** The settings negotiated by the benchmark, as a client */
+    ClientConnectionSettings clientConnectionSettings;
+
+    /** The buffer the service's responses may be written into */
+    std::string responseBuffer;
+};
+
+#endif
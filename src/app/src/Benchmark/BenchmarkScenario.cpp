@@ -0,0 +1,456 @@
+#include "BenchmarkScenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+
+namespace
+{
+    /** The radius of the service's spheres */
+    constexpr double sphereRadius = 50.0;
+
+    /** The distance between the centers of neighbouring columns of spheres */
+    constexpr double sphereSpacing = 150.0;
+
+    /** The side of the service's floors */
+    constexpr double floorSize = 2000.0;
+
+    /** The height of a sphere resting on a floor */
+    constexpr double sphereRestHeight = 150.0;
+
+    /** The number of layers of falling spheres on the rain */
+    constexpr std::uint32_t rainLayerCount = 10;
+
+    /** The height the lowest layer of the rain starts at */
+    constexpr double rainStartHeight = 400.0;
+
+    /** The height the churned spheres are dropped from */
+    constexpr double churnDropHeight = 1500.0;
+
+    /** @return The number of floors on each side to fit the columns */
+    std::uint32_t GetFloorsPerSideForColumns(std::uint64_t columnCount)
+    {
+        const double columnsPerFloorSide = std::floor(floorSize
+            / sphereSpacing);
+        return std::max<std::uint32_t>(1, static_cast<std::uint32_t>
+            (std::ceil(std::sqrt(static_cast<double>(columnCount))
+            / columnsPerFloorSide)));
+    }
+
+    /**
+    * The columns of spheres over the floor grid, spaced by "sphereSpacing",
+    * centered on the origin
+    */
+    struct ColumnGrid
+    {
+        std::uint32_t columnsPerSide = 1;
+        double gridStart = 0.0;
+
+        explicit ColumnGrid(std::uint32_t floorsPerSide)
+        {
+            columnsPerSide = static_cast<std::uint32_t>(std::floor
+                (floorsPerSide * floorSize / sphereSpacing));
+            gridStart = -(columnsPerSide - 1.0) * sphereSpacing / 2.0;
+        }
+
+        std::uint32_t GetColumnCount() const
+        {
+            return columnsPerSide * columnsPerSide;
+        }
+
+        double GetColumnX(std::uint32_t column) const
+        {
+            return gridStart + (column % columnsPerSide) * sphereSpacing;
+        }
+
+        double GetColumnY(std::uint32_t column) const
+        {
+            return gridStart + (column / columnsPerSide) * sphereSpacing;
+        }
+    };
+
+    /**
+    * Spheres falling in layers on the floors. The spheres collide with the
+    * floors and each other, so most of the world is active.
+    */
+    class RainScenario : public BenchmarkScenario
+    {
+    public:
+        explicit RainScenario(const BenchmarkSettings& settings)
+            : BenchmarkScenario(settings)
+        {
+        }
+
+        std::string BuildInitMessage() override
+        {
+            const std::uint64_t columnCount = (settings.bodyCount
+                + rainLayerCount - 1) / rainLayerCount;
+            floorsPerSide = GetFloorsPerSideForColumns(columnCount);
+
+            std::string initMessage = "Init\n";
+            AppendFloorGrid(initMessage);
+
+            const ColumnGrid columnGrid(floorsPerSide);
+            for(std::uint32_t i = 0; i < settings.bodyCount; i++)
+            {
+                const std::uint32_t column = i % columnGrid.GetColumnCount();
+                const std::uint32_t layer = i / columnGrid.GetColumnCount();
+
+                AppendSphere(nextBodyId++, columnGrid.GetColumnX(column)
+                    + GetJitter(10.0), columnGrid.GetColumnY(column)
+                    + GetJitter(10.0), rainStartHeight + layer
+                    * sphereSpacing * 1.5 + GetJitter(20.0), false,
+                    initMessage);
+            }
+
+            initialBodyCount = nextBodyId;
+            initMessage += "MessageEnd\n";
+            return initMessage;
+        }
+    };
+
+    /**
+    * Square pyramids of spheres, packed so each sphere rests on four
+    * others. Every sphere is on several contacts, so this stresses the
+    * contact solver.
+    */
+    class PyramidsScenario : public BenchmarkScenario
+    {
+    public:
+        explicit PyramidsScenario(const BenchmarkSettings& settings)
+            : BenchmarkScenario(settings)
+        {
+        }
+
+        std::string BuildInitMessage() override
+        {
+            const std::uint32_t baseSize = std::max<std::uint32_t>(1,
+                settings.pyramidBaseSize);
+
+            std::uint32_t pyramidBodyCount = 0;
+            for(std::uint32_t side = 1; side <= baseSize; side++)
+            {
+                pyramidBodyCount += side * side;
+            }
+
+            const std::uint32_t pyramidCount = std::max<std::uint32_t>(1,
+                (settings.bodyCount + pyramidBodyCount - 1)
+                / pyramidBodyCount);
+            const std::uint32_t pyramidsPerSide = static_cast<std::uint32_t>
+                (std::ceil(std::sqrt(static_cast<double>(pyramidCount))));
+
+            // Leave room between the pyramids, so they do not touch
+            const double pyramidPitch = baseSize * 2.0 * sphereRadius
+                + 4.0 * sphereRadius;
+            const std::uint32_t pyramidsPerFloorSide =
+                std::max<std::uint32_t>(1, static_cast<std::uint32_t>
+                (std::floor(floorSize / pyramidPitch)));
+            floorsPerSide = (pyramidsPerSide + pyramidsPerFloorSide - 1)
+                / pyramidsPerFloorSide;
+
+            std::string initMessage = "Init\n";
+            AppendFloorGrid(initMessage);
+
+            // On square packing, each layer is sqrt(2) radius over the last
+            const double layerHeight = sphereRadius * std::sqrt(2.0);
+
+            std::uint32_t remainingBodyCount = settings.bodyCount;
+            for(std::uint32_t pyramid = 0; remainingBodyCount > 0; pyramid++)
+            {
+                const double pyramidX = (pyramid % pyramidsPerSide
+                    - (pyramidsPerSide - 1) / 2.0) * pyramidPitch;
+                const double pyramidY = (pyramid / pyramidsPerSide
+                    - (pyramidsPerSide - 1) / 2.0) * pyramidPitch;
+
+                for(std::uint32_t layer = 0; layer < baseSize
+                    && remainingBodyCount > 0; layer++)
+                {
+                    const std::uint32_t side = baseSize - layer;
+                    const double layerStart = -(side - 1.0) * sphereRadius;
+
+                    for(std::uint32_t i = 0; i < side * side
+                        && remainingBodyCount > 0; i++)
+                    {
+                        AppendSphere(nextBodyId++, pyramidX + layerStart
+                            + (i % side) * 2.0 * sphereRadius, pyramidY
+                            + layerStart + (i / side) * 2.0 * sphereRadius,
+                            sphereRestHeight + layer * layerHeight, false,
+                            initMessage);
+                        remainingBodyCount--;
+                    }
+                }
+            }
+
+            initialBodyCount = nextBodyId;
+            initMessage += "MessageEnd\n";
+            return initMessage;
+        }
+    };
+
+    /**
+    * Spheres resting apart on the floors, which go to sleep, with a few
+    * bouncing ones (see "awakeFraction"). Measures the cost of a mostly
+    * sleeping world.
+    */
+    class SleepingScenario : public BenchmarkScenario
+    {
+    public:
+        explicit SleepingScenario(const BenchmarkSettings& settings)
+            : BenchmarkScenario(settings)
+        {
+        }
+
+        std::string BuildInitMessage() override
+        {
+            floorsPerSide = GetFloorsPerSideForColumns(settings.bodyCount);
+
+            std::string initMessage = "Init\n";
+            AppendFloorGrid(initMessage);
+
+            const double awakeFraction = std::clamp(static_cast<double>
+                (settings.awakeFraction), 0.0, 1.0);
+
+            const ColumnGrid columnGrid(floorsPerSide);
+            for(std::uint32_t i = 0; i < settings.bodyCount; i++)
+            {
+                // The awake spheres are spread evenly, each on its own
+                // column, so they bounce without waking the others
+                const bool bIsAwake = std::floor((i + 1) * awakeFraction)
+                    > std::floor(i * awakeFraction);
+
+                AppendSphere(nextBodyId++, columnGrid.GetColumnX(i),
+                    columnGrid.GetColumnY(i), bIsAwake ? sphereRestHeight
+                    + 4.0 * sphereSpacing : sphereRestHeight, false,
+                    initMessage);
+            }
+
+            initialBodyCount = nextBodyId;
+            initMessage += "MessageEnd\n";
+            return initMessage;
+        }
+    };
+
+    /**
+    * The rain, with spheres removed and added back on every step (see
+    * "churnBodyCount"). A step's removed spheres are added back (dropped
+    * from above) on the next step, with the same IDs.
+    */
+    class ChurnScenario : public RainScenario
+    {
+    public:
+        explicit ChurnScenario(const BenchmarkSettings& settings)
+            : RainScenario(settings)
+        {
+        }
+
+        std::string BuildInitMessage() override
+        {
+            std::string initMessage = RainScenario::BuildInitMessage();
+
+            aliveSphereIds.clear();
+            removedSphereIds.clear();
+            for(std::uint32_t bodyId = nextBodyId - settings.bodyCount;
+                bodyId < nextBodyId; bodyId++)
+            {
+                aliveSphereIds.push_back(bodyId);
+            }
+
+            return initMessage;
+        }
+
+        void BuildPreStepMessages(std::uint32_t /*stepIndex*/,
+            std::vector<std::string>& outMessages) override
+        {
+            const ColumnGrid columnGrid(floorsPerSide);
+            std::uniform_int_distribution<std::uint32_t> columnDistribution
+                (0, columnGrid.GetColumnCount() - 1);
+
+            if(!removedSphereIds.empty())
+            {
+                std::string addBodyMessage = "AddBody\n";
+                for(const std::uint32_t bodyId : removedSphereIds)
+                {
+                    const std::uint32_t column =
+                        columnDistribution(randomGenerator);
+                    AppendSphere(bodyId, columnGrid.GetColumnX(column),
+                        columnGrid.GetColumnY(column), churnDropHeight,
+                        true, addBodyMessage);
+                    aliveSphereIds.push_back(bodyId);
+                }
+
+                addBodyMessage += "MessageEnd\n";
+                outMessages.push_back(std::move(addBodyMessage));
+                removedSphereIds.clear();
+            }
+
+            // The oldest spheres are removed first
+            const std::uint32_t removedCount = std::min<std::uint32_t>
+                (settings.churnBodyCount, static_cast<std::uint32_t>
+                (aliveSphereIds.size()));
+            if(removedCount == 0)
+            {
+                return;
+            }
+
+            std::string removeBodyMessage = "RemoveBody\n";
+            for(std::uint32_t i = 0; i < removedCount; i++)
+            {
+                const std::uint32_t bodyId = aliveSphereIds.front();
+                aliveSphereIds.pop_front();
+                removedSphereIds.push_back(bodyId);
+
+                removeBodyMessage += std::to_string(bodyId);
+                removeBodyMessage += '\n';
+            }
+
+            removeBodyMessage += "MessageEnd\n";
+            outMessages.push_back(std::move(removeBodyMessage));
+        }
+
+    private:
+        /** The spheres on the world, from the oldest */
+        std::deque<std::uint32_t> aliveSphereIds;
+
+        /** The spheres removed on the last step, added on the next one */
+        std::vector<std::uint32_t> removedSphereIds;
+    };
+}
+
+bool BenchmarkSettings::SetValue(std::string_view key, std::string_view value,
+    std::string& outError)
+{
+    std::uint32_t* unsignedSetting = key == "bodies" ? &bodyCount
+        : key == "steps" ? &stepCount
+        : key == "warmupSteps" ? &warmupStepCount
+        : key == "churnBodies" ? &churnBodyCount
+        : key == "pyramidBase" ? &pyramidBaseSize
+        : key == "seed" ? &seed
+        : nullptr;
+
+    const std::string valueText(value);
+    if(unsignedSetting)
+    {
+        char* valueEnd = nullptr;
+        const unsigned long parsedValue =
+            std::strtoul(valueText.c_str(), &valueEnd, 10);
+        if(valueText.empty() || *valueEnd != '\0')
+        {
+            outError = "Invalid value for " + std::string(key) + ": "
+                + valueText;
+            return false;
+        }
+
+        *unsignedSetting = static_cast<std::uint32_t>(parsedValue);
+    }
+    else if(key == "awakeFraction")
+    {
+        awakeFraction = std::strtof(valueText.c_str(), nullptr);
+        if(awakeFraction < 0.0f || awakeFraction > 1.0f)
+        {
+            outError = "awakeFraction must be between 0 and 1";
+            return false;
+        }
+    }
+    else if(key == "stepResponseFormat")
+    {
+        stepResponseFormat = valueText;
+    }
+    else if(key == "stepResponseMode")
+    {
+        stepResponseMode = valueText;
+    }
+    else if(key == "pipelining")
+    {
+        if(value != "enabled" && value != "disabled")
+        {
+            outError = "pipelining must be \"enabled\" or \"disabled\"";
+            return false;
+        }
+
+        bPipelinedStepping = value == "enabled";
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<BenchmarkScenario> BenchmarkScenario::Create
+    (std::string_view scenarioName, const BenchmarkSettings& settings)
+{
+    if(scenarioName == "rain")
+    {
+        return std::make_unique<RainScenario>(settings);
+    }
+
+    if(scenarioName == "pyramids")
+    {
+        return std::make_unique<PyramidsScenario>(settings);
+    }
+
+    if(scenarioName == "sleeping")
+    {
+        return std::make_unique<SleepingScenario>(settings);
+    }
+
+    if(scenarioName == "churn")
+    {
+        return std::make_unique<ChurnScenario>(settings);
+    }
+
+    return nullptr;
+}
+
+std::vector<std::string_view> BenchmarkScenario::GetScenarioNames()
+{
+    return { "rain", "pyramids", "sleeping", "churn" };
+}
+
+void BenchmarkScenario::BuildPreStepMessages(std::uint32_t /*stepIndex*/,
+    std::vector<std::string>& /*outMessages*/)
+{
+}
+
+BenchmarkScenario::BenchmarkScenario(const BenchmarkSettings& settings)
+    : settings(settings), randomGenerator(settings.seed)
+{
+}
+
+void BenchmarkScenario::AppendFloorGrid(std::string& outInitMessage)
+{
+    char floorLine[128];
+    for(std::uint32_t i = 0; i < floorsPerSide * floorsPerSide; i++)
+    {
+        std::snprintf(floorLine, sizeof(floorLine), "floor;%u;primary;%.1f;"
+            "%.1f;0\n", nextBodyId++, GetFloorGridOrigin(i % floorsPerSide),
+            GetFloorGridOrigin(i / floorsPerSide));
+        outInitMessage += floorLine;
+    }
+}
+
+void BenchmarkScenario::AppendSphere(std::uint32_t bodyId, double x,
+    double y, double z, bool bWithVelocity, std::string& outMessage)
+{
+    char sphereLine[128];
+    std::snprintf(sphereLine, sizeof(sphereLine),
+        "sphere;%u;primary;%.2f;%.2f;%.2f%s\n", bodyId, x, y, z,
+        bWithVelocity ? ";0;0;0;0;0;0" : "");
+    outMessage += sphereLine;
+}
+
+double BenchmarkScenario::GetFloorGridOrigin(std::uint32_t floorGridIndex)
+    const
+{
+    return (floorGridIndex - (floorsPerSide - 1) / 2.0) * floorSize;
+}
+
+double BenchmarkScenario::GetJitter(double maxOffset)
+{
+    std::uniform_real_distribution<double> jitterDistribution(-maxOffset,
+        maxOffset);
+    return jitterDistribution(randomGenerator);
+}
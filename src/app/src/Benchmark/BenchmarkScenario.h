@@ -0,0 +1,153 @@
+#ifndef BENCHMARKSCENARIO_H
+#define BENCHMARKSCENARIO_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** The settings of a benchmark run, shared by every scenario */
+struct BenchmarkSettings
+{
+    /** The number of (dynamic) spheres on the world */
+    std::uint32_t bodyCount = 2000;
+
+    /** The steps run before the measures are reset */
+    std::uint32_t warmupStepCount = 60;
+
+    /** The measured steps */
+    std::uint32_t stepCount = 600;
+
+    /** The spheres removed and added back on each step ("churn") */
+    std::uint32_t churnBodyCount = 50;
+
+    /** The number of spheres on the base's side of each pyramid */
+    std::uint32_t pyramidBaseSize = 8;
+
+    /** The fraction of spheres that never sleep ("sleeping") */
+    float awakeFraction = 0.05f;
+
+    /** The seed of the positions' jitter, so every run is the same */
+    std::uint32_t seed = 1;
+
+    /**
+    * The step response format negotiated ("text", "binary", "quantized" or
+    * "delta", optionally with their values, e.g. "quantized;rotationBits=10").
+    * On "delta", each step acknowledges the previous response
+    */
+    std::string stepResponseFormat = "binary";
+
+    /** The step response mode negotiated ("full" or "activeset") */
+    std::string stepResponseMode = "full";
+
+    /** If the steps are pipelined (see "SetStepPipelining") */
+    bool bPipelinedStepping = false;
+
+    /**
+    * Sets a setting from its text (e.g. "bodies" and "5000"). The keys are
+    * "bodies", "steps", "warmupSteps", "churnBodies", "pyramidBase",
+    * "awakeFraction", "seed", "stepResponseFormat", "stepResponseMode" and
+    * "pipelining" ("enabled" or "disabled").
+    *
+    * @param key The setting's key
+    * @param value The setting's text
+    * @param outError The error, if the value could not be parsed. Empty if
+    * the key is not a setting's key
+    *
+    * @return True if the setting was set
+    */
+    bool SetValue(std::string_view key, std::string_view value,
+        std::string& outError);
+};
+
+/**
+* A benchmark scenario: the world it initializes (as an "Init" message) and
+* the messages it sends before each step (e.g. "AddBody" and "RemoveBody").
+* The scenarios only use the service's messages, so they measure the same
+* path the clients take.
+*
+* The bodies are the service's spheres (50 units of radius) over a grid of
+* its floors (2000 by 2000 units), which grows with the number of spheres.
+*/
+class BenchmarkScenario
+{
+public:
+    virtual ~BenchmarkScenario() = default;
+
+    /**
+    * Creates a scenario by its name.
+    *
+    * @param scenarioName The scenario's name (see "GetScenarioNames()")
+    * @param settings The benchmark's settings
+    *
+    * @return The scenario, or null if there is no scenario with the name
+    */
+    static std::unique_ptr<BenchmarkScenario> Create
+        (std::string_view scenarioName, const BenchmarkSettings& settings);
+
+    /** @return The name of every scenario */
+    static std::vector<std::string_view> GetScenarioNames();
+
+    /** @return The "Init" message with the scenario's initial world */
+    virtual std::string BuildInitMessage() = 0;
+
+    /**
+    * Builds the messages sent before a step. Most scenarios send none.
+    *
+    * @param stepIndex The step's index, from the first warm-up step
+    * @param outMessages The messages, sent on order
+    */
+    virtual void BuildPreStepMessages(std::uint32_t stepIndex,
+        std::vector<std::string>& outMessages);
+
+    /** @return The number of bodies on the initial world (with floors) */
+    std::uint32_t GetInitialBodyCount() const { return initialBodyCount; }
+
+protected:
+    explicit BenchmarkScenario(const BenchmarkSettings& settings);
+
+    /**
+    * Appends the floors of the grid (see "floorsPerSide") on the "Init"
+    * message, centered on the origin. The floors take the first body IDs.
+    *
+    * @param outInitMessage The "Init" message to append to
+    */
+    void AppendFloorGrid(std::string& outInitMessage);
+
+    /**
+    * Appends a sphere line ("Init" or "AddBody" format) to a message.
+    *
+    * @param bWithVelocity If the line has the (zero) velocities of the
+    * "AddBody" format
+    */
+    void AppendSphere(std::uint32_t bodyId, double x, double y, double z,
+        bool bWithVelocity, std::string& outMessage);
+
+    /**
+    * @return The origin of the floor at a grid position, with the grid
+    * centered on the origin
+    */
+    double GetFloorGridOrigin(std::uint32_t floorGridIndex) const;
+
+    /** @return A random offset between -maxOffset and maxOffset */
+    double GetJitter(double maxOffset);
+
+    /** The benchmark's settings */
+    BenchmarkSettings settings;
+
+    /** The generator of the positions' jitter */
+    std::mt19937 randomGenerator;
+
+    /** The number of floors on each side of the grid */
+    std::uint32_t floorsPerSide = 1;
+
+    /** The next free body ID */
+    std::uint32_t nextBodyId = 0;
+
+    /** The number of bodies on the initial world */
+    std::uint32_t initialBodyCount = 0;
+};
+
+#endif
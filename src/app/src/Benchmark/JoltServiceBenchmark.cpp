@@ -0,0 +1,187 @@
+#include "BenchmarkRunner.h"
+#include "../Logging/ServiceLogger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    /**
+    * Sets a benchmark option (e.g. "--bodies=5000") from its argument.
+    *
+    * @param argument The argument, without the "--"
+    * @param settings The benchmark's settings to set
+    * @param scenarioNames The scenarios to run, set by "--scenario"
+    * @param outputPath The JSON's file, set by "--output"
+    * @param outError The error, if the option's value could not be parsed
+    *
+    * @return True if the argument is a benchmark option, false if it is not
+    * (so it is a physics service config option) or on error
+    */
+    bool SetBenchmarkOption(std::string_view argument,
+        BenchmarkSettings& settings,
+        std::vector<std::string>& scenarioNames, std::string& outputPath,
+        std::string& outError)
+    {
+        const size_t separatorIndex = argument.find('=');
+        if(separatorIndex == std::string_view::npos)
+        {
+            return false;
+        }
+
+        const std::string_view key = argument.substr(0, separatorIndex);
+        const std::string_view value = argument.substr(separatorIndex + 1);
+
+        if(key == "scenario")
+        {
+            scenarioNames.clear();
+
+            size_t nameStart = 0;
+            while(nameStart <= value.size())
+            {
+                size_t nameEnd = value.find(',', nameStart);
+                if(nameEnd == std::string_view::npos)
+                {
+                    nameEnd = value.size();
+                }
+
+                const std::string_view scenarioName =
+                    value.substr(nameStart, nameEnd - nameStart);
+                if(scenarioName == "all")
+                {
+                    for(std::string_view name
+                        : BenchmarkScenario::GetScenarioNames())
+                    {
+                        scenarioNames.emplace_back(name);
+                    }
+                }
+                else if(!scenarioName.empty())
+                {
+                    scenarioNames.emplace_back(scenarioName);
+                }
+
+                nameStart = nameEnd + 1;
+            }
+
+            return true;
+        }
+
+        if(key == "output")
+        {
+            outputPath = value;
+            return true;
+        }
+
+        return settings.SetValue(key, value, outError);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // Only the warnings and errors are logged by default, so the logs do not
+    // take time from the measures. The environment may still ask for more
+    ServiceLogger::SetLevel(ELogLevel::Warning);
+    if(const char* logLevelName = std::getenv("JOLTSERVICE_LOG_LEVEL"))
+    {
+        ELogLevel logLevel {};
+        if(ServiceLogger::ParseLevel(logLevelName, logLevel))
+        {
+            ServiceLogger::SetLevel(logLevel);
+        }
+    }
+
+    // The benchmark options are taken first. Every other "--key=value" and
+    // "--config=<file>" argument is a physics service config option
+    BenchmarkSettings settings;
+    std::vector<std::string> scenarioNames;
+    std::string outputPath;
+    std::vector<char*> physicsServiceConfigArgs = { argv[0] };
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if(argument.substr(0, 2) != "--")
+        {
+            LOG_ERROR(Physics, "Unknown argument: %s", argv[i]);
+            ServiceLogger::Get().Flush();
+            return 1;
+        }
+
+        std::string optionError;
+        if(!SetBenchmarkOption(argument.substr(2), settings, scenarioNames,
+            outputPath, optionError))
+        {
+            if(!optionError.empty())
+            {
+                LOG_ERROR(Physics, "%s", optionError.c_str());
+                ServiceLogger::Get().Flush();
+                return 1;
+            }
+
+            physicsServiceConfigArgs.push_back(argv[i]);
+        }
+    }
+
+    if(scenarioNames.empty())
+    {
+        for(std::string_view name : BenchmarkScenario::GetScenarioNames())
+        {
+            scenarioNames.emplace_back(name);
+        }
+    }
+
+    PhysicsServiceConfig physicsServiceConfig;
+    std::string physicsServiceConfigError;
+    if(!physicsServiceConfig.LoadFromCommandLine
+        (static_cast<int>(physicsServiceConfigArgs.size()),
+        physicsServiceConfigArgs.data(), physicsServiceConfigError)
+        || !physicsServiceConfig.Validate(physicsServiceConfigError))
+    {
+        LOG_ERROR(Physics, "Invalid physics service config: %s",
+            physicsServiceConfigError.c_str());
+        ServiceLogger::Get().Flush();
+        return 1;
+    }
+
+    BenchmarkRunner benchmarkRunner(physicsServiceConfig, settings);
+
+    std::vector<BenchmarkResult> results;
+    bool bHadErrors = false;
+    for(const std::string& scenarioName : scenarioNames)
+    {
+        results.push_back(benchmarkRunner.Run(scenarioName));
+
+        if(!results.back().error.empty())
+        {
+            LOG_ERROR(Physics, "Scenario %s failed: %s", scenarioName.c_str(),
+                results.back().error.c_str());
+            bHadErrors = true;
+        }
+    }
+
+    const std::string json = benchmarkRunner.ToJson(results);
+
+    // The logs are flushed first, so they are not mixed with the JSON
+    ServiceLogger::Get().Flush();
+
+    if(outputPath.empty())
+    {
+        std::fwrite(json.data(), 1, json.size(), stdout);
+    }
+    else
+    {
+        std::ofstream outputFile(outputPath, std::ios::binary);
+        outputFile << json;
+        if(!outputFile)
+        {
+            std::fprintf(stderr, "Could not write %s\n", outputPath.c_str());
+            return 1;
+        }
+    }
+
+    return bHadErrors ? 1 : 0;
+}
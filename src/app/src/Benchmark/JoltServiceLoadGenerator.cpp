@@ -0,0 +1,166 @@
+#include "LoadGenerator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    /**
+    * Sets a load generator option (e.g. "--connections=4") from its
+    * argument. The scenario's settings (e.g. "--bodies=5000") are options
+    * too (see "BenchmarkSettings::SetValue()").
+    *
+    * @param argument The argument, without the "--"
+    * @param settings The load generator's settings to set
+    * @param outputPath The JSON's file, set by "--output"
+    * @param outError The error, if the option is unknown or its value could
+    * not be parsed
+    *
+    * @return True if the option was set
+    */
+    bool SetLoadGeneratorOption(std::string_view argument,
+        LoadGeneratorSettings& settings, std::string& outputPath,
+        std::string& outError)
+    {
+        const size_t separatorIndex = argument.find('=');
+        const std::string_view key = argument.substr(0, separatorIndex);
+        const std::string value(separatorIndex == std::string_view::npos
+            ? std::string_view() : argument.substr(separatorIndex + 1));
+
+        if(key == "host")
+        {
+            settings.host = value;
+        }
+        else if(key == "port")
+        {
+            settings.port = value;
+        }
+        else if(key == "connections" || key == "frames"
+            || key == "warmupFrames")
+        {
+            char* valueEnd = nullptr;
+            const unsigned long parsedValue =
+                std::strtoul(value.c_str(), &valueEnd, 10);
+            if(value.empty() || *valueEnd != '\0'
+                || (key == "connections" && parsedValue == 0))
+            {
+                outError = "Invalid value for " + std::string(key) + ": "
+                    + value;
+                return false;
+            }
+
+            (key == "connections" ? settings.connectionCount
+                : key == "frames" ? settings.frameCount
+                : settings.warmupFrameCount) =
+                static_cast<std::uint32_t>(parsedValue);
+        }
+        else if(key == "rate")
+        {
+            settings.frameRate = std::strtod(value.c_str(), nullptr);
+            if(settings.frameRate < 0.0)
+            {
+                outError = "rate must not be negative";
+                return false;
+            }
+        }
+        else if(key == "framing")
+        {
+            if(value != "delimited" && value != "framed")
+            {
+                outError = "framing must be \"delimited\" or \"framed\"";
+                return false;
+            }
+
+            settings.messageFraming = value == "framed"
+                ? EMessageFraming::Framed : EMessageFraming::Delimited;
+        }
+        else if(key == "script")
+        {
+            settings.scriptPath = value;
+        }
+        else if(key == "scenario")
+        {
+            settings.scenarioName = value;
+        }
+        else if(key == "output")
+        {
+            outputPath = value;
+        }
+        else if(!settings.scenarioSettings.SetValue(key, value, outError))
+        {
+            if(outError.empty())
+            {
+                outError = "Unknown option: " + std::string(key);
+            }
+            return false;
+        }
+
+        return true;
+    }
+}
+
+/**
+* Generates load on a running service over TCP (e.g. one started with
+* "JoltService 9000" on the same machine), and writes the measures as JSON:
+*
+* JoltServiceLoadGenerator --port=9000 --connections=4 --rate=60
+*     --frames=600 --framing=framed --scenario=churn --bodies=5000
+*
+* The frames come from a script ("--script=<file>", see 
+* "LoadGeneratorScript") or from a benchmark scenario ("--scenario").
+*/
+int main(int argc, char** argv)
+{
+    LoadGeneratorSettings settings;
+    std::string outputPath;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string_view argument = argv[i];
+        std::string optionError;
+        if(argument.substr(0, 2) != "--")
+        {
+            optionError = "Unknown argument: " + std::string(argument);
+        }
+        else
+        {
+            SetLoadGeneratorOption(argument.substr(2), settings, outputPath,
+                optionError);
+        }
+
+        if(!optionError.empty())
+        {
+            std::fprintf(stderr, "%s\n", optionError.c_str());
+            return 1;
+        }
+    }
+
+    LoadGenerator loadGenerator(settings);
+    const LoadGeneratorResult result = loadGenerator.Run();
+    const std::string json = loadGenerator.ToJson(result);
+
+    for(const std::string& error : result.errors)
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+    }
+
+    if(outputPath.empty())
+    {
+        std::fwrite(json.data(), 1, json.size(), stdout);
+    }
+    else
+    {
+        std::ofstream outputFile(outputPath, std::ios::binary);
+        outputFile << json;
+        if(!outputFile)
+        {
+            std::fprintf(stderr, "Could not write %s\n", outputPath.c_str());
+            return 1;
+        }
+    }
+
+    return result.errors.empty() ? 0 : 1;
+}
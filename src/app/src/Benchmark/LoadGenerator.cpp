@@ -0,0 +1,438 @@
+#include "LoadGenerator.h"
+#include "LoadGeneratorClient.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+using namespace BenchmarkReport;
+
+namespace
+{
+    /** The start of the "Init" message's response when it succeeds */
+    constexpr std::string_view initSuccessPrefix =
+        "Physics system initialized";
+
+    /** The start of every error response */
+    constexpr std::string_view errorPrefix = "Error";
+
+    /** The step message sent on every frame of a scenario */
+    constexpr std::string_view stepMessage = "Step\nMessageEnd\n";
+
+    /**
+    * @return The message type of a delimited message (its first line, with
+    * the world ID if given)
+    */
+    std::string_view GetMessageType(std::string_view message)
+    {
+        return message.substr(0, message.find('\n'));
+    }
+
+    /** @return True if a delimited message is an "Init", on any world */
+    bool IsInitMessage(std::string_view message)
+    {
+        std::string_view messageType;
+        std::uint32_t worldId = 0;
+        MessageFraming::SplitMessageTypeLine(message, messageType, worldId);
+
+        return messageType == "Init";
+    }
+
+    /** @return True if a response is an error response */
+    bool IsErrorResponse(const std::string& response)
+    {
+        return response.compare(0, errorPrefix.size(), errorPrefix) == 0;
+    }
+}
+
+bool LoadGeneratorScript::LoadFromFile(const std::string& scriptPath,
+    std::string& outError)
+{
+    std::ifstream scriptFile(scriptPath);
+    if(!scriptFile)
+    {
+        outError = "Could not open the script file: " + scriptPath;
+        return false;
+    }
+
+    setupMessages.clear();
+    frameMessages.clear();
+
+    std::string message;
+    std::string line;
+    while(std::getline(scriptFile, line))
+    {
+        if(!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        // Comments and empty lines are only skipped between messages, as
+        // the messages' lines are kept as they are
+        if(message.empty() && (line.empty() || line[0] == '#'))
+        {
+            continue;
+        }
+
+        message += line;
+        message += '\n';
+
+        if(line == "MessageEnd")
+        {
+            (IsInitMessage(message) ? setupMessages
+                : frameMessages).push_back(std::move(message));
+            message.clear();
+        }
+    }
+
+    if(!message.empty())
+    {
+        outError = "The script's last message has no \"MessageEnd\" line";
+        return false;
+    }
+
+    if(frameMessages.empty())
+    {
+        outError = "The script has no frame messages: " + scriptPath;
+        return false;
+    }
+
+    return true;
+}
+
+void LoadGeneratorMessageStats::Merge
+    (const LoadGeneratorMessageStats& otherStats)
+{
+    messageCount += otherStats.messageCount;
+    errorCount += otherStats.errorCount;
+    roundTripHistogram.Merge(otherStats.roundTripHistogram);
+    serverHistogram.Merge(otherStats.serverHistogram);
+    bytesSent += otherStats.bytesSent;
+    bytesReceived += otherStats.bytesReceived;
+}
+
+LoadGenerator::LoadGenerator(const LoadGeneratorSettings& settings)
+    : settings(settings)
+{
+}
+
+LoadGeneratorResult LoadGenerator::Run()
+{
+    LoadGeneratorResult result;
+    std::string error;
+
+    // The scenario's world is the setup, and its frames are built while
+    // replayed (only by the first connection)
+    std::unique_ptr<BenchmarkScenario> scenario;
+    if(!settings.scriptPath.empty())
+    {
+        if(!script.LoadFromFile(settings.scriptPath, error))
+        {
+            result.errors.push_back(error);
+            return result;
+        }
+    }
+    else
+    {
+        scenario = BenchmarkScenario::Create(settings.scenarioName,
+            settings.scenarioSettings);
+        if(!scenario)
+        {
+            result.errors.push_back("Unknown scenario: "
+                + settings.scenarioName);
+            return result;
+        }
+
+        // The pipelining is the world's, so it is part of the setup
+        script.setupMessages =
+        {
+            std::string("SetStepPipelining\n")
+                + (settings.scenarioSettings.bPipelinedStepping
+                ? "enabled" : "disabled") + "\nMessageEnd\n",
+            scenario->BuildInitMessage()
+        };
+        script.frameMessages = { std::string(stepMessage) };
+    }
+
+    // Send the setup on its own connection, before any frame
+    {
+        LoadGeneratorClient setupClient;
+        LoadGeneratorExchange exchange;
+        if(!setupClient.Connect(settings.host, settings.port, error))
+        {
+            result.errors.push_back(error);
+            return result;
+        }
+
+        for(const std::string& setupMessage : script.setupMessages)
+        {
+            if(!setupClient.Exchange(setupMessage, exchange, error))
+            {
+                result.errors.push_back(error);
+                return result;
+            }
+
+            if(IsInitMessage(setupMessage)
+                && exchange.response.compare(0, initSuccessPrefix.size(),
+                initSuccessPrefix) != 0)
+            {
+                result.errors.push_back("Init failed: " + exchange.response);
+                return result;
+            }
+        }
+    }
+
+    // Replay the frames on every connection at once
+    std::vector<LoadGeneratorResult> connectionResults
+        (settings.connectionCount);
+    std::vector<std::thread> connectionThreads;
+    connectionThreads.reserve(settings.connectionCount);
+
+    for(std::uint32_t i = 0; i < settings.connectionCount; i++)
+    {
+        connectionThreads.emplace_back([this, i, &connectionResults,
+            &scenario]()
+        {
+            RunConnection(i, i == 0 ? scenario.get() : nullptr,
+                connectionResults[i]);
+        });
+    }
+
+    for(std::thread& connectionThread : connectionThreads)
+    {
+        connectionThread.join();
+    }
+
+    for(const LoadGeneratorResult& connectionResult : connectionResults)
+    {
+        result.errors.insert(result.errors.end(),
+            connectionResult.errors.begin(), connectionResult.errors.end());
+
+        for(const auto& [messageType, messageStats]
+            : connectionResult.messageStats)
+        {
+            result.messageStats[messageType].Merge(messageStats);
+        }
+
+        result.frameCount += connectionResult.frameCount;
+        result.lateFrameCount += connectionResult.lateFrameCount;
+        result.elapsedSeconds = std::max(result.elapsedSeconds,
+            connectionResult.elapsedSeconds);
+    }
+
+    return result;
+}
+
+void LoadGenerator::RunConnection(std::uint32_t connectionIndex,
+    BenchmarkScenario* scenario, LoadGeneratorResult& outResult) const
+{
+    std::string error;
+    LoadGeneratorClient client;
+    if(!client.Connect(settings.host, settings.port, error)
+        || !client.Negotiate(settings.messageFraming, error))
+    {
+        outResult.errors.push_back("Connection "
+            + std::to_string(connectionIndex) + ": " + error);
+        return;
+    }
+
+    // The step responses are negotiated per connection
+    const std::string negotiationMessages[] =
+    {
+        "SetStepResponseFormat\n"
+            + settings.scenarioSettings.stepResponseFormat + "\nMessageEnd\n",
+        "SetStepResponseMode\n"
+            + settings.scenarioSettings.stepResponseMode + "\nMessageEnd\n"
+    };
+
+    LoadGeneratorExchange exchange;
+    for(const std::string& negotiationMessage : negotiationMessages)
+    {
+        if(!client.Exchange(negotiationMessage, exchange, error)
+            || IsErrorResponse(exchange.response))
+        {
+            outResult.errors.push_back("Connection "
+                + std::to_string(connectionIndex) + ": "
+                + (error.empty() ? exchange.response : error));
+            return;
+        }
+    }
+
+    // Each frame is scheduled a frame period after the previous one's
+    // schedule, so a frame that overruns does not delay every later one
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration framePeriod = settings.frameRate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>
+        (std::chrono::duration<double>(1.0 / settings.frameRate))
+        : Clock::duration::zero();
+
+    const std::uint32_t totalFrameCount =
+        settings.warmupFrameCount + settings.frameCount;
+    const Clock::time_point firstFrameTime = Clock::now();
+    Clock::time_point measuredStartTime = firstFrameTime;
+
+    std::vector<std::string> scenarioFrameMessages;
+    for(std::uint32_t frameIndex = 0; frameIndex < totalFrameCount;
+        frameIndex++)
+    {
+        const bool bMeasured = frameIndex >= settings.warmupFrameCount;
+
+        // Built before the frame's time, so it is not on the measures
+        const std::vector<std::string>* frameMessages = &script.frameMessages;
+        if(scenario)
+        {
+            scenarioFrameMessages.clear();
+            scenario->BuildPreStepMessages(frameIndex, scenarioFrameMessages);
+            scenarioFrameMessages.emplace_back(stepMessage);
+            frameMessages = &scenarioFrameMessages;
+        }
+
+        if(framePeriod != Clock::duration::zero())
+        {
+            const Clock::time_point frameTime =
+                firstFrameTime + framePeriod * frameIndex;
+            if(Clock::now() > frameTime)
+            {
+                outResult.lateFrameCount += bMeasured ? 1 : 0;
+            }
+            else
+            {
+                std::this_thread::sleep_until(frameTime);
+            }
+        }
+
+        if(frameIndex == settings.warmupFrameCount)
+        {
+            measuredStartTime = Clock::now();
+        }
+
+        for(const std::string& message : *frameMessages)
+        {
+            if(!client.Exchange(message, exchange, error))
+            {
+                outResult.errors.push_back("Connection "
+                    + std::to_string(connectionIndex) + ": " + error);
+                return;
+            }
+
+            if(!bMeasured)
+            {
+                continue;
+            }
+
+            LoadGeneratorMessageStats& messageStats = outResult.messageStats
+                [std::string(GetMessageType(message))];
+            messageStats.messageCount++;
+            messageStats.errorCount += IsErrorResponse(exchange.response)
+                ? 1 : 0;
+            messageStats.roundTripHistogram.Record
+                (exchange.roundTripNanoseconds);
+            messageStats.serverHistogram.Record(exchange.serverNanoseconds);
+            messageStats.bytesSent += exchange.bytesSent;
+            messageStats.bytesReceived += exchange.bytesReceived;
+        }
+
+        outResult.frameCount += bMeasured ? 1 : 0;
+    }
+
+    outResult.elapsedSeconds = std::chrono::duration<double>
+        (Clock::now() - measuredStartTime).count();
+}
+
+std::string LoadGenerator::ToJson(const LoadGeneratorResult& result) const
+{
+    std::string json = "{\"config\":{";
+    AppendJsonString(json, "host", settings.host);
+    AppendJsonString(json, "port", settings.port);
+    AppendJsonNumber(json, "connections", settings.connectionCount);
+    AppendJsonNumber(json, "frameRate", settings.frameRate);
+    AppendJsonNumber(json, "warmupFrames", settings.warmupFrameCount);
+    AppendJsonNumber(json, "frames", settings.frameCount);
+    AppendJsonString(json, "framing",
+        settings.messageFraming == EMessageFraming::Framed
+        ? "framed" : "delimited");
+    AppendJsonString(json, "stepResponseFormat",
+        settings.scenarioSettings.stepResponseFormat);
+    AppendJsonString(json, "stepResponseMode",
+        settings.scenarioSettings.stepResponseMode);
+    if(settings.scriptPath.empty())
+    {
+        AppendJsonString(json, "scenario", settings.scenarioName);
+        AppendJsonNumber(json, "bodies", settings.scenarioSettings.bodyCount,
+            "");
+    }
+    else
+    {
+        AppendJsonString(json, "script", settings.scriptPath, "");
+    }
+    json += "},\"totals\":{";
+
+    LoadGeneratorMessageStats totalStats;
+    for(const auto& [messageType, messageStats] : result.messageStats)
+    {
+        totalStats.Merge(messageStats);
+    }
+
+    const double elapsedSeconds = std::max(result.elapsedSeconds, 1e-9);
+    AppendJsonNumber(json, "elapsedSeconds", result.elapsedSeconds);
+    AppendJsonNumber(json, "frames", static_cast<double>(result.frameCount));
+    AppendJsonNumber(json, "framesPerSecond",
+        static_cast<double>(result.frameCount) / elapsedSeconds);
+    AppendJsonNumber(json, "lateFrames",
+        static_cast<double>(result.lateFrameCount));
+    AppendJsonNumber(json, "messages",
+        static_cast<double>(totalStats.messageCount));
+    AppendJsonNumber(json, "errorResponses",
+        static_cast<double>(totalStats.errorCount));
+    AppendJsonNumber(json, "bytesSent",
+        static_cast<double>(totalStats.bytesSent));
+    AppendJsonNumber(json, "bytesReceived",
+        static_cast<double>(totalStats.bytesReceived));
+    AppendJsonNumber(json, "receivedMegabitsPerSecond",
+        static_cast<double>(totalStats.bytesReceived) * 8.0 / 1e6
+        / elapsedSeconds, "");
+    json += "},\"messages\":[";
+
+    size_t messageTypeIndex = 0;
+    for(const auto& [messageType, messageStats] : result.messageStats)
+    {
+        const BenchmarkDurationStats roundTripStats =
+            GetDurationStats(messageStats.roundTripHistogram);
+        const BenchmarkDurationStats serverStats =
+            GetDurationStats(messageStats.serverHistogram);
+        const double messageCount =
+            static_cast<double>(std::max<std::uint64_t>
+            (messageStats.messageCount, 1));
+
+        json += "{";
+        AppendJsonString(json, "type", messageType);
+        AppendJsonNumber(json, "count",
+            static_cast<double>(messageStats.messageCount));
+        AppendJsonNumber(json, "errorResponses",
+            static_cast<double>(messageStats.errorCount));
+        AppendJsonDurationStats(json, "roundTripUs", roundTripStats);
+        AppendJsonDurationStats(json, "serverUs", serverStats);
+
+        // The time on the network path (sockets, kernel and wire), on average
+        AppendJsonNumber(json, "networkMeanUs",
+            std::max(0.0, roundTripStats.mean - serverStats.mean));
+        AppendJsonNumber(json, "bytesSentMean",
+            static_cast<double>(messageStats.bytesSent) / messageCount);
+        AppendJsonNumber(json, "bytesReceivedMean",
+            static_cast<double>(messageStats.bytesReceived) / messageCount,
+            "");
+        json += ++messageTypeIndex < result.messageStats.size() ? "}," : "}";
+    }
+
+    json += "],\"errors\":[";
+    for(size_t i = 0; i < result.errors.size(); i++)
+    {
+        AppendJsonQuoted(json, result.errors[i]);
+        json += i + 1 < result.errors.size() ? "," : "";
+    }
+
+    json += "]}\n";
+    return json;
+}
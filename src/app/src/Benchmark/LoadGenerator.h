@@ -0,0 +1,169 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "BenchmarkScenario.h"
+#include "../Communication/MessageFraming.h"
+#include "../PhysicsSimulation/StepTimeHistogram.h"
+
+/** The settings of a load generator run */
+struct LoadGeneratorSettings
+{
+    /** The service's host and port */
+    std::string host = "127.0.0.1";
+    std::string port = "9000";
+
+    /** The number of concurrent connections, each on its own thread */
+    std::uint32_t connectionCount = 1;
+
+    /** The frames per second sent on each connection (0 to not pace them) */
+    double frameRate = 60.0;
+
+    /** The frames sent before the measures start, on each connection */
+    std::uint32_t warmupFrameCount = 60;
+
+    /** The measured frames, on each connection */
+    std::uint32_t frameCount = 600;
+
+    /** The framing of the connections */
+    EMessageFraming messageFraming = EMessageFraming::Delimited;
+
+    /**
+    * The script replayed on the frames (see "LoadGeneratorScript"), or empty
+    * to replay the benchmark scenario
+    */
+    std::string scriptPath;
+
+    /** The benchmark scenario replayed, if there is no script */
+    std::string scenarioName = "rain";
+
+    /** The scenario's settings and the step responses negotiated */
+    BenchmarkSettings scenarioSettings;
+};
+
+/**
+* A scripted sequence of messages. The script file has messages on the
+* delimited format (see "MessageHandlerParser"), each ending with its
+* "MessageEnd" line. Lines starting with '#' between messages are comments.
+* A message is for the world on its message type line ("Step;2"), or for
+* the first world if it has none.
+*
+* The "Init" messages are the setup, sent once before any frame. The other
+* messages make up a frame, replayed in order on every frame of every
+* connection.
+*/
+struct LoadGeneratorScript
+{
+    /**
+    * Loads a script file.
+    *
+    * @param scriptPath The script file's path
+    * @param outError The error, if the file could not be read or has no
+    * frame messages
+    *
+    * @return True if loaded
+    */
+    bool LoadFromFile(const std::string& scriptPath, std::string& outError);
+
+    /** The messages sent once, before any frame */
+    std::vector<std::string> setupMessages;
+
+    /** The messages of every frame */
+    std::vector<std::string> frameMessages;
+};
+
+/** The measures of a message type */
+struct LoadGeneratorMessageStats
+{
+    /** The number of messages sent, and of error responses */
+    std::uint64_t messageCount = 0;
+    std::uint64_t errorCount = 0;
+
+    /** The round-trip times, as seen by the client */
+    StepTimeHistogram roundTripHistogram;
+
+    /** The server's processing times (see "SetServerTiming") */
+    StepTimeHistogram serverHistogram;
+
+    /** The bytes sent and received, with any framing */
+    std::uint64_t bytesSent = 0;
+    std::uint64_t bytesReceived = 0;
+
+    /** Adds the measures of another connection */
+    void Merge(const LoadGeneratorMessageStats& otherStats);
+};
+
+/** The measures of a load generator run, over every connection */
+struct LoadGeneratorResult
+{
+    /** The errors that stopped the run or any connection */
+    std::vector<std::string> errors;
+
+    /** The measures of each message type, by its message type */
+    std::map<std::string, LoadGeneratorMessageStats> messageStats;
+
+    /** The measured frames sent, over every connection */
+    std::uint64_t frameCount = 0;
+
+    /** The frames that started after their time, as the previous overran */
+    std::uint64_t lateFrameCount = 0;
+
+    /** The time from the first to the last measured frame */
+    double elapsedSeconds = 0.0;
+};
+
+/**
+* Generates load on a running service over TCP: replays a script (or a
+* benchmark scenario) at a target frame rate from several concurrent
+* connections, and measures every message's round-trip time, server
+* processing time and bytes transferred.
+*
+* The setup (e.g. "Init") is sent once, on its own connection. Then every
+* connection negotiates its framing and step responses and replays the
+* frames. As every connection shares the service's world, a scenario's
+* messages before each step (e.g. the churn's) are only sent by the first
+* connection, and the others only step.
+*/
+class LoadGenerator final
+{
+public:
+    /** @param settings The run's settings */
+    explicit LoadGenerator(const LoadGeneratorSettings& settings);
+
+    /** @return The run's measures. Has the errors if it did not finish */
+    LoadGeneratorResult Run();
+
+    /**
+    * Writes a run's measures as JSON, with the settings it ran with.
+    *
+    * @param result The run's measures
+    *
+    * @return The JSON document
+    */
+    std::string ToJson(const LoadGeneratorResult& result) const;
+
+private:
+    /**
+    * Replays the frames on a connection.
+    *
+    * @param connectionIndex The connection's index
+    * @param scenario The scenario that builds the frames' messages, or null
+    * to replay the script's frame messages
+    * @param outResult The connection's measures
+    */
+    void RunConnection(std::uint32_t connectionIndex,
+        BenchmarkScenario* scenario, LoadGeneratorResult& outResult) const;
+
+    /** The run's settings */
+    LoadGeneratorSettings settings;
+
+    /** The script replayed (built from the scenario, if there is no file) */
+    LoadGeneratorScript script;
+};
+
+#endif
@@ -0,0 +1,402 @@
+#include "LoadGeneratorClient.h"
+#include "../Communication/MessageFraming.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /** The "MessageEnd" line every delimited response ends with */
+    constexpr std::string_view messageEndLine = "MessageEnd\n";
+
+    /** The bytes asked on each "recv()" */
+    constexpr size_t receiveChunkSize = 256 * 1024;
+
+    /**
+    * Splits a delimited message into its message type, world ID (see 
+    * "MessageFraming::SplitMessageTypeLine()") and payload (without the 
+    * "MessageEnd" line).
+    *
+    * @return True if the world ID is valid and false otherwise
+    */
+    bool SplitDelimitedMessage(std::string_view message,
+        std::string_view& outMessageType, std::uint16_t& outWorldId,
+        std::string_view& outPayload)
+    {
+        const size_t messageTypeEnd = message.find('\n');
+        outPayload = messageTypeEnd == std::string_view::npos
+            ? std::string_view() : message.substr(messageTypeEnd + 1);
+
+        const size_t messageEndPos = outPayload.rfind("MessageEnd");
+        if(messageEndPos != std::string_view::npos)
+        {
+            outPayload = outPayload.substr(0, messageEndPos);
+        }
+
+        // The frame header only has room for 16 bit world IDs
+        std::uint32_t worldId = 0;
+        const bool bIsWorldIdValid = MessageFraming::SplitMessageTypeLine
+            (message, outMessageType, worldId) && worldId <= 0xFFFF;
+        outWorldId = static_cast<std::uint16_t>(worldId);
+
+        return bIsWorldIdValid;
+    }
+}
+
+LoadGeneratorClient::~LoadGeneratorClient()
+{
+    Close();
+}
+
+bool LoadGeneratorClient::Connect(const std::string& host,
+    const std::string& port, std::string& outError)
+{
+    Close();
+
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addrInfoResult = nullptr;
+    const int getAddrInfoReturnValue = getaddrinfo(host.c_str(), port.c_str(),
+        &hints, &addrInfoResult);
+    if(getAddrInfoReturnValue != 0)
+    {
+        outError = std::string("getaddrinfo failed with error: ")
+            + gai_strerror(getAddrInfoReturnValue);
+        return false;
+    }
+
+    for(addrinfo* addrInfo = addrInfoResult; addrInfo && clientSocket == -1;
+        addrInfo = addrInfo->ai_next)
+    {
+        clientSocket = socket(addrInfo->ai_family, addrInfo->ai_socktype,
+            addrInfo->ai_protocol);
+        if(clientSocket == -1)
+        {
+            continue;
+        }
+
+        if(connect(clientSocket, addrInfo->ai_addr, addrInfo->ai_addrlen)
+            == -1)
+        {
+            outError = std::string("connect failed with error: ")
+                + strerror(errno);
+            close(clientSocket);
+            clientSocket = -1;
+        }
+    }
+
+    freeaddrinfo(addrInfoResult);
+
+    if(clientSocket == -1)
+    {
+        if(outError.empty())
+        {
+            outError = "Could not create a socket for " + host + ":" + port;
+        }
+        return false;
+    }
+
+    // Every message is sent right away, as the client waits for its response
+    const int noDelayOption = 1;
+    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelayOption,
+        sizeof(noDelayOption));
+
+    return true;
+}
+
+bool LoadGeneratorClient::Negotiate(EMessageFraming newMessageFraming,
+    std::string& outError)
+{
+    LoadGeneratorExchange exchange;
+
+    // The response to this message has no server time yet
+    if(!Exchange("SetServerTiming\nenabled\nMessageEnd\n", exchange,
+        outError))
+    {
+        return false;
+    }
+
+    if(exchange.response.compare(0, 5, "Error") == 0)
+    {
+        outError = exchange.response;
+        return false;
+    }
+
+    bServerTiming = true;
+
+    if(newMessageFraming == EMessageFraming::Delimited)
+    {
+        return true;
+    }
+
+    // The response to this message is still delimited
+    if(!Exchange("SetMessageFraming\nframed\nMessageEnd\n", exchange,
+        outError))
+    {
+        return false;
+    }
+
+    if(exchange.response.compare(0, 5, "Error") == 0)
+    {
+        outError = exchange.response;
+        return false;
+    }
+
+    messageFraming = EMessageFraming::Framed;
+    return true;
+}
+
+bool LoadGeneratorClient::Exchange(std::string_view message,
+    LoadGeneratorExchange& outExchange, std::string& outError)
+{
+    outExchange.response.clear();
+    outExchange.serverNanoseconds = 0;
+
+    std::string_view dataToSend = message;
+    std::uint16_t messageWorldId = 0;
+    if(messageFraming == EMessageFraming::Framed)
+    {
+        std::string_view messageType;
+        std::string_view messagePayload;
+        if(!SplitDelimitedMessage(message, messageType, messageWorldId,
+            messagePayload))
+        {
+            outError = "Invalid world ID on message type line: "
+                + std::string(message.substr(0, message.find('\n')));
+            return false;
+        }
+
+        const std::uint16_t opcode = 
+            MessageFraming::FindMessageTypeOpcode(messageType);
+        if(opcode == 0)
+        {
+            outError = "No opcode for message type: "
+                + std::string(messageType);
+            return false;
+        }
+
+        frameBuffer.clear();
+        MessageFraming::AppendFrameHeader(frameBuffer,
+            static_cast<std::uint32_t>(messagePayload.size()), opcode,
+            messageWorldId);
+        frameBuffer += messagePayload;
+        dataToSend = frameBuffer;
+    }
+
+    const size_t receivedBytesBefore = receivedBuffer.size();
+    const auto sendTime = std::chrono::steady_clock::now();
+
+    if(!SendAll(dataToSend, outError))
+    {
+        return false;
+    }
+
+    size_t responseLength = 0;
+    if(messageFraming == EMessageFraming::Framed)
+    {
+        if(!ReceiveAtLeast(MessageFraming::frameHeaderSize, outError))
+        {
+            return false;
+        }
+
+        std::uint32_t payloadLength = 0;
+        std::uint16_t opcode = 0;
+        std::uint16_t worldId = 0;
+        MessageFraming::ReadFrameHeader(receivedBuffer.data(), payloadLength,
+            opcode, worldId);
+
+        responseLength = MessageFraming::frameHeaderSize + payloadLength;
+        if(!ReceiveAtLeast(responseLength, outError))
+        {
+            return false;
+        }
+
+        outExchange.roundTripNanoseconds = static_cast<std::uint64_t>
+            (std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now() - sendTime).count());
+
+        // The response echoes the world the message was for
+        if(worldId != messageWorldId)
+        {
+            receivedBuffer.erase(0, responseLength);
+            receivedScanOffset = 0;
+
+            outError = "Response for world " + std::to_string(worldId)
+                + " to a message for world " + std::to_string(messageWorldId);
+            return false;
+        }
+
+        size_t payloadStart = MessageFraming::frameHeaderSize;
+        if(bServerTiming && payloadLength >= MessageFraming::serverTimeSize)
+        {
+            const unsigned char* serverTimeBytes =
+                reinterpret_cast<const unsigned char*>
+                (receivedBuffer.data() + payloadStart);
+            for(size_t i = 0; i < MessageFraming::serverTimeSize; i++)
+            {
+                outExchange.serverNanoseconds |=
+                    static_cast<std::uint64_t>(serverTimeBytes[i]) << (8 * i);
+            }
+            payloadStart += MessageFraming::serverTimeSize;
+        }
+
+        outExchange.response.assign(receivedBuffer, payloadStart,
+            responseLength - payloadStart);
+        receivedBuffer.erase(0, responseLength);
+        receivedScanOffset = 0;
+    }
+    else
+    {
+        if(!ReceiveDelimitedResponse(outExchange.response, outError))
+        {
+            return false;
+        }
+
+        outExchange.roundTripNanoseconds = static_cast<std::uint64_t>
+            (std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now() - sendTime).count());
+
+        responseLength = outExchange.response.size();
+
+        // The server time line goes before the response
+        const std::string_view serverTimeLinePrefix =
+            MessageFraming::serverTimeLinePrefix;
+        if(bServerTiming && outExchange.response.compare(0,
+            serverTimeLinePrefix.size(), serverTimeLinePrefix) == 0)
+        {
+            const size_t serverTimeLineEnd = outExchange.response.find('\n');
+            outExchange.serverNanoseconds = std::strtoull
+                (outExchange.response.c_str() + serverTimeLinePrefix.size(),
+                nullptr, 10);
+            outExchange.response.erase(0, serverTimeLineEnd + 1);
+        }
+    }
+
+    outExchange.bytesSent = dataToSend.size();
+    outExchange.bytesReceived = responseLength;
+
+    // The service only answers, so nothing else should have been received
+    if(receivedBytesBefore != 0)
+    {
+        outError = "Received data that was not a response";
+        return false;
+    }
+
+    return true;
+}
+
+void LoadGeneratorClient::Close()
+{
+    if(clientSocket != -1)
+    {
+        shutdown(clientSocket, SHUT_RDWR);
+        close(clientSocket);
+        clientSocket = -1;
+    }
+
+    messageFraming = EMessageFraming::Delimited;
+    bServerTiming = false;
+    receivedBuffer.clear();
+    receivedScanOffset = 0;
+}
+
+bool LoadGeneratorClient::SendAll(std::string_view data,
+    std::string& outError)
+{
+    size_t sentBytes = 0;
+    while(sentBytes < data.size())
+    {
+        const ssize_t sendReturnValue = send(clientSocket,
+            data.data() + sentBytes, data.size() - sentBytes, MSG_NOSIGNAL);
+        if(sendReturnValue == -1)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            outError = std::string("send failed with error: ")
+                + strerror(errno);
+            return false;
+        }
+
+        sentBytes += static_cast<size_t>(sendReturnValue);
+    }
+
+    return true;
+}
+
+bool LoadGeneratorClient::ReceiveAtLeast(size_t byteCount,
+    std::string& outError)
+{
+    while(receivedBuffer.size() < byteCount)
+    {
+        const size_t previousSize = receivedBuffer.size();
+        receivedBuffer.resize(previousSize + receiveChunkSize);
+
+        const ssize_t receivedBytes = recv(clientSocket,
+            receivedBuffer.data() + previousSize, receiveChunkSize, 0);
+        receivedBuffer.resize(previousSize
+            + static_cast<size_t>(std::max<ssize_t>(receivedBytes, 0)));
+
+        if(receivedBytes == 0)
+        {
+            outError = "The service closed the connection";
+            return false;
+        }
+
+        if(receivedBytes < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            outError = std::string("recv failed with error: ")
+                + strerror(errno);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LoadGeneratorClient::ReceiveDelimitedResponse(std::string& outResponse,
+    std::string& outError)
+{
+    while(true)
+    {
+        // The last bytes are searched again, as the line may have been split
+        // between two chunks
+        const size_t scanStart = receivedScanOffset > messageEndLine.size()
+            ? receivedScanOffset - messageEndLine.size() : 0;
+        const size_t messageEndPos =
+            receivedBuffer.find(messageEndLine, scanStart);
+        if(messageEndPos != std::string::npos)
+        {
+            const size_t responseLength =
+                messageEndPos + messageEndLine.size();
+            outResponse.assign(receivedBuffer, 0, responseLength);
+            receivedBuffer.erase(0, responseLength);
+            receivedScanOffset = 0;
+            return true;
+        }
+
+        receivedScanOffset = receivedBuffer.size();
+        if(!ReceiveAtLeast(receivedBuffer.size() + 1, outError))
+        {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef LOADGENERATORCLIENT_H
+#define LOADGENERATORCLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../Communication/MessageFraming.h"
+
+/** A message sent to the service and its response, as seen by the client */
+struct LoadGeneratorExchange
+{
+    /** The response (without the frame header or the server time) */
+    std::string response;
+
+    /** The time from sending the message until its whole response arrived */
+    std::uint64_t roundTripNanoseconds = 0;
+
+    /** The time the server took to handle it (see "SetServerTiming") */
+    std::uint64_t serverNanoseconds = 0;
+
+    /** The bytes sent and received on the socket, with any framing */
+    std::uint64_t bytesSent = 0;
+    std::uint64_t bytesReceived = 0;
+};
+
+/**
+* A client of the service's protocol over TCP, as the game's proxy is. The
+* socket is blocking, so every message waits for its response before the next
+* one is sent. Nagle's algorithm is disabled, as the messages are small and
+* latency bound.
+*
+* The messages are always given in the delimited format (see
+* "MessageHandlerParser"). Once the client negotiated the framed protocol,
+* they are sent as frames instead (see MessageFraming).
+*/
+class LoadGeneratorClient final
+{
+public:
+    LoadGeneratorClient() = default;
+    ~LoadGeneratorClient();
+
+    LoadGeneratorClient(const LoadGeneratorClient&) = delete;
+    LoadGeneratorClient& operator=(const LoadGeneratorClient&) = delete;
+
+    /**
+    * Connects to the service.
+    *
+    * @param host The service's host (e.g. "127.0.0.1")
+    * @param port The service's port
+    * @param outError The error, if could not connect
+    *
+    * @return True if connected
+    */
+    bool Connect(const std::string& host, const std::string& port,
+        std::string& outError);
+
+    /**
+    * Negotiates the connection's framing and enables the server timing, so
+    * every response after it carries the server's processing time.
+    *
+    * @param messageFraming The framing of the messages after it
+    * @param outError The error, if the service refused any of them
+    *
+    * @return True if negotiated
+    */
+    bool Negotiate(EMessageFraming messageFraming, std::string& outError);
+
+    /**
+    * Sends a message and waits for its whole response.
+    *
+    * @param message The message, in the delimited format (with the message
+    * type line and the "MessageEnd" line)
+    * @param outExchange The response and its measures
+    * @param outError The error, if the connection failed (an error response
+    * from the service is still a response)
+    *
+    * @return True if the response was received
+    */
+    bool Exchange(std::string_view message, LoadGeneratorExchange& outExchange,
+        std::string& outError);
+
+    /** Closes the connection, if connected */
+    void Close();
+
+private:
+    /**
+    * Sends every byte of a buffer.
+    *
+    * @return False if the connection failed
+    */
+    bool SendAll(std::string_view data, std::string& outError);
+
+    /**
+    * Receives until the received buffer has at least a number of bytes.
+    *
+    * @return False if the connection failed or was closed
+    */
+    bool ReceiveAtLeast(size_t byteCount, std::string& outError);
+
+    /**
+    * Receives a whole delimited response (up to its "MessageEnd" line) and
+    * takes it from the received buffer.
+    *
+    * @param outResponse The response, with the "MessageEnd" line
+    *
+    * @return False if the connection failed or was closed
+    */
+    bool ReceiveDelimitedResponse(std::string& outResponse,
+        std::string& outError);
+
+    /** The connected socket, or -1 */
+    int clientSocket = -1;
+
+    /** The framing of the messages sent and received */
+    EMessageFraming messageFraming = EMessageFraming::Delimited;
+
+    /** If the responses carry the server time */
+    bool bServerTiming = false;
+
+    /** The bytes received and not taken by a response yet */
+    std::string receivedBuffer;
+
+    /** The received buffer's bytes already searched for "MessageEnd" */
+    size_t receivedScanOffset = 0;
+
+    /** The message sent, as a frame (kept to reuse its capacity) */
+    std::string frameBuffer;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CLIENTCONNECTION_H
+#define CLIENTCONNECTION_H
+
+#include <cstdint>
+#include <string>
+#include "ClientConnectionSettings.h"
+
+/**
+* The state of a client connected to the physics service server. Each client
+* has its own decode buffer, negotiated settings and pending send buffer, so
+* several clients (e.g. the game server, a spectator feed and a metrics 
+* scraper) can be served concurrently by the same server.
+*/
+struct ClientConnection
+{
+    /** The client's connected socket */
+    int clientSocket = -1;
+
+    /** 
+    * The current decoded message. This is the data received from the client
+    * that has not been handled yet (i.e. chunks of a message that did not
+    * reach the "MessageEnd" flag).
+    */
+    std::string decodedMessage = "";
+
+    /** 
+    * The position on the decoded message from which the "MessageEnd" flag
+    * has not been searched yet. This avoids scanning the whole decoded 
+    * message again each time a new chunk is received.
+    */
+    size_t decodedMessageScanOffset = 0;
+
+    /** 
+    * The data that should still be sent to the client. The socket is 
+    * non-blocking, so a response that does not fit the socket's send buffer 
+    * is kept here until the socket is writable again.
+    */
+    std::string pendingSendBuffer = "";
+
+    /** 
+    * The position on the pending send buffer from which the data has not 
+    * been sent yet
+    */
+    size_t pendingSendOffset = 0;
+
+    /** The settings negotiated by this client */
+    ClientConnectionSettings settings;
+
+    /** The ID of the world the client last stepped or initialized */
+    std::uint32_t worldId = 0;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef CLIENTCONNECTIONSETTINGS_H
+#define CLIENTCONNECTIONSETTINGS_H
+
+#include "MessageFraming.h"
+#include "../PhysicsSimulation/ClientInterest.h"
+#include "../PhysicsSimulation/ClientActiveSet.h"
+#include "../Serialization/StateDeltaHistory.h"
+#include "../Serialization/StateQuantization.h"
+
+/**
+* The step response format. The "Text" format is the legacy format, where each
+* body is sent as a ";" separated line. The "Binary" format sends a packed
+* little-endian record per body. The "Quantized" format is the binary format
+* with bit packed records of quantized values. The "QuantizedDelta" format 
+* sends the quantized values delta compressed against the last step the 
+* client acknowledged.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationBinary
+*/
+enum class EStepResponseFormat
+{
+    Text,
+    Binary,
+    Quantized,
+    QuantizedDelta
+};
+
+/**
+* The step response mode. On "Full" mode, every body is reported on each step.
+* On "ActiveSet" mode, only the bodies that are active and changed (or that 
+* woke up or went to sleep) are reported.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationActiveSet
+*/
+enum class EStepResponseMode
+{
+    Full,
+    ActiveSet
+};
+
+/**
+* The settings negotiated by a client for its connection. Every connection
+* starts with the default (legacy) settings, and the client may change them
+* through the negotiation messages (e.g. "SetStepResponseFormat"). The message
+* handlers read these settings to decide how to answer the client.
+*/
+struct ClientConnectionSettings
+{
+    /** The format used to send the step physics response to this client */
+    EStepResponseFormat stepResponseFormat = EStepResponseFormat::Text;
+
+    /** 
+    * The precision of the values, on the "Quantized" and "QuantizedDelta"
+    * formats
+    */
+    StateQuantizationSettings stateQuantization;
+
+    /** 
+    * The steps sent to this client and the last one it acknowledged, on the
+    * "QuantizedDelta" format
+    */
+    StateDeltaHistory stateDeltaHistory;
+
+    /** 
+    * The states last reported to this client and the events it has not been
+    * reported yet, on the "ActiveSet" mode
+    */
+    ClientActiveSet activeSet;
+
+    /** The bodies reported to this client on each step */
+    EStepResponseMode stepResponseMode = EStepResponseMode::Full;
+
+    /** 
+    * The maximum change on any body's state component for an active body
+    * not to be reported. Only used on "ActiveSet" mode.
+    */
+    float activeSetChangeEpsilon = 0.f;
+
+    /** The framing of the messages sent and received on this connection */
+    EMessageFraming messageFraming = EMessageFraming::Delimited;
+
+    /** 
+    * If every response carries the time the server took to handle its 
+    * message (see "SetServerTiming" and MessageFraming)
+    */
+    bool bServerTiming = false;
+
+    /** 
+    * The regions of the world this client is interested in (see 
+    * "SetInterestRegions"). Without regions, the client is interested in the
+    * whole world. Only used on "Full" mode.
+    */
+    ClientInterest interest;
+};
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef MESSAGEFRAMING_H
+#define MESSAGEFRAMING_H
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include "../Serialization/ByteBufferWriter.h"
+
+/**
+* The message framing used on a connection. On "Delimited" mode (the legacy
+* mode), every message starts with the message type line and ends with the
+* "MessageEnd" line. On "Framed" mode, every message is a frame with a fixed
+* header carrying the opcode and payload length.
+*
+* @see MessageFraming
+*/
+enum class EMessageFraming
+{
+    Delimited,
+    Framed
+};
+
+/**
+* The opcodes of the framed message protocol. Each message type has an opcode,
+* which is sent on the frame header instead of the message type line used by
+* the delimited protocol. The response to a message has the same opcode with
+* the "Response" flag set.
+*/
+enum class EMessageOpcode : std::uint16_t
+{
+    Init = 1,
+    Step = 2,
+    RemoveBody = 3,
+    AddBody = 4,
+    UpdateBodyType = 5,
+    GetSimulationMeasures = 6,
+    SetStepResponseFormat = 7,
+    SetStepResponseMode = 8,
+    SetMessageFraming = 9,
+    SetStepPipelining = 10,
+    GetPhaseProfile = 11,
+    SetServerTiming = 12,
+    SaveSnapshot = 13,
+    LoadSnapshot = 14,
+    ExportBodies = 15,
+    ImportBodies = 16,
+    SetInterestRegions = 17,
+    GetWorldCosts = 18,
+    SetStepAuthority = 19,
+
+    /** Flag set on the opcode of every response */
+    Response = 0x8000
+};
+
+/**
+* The framed message protocol. When a client negotiates it (see 
+* "SetMessageFraming"), every message in both directions is a frame with a 
+* fixed size header followed by the payload:
+*
+* uint32 payloadLength (little-endian)
+* uint16 opcode (little-endian, see EMessageOpcode)
+* uint16 worldId (little-endian)
+* payloadLength bytes of payload
+*
+* The world ID routes the message to one of the physics worlds hosted by the
+* service (see "PhysicsWorldHost"), 0 being the first one. The response has
+* the same world ID. On delimited messages, the world ID follows the message
+* type on its line, as "Step;2". A message type alone goes to world 0.
+*
+* The payload is the same as the delimited message's body, i.e. without the
+* message type line and without the "MessageEnd" line. As the header carries
+* the payload length, the server knows exactly when a frame is complete and
+* can hand the handlers a view of the payload on the receive buffer.
+*
+* When a client enables the server timing (see "SetServerTiming"), every 
+* response starts with the time the server took to handle its message. On
+* framed responses, it is a uint64 of nanoseconds (little-endian) at the 
+* payload's start, counted on the payload length. On delimited responses, it 
+* is a "ServerTimeNs;nanoseconds" line before the response.
+*/
+namespace MessageFraming
+{
+    /** The size in bytes of the frame header */
+    constexpr size_t frameHeaderSize = 8;
+
+    /** 
+    * The maximum payload length accepted on a frame. Clients that send 
+    * bigger frames are disconnected, as they are most likely not speaking
+    * the framed protocol.
+    */
+    constexpr std::uint32_t maxFramePayloadLength = 512 * 1024 * 1024;
+
+    /** The size in bytes of the server time on framed responses */
+    constexpr size_t serverTimeSize = 8;
+
+    /** The line's prefix of the server time on delimited responses */
+    constexpr std::string_view serverTimeLinePrefix = "ServerTimeNs;";
+
+    /** A message type and the opcode of its frames */
+    struct MessageTypeOpcode
+    {
+        std::string_view messageType;
+        EMessageOpcode opcode;
+    };
+
+    /** Every message type of the service, with its opcode */
+    constexpr MessageTypeOpcode messageTypeOpcodes[] =
+    {
+        { "Init", EMessageOpcode::Init },
+        { "Step", EMessageOpcode::Step },
+        { "RemoveBody", EMessageOpcode::RemoveBody },
+        { "AddBody", EMessageOpcode::AddBody },
+        { "UpdateBodyType", EMessageOpcode::UpdateBodyType },
+        { "GetSimulationMeasures", EMessageOpcode::GetSimulationMeasures },
+        { "SetStepResponseFormat", EMessageOpcode::SetStepResponseFormat },
+        { "SetStepResponseMode", EMessageOpcode::SetStepResponseMode },
+        { "SetMessageFraming", EMessageOpcode::SetMessageFraming },
+        { "SetStepPipelining", EMessageOpcode::SetStepPipelining },
+        { "GetPhaseProfile", EMessageOpcode::GetPhaseProfile },
+        { "SetServerTiming", EMessageOpcode::SetServerTiming },
+        { "SaveSnapshot", EMessageOpcode::SaveSnapshot },
+        { "LoadSnapshot", EMessageOpcode::LoadSnapshot },
+        { "ExportBodies", EMessageOpcode::ExportBodies },
+        { "ImportBodies", EMessageOpcode::ImportBodies },
+        { "SetInterestRegions", EMessageOpcode::SetInterestRegions },
+        { "GetWorldCosts", EMessageOpcode::GetWorldCosts },
+        { "SetStepAuthority", EMessageOpcode::SetStepAuthority }
+    };
+
+    /** @return The opcode of a message type, or 0 if it is unknown */
+    inline std::uint16_t FindMessageTypeOpcode(std::string_view messageType)
+    {
+        for(const MessageTypeOpcode& messageTypeOpcode : messageTypeOpcodes)
+        {
+            if(messageTypeOpcode.messageType == messageType)
+            {
+                return static_cast<std::uint16_t>(messageTypeOpcode.opcode);
+            }
+        }
+
+        return 0;
+    }
+
+    /** @return The message type of an opcode, or empty if it is unknown */
+    inline std::string_view FindOpcodeMessageType(EMessageOpcode opcode)
+    {
+        for(const MessageTypeOpcode& messageTypeOpcode : messageTypeOpcodes)
+        {
+            if(messageTypeOpcode.opcode == opcode)
+            {
+                return messageTypeOpcode.messageType;
+            }
+        }
+
+        return std::string_view();
+    }
+
+    /** 
+    * Splits the first line of a delimited message into its message type 
+    * and the world ID that may follow it (e.g. "Step;2"). A message type
+    * alone is for world 0.
+    * 
+    * @param message The delimited message (or only its first line)
+    * @param outMessageType The message type, without the world ID
+    * @param outWorldId The ID of the world the message is for
+    * 
+    * @return False if the world ID is not a number
+    */
+    inline bool SplitMessageTypeLine(std::string_view message, 
+        std::string_view& outMessageType, std::uint32_t& outWorldId)
+    {
+        outWorldId = 0;
+
+        const std::string_view messageTypeLine = 
+            message.substr(0, message.find('\n'));
+        const size_t worldIdPos = messageTypeLine.find(';');
+        outMessageType = messageTypeLine.substr(0, worldIdPos);
+        if(worldIdPos == std::string_view::npos)
+        {
+            return true;
+        }
+
+        const std::string_view worldIdText = 
+            messageTypeLine.substr(worldIdPos + 1);
+        const char* worldIdTextEnd = worldIdText.data() + worldIdText.size();
+        const auto [parseEnd, parseError] = std::from_chars
+            (worldIdText.data(), worldIdTextEnd, outWorldId);
+
+        return !worldIdText.empty() && parseError == std::errc() 
+            && parseEnd == worldIdTextEnd;
+    }
+
+    /** 
+    * Reads a frame header.
+    * 
+    * @param frameHeader The frame header's first byte. Must have at least
+    * "frameHeaderSize" bytes
+    * @param outPayloadLength The frame's payload length
+    * @param outOpcode The frame's opcode
+    * @param outWorldId The ID of the world the frame is for
+    */
+    inline void ReadFrameHeader(const char* frameHeader, 
+        std::uint32_t& outPayloadLength, std::uint16_t& outOpcode,
+        std::uint16_t& outWorldId)
+    {
+        const unsigned char* headerBytes = 
+            reinterpret_cast<const unsigned char*>(frameHeader);
+
+        outPayloadLength = static_cast<std::uint32_t>(headerBytes[0])
+            | (static_cast<std::uint32_t>(headerBytes[1]) << 8)
+            | (static_cast<std::uint32_t>(headerBytes[2]) << 16)
+            | (static_cast<std::uint32_t>(headerBytes[3]) << 24);
+
+        outOpcode = static_cast<std::uint16_t>(headerBytes[4] 
+            | (headerBytes[5] << 8));
+
+        outWorldId = static_cast<std::uint16_t>(headerBytes[6] 
+            | (headerBytes[7] << 8));
+    }
+
+    /** 
+    * Appends a frame header to the given buffer.
+    * 
+    * @param buffer The buffer to append the header to
+    * @param payloadLength The length of the payload that follows the header
+    * @param opcode The frame's opcode
+    * @param worldId The ID of the world the frame is for (or from)
+    */
+    inline void AppendFrameHeader(std::string& buffer, 
+        std::uint32_t payloadLength, std::uint16_t opcode, 
+        std::uint16_t worldId = 0)
+    {
+        ByteBufferWriter::AppendUInt32(buffer, payloadLength);
+        ByteBufferWriter::AppendUInt8(buffer, opcode & 0xFF);
+        ByteBufferWriter::AppendUInt8(buffer, (opcode >> 8) & 0xFF);
+        ByteBufferWriter::AppendUInt8(buffer, worldId & 0xFF);
+        ByteBufferWriter::AppendUInt8(buffer, (worldId >> 8) & 0xFF);
+    }
+}
+
+#endif
@@ -1,41 +1,174 @@
 #include "MessageHandlerParser.h"
+#include "MessageHandlers/MessageHandler_InitPhysicsSystem.h"
+#include "MessageHandlers/MessageHandler_StepPhysicsSystem.h"
+#include "MessageHandlers/MessageHandler_RemoveBody.h"
+#include "MessageHandlers/MessageHandler_AddBody.h"
+#include "MessageHandlers/MessageHandler_UpdateBodyType.h"
+#include "MessageHandlers/MessageHandler_GetSimulationMeasures.h"
+#include "MessageHandlers/MessageHandler_GetPhaseProfile.h"
+#include "MessageHandlers/MessageHandler_SetStepResponseFormat.h"
+#include "MessageHandlers/MessageHandler_SetStepResponseMode.h"
+#include "MessageHandlers/MessageHandler_SetMessageFraming.h"
+#include "MessageHandlers/MessageHandler_SetStepPipelining.h"
+#include "MessageHandlers/MessageHandler_SetServerTiming.h"
+#include "MessageHandlers/MessageHandler_SaveSnapshot.h"
+#include "MessageHandlers/MessageHandler_LoadSnapshot.h"
+#include "MessageHandlers/MessageHandler_ExportBodies.h"
+#include "MessageHandlers/MessageHandler_ImportBodies.h"
+#include "MessageHandlers/MessageHandler_SetInterestRegions.h"
+#include "MessageHandlers/MessageHandler_SetStepAuthority.h"
+#include "MessageHandlers/MessageHandler_GetWorldCosts.h"
 
-std::string MessageHandlerParser::handleMessage(std::string& message)
+std::string_view MessageHandlerParser::handleMessage
+    (std::string_view message, std::string& responseBuffer,
+    ClientConnectionSettings* clientConnectionSettings)
 {
     // Extracting the handler type from the message
-    const std::string handlerType = extractHandlerTypeFromMessage(message);
+    const std::string_view handlerType = extractHandlerTypeFromMessage(message);
 
     // Find the handler on the map
-    auto handlerPtr = messageHandlersMap.find(handlerType);
+    auto handlerPtr = messageHandlersMap.find(std::string(handlerType));
 
     // If could find the handler, handle the message
     if(handlerPtr != messageHandlersMap.end())
     {
-        return handlerPtr->second->handleMessage(message);
+        // Let the handler know which client's settings to respond with
+        handlerPtr->second->setClientConnectionSettings
+            (clientConnectionSettings);
+
+        return handlerPtr->second->handleMessage(message, responseBuffer);
     }
 
     // If not, call the unknown message method
-    printf("Error: Message type could not be handled. Message: (%s).\n"
-        "Every receving message should have the message type on the first"
-        "line. The given handler type is unknown.\n\n", message.c_str());
+    LOG_WARNING(Messages, "Message type could not be handled. Message: "
+        "(%.*s).\nEvery receving message should have the message type on the "
+        "first line. The given handler type is unknown.", 
+        ServiceLogger::ClampTextLength(message.size()), message.data());
 
-    return "Error: Message type could not be handled.";
+    responseBuffer = "Error: Message type could not be handled.";
+    return responseBuffer;
 }
 
-std::string MessageHandlerParser::extractHandlerTypeFromMessage
-    (const std::string& message)
+std::string_view MessageHandlerParser::handleFramedMessage
+    (std::uint16_t opcode, std::string_view messagePayload, 
+    std::string& responseBuffer, 
+    ClientConnectionSettings* clientConnectionSettings)
 {
-    // Get the message type delimiter ('\n') every message should have the
-    // handler type on the first line
-    const size_t messageTypeDelimiterPos = message.find('\n');
+    // Find the handler by the frame's opcode
+    auto handlerPtr = messageHandlersByOpcode.find(opcode);
 
-    // If found the delimiter, return the substring from the message init into 
-    // it
-    if(messageTypeDelimiterPos != std::string::npos)
+    // If could find the handler, handle the payload
+    if(handlerPtr != messageHandlersByOpcode.end())
     {
-        return message.substr(0, messageTypeDelimiterPos);
+        // Let the handler know which client's settings to respond with
+        handlerPtr->second->setClientConnectionSettings
+            (clientConnectionSettings);
+
+        return handlerPtr->second->handleMessagePayloadAsView
+            (messagePayload, responseBuffer);
     }
 
-    // If not, just return the message itself
-    return message;
+    // If not, call the unknown message method
+    LOG_WARNING(Messages, "Message opcode could not be handled. Opcode: "
+        "(%u).", static_cast<unsigned int>(opcode));
+
+    responseBuffer = "Error: Message opcode could not be handled.";
+    return responseBuffer;
+}
+
+std::string_view MessageHandlerParser::extractHandlerTypeFromMessage
+    (std::string_view message)
+{
+    // Every message should have the handler type on the first line. The 
+    // type may be followed by the world ID the message is for (e.g. 
+    // "Step;2"), which is not part of it
+    std::string_view handlerType;
+    std::uint32_t worldId = 0;
+    MessageFraming::SplitMessageTypeLine(message, handlerType, worldId);
+
+    return handlerType;
+}
+
+void MessageHandlerParser::registerPhysicsServiceHandlers
+    (PhysicsServiceImpl* physicsServiceImplementation)
+{
+    // Register InitPhysicsSystem handler (message type: "Init")
+    registerHandler<MessageHandler_InitPhysicsSystem>
+        (EMessageOpcode::Init, physicsServiceImplementation);
+
+    // Register StepPhysicsSystem handler (message type: "Step")
+    registerHandler<MessageHandler_StepPhysicsSystem>
+        (EMessageOpcode::Step, physicsServiceImplementation);
+
+    // Register RemoveBody handler (message type: "RemoveBody")
+    registerHandler<MessageHandler_RemoveBody>
+        (EMessageOpcode::RemoveBody, physicsServiceImplementation);
+    
+    // Register AddBody handler (message type: "AddBody")
+    registerHandler<MessageHandler_AddBody>
+        (EMessageOpcode::AddBody, physicsServiceImplementation);
+
+    // Register UpdateBodyType handler (message type: "UpdateBodyType")
+    registerHandler<MessageHandler_UpdateBodyType>
+        (EMessageOpcode::UpdateBodyType, physicsServiceImplementation);
+
+    // Register GetSimulationMeasures handler (message type: 
+    // "GetSimulationMeasures")
+    registerHandler<MessageHandler_GetSimulationMeasures>
+        (EMessageOpcode::GetSimulationMeasures, physicsServiceImplementation);
+
+    // Register GetPhaseProfile handler (message type: "GetPhaseProfile")
+    registerHandler<MessageHandler_GetPhaseProfile>
+        (EMessageOpcode::GetPhaseProfile, physicsServiceImplementation);
+
+    // Register SetStepResponseFormat handler (message type: 
+    // "SetStepResponseFormat")
+    registerHandler<MessageHandler_SetStepResponseFormat>
+        (EMessageOpcode::SetStepResponseFormat, physicsServiceImplementation);
+
+    // Register SetStepResponseMode handler (message type: 
+    // "SetStepResponseMode")
+    registerHandler<MessageHandler_SetStepResponseMode>
+        (EMessageOpcode::SetStepResponseMode, physicsServiceImplementation);
+
+    // Register SetMessageFraming handler (message type: "SetMessageFraming")
+    registerHandler<MessageHandler_SetMessageFraming>
+        (EMessageOpcode::SetMessageFraming, physicsServiceImplementation);
+
+    // Register SetStepPipelining handler (message type: "SetStepPipelining")
+    registerHandler<MessageHandler_SetStepPipelining>
+        (EMessageOpcode::SetStepPipelining, physicsServiceImplementation);
+
+    // Register SetServerTiming handler (message type: "SetServerTiming")
+    registerHandler<MessageHandler_SetServerTiming>
+        (EMessageOpcode::SetServerTiming, physicsServiceImplementation);
+
+    // Register SaveSnapshot handler (message type: "SaveSnapshot")
+    registerHandler<MessageHandler_SaveSnapshot>
+        (EMessageOpcode::SaveSnapshot, physicsServiceImplementation);
+
+    // Register LoadSnapshot handler (message type: "LoadSnapshot")
+    registerHandler<MessageHandler_LoadSnapshot>
+        (EMessageOpcode::LoadSnapshot, physicsServiceImplementation);
+
+    // Register ExportBodies handler (message type: "ExportBodies")
+    registerHandler<MessageHandler_ExportBodies>
+        (EMessageOpcode::ExportBodies, physicsServiceImplementation);
+
+    // Register ImportBodies handler (message type: "ImportBodies")
+    registerHandler<MessageHandler_ImportBodies>
+        (EMessageOpcode::ImportBodies, physicsServiceImplementation);
+
+    // Register SetInterestRegions handler (message type: 
+    // "SetInterestRegions")
+    registerHandler<MessageHandler_SetInterestRegions>
+        (EMessageOpcode::SetInterestRegions, physicsServiceImplementation);
+
+    // Register GetWorldCosts handler (message type: "GetWorldCosts")
+    registerHandler<MessageHandler_GetWorldCosts>
+        (EMessageOpcode::GetWorldCosts, physicsServiceImplementation);
+
+    // Register SetStepAuthority handler (message type: "SetStepAuthority")
+    registerHandler<MessageHandler_SetStepAuthority>
+        (EMessageOpcode::SetStepAuthority, physicsServiceImplementation);
 }
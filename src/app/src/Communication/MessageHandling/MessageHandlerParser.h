@@ -4,7 +4,10 @@
 #include <iostream>
 #include <unordered_map>
 #include <memory>
+#include <cstdint>
+#include <string_view>
 #include "MessageHandlers/MessageHandlerBase.h"
+#include "../MessageFraming.h"
 
 /**
 * The message handler parser is responsible for handling the service's incoming
@@ -15,8 +18,12 @@
 * be used here to find the proper handler to the message. This class has a
 * map with the registered handlers. The proper handler should exist on the map
 * before handling the message.
+*
+* On the framed protocol, the handler type is given by the frame's opcode
+* instead. Thus, each handler is also registered by its opcode.
 * 
 * @see MessageHandlerBase
+* @see MessageFraming
 */
 class MessageHandlerParser final
 {
@@ -29,14 +36,43 @@ public:
     * message's first line and fint the proper handler on the registered
     * handlers. Then, will pass the message to the proper handler.
     * 
-    * @param message The incoming message to be handled
+    * @param message The incoming message to be handled. The message is not
+    * copied, so this may be a view on the receive buffer
+    * @param responseBuffer The buffer the response may be written into. 
+    * Responses already on a reusable buffer (e.g. the step response) are not
+    * copied into it
+    * @param clientConnectionSettings The settings negotiated by the client
+    * that sent the message. Handlers use it to format their response. May be
+    * null (e.g. for in-process messages), so the default settings are used
     * 
     * @return The message handler response to the message. This should be used
     * as the response to send the client once the given message has been 
     * processed (e.g. while steping physics will return the step physics
-    * response).
+    * response). The view is valid until the next message is handled
     */
-    std::string handleMessage(std::string& message);
+    std::string_view handleMessage(std::string_view message, 
+        std::string& responseBuffer,
+        ClientConnectionSettings* clientConnectionSettings = nullptr);
+
+    /**
+    * Handles a incoming framed message. This will find the proper handler by
+    * the frame's opcode and pass the frame's payload to it.
+    * 
+    * @param opcode The frame's opcode
+    * @param messagePayload The frame's payload. This is a view on the 
+    * receive buffer, so no copy is made
+    * @param responseBuffer The buffer the response may be written into
+    * @param clientConnectionSettings The settings negotiated by the client
+    * that sent the message
+    * 
+    * @return The message handler response to the message. The view is valid
+    * until the next message is handled
+    * 
+    * @see handleMessage
+    */
+    std::string_view handleFramedMessage(std::uint16_t opcode, 
+        std::string_view messagePayload, std::string& responseBuffer,
+        ClientConnectionSettings* clientConnectionSettings);
 
     /** 
     * Registers handlers on this parser. The handler will be store by the
@@ -44,16 +80,20 @@ public:
     * receiveing a message, the parser will find the proper registered handler
     * on by its type.
     * 
-    * @param handlerTypeStr The handler type to register. This should be the
-    * string on the first line on each message. This is the str we compare to
-    * find the proper handler to the message
+    * @param handlerOpcode The handler opcode to register. This is the opcode
+    * on the framed messages' header. The handler type (the string on the 
+    * first line on each message) is the opcode's message type (see 
+    * "MessageFraming::messageTypeOpcodes")
     * @param physicsServiceImplementation The physics service implementation
     * ptr. This will be used by the handlers to process the given message
     */
     template <typename T>
-    void registerHandler(const std::string& handlerTypeStr, 
+    void registerHandler(EMessageOpcode handlerOpcode,
         class PhysicsServiceImpl* physicsServiceImplementation) 
     {
+        const std::string handlerTypeStr 
+            { MessageFraming::FindOpcodeMessageType(handlerOpcode) };
+
         // Create a ptr to the message handler
         messageHandlersMap[handlerTypeStr] = std::make_unique<T>();
 
@@ -61,18 +101,33 @@ public:
         // implementation
         messageHandlersMap[handlerTypeStr]->initializeMessageHandler
             (physicsServiceImplementation);
+
+        // The opcode refers to the same handler
+        messageHandlersByOpcode[static_cast<std::uint16_t>(handlerOpcode)] = 
+            messageHandlersMap[handlerTypeStr].get();
     }
 
+    /** 
+    * Registers every message handler of the physics service on this parser
+    * (e.g. "Init", "Step" and "AddBody"), by their types and opcodes.
+    * 
+    * @param physicsServiceImplementation The physics service implementation
+    * ptr the handlers process the messages with
+    */
+    void registerPhysicsServiceHandlers
+        (class PhysicsServiceImpl* physicsServiceImplementation);
+
 private:
     /**
     * Extracts the handler type from the message. This will get the handler
-    * type from the message's first line and return it.
+    * type from the message's first line and return it, without the world ID
+    * that may follow it (e.g. "Step;2", see MessageFraming).
     * 
     * @param message The message to extract the handler type
     * 
     * @return The message's handler type
     */
-    std::string extractHandlerTypeFromMessage(const std::string& message);
+    std::string_view extractHandlerTypeFromMessage(std::string_view message);
 
 public:
     /** 
@@ -81,6 +136,13 @@ public:
     * "registerHandler()" method.
     */
     std::unordered_map<std::string, HandlerPtr> messageHandlersMap;
+
+    /** 
+    * The message handlers by opcode. This stores as key the handler opcode 
+    * and as value a ptr to the handler owned by "messageHandlersMap".
+    */
+    std::unordered_map<std::uint16_t, MessageHandlerBase*> 
+        messageHandlersByOpcode;
 };
 
 #endif
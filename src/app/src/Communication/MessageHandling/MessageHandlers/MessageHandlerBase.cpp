@@ -1,27 +1,148 @@
 #include "MessageHandlerBase.h"
+#include "../../../Serialization/TextRecordParser.h"
 
 
-std::string MessageHandlerBase::handleMessage(std::string& message)
+std::string_view MessageHandlerBase::handleMessage(std::string_view message,
+    std::string& responseBuffer)
 {
-    // Get the first and last line '\n' character position
+    // Get the first line '\n' character position. The first line is the 
+    // type of the handler
     const size_t firstLinePos = message.find('\n');
-    const size_t lastLinePos = message.rfind('\n');
-    const size_t secondLastLinePos = message.rfind('\n', lastLinePos - 1);
+    if(firstLinePos == std::string_view::npos)
+    {
+        return handleMessagePayloadAsView(std::string_view(), 
+            responseBuffer);
+    }
+
+    // Calculate the payload initial pos, starting from the second line
+    const size_t payloadInitialPos = firstLinePos + 1;
 
-    // Remove the first and last line. This is needed as the first line will
-    // be the type of the handler and the last will be "MessageEnd"
-    if(firstLinePos != std::string::npos && lastLinePos != std::string::npos)
+    // The payload ends on the '\n' before the "MessageEnd" flag (or on the
+    // message's end if there is no flag)
+    size_t payloadEndPos = message.rfind("MessageEnd");
+    if(payloadEndPos == std::string_view::npos 
+        || payloadEndPos < payloadInitialPos)
     {
-        // Calculate the substring initial pos, starting from the second line
-        const size_t substringInitialPos = firstLinePos + 1;
+        payloadEndPos = message.size();
+    }
+    else if(payloadEndPos > payloadInitialPos 
+        && message[payloadEndPos - 1] == '\n')
+    {
+        payloadEndPos--;
+    }
 
-        // Calculate the substring length, which will be the second last
-        // end pos minus de first line pos
-        const size_t substringLength = secondLastLinePos - firstLinePos - 1;
+    // Handle the message without the first and last line
+    return handleMessagePayloadAsView(message.substr(payloadInitialPos, 
+        payloadEndPos - payloadInitialPos), responseBuffer);
+}
+
+std::string_view MessageHandlerBase::handleMessagePayloadAsView
+    (std::string_view messagePayload, std::string& responseBuffer)
+{
+    // The response is moved into the buffer, so it is not copied
+    responseBuffer = handleMessagePayload(messagePayload);
+    return responseBuffer;
+}
+
+void MessageHandlerBase::splitPayloadIntoRecords
+    (std::string_view messagePayload, std::vector<std::string_view>& outRecords)
+{
+    outRecords.clear();
+
+    size_t recordStartPos = 0;
+    while(recordStartPos < messagePayload.size())
+    {
+        size_t recordEndPos = messagePayload.find('\n', recordStartPos);
+        if(recordEndPos == std::string_view::npos)
+        {
+            recordEndPos = messagePayload.size();
+        }
+
+        std::string_view record = messagePayload.substr(recordStartPos, 
+            recordEndPos - recordStartPos);
+
+        // Ignore the line's carriage return, if any
+        if(!record.empty() && record.back() == '\r')
+        {
+            record.remove_suffix(1);
+        }
+
+        if(!record.empty())
+        {
+            outRecords.push_back(record);
+        }
+
+        recordStartPos = recordEndPos + 1;
+    }
+}
+
+void MessageHandlerBase::splitRecordIntoFields(std::string_view record, 
+    std::vector<std::string_view>& outFields)
+{
+    TextRecordParser::SplitRecordIntoFields(record, outFields);
+}
+
+std::string MessageHandlerBase::parseOptionField
+    (std::string_view messagePayload, 
+    std::vector<std::string_view>* outOptionArguments)
+{
+    const std::string_view optionLine = TextRecordParser::TrimField
+        (messagePayload.substr(0, messagePayload.find('\n')));
+
+    std::vector<std::string_view> optionFields;
+    TextRecordParser::SplitRecordIntoFields(optionLine, optionFields);
+    if(optionFields.empty())
+    {
+        return std::string();
+    }
+
+    if(outOptionArguments)
+    {
+        outOptionArguments->assign(optionFields.begin() + 1, 
+            optionFields.end());
+    }
+    else if(optionFields.size() > 1)
+    {
+        return std::string(optionLine);
+    }
+
+    return std::string(optionFields[0]);
+}
+
+bool MessageHandlerBase::parseIntegerField(std::string_view field, 
+    int& outValue)
+{
+    return TextRecordParser::ParseNumberField(field, outValue);
+}
+
+bool MessageHandlerBase::parseDecimalField(std::string_view field, 
+    double& outValue)
+{
+    return TextRecordParser::ParseNumberField(field, outValue);
+}
+
+std::string MessageHandlerBase::buildRecordStatusesResponse
+    (const std::vector<std::string>& recordErrors)
+{
+    std::string recordStatusesResponse;
+
+    for(size_t i = 0; i < recordErrors.size(); i++)
+    {
+        if(i > 0)
+        {
+            recordStatusesResponse += '\n';
+        }
 
-        // Set the message with the substring without the first and last line
-        message = message.substr(substringInitialPos, substringLength);
+        if(recordErrors[i].empty())
+        {
+            recordStatusesResponse += "ok";
+        }
+        else
+        {
+            recordStatusesResponse += "error;";
+            recordStatusesResponse += recordErrors[i];
+        }
     }
 
-    return "";
+    return recordStatusesResponse;
 }
@@ -2,6 +2,10 @@
 #define MESSAGEHANDLERBASE_H
 
 #include <iostream>
+#include <string_view>
+#include <vector>
+#include "../../ClientConnectionSettings.h"
+#include "../../../Logging/ServiceLogger.h"
 
 /** 
 * The messge handler base. This is the base for every message handler 
@@ -28,18 +32,139 @@ public:
     }
 
     /** 
-    * Handles the incoming message. This should be overwritten for each message
-    * handler with the proper functionality. However, this base class processes
-    * the incoming message to remove the message's first and last line. This is
-    * needed as the first line will be the handler type and the last the flag
-    * "MessageEnd". Thus, they are unecessary to the message handler processing.
+    * Sets the connection settings of the client that sent the message being
+    * handled. The parser sets this before delegating each message, so the
+    * handler can answer according to what the client has negotiated.
+    * 
+    * @param inClientConnectionSettings The settings of the client connection.
+    * May be null, in which case the default settings should be used
+    */
+    void setClientConnectionSettings
+        (ClientConnectionSettings* inClientConnectionSettings)
+    {
+        clientConnectionSettings = inClientConnectionSettings;
+    }
+
+    /** 
+    * Handles an incoming delimited message. This processes the incoming 
+    * message to remove the message's first and last line, and passes the
+    * remaining payload to "handleMessagePayload()". This is needed as the 
+    * first line will be the handler type and the last the flag "MessageEnd".
+    * Thus, they are unecessary to the message handler processing. 
+    * 
+    * The payload is a view on the given message, so no copy is made.
     * 
     * @param message The incoming message to handle
+    * @param responseBuffer The buffer the response may be written into (see
+    * "handleMessagePayloadAsView()")
+    * 
+    * @return The handler response to the message processing. This most likely
+    * will be a response from the physics service implementation
+    */
+    std::string_view handleMessage(std::string_view message, 
+        std::string& responseBuffer);
+
+    /** 
+    * Handles the incoming message's payload. This should be overwritten for 
+    * each message handler with the proper functionality. The payload is the
+    * message without the handler type and the "MessageEnd" flag. Thus, this
+    * is the same for delimited and framed messages.
+    * 
+    * @param messagePayload The incoming message's payload. This is a view
+    * on the receive buffer, valid only during this call
     * 
     * @return The handler response to the message processing. This most likely
     * will be a response from the physics service implementation
     */
-    virtual std::string handleMessage(std::string& message);
+    virtual std::string handleMessagePayload
+        (std::string_view messagePayload) = 0;
+
+    /** 
+    * Handles the incoming message's payload, giving a view on the response
+    * instead of the response itself. By default, the response of 
+    * "handleMessagePayload()" is moved into the given buffer. Handlers whose
+    * response is already on a reusable buffer (e.g. the step response) 
+    * override this, so the response is not copied before it is sent.
+    * 
+    * @param messagePayload The incoming message's payload
+    * @param responseBuffer The buffer the response may be written into
+    * 
+    * @return The handler response to the message processing. This is a view
+    * valid until the next message is handled (or the buffer changes)
+    */
+    virtual std::string_view handleMessagePayloadAsView
+        (std::string_view messagePayload, std::string& responseBuffer);
+
+protected:
+    /** 
+    * Splits a message payload into its records (i.e. its lines). Empty lines
+    * are skipped, so the n-th record is the n-th non empty line. The records
+    * are views on the payload, so no copy is made.
+    * 
+    * @param messagePayload The message payload to split
+    * @param outRecords The payload's records
+    */
+    static void splitPayloadIntoRecords(std::string_view messagePayload, 
+        std::vector<std::string_view>& outRecords);
+
+    /** 
+    * Splits a record into its ";" separated fields. The blanks around each 
+    * field are trimmed (see "TextRecordParser").
+    * 
+    * @param record The record to split
+    * @param outFields The record's fields. Views on the record
+    */
+    static void splitRecordIntoFields(std::string_view record, 
+        std::vector<std::string_view>& outFields);
+
+    /** 
+    * Parses the option of a negotiation message (e.g. "framed" on 
+    * "SetMessageFraming"), which is the first field of the payload's first
+    * line. The blanks around the fields are trimmed.
+    * 
+    * @param messagePayload The message payload
+    * @param outOptionArguments The fields after the option, if the option
+    * takes any. If null, the option must be the line's only field
+    * 
+    * @return The option, or empty if the payload has none. If the line has
+    * fields that were not asked for, the whole line is returned, so it 
+    * matches no option
+    */
+    static std::string parseOptionField(std::string_view messagePayload,
+        std::vector<std::string_view>* outOptionArguments = nullptr);
+
+    /** 
+    * Parses an integer field. The blanks around the value are ignored.
+    * 
+    * @param field The field to parse
+    * @param outValue The parsed value
+    * 
+    * @return True if the whole field is a valid integer and false otherwise
+    */
+    static bool parseIntegerField(std::string_view field, int& outValue);
+
+    /** 
+    * Parses a decimal field. The blanks around the value are ignored.
+    * 
+    * @param field The field to parse
+    * @param outValue The parsed value
+    * 
+    * @return True if the whole field is a valid decimal and false otherwise
+    */
+    static bool parseDecimalField(std::string_view field, double& outValue);
+
+    /** 
+    * Builds the response of a multi-record message. The response has a 
+    * status line per record, on the same order as the records: "ok" if the
+    * record was applied, or "error;reason" otherwise.
+    * 
+    * @param recordErrors The error of each record. Empty if the record was
+    * applied
+    * 
+    * @return The multi-record message response
+    */
+    static std::string buildRecordStatusesResponse
+        (const std::vector<std::string>& recordErrors);
 
 protected:
     /** 
@@ -47,6 +172,13 @@ protected:
     * methods on the physics service according to the handler.
     */
     class PhysicsServiceImpl* physicsServiceImplementation = nullptr;
+
+    /** 
+    * The connection settings of the client that sent the message currently
+    * being handled. May be null if the message did not come from a client
+    * connection.
+    */
+    ClientConnectionSettings* clientConnectionSettings = nullptr;
 };
 
 #endif
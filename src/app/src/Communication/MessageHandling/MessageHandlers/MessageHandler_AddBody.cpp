@@ -5,108 +5,131 @@
 * Message template:
 *
 * "AddBody\n
-* actorType; id_0; bodyType; posX_0; posY_0; posZ_0\n
+* actorType; id_0; bodyType; posX_0; posY_0; posZ_0; linVelX_0; linVelY_0; 
+* linVelZ_0; angVelX_0; angVelY_0; angVelZ_0\n
+* actorType; id_1; bodyType; posX_1; posY_1; posZ_1; linVelX_1; linVelY_1; 
+* linVelZ_1; angVelX_1; angVelY_1; angVelZ_1\n
+* ...
 * MessageEnd\n"
 *
 */
-std::string MessageHandler_AddBody::handleMessage
-    (std::string& message)
+std::string MessageHandler_AddBody::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "New sphere body addition requested. Processing...\n";
-
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    LOG_DEBUG(Messages, "New body addition requested. Processing...");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to add new sphere"
-            "body.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to add "
+            "new bodies.");
 
-        return "Error: Could not create sphere as physics service "
+        return "Error: Could not create bodies as physics service "
             "implementation is null.";
     }
 
-	// Split info with ";" delimiter
-	std::stringstream newSphereBodyDataStream(message);
-	std::vector<std::string> newSphereBodyParsedData;
-
-	std::string line {};
-	while (std::getline(newSphereBodyDataStream, line, ';')) 
-	{
-		newSphereBodyParsedData.push_back(line);
-	}
-
-    // Check for errors
-    if (newSphereBodyParsedData.size() < 12)
+    if(!physicsServiceImplementation->IsInitialized())
     {
-        std::cout << "Error on parsing addBody message info. Line with less "
-            "than 12 params: " << message << '\n';
-        return "Error on parsing addBody message info. Line with less "
-            "than 12 params.";
+        LOG_WARNING(Messages, "Could not add new bodies, as the physics "
+            "system is not initialized.");
+
+        return "Error: The physics system is not initialized.";
     }
 
-    // Get the new sphere body's ID
-	const int newSphereId { std::stoi(newSphereBodyParsedData[1]) };
+    // Get every record (i.e. body to add) on the message
+    std::vector<std::string_view> bodyRecords;
+    splitPayloadIntoRecords(messagePayload, bodyRecords);
 
-    // Create data for sphere creation
-    const BodyID newSphereBodyID(newSphereId);
+    std::vector<std::string> recordErrors(bodyRecords.size());
 
-    // Get the new body type
-	const std::string newSphereBodyTypeAsString
-        { newSphereBodyParsedData[2] };
-    // Set the new body type
-    EBodyType newBodyType{};
-    if (newSphereBodyTypeAsString == "primary")
-    {
-        newBodyType = EBodyType::Primary;
-    }
-    else if (newSphereBodyTypeAsString == "clone")
+    // The info of the bodies to add and the record each one came from
+    std::vector<BodyCreationInfo> bodiesCreationInfo;
+    std::vector<size_t> bodiesRecordIndex;
+    bodiesCreationInfo.reserve(bodyRecords.size());
+    bodiesRecordIndex.reserve(bodyRecords.size());
+
+    std::vector<std::string_view> recordFields;
+    for(size_t i = 0; i < bodyRecords.size(); i++)
     {
-        newBodyType = EBodyType::Clone;
+        // Split info with ";" delimiter
+        splitRecordIntoFields(bodyRecords[i], recordFields);
+
+        // Check for errors
+        if (recordFields.size() < 12)
+        {
+            LOG_WARNING(Messages, "Error on parsing addBody message info. "
+                "Line with less than 12 params: %.*s",
+                ServiceLogger::ClampTextLength(bodyRecords[i].size()), 
+                bodyRecords[i].data());
+            recordErrors[i] = "Line with less than 12 params.";
+            continue;
+        }
+
+        BodyCreationInfo bodyCreationInfo;
+
+        // The actor type only tells floors apart, any other actor is a 
+        // sphere body
+        bodyCreationInfo.shapeType = 
+            recordFields[0].find("floor") != std::string_view::npos? 
+            EBodyShapeType::Floor : EBodyShapeType::Sphere;
+
+        // Get the new body's ID
+        int newBodyId = 0;
+        if(!parseIntegerField(recordFields[1], newBodyId))
+        {
+            recordErrors[i] = "Invalid body ID.";
+            continue;
+        }
+        bodyCreationInfo.bodyId = BodyID(newBodyId);
+
+        // Get the new body type
+        if(!BodyRuntimeData::ParseBodyType(recordFields[2], 
+            bodyCreationInfo.bodyType))
+        {
+            LOG_WARNING(Messages, "Unknown body type: %.*s",
+                static_cast<int>(recordFields[2].size()), 
+                recordFields[2].data());
+            recordErrors[i] = "Unknown body type.";
+            continue;
+        }
+
+        // Get the new body's position, linear velocity and angular velocity
+        double vectorComponents[9] {};
+        bool bAreVectorsValid = true;
+        for(size_t component = 0; component < 9; component++)
+        {
+            bAreVectorsValid = bAreVectorsValid && parseDecimalField
+                (recordFields[3 + component], vectorComponents[component]);
+        }
+
+        if(!bAreVectorsValid)
+        {
+            recordErrors[i] = "Invalid position or velocity.";
+            continue;
+        }
+
+        bodyCreationInfo.initialPosition = RVec3(vectorComponents[0], 
+            vectorComponents[1], vectorComponents[2]);
+        bodyCreationInfo.initialLinearVelocity = RVec3(vectorComponents[3], 
+            vectorComponents[4], vectorComponents[5]);
+        bodyCreationInfo.initialAngularVelocity = RVec3(vectorComponents[6], 
+            vectorComponents[7], vectorComponents[8]);
+
+        bodiesCreationInfo.push_back(bodyCreationInfo);
+        bodiesRecordIndex.push_back(i);
     }
-    else
+
+    // Request the creation of every valid body as a single batch
+    std::vector<std::string> bodiesErrors;
+    const size_t addedBodiesCount = 
+        physicsServiceImplementation->AddNewBodiesToPhysicsWorld
+        (bodiesCreationInfo, &bodiesErrors);
+
+    for(size_t i = 0; i < bodiesErrors.size(); i++)
     {
-        std::cout << "Unknown body type: " << newSphereBodyTypeAsString << '\n';
+        recordErrors[bodiesRecordIndex[i]] = std::move(bodiesErrors[i]);
     }
 
-    // Get the new sphere body's position
-	const double initialPosX { std::stod(newSphereBodyParsedData[3]) };
-	const double initialPosY { std::stod(newSphereBodyParsedData[4]) };
-	const double initialPosZ { std::stod(newSphereBodyParsedData[5]) };
-
-    // Create the new sphere initial pos
-    const RVec3 newSphereInitialPos(initialPosX, initialPosY, initialPosZ);
-
-    // Get the new sphere body's linear velocity
-	const double initalLinearVelocityX 
-        { std::stod(newSphereBodyParsedData[6]) };
-	const double initalLinearVelocityY 
-        { std::stod(newSphereBodyParsedData[7]) };
-	const double initalLinearVelocityZ 
-        { std::stod(newSphereBodyParsedData[8]) };
-
-    // Create the new sphere linear velocity
-    const RVec3 newSphereLinearVelocty(initalLinearVelocityX, 
-        initalLinearVelocityY, initalLinearVelocityZ);
-    
-    // Get the new sphere body's linear velocity
-	const double initalAngularVelocityX 
-        { std::stod(newSphereBodyParsedData[9]) };
-	const double initalAngularVelocityY 
-        { std::stod(newSphereBodyParsedData[10]) };
-	const double initalAngularVelocityZ 
-        { std::stod(newSphereBodyParsedData[11]) };
-
-    // Create the new sphere linear velocity
-    const RVec3 newSphereAngularVelocity(initalAngularVelocityX, 
-        initalAngularVelocityY, initalAngularVelocityZ);
-
-    // Request the creation of sphere
-    std::string additionReturn = 
-        physicsServiceImplementation->AddNewSphereToPhysicsWorld
-        (newSphereBodyID, newBodyType, newSphereInitialPos, 
-        newSphereLinearVelocty, newSphereAngularVelocity);
-
-    std::cout << additionReturn << "\n\n";
-    return additionReturn;
+    LOG_DEBUG(Messages, "Added %zu of %zu requested bodies.", addedBodiesCount,
+        bodyRecords.size());
+    return buildRecordStatusesResponse(recordErrors);
 }
@@ -4,28 +4,31 @@
 #include "MessageHandlerBase.h"
 
 /** 
-* The add body message handler. Will add a body according to the given data on
-* the physics system.
+* The add body message handler. Will add the bodies according to the given 
+* data on the physics system. Every body on the message is added as a single
+* batch.
 */
 class MessageHandler_AddBody : public MessageHandlerBase
 {
 public:
     /** 
-    * Adds a new sphere body to the physics system.
+    * Adds new bodies to the physics system, one per line.
     * The message template should be:
     * 
     * "AddBody\n
-    * actorType; id_0; bodyType; posX_0; posY_0; posZ_0\n
+    * actorType; id_0; bodyType; posX_0; posY_0; posZ_0; linVelX_0; 
+    * linVelY_0; linVelZ_0; angVelX_0; angVelY_0; angVelZ_0\n
+    * ...
     * MessageEnd\n"
     * 
-    * @param message The received message from the client with the info to 
-    * create a new sphere body
+    * @param messagePayload The received message from the client with the info to 
+    * create the new bodies
     * 
-    * @return The result of adding a new sphere body. May return a failure 
-    * message if could not successfully add the new sphere body on the physics 
-    * system
+    * @return A status line per body, on the same order as the message lines:
+    * "ok" if the body was added or "error;reason" otherwise
     */
-    std::string handleMessage(std::string& message) override;
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
 };
 
 #endif
\ No newline at end of file
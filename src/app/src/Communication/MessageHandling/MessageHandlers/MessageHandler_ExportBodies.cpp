@@ -0,0 +1,101 @@
+#include "MessageHandler_ExportBodies.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+#include "../../../Serialization/Base64.h"
+
+/* 
+* Message template:
+*
+* "ExportBodies\n
+* remove\n (optional)
+* id_0\n
+* id_1\n
+* ...
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_ExportBodies::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Export bodies requested. Processing...");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "export bodies.");
+
+        return "Error: Could not export bodies as physics service "
+            "implementation is null.";
+    }
+
+    std::vector<std::string_view> records;
+    splitPayloadIntoRecords(messagePayload, records);
+
+    std::vector<BodyID> bodyIdsToExport;
+    bodyIdsToExport.reserve(records.size());
+    bool bRemoveExportedBodies = false;
+
+    std::vector<std::string_view> recordFields;
+    for(const std::string_view record : records)
+    {
+        splitRecordIntoFields(record, recordFields);
+        if(recordFields.empty())
+        {
+            continue;
+        }
+
+        if(recordFields[0] == "remove")
+        {
+            bRemoveExportedBodies = true;
+            continue;
+        }
+
+        int bodyIdToExportAsInt = 0;
+        if(!parseIntegerField(recordFields[0], bodyIdToExportAsInt))
+        {
+            const std::string invalidBodyId {recordFields[0]};
+            LOG_WARNING(Messages, "Invalid body ID to export: %s", 
+                invalidBodyId.c_str());
+
+            return "Error: Invalid body ID to export: " + invalidBodyId;
+        }
+
+        bodyIdsToExport.push_back(BodyID(bodyIdToExportAsInt));
+    }
+
+    std::string blob;
+    std::string exportError;
+    if(!physicsServiceImplementation->ExportBodies(bodyIdsToExport, 
+        bRemoveExportedBodies, blob, exportError))
+    {
+        LOG_WARNING(Messages, "Could not export bodies: %s", 
+            exportError.c_str());
+
+        return "Error: Could not export bodies: " + exportError;
+    }
+
+    LOG_DEBUG(Messages, "Exported %zu bodies.", bodyIdsToExport.size());
+
+    // The framed responses carry their length, so the blob is sent as it is
+    if(clientConnectionSettings && clientConnectionSettings->messageFraming
+        == EMessageFraming::Framed)
+    {
+        return blob;
+    }
+
+    std::string encodedBlob;
+    Base64::Append(encodedBlob, blob);
+
+    // The delimited messages end on the first "MessageEnd", which base64 
+    // text may hold by chance. It is broken with a line break, which the
+    // decoder skips, so the blob can be sent back on "ImportBodies" as it is
+    const std::string_view messageEndFlag = "MessageEnd";
+    size_t messageEndFlagPos = encodedBlob.find(messageEndFlag);
+    while(messageEndFlagPos != std::string::npos)
+    {
+        encodedBlob.insert(messageEndFlagPos + 1, 1, '\n');
+        messageEndFlagPos = encodedBlob.find(messageEndFlag, 
+            messageEndFlagPos + 2);
+    }
+
+    return encodedBlob;
+}
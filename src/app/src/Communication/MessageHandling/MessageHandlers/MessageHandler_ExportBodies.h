@@ -0,0 +1,46 @@
+#ifndef MESSAGEHANDLER_EXPORTBODIES_H
+#define MESSAGEHANDLER_EXPORTBODIES_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The export bodies message handler. Will export bodies into a body 
+* migration blob, with each body's exact Jolt state (velocities, sleep 
+* state...) and runtime data, so they can be handed off to another service
+* through "ImportBodies".
+*
+* On framed connections, the blob is the response's payload as it is. On
+* delimited connections, it is sent as base64 text, as a binary response 
+* could hold the "MessageEnd" line.
+*
+* @see PhysicsServiceImpl::ExportBodies
+* @see BodyMigrationBlob
+*/
+class MessageHandler_ExportBodies : public MessageHandlerBase
+{
+public:
+    /** 
+    * Exports bodies into a body migration blob.
+    * The message template should be:
+    * 
+    * "ExportBodies\n
+    * remove\n (optional)
+    * id_0\n
+    * id_1\n
+    * ...
+    * MessageEnd\n"
+    * 
+    * Where "remove" removes the bodies from the physics world once they are
+    * exported, as on a handoff.
+    * 
+    * @param messagePayload The received message from the client with the 
+    * IDs of the bodies to export
+    * 
+    * @return The body migration blob. May return a failure message if any
+    * body is not on the physics world, in which case no body is exported
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "MessageHandler_GetPhaseProfile.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "GetPhaseProfile\n
+* options\n (optional)
+* MessageEnd\n"
+*
+* Where options may be "reset".
+*
+*/
+std::string MessageHandler_GetPhaseProfile::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Get phase profile requested.");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to get "
+            "the phase profile.");
+
+        return "No physics service implementation valid to get the phase "
+            "profile.";
+    }
+
+    std::vector<std::string_view> records;
+    std::vector<std::string_view> options;
+    splitPayloadIntoRecords(messagePayload, records);
+
+    bool bResetOnRead = false;
+
+    for(const std::string_view record : records)
+    {
+        splitRecordIntoFields(record, options);
+
+        for(const std::string_view option : options)
+        {
+            if(option == "reset")
+            {
+                bResetOnRead = true;
+            }
+            else if(!option.empty())
+            {
+                const std::string unknownOption {option};
+                LOG_WARNING(Messages, "Unknown phase profile option: %s",
+                    unknownOption.c_str());
+
+                return "Error: Unknown phase profile option: " 
+                    + unknownOption;
+            }
+        }
+    }
+
+    std::string phaseProfile = 
+        physicsServiceImplementation->GetPhaseProfile(bResetOnRead); 
+
+    LOG_DEBUG(Messages, "Gotten phase profile.");
+    LOG_DEBUG(Messages, "%s", phaseProfile.c_str());
+    return phaseProfile;
+}
@@ -0,0 +1,38 @@
+#ifndef MESSAGEHANDLER_GETPHASEPROFILE_H
+#define MESSAGEHANDLER_GETPHASEPROFILE_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The get phase profile message handler. Will return the time of each phase
+* of the physics update (broad phase, narrow phase, island building, 
+* constraint solving, integration...) and the broad phase's query stats.
+* They are only measured on the phase profiling build.
+*
+* @see PhysicsServiceImpl::GetPhaseProfile
+*/
+class MessageHandler_GetPhaseProfile : public MessageHandlerBase
+{
+public:
+    /** 
+    * Gets the phase profile.
+    * The message template should be:
+    * 
+    * "GetPhaseProfile\n
+    * options\n (optional)
+    * MessageEnd\n"
+    * 
+    * Where options may be "reset", to reset the phase times once they are
+    * read.
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested options
+    * 
+    * @return The phase profile, a "name;value" line per measure followed by
+    * a line per phase. May return a failure message if an option is unknown
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -5,31 +5,71 @@
 * Message template:
 *
 * "GetSimulationMeasures\n
+* options\n (optional)
 * MessageEnd\n"
 *
+* Where options is a ";" separated list of "reset" and "samples".
+*
 */
-std::string MessageHandler_GetSimulationMeasures::handleMessage
-    (std::string& message)
+std::string MessageHandler_GetSimulationMeasures::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "Get simulation measures requested.\n";
-
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    LOG_DEBUG(Messages, "Get simulation measures requested.");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to get "
-            "simulation measures.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to get "
+            "simulation measures.");
 
         return "No physics service implementation valid to get "
             "simulation measures.";
     }
 
-    // Initialize the physics system with the given info
-    std::string simulationMeasures = 
-        physicsServiceImplementation->GetSimulationMeasures(); 
+    if(!physicsServiceImplementation->IsInitialized())
+    {
+        LOG_WARNING(Messages, "Could not get simulation measures, as the "
+            "physics system is not initialized.");
+
+        return "Error: The physics system is not initialized.";
+    }
+
+    std::vector<std::string_view> records;
+    std::vector<std::string_view> options;
+    splitPayloadIntoRecords(messagePayload, records);
+
+    bool bResetOnRead = false;
+    bool bIncludeRecentSamples = false;
+
+    for(const std::string_view record : records)
+    {
+        splitRecordIntoFields(record, options);
+
+        for(const std::string_view option : options)
+        {
+            if(option == "reset")
+            {
+                bResetOnRead = true;
+            }
+            else if(option == "samples")
+            {
+                bIncludeRecentSamples = true;
+            }
+            else if(!option.empty())
+            {
+                const std::string unknownOption {option};
+                LOG_WARNING(Messages, "Unknown simulation measures option: %s",
+                    unknownOption.c_str());
+
+                return "Error: Unknown simulation measures option: " 
+                    + unknownOption;
+            }
+        }
+    }
+
+    std::string simulationMeasures = physicsServiceImplementation->
+        GetSimulationMeasures(bResetOnRead, bIncludeRecentSamples); 
 
-    std::cout << "Gotten simulation measures.\n\n";
-    std::cout << simulationMeasures << "\n\n";
+    LOG_DEBUG(Messages, "Gotten simulation measures.");
+    LOG_DEBUG(Messages, "%s", simulationMeasures.c_str());
     return simulationMeasures;
 }
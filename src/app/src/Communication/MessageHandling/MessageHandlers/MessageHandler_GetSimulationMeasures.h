@@ -4,15 +4,36 @@
 #include "MessageHandlerBase.h"
 
 /**
- * 
+* The get simulation measures message handler. Will return the step time 
+* percentiles (p50, p90, p99, p999), max, mean and count since the 
+* initialization or the last reset, along with the temp allocator and job 
+* system stats.
+*
+* @see PhysicsServiceImpl::GetSimulationMeasures
 */
 class MessageHandler_GetSimulationMeasures : public MessageHandlerBase
 {
 public:
     /** 
-    *
+    * Gets the simulation measures.
+    * The message template should be:
+    * 
+    * "GetSimulationMeasures\n
+    * options\n (optional)
+    * MessageEnd\n"
+    * 
+    * Where options is a ";" separated list of:
+    * - "reset": Resets the measures once they are read
+    * - "samples": Includes the measures of the most recent steps
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested options
+    * 
+    * @return The simulation measures, a "name;value" line per measure. May
+    * return a failure message if an option is unknown
     */
-    std::string handleMessage(std::string& message) override;
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
 };
 
-#endif
\ No newline at end of file
+#endif
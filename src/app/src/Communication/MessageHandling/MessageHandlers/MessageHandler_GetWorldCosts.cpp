@@ -0,0 +1,43 @@
+#include "MessageHandler_GetWorldCosts.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+#include "../../../PhysicsSimulation/PhysicsWorldHost.h"
+
+/* 
+* Message template:
+*
+* "GetWorldCosts\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_GetWorldCosts::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Get world costs requested.");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to get "
+            "the world costs.");
+
+        return "No physics service implementation valid to get the world "
+            "costs.";
+    }
+
+    // Worlds handled without a host (e.g. by the benchmark) have no costs
+    // to compare
+    const PhysicsWorldHost* worldHost = 
+        physicsServiceImplementation->GetWorldHost();
+    if(!worldHost)
+    {
+        LOG_WARNING(Messages, "The physics world is not hosted, so it has no "
+            "world costs.");
+
+        return "Error: The physics world is not hosted by a world host.";
+    }
+
+    std::string worldCosts = worldHost->GetWorldCostsReport();
+
+    LOG_DEBUG(Messages, "Gotten world costs.");
+    LOG_DEBUG(Messages, "%s", worldCosts.c_str());
+    return worldCosts;
+}
@@ -0,0 +1,35 @@
+#ifndef MESSAGEHANDLER_GETWORLDCOSTS_H
+#define MESSAGEHANDLER_GETWORLDCOSTS_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The get world costs message handler. Will return the resources taken by
+* each physics world hosted by the service (bodies, step time and its share
+* of every world's step time, temp allocator peak and memory footprint), and
+* the totals of the job system and temp allocators they share. It may be 
+* sent to any world, as every world is reported.
+*
+* @see PhysicsWorldHost::GetWorldCostsReport
+*/
+class MessageHandler_GetWorldCosts : public MessageHandlerBase
+{
+public:
+    /** 
+    * Gets the world costs.
+    * The message template should be:
+    * 
+    * "GetWorldCosts\n
+    * MessageEnd\n"
+    * 
+    * @param messagePayload The received message from the client (empty)
+    * 
+    * @return The world costs, "name;value" lines of the shared resources 
+    * followed by a line per world. May return a failure message if the 
+    * physics world is not hosted
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
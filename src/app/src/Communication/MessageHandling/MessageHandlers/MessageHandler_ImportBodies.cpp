@@ -0,0 +1,63 @@
+#include "MessageHandler_ImportBodies.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+#include "../../../Serialization/Base64.h"
+
+/* 
+* Message template:
+*
+* "ImportBodies\n
+* blob\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_ImportBodies::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Import bodies requested. Processing...");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "import bodies.");
+
+        return "Error: Could not import bodies as physics service "
+            "implementation is null.";
+    }
+
+    // The framed messages carry the blob as it is, and the delimited ones
+    // as base64 text
+    std::string decodedBlob;
+    std::string_view blob = messagePayload;
+    if(!clientConnectionSettings || clientConnectionSettings->messageFraming
+        != EMessageFraming::Framed)
+    {
+        if(!Base64::Decode(messagePayload, decodedBlob))
+        {
+            LOG_WARNING(Messages, "Could not import bodies: the blob is not "
+                "valid base64.");
+
+            return "Error: Could not import bodies: the blob is not valid "
+                "base64.";
+        }
+
+        blob = decodedBlob;
+    }
+
+    std::vector<std::string> bodiesErrors;
+    std::string importError;
+    const size_t importedBodiesCount = physicsServiceImplementation
+        ->ImportBodies(blob, bodiesErrors, importError);
+
+    if(!importError.empty())
+    {
+        LOG_WARNING(Messages, "Could not import bodies: %s", 
+            importError.c_str());
+
+        return "Error: Could not import bodies: " + importError;
+    }
+
+    LOG_DEBUG(Messages, "Imported %zu of %zu bodies.", importedBodiesCount,
+        bodiesErrors.size());
+
+    return buildRecordStatusesResponse(bodiesErrors);
+}
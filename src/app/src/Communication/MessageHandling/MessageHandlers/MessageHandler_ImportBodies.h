@@ -0,0 +1,40 @@
+#ifndef MESSAGEHANDLER_IMPORTBODIES_H
+#define MESSAGEHANDLER_IMPORTBODIES_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The import bodies message handler. Will add the bodies of a body migration
+* blob (see "ExportBodies") to the physics world, each with its exported 
+* Jolt state and runtime data.
+*
+* On framed connections, the blob is the message's payload as it is. On
+* delimited connections, it is sent as base64 text.
+*
+* @see PhysicsServiceImpl::ImportBodies
+* @see BodyMigrationBlob
+*/
+class MessageHandler_ImportBodies : public MessageHandlerBase
+{
+public:
+    /** 
+    * Imports the bodies of a body migration blob.
+    * The message template should be:
+    * 
+    * "ImportBodies\n
+    * blob\n
+    * MessageEnd\n"
+    * 
+    * @param messagePayload The received message from the client with the
+    * body migration blob
+    * 
+    * @return A status line per body on the blob, on the blob's order: "ok"
+    * or "error;reason" (see "buildRecordStatusesResponse()"). May return a
+    * failure message if the blob is not valid, in which case no body is 
+    * imported
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
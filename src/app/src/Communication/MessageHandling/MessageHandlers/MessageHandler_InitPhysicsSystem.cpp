@@ -12,26 +12,24 @@
 * MessageEnd\n"
 *
 */
-std::string MessageHandler_InitPhysicsSystem::handleMessage
-    (std::string& message)
+std::string MessageHandler_InitPhysicsSystem::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "Initialize physics system requested.\n";
-
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    LOG_DEBUG(Messages, "Initialize physics system requested.");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to init physics "
-            "system.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to init "
+            "physics system.");
 
         return "No physics service implementation valid to init physics "
             "system.";
     }
 
     // Initialize the physics system with the given info
-    physicsServiceImplementation->InitPhysicsSystem(message); 
+    std::string initializationReport = 
+        physicsServiceImplementation->InitPhysicsSystem(messagePayload); 
 
-    std::cout << "Physics system initialized.\n\n";
-    return "Physics system initialized.";
+    LOG_INFO(Messages, "%s", initializationReport.c_str());
+    return initializationReport;
 }
@@ -22,13 +22,14 @@ public:
     * ...
     * MessageEnd"
     * 
-    * @param message The received message from the client with the physics
+    * @param messagePayload The received message from the client with the physics
     * system initialization system
     * 
     * @return The result of initializing the physics system. May return an
     * error
     */
-    std::string handleMessage(std::string& message) override;
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "MessageHandler_LoadSnapshot.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "LoadSnapshot\n
+* snapshotName\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_LoadSnapshot::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Load snapshot requested.");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "load a snapshot.");
+
+        return "Error: No physics service implementation valid to load a "
+            "snapshot.";
+    }
+
+    // Get the snapshot's name (ignoring any trailing '\r' or spaces)
+    const std::string_view snapshotName =
+        messagePayload.substr(0, messagePayload.find_first_of("\r\n "));
+
+    std::string loadReport =
+        physicsServiceImplementation->LoadSnapshot(snapshotName);
+
+    LOG_INFO(Messages, "%s", loadReport.c_str());
+    return loadReport;
+}
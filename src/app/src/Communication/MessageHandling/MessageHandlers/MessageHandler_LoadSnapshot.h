@@ -0,0 +1,38 @@
+#ifndef MESSAGEHANDLER_LOADSNAPSHOT_H
+#define MESSAGEHANDLER_LOADSNAPSHOT_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The load snapshot message handler. Will replace the physics system with
+* the world saved on a snapshot file (see "SaveSnapshot"), with its
+* velocities, sleep states and step counter.
+*
+* @see PhysicsServiceImpl::LoadSnapshot
+*/
+class MessageHandler_LoadSnapshot : public MessageHandlerBase
+{
+public:
+    /** 
+    * Replaces the physics system with a saved snapshot.
+    * The message template should be:
+    * 
+    * "LoadSnapshot\n
+    * snapshotName\n
+    * MessageEnd\n"
+    * 
+    * Where snapshotName is the snapshot's file name on the service's
+    * snapshot directory (letters, digits, '.', '_' and '-').
+    * 
+    * @param messagePayload The received message from the client with the
+    * name of the snapshot to load
+    * 
+    * @return The load report. May return a failure message if the
+    * snapshot does not exist or is invalid, in which case the current
+    * physics system is kept
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -5,39 +5,76 @@
 * Message template:
 *
 * "RemoveBody\n
-* id\n
+* id_0\n
+* id_1\n
+* ...
 * MessageEnd\n"
 *
 */
-std::string MessageHandler_RemoveBody::handleMessage
-    (std::string& message)
+std::string MessageHandler_RemoveBody::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "Remove body requested. Processing...\n";
-
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    LOG_DEBUG(Messages, "Remove body requested. Processing...");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to remove "
-            "body.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "remove body.");
 
         return "Error: Could not remove body as physics service implementation "
             "is null.";
     }
 
-    // Get the requested body's ID for removal
-	const int bodyIdToRemoveAsInt = std::stoi(message);
+    if(!physicsServiceImplementation->IsInitialized())
+    {
+        LOG_WARNING(Messages, "Could not remove bodies, as the physics "
+            "system is not initialized.");
+
+        return "Error: The physics system is not initialized.";
+    }
+
+    // Get every record (i.e. body to remove) on the message
+    std::vector<std::string_view> bodyRecords;
+    splitPayloadIntoRecords(messagePayload, bodyRecords);
+
+    std::vector<std::string> recordErrors(bodyRecords.size());
+
+    // The bodies to remove and the record each one came from
+    std::vector<BodyID> bodiesToRemoveIDs;
+    std::vector<size_t> bodiesRecordIndex;
+    bodiesToRemoveIDs.reserve(bodyRecords.size());
+    bodiesRecordIndex.reserve(bodyRecords.size());
 
-    // Convert the id into BodyId
-    const BodyID bodyIdToRemove(bodyIdToRemoveAsInt);
+    std::vector<std::string_view> recordFields;
+    for(size_t i = 0; i < bodyRecords.size(); i++)
+    {
+        splitRecordIntoFields(bodyRecords[i], recordFields);
+
+        // Get the requested body's ID for removal
+        int bodyIdToRemoveAsInt = 0;
+        if(recordFields.empty() 
+            || !parseIntegerField(recordFields[0], bodyIdToRemoveAsInt))
+        {
+            recordErrors[i] = "Invalid body ID.";
+            continue;
+        }
+
+        bodiesToRemoveIDs.push_back(BodyID(bodyIdToRemoveAsInt));
+        bodiesRecordIndex.push_back(i);
+    }
 
-    std::cout << "Requesting physics service to remove body.\n";
+    LOG_DEBUG(Messages, "Requesting physics service to remove %zu bodies.",
+        bodiesToRemoveIDs.size());
 
-    // Request the creation of sphere
-    std::string removalReturn = 
-        physicsServiceImplementation->RemoveBodyByID(bodyIdToRemove);
+    // Request the removal of every valid body as a single batch
+    std::vector<std::string> bodiesErrors;
+    physicsServiceImplementation->RemoveBodiesByID(bodiesToRemoveIDs, 
+        &bodiesErrors);
+
+    for(size_t i = 0; i < bodiesErrors.size(); i++)
+    {
+        recordErrors[bodiesRecordIndex[i]] = std::move(bodiesErrors[i]);
+    }
 
-    std::cout << removalReturn << "\n\n";
-    return removalReturn;
+    return buildRecordStatusesResponse(recordErrors);
 }
@@ -4,27 +4,31 @@
 #include "MessageHandlerBase.h"
 
 /** 
-* The remove body message handler. Will remove a body according to the given
-* BodyID from the physics system.
+* The remove body message handler. Will remove the bodies according to the 
+* given BodyIDs from the physics system. Every body on the message is removed
+* as a single batch.
 */
 class MessageHandler_RemoveBody : public MessageHandlerBase
 {
 public:
     /** 
-    * Removes a body from the physics system.
+    * Removes bodies from the physics system, one per line.
     * The message template should be:
     * 
     * "RemoveBody\n
-    * id\n
+    * id_0\n
+    * id_1\n
+    * ...
     * MessageEnd\n"
     * 
-    * @param message The received message from the client with the info to 
-    * remove the body
+    * @param messagePayload The received message from the client with the info to 
+    * remove the bodies
     * 
-    * @return The result of removing a body. May return a failure message if 
-    * could not successfully remove the body from the physics system
+    * @return A status line per body, on the same order as the message lines:
+    * "ok" if the body was removed or "error;reason" otherwise
     */
-    std::string handleMessage(std::string& message) override;
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
 };
 
 #endif
\ No newline at end of file
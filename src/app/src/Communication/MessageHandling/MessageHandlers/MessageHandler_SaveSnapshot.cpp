@@ -0,0 +1,35 @@
+#include "MessageHandler_SaveSnapshot.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "SaveSnapshot\n
+* snapshotName\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SaveSnapshot::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Save snapshot requested.");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "save a snapshot.");
+
+        return "Error: No physics service implementation valid to save a "
+            "snapshot.";
+    }
+
+    // Get the snapshot's name (ignoring any trailing '\r' or spaces)
+    const std::string_view snapshotName =
+        messagePayload.substr(0, messagePayload.find_first_of("\r\n "));
+
+    std::string saveReport =
+        physicsServiceImplementation->SaveSnapshot(snapshotName);
+
+    LOG_INFO(Messages, "%s", saveReport.c_str());
+    return saveReport;
+}
@@ -0,0 +1,38 @@
+#ifndef MESSAGEHANDLER_SAVESNAPSHOT_H
+#define MESSAGEHANDLER_SAVESNAPSHOT_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The save snapshot message handler. Will save the whole world (every body,
+* its runtime data and Jolt's physics state) into a snapshot file on the
+* service's snapshot directory, so it can be restored after a restart (see
+* "LoadSnapshot").
+*
+* @see PhysicsServiceImpl::SaveSnapshot
+*/
+class MessageHandler_SaveSnapshot : public MessageHandlerBase
+{
+public:
+    /** 
+    * Saves the whole world into a snapshot file.
+    * The message template should be:
+    * 
+    * "SaveSnapshot\n
+    * snapshotName\n
+    * MessageEnd\n"
+    * 
+    * Where snapshotName is the snapshot's file name on the service's
+    * snapshot directory (letters, digits, '.', '_' and '-').
+    * 
+    * @param messagePayload The received message from the client with the
+    * name of the snapshot to save
+    * 
+    * @return The save report. May return a failure message if the
+    * name is invalid or the snapshot could not be written
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "MessageHandler_SetInterestRegions.h"
+
+#include <cmath>
+
+/* 
+* Message template:
+*
+* "SetInterestRegions\n
+* box;minX;minY;minZ;maxX;maxY;maxZ\n
+* sphere;centerX;centerY;centerZ;radius\n
+* ...
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetInterestRegions::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set interest regions requested.");
+
+    if(!clientConnectionSettings)
+    {
+        LOG_ERROR(Messages, "No client connection to set the interest "
+            "regions on.");
+
+        return "Error: Could not set interest regions as there is no "
+            "client connection.";
+    }
+
+    // Get every record (i.e. region of interest) on the message
+    std::vector<std::string_view> regionRecords;
+    splitPayloadIntoRecords(messagePayload, regionRecords);
+
+    if(regionRecords.empty())
+    {
+        clientConnectionSettings->interest.ClearRegions();
+
+        LOG_INFO(Messages, "Interest regions cleared.");
+        return "Interest regions cleared.";
+    }
+
+    std::vector<InterestRegion> newRegions;
+    newRegions.reserve(regionRecords.size());
+
+    std::vector<std::string_view> recordFields;
+    for(size_t i = 0; i < regionRecords.size(); i++)
+    {
+        splitRecordIntoFields(regionRecords[i], recordFields);
+
+        const std::string recordError = "Error: Invalid interest region on "
+            "record " + std::to_string(i) + ": ";
+
+        // Get the region's shape, which gives its number of values
+        InterestRegion region;
+        size_t expectedValuesCount = 0;
+        if(!recordFields.empty() && recordFields[0] == "box")
+        {
+            region.shape = EInterestRegionShape::Box;
+            expectedValuesCount = 6;
+        }
+        else if(!recordFields.empty() && recordFields[0] == "sphere")
+        {
+            region.shape = EInterestRegionShape::Sphere;
+            expectedValuesCount = 4;
+        }
+        else
+        {
+            LOG_WARNING(Messages, "Unknown interest region shape on record "
+                "%zu.", i);
+            return recordError + "unknown shape.";
+        }
+
+        if(recordFields.size() != expectedValuesCount + 1)
+        {
+            LOG_WARNING(Messages, "Wrong number of values on interest "
+                "region record %zu.", i);
+            return recordError + "expected "
+                + std::to_string(expectedValuesCount) + " values.";
+        }
+
+        // Parse every value. Infinite or NaN values are refused, as they
+        // can't bound a region
+        float regionValues[6] = {};
+        for(size_t j = 0; j < expectedValuesCount; j++)
+        {
+            double regionValue = 0.0;
+            if(!parseDecimalField(recordFields[j + 1], regionValue)
+                || !std::isfinite(regionValue))
+            {
+                LOG_WARNING(Messages, "Invalid value on interest region "
+                    "record %zu.", i);
+                return recordError + "invalid value "
+                    + std::string(recordFields[j + 1]) + ".";
+            }
+
+            regionValues[j] = static_cast<float>(regionValue);
+        }
+
+        if(region.shape == EInterestRegionShape::Box)
+        {
+            region.boxMin = Vec3(regionValues[0], regionValues[1],
+                regionValues[2]);
+            region.boxMax = Vec3(regionValues[3], regionValues[4],
+                regionValues[5]);
+
+            if(region.boxMin.GetX() > region.boxMax.GetX()
+                || region.boxMin.GetY() > region.boxMax.GetY()
+                || region.boxMin.GetZ() > region.boxMax.GetZ())
+            {
+                LOG_WARNING(Messages, "Inverted box on interest region "
+                    "record %zu.", i);
+                return recordError + "the box's min is above its max.";
+            }
+        }
+        else
+        {
+            region.sphereCenter = Vec3(regionValues[0], regionValues[1],
+                regionValues[2]);
+            region.sphereRadius = regionValues[3];
+
+            if(region.sphereRadius <= 0.f)
+            {
+                LOG_WARNING(Messages, "Non positive radius on interest "
+                    "region record %zu.", i);
+                return recordError + "the sphere's radius is not positive.";
+            }
+        }
+
+        newRegions.push_back(region);
+    }
+
+    clientConnectionSettings->interest.SetRegions(std::move(newRegions));
+
+    LOG_INFO(Messages, "Interest regions set: %zu.", regionRecords.size());
+    return "Interest regions set: " + std::to_string(regionRecords.size());
+}
@@ -0,0 +1,42 @@
+#ifndef MESSAGEHANDLER_SETINTERESTREGIONS_H
+#define MESSAGEHANDLER_SETINTERESTREGIONS_H
+
+#include "MessageHandlerBase.h"
+
+/**
+* The set interest regions message handler. Will set the regions of the world
+* the client connection is interested in, so its step physics responses only
+* have the bodies inside them, plus the bodies that entered and left them.
+* This is set per connection, so each game server only pays for the bodies
+* it simulates around its players.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationInterest
+*/
+class MessageHandler_SetInterestRegions : public MessageHandlerBase
+{
+public:
+    /** 
+    * Replaces the regions of interest of the client's connection.
+    * The message template should be:
+    * 
+    * "SetInterestRegions\n
+    * box;minX;minY;minZ;maxX;maxY;maxZ\n
+    * sphere;centerX;centerY;centerZ;radius\n
+    * ...
+    * MessageEnd\n"
+    * 
+    * Where each record is a region of interest. Without records, every
+    * region is removed and the client gets every body again. If any record
+    * is invalid, the previous regions are kept.
+    * 
+    * @param messagePayload The received message from the client with its
+    * regions of interest
+    * 
+    * @return The result of setting the regions of interest. May return a
+    * failure message with the first invalid record
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
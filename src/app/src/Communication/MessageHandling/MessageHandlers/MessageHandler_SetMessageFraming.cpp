@@ -0,0 +1,46 @@
+#include "MessageHandler_SetMessageFraming.h"
+
+/* 
+* Message template:
+*
+* "SetMessageFraming\n
+* framing\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetMessageFraming::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set message framing requested.");
+
+    if(!clientConnectionSettings)
+    {
+        LOG_ERROR(Messages, "No client connection to set the message framing "
+            "on.");
+
+        return "Error: Could not set message framing as there is no client "
+            "connection.";
+    }
+
+    // Get the requested framing (ignoring the blanks around it)
+    const std::string requestedFraming = parseOptionField(messagePayload);
+
+    if(requestedFraming == "delimited")
+    {
+        clientConnectionSettings->messageFraming = EMessageFraming::Delimited;
+    }
+    else if(requestedFraming == "framed")
+    {
+        clientConnectionSettings->messageFraming = EMessageFraming::Framed;
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown message framing: %s",
+            requestedFraming.c_str());
+
+        return "Error: Unknown message framing: " + requestedFraming;
+    }
+
+    LOG_INFO(Messages, "Message framing set to: %s", requestedFraming.c_str());
+    return "Message framing set to: " + requestedFraming;
+}
@@ -0,0 +1,39 @@
+#ifndef MESSAGEHANDLER_SETMESSAGEFRAMING_H
+#define MESSAGEHANDLER_SETMESSAGEFRAMING_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set message framing message handler. Will set the framing used on the
+* client's connection. This is negotiated per connection, so old clients that
+* never send this message keep using the delimited ("MessageEnd") framing.
+*
+* The response to this message is still sent with the framing the message 
+* came in with. Every message after it uses the new framing.
+*/
+class MessageHandler_SetMessageFraming : public MessageHandlerBase
+{
+public:
+    /** 
+    * Sets the message framing for the client's connection.
+    * The message template should be:
+    * 
+    * "SetMessageFraming\n
+    * framing\n
+    * MessageEnd\n"
+    * 
+    * Where framing is either "delimited" or "framed".
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested framing
+    * 
+    * @return The result of setting the message framing. May return a
+    * failure message if the framing is unknown
+    * 
+    * @see MessageFraming
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
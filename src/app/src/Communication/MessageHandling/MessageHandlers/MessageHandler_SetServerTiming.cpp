@@ -0,0 +1,46 @@
+#include "MessageHandler_SetServerTiming.h"
+
+/* 
+* Message template:
+*
+* "SetServerTiming\n
+* timing\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetServerTiming::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set server timing requested.");
+
+    if(!clientConnectionSettings)
+    {
+        LOG_ERROR(Messages, "No client connection to set the server timing "
+            "on.");
+
+        return "Error: Could not set server timing as there is no client "
+            "connection.";
+    }
+
+    // Get the requested timing (ignoring the blanks around it)
+    const std::string requestedTiming = parseOptionField(messagePayload);
+
+    if(requestedTiming == "enabled")
+    {
+        clientConnectionSettings->bServerTiming = true;
+    }
+    else if(requestedTiming == "disabled")
+    {
+        clientConnectionSettings->bServerTiming = false;
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown server timing: %s",
+            requestedTiming.c_str());
+
+        return "Error: Unknown server timing: " + requestedTiming;
+    }
+
+    LOG_INFO(Messages, "Server timing set to: %s", requestedTiming.c_str());
+    return "Server timing set to: " + requestedTiming;
+}
@@ -0,0 +1,40 @@
+#ifndef MESSAGEHANDLER_SETSERVERTIMING_H
+#define MESSAGEHANDLER_SETSERVERTIMING_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set server timing message handler. Will enable or disable the server
+* timing on the client's connection. With it enabled, every response carries
+* the time the server took to handle its message, so a client can tell the
+* server's processing time apart from the network's on the round-trip time.
+*
+* The response to this message is still sent with the server timing the 
+* message came in with. Every message after it uses the new server timing.
+*
+* @see MessageFraming
+*/
+class MessageHandler_SetServerTiming : public MessageHandlerBase
+{
+public:
+    /** 
+    * Enables or disables the server timing for the client's connection.
+    * The message template should be:
+    * 
+    * "SetServerTiming\n
+    * timing\n
+    * MessageEnd\n"
+    * 
+    * Where timing is either "enabled" or "disabled".
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested server timing
+    * 
+    * @return The result of setting the server timing. May return a failure
+    * message if the requested server timing is unknown
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
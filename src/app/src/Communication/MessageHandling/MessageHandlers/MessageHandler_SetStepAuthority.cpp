@@ -0,0 +1,50 @@
+#include "MessageHandler_SetStepAuthority.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "SetStepAuthority\n
+* authority\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetStepAuthority::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set step authority requested.");
+
+    if(!clientConnectionSettings || !physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No client connection to set the step authority "
+            "on.");
+
+        return "Error: Could not set step authority as there is no client "
+            "connection.";
+    }
+
+    // Get the requested authority (ignoring the blanks around it)
+    const std::string requestedAuthority = parseOptionField(messagePayload);
+
+    if(requestedAuthority == "take")
+    {
+        physicsServiceImplementation->SetStepAuthority
+            (clientConnectionSettings);
+    }
+    else if(requestedAuthority == "release")
+    {
+        physicsServiceImplementation->ReleaseStepAuthority
+            (clientConnectionSettings);
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown step authority: %s",
+            requestedAuthority.c_str());
+
+        return "Error: Unknown step authority: " + requestedAuthority;
+    }
+
+    LOG_INFO(Messages, "Step authority set to: %s", 
+        requestedAuthority.c_str());
+    return "Step authority set to: " + requestedAuthority;
+}
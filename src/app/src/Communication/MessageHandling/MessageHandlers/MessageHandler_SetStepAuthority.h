@@ -0,0 +1,43 @@
+#ifndef MESSAGEHANDLER_SETSTEPAUTHORITY_H
+#define MESSAGEHANDLER_SETSTEPAUTHORITY_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set step authority message handler. Will take or release the step 
+* authority of the world for the client's connection. Every client shares the
+* same physics world, so only the client with the step authority advances it
+* on its "Step" messages. The other clients are spectators: their steps are 
+* answered with the latest step's state, without stepping the world.
+*
+* Without this negotiation, the first client to step a world claims its step
+* authority, and keeps it until it releases it or disconnects.
+*
+* @see PhysicsServiceImpl::ClaimStepAuthority
+*/
+class MessageHandler_SetStepAuthority : public MessageHandlerBase
+{
+public:
+    /** 
+    * Takes or releases the world's step authority for the client's 
+    * connection.
+    * The message template should be:
+    * 
+    * "SetStepAuthority\n
+    * authority\n
+    * MessageEnd\n"
+    * 
+    * Where authority is either "take" (the client that had it becomes a
+    * spectator) or "release" (the next client to step the world claims it).
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested step authority
+    * 
+    * @return The result of setting the step authority. May return a failure
+    * message if the requested step authority is unknown
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
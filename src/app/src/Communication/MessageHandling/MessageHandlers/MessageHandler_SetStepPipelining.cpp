@@ -0,0 +1,48 @@
+#include "MessageHandler_SetStepPipelining.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "SetStepPipelining\n
+* pipelining\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetStepPipelining::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set step pipelining requested.");
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to set "
+            "step pipelining.");
+
+        return "No physics service implementation valid to set step "
+            "pipelining.";
+    }
+
+    // Get the requested pipelining (ignoring the blanks around it)
+    const std::string requestedPipelining = parseOptionField(messagePayload);
+
+    if(requestedPipelining == "enabled")
+    {
+        physicsServiceImplementation->SetPipelinedStepping(true);
+    }
+    else if(requestedPipelining == "disabled")
+    {
+        physicsServiceImplementation->SetPipelinedStepping(false);
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown step pipelining: %s",
+            requestedPipelining.c_str());
+
+        return "Error: Unknown step pipelining: " + requestedPipelining;
+    }
+
+    LOG_INFO(Messages, "Step pipelining set to: %s",
+        requestedPipelining.c_str());
+    return "Step pipelining set to: " + requestedPipelining;
+}
@@ -0,0 +1,39 @@
+#ifndef MESSAGEHANDLER_SETSTEPPIPELINING_H
+#define MESSAGEHANDLER_SETSTEPPIPELINING_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set step pipelining message handler. Will enable or disable the 
+* pipelined stepping on the physics service. On the pipelined stepping, the 
+* next physics step runs while the previous step's response is serialized and
+* sent, at the cost of one step of latency.
+*
+* As every client shares the same physics world, this affects every client.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationPipelined
+*/
+class MessageHandler_SetStepPipelining : public MessageHandlerBase
+{
+public:
+    /** 
+    * Enables or disables the pipelined stepping.
+    * The message template should be:
+    * 
+    * "SetStepPipelining\n
+    * pipelining\n
+    * MessageEnd\n"
+    * 
+    * Where pipelining is either "enabled" or "disabled".
+    * 
+    * @param messagePayload The received message from the client with the 
+    * requested pipelining
+    * 
+    * @return The result of setting the step pipelining. May return a
+    * failure message if the requested pipelining is unknown
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
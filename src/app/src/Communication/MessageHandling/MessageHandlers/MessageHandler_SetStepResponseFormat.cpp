@@ -0,0 +1,109 @@
+#include "MessageHandler_SetStepResponseFormat.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+
+/* 
+* Message template:
+*
+* "SetStepResponseFormat\n
+* format;key=value;key=value...\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetStepResponseFormat::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set step response format requested.");
+
+    if(!clientConnectionSettings)
+    {
+        LOG_ERROR(Messages, "No client connection to set the step response "
+            "format on.");
+
+        return "Error: Could not set step response format as there is no "
+            "client connection.";
+    }
+
+    // Get the requested format and its quantization values (ignoring the
+    // blanks around them)
+    std::vector<std::string_view> quantizationFields;
+    const std::string requestedFormat = 
+        parseOptionField(messagePayload, &quantizationFields);
+
+    if(requestedFormat == "text")
+    {
+        clientConnectionSettings->stepResponseFormat = 
+            EStepResponseFormat::Text;
+    }
+    else if(requestedFormat == "binary")
+    {
+        clientConnectionSettings->stepResponseFormat = 
+            EStepResponseFormat::Binary;
+    }
+    else if(requestedFormat == "quantized" || requestedFormat == "delta")
+    {
+        // Every quantization value not given takes its default
+        StateQuantizationSettings newQuantizationSettings;
+        std::string quantizationError;
+        for(const std::string_view quantizationField : quantizationFields)
+        {
+            const size_t separatorPos = quantizationField.find('=');
+            if(separatorPos == std::string_view::npos)
+            {
+                quantizationError = "Quantization value without \"=\": "
+                    + std::string(quantizationField);
+                break;
+            }
+
+            if(!newQuantizationSettings.SetValue
+                (quantizationField.substr(0, separatorPos), 
+                quantizationField.substr(separatorPos + 1), quantizationError))
+            {
+                break;
+            }
+        }
+
+        if(quantizationError.empty())
+        {
+            newQuantizationSettings.Validate(quantizationError);
+        }
+
+        if(!quantizationError.empty())
+        {
+            LOG_WARNING(Messages, "Invalid %s step response format: %s", 
+                requestedFormat.c_str(), quantizationError.c_str());
+
+            return "Error: Invalid " + requestedFormat 
+                + " step response format: " + quantizationError;
+        }
+
+        clientConnectionSettings->stepResponseFormat = 
+            requestedFormat == "delta" ? EStepResponseFormat::QuantizedDelta
+            : EStepResponseFormat::Quantized;
+        clientConnectionSettings->stateQuantization = newQuantizationSettings;
+
+        // The previous steps were quantized with other settings (if any), so
+        // they can't be a baseline
+        clientConnectionSettings->stateDeltaHistory.Reset();
+
+        // Report the error bounds, so the client can check the precision
+        // it asked for
+        const std::uint32_t bodyIdBits = physicsServiceImplementation 
+            ? physicsServiceImplementation->GetQuantizedBodyIdBits() : 32;
+
+        LOG_INFO(Messages, "Step response format set to: %s",
+            requestedFormat.c_str());
+        return "Step response format set to: " + requestedFormat + "\n"
+            + newQuantizationSettings.GetErrorBoundsReport(bodyIdBits);
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown step response format: %s",
+            requestedFormat.c_str());
+
+        return "Error: Unknown step response format: " + requestedFormat;
+    }
+
+    LOG_INFO(Messages, "Step response format set to: %s",
+        requestedFormat.c_str());
+    return "Step response format set to: " + requestedFormat;
+}
@@ -0,0 +1,47 @@
+#ifndef MESSAGEHANDLER_SETSTEPRESPONSEFORMAT_H
+#define MESSAGEHANDLER_SETSTEPRESPONSEFORMAT_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set step response format message handler. Will set the format that the
+* client connection wants to receive the step physics responses on. This is
+* negotiated per connection, so old clients that never send this message keep
+* receiving the legacy text format.
+*/
+class MessageHandler_SetStepResponseFormat : public MessageHandlerBase
+{
+public:
+    /** 
+    * Sets the step response format for the client's connection.
+    * The message template should be:
+    * 
+    * "SetStepResponseFormat\n
+    * format;key=value;key=value...\n
+    * MessageEnd\n"
+    * 
+    * Where format is either "text", "binary", "quantized" or "delta". The 
+    * quantized and delta formats may be followed by the quantization values
+    * to use instead of their defaults (see "StateQuantizationSettings"), 
+    * e.g. "quantized;originX=5000;positionPrecision=0.05;rotationBits=10".
+    * The delta format sends the quantized states delta compressed against 
+    * the last step acknowledged by the client (see "StateDeltaHistory" and
+    * "Step"). Setting it again starts over from a keyframe.
+    * 
+    * The response to the quantized and delta formats has the error bounds 
+    * of the quantized values (see "StateQuantizationSettings::
+    * GetErrorBoundsReport()"), so each deployment can check the precision 
+    * it asked for.
+    * 
+    * @param messagePayload The received message from the client with the requested
+    * step response format
+    * 
+    * @return The result of setting the step response format. May return a
+    * failure message if the format is unknown or a quantization value is
+    * invalid
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "MessageHandler_SetStepResponseMode.h"
+#include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+#include <cmath>
+#include <vector>
+
+/* 
+* Message template:
+*
+* "SetStepResponseMode\n
+* mode;changeEpsilon\n
+* MessageEnd\n"
+*
+*/
+std::string MessageHandler_SetStepResponseMode::handleMessagePayload
+    (std::string_view messagePayload)
+{
+    LOG_DEBUG(Messages, "Set step response mode requested.");
+
+    if(!clientConnectionSettings)
+    {
+        LOG_ERROR(Messages, "No client connection to set the step response "
+            "mode on.");
+
+        return "Error: Could not set step response mode as there is no "
+            "client connection.";
+    }
+
+    if(!physicsServiceImplementation)
+    {
+        LOG_ERROR(Messages, "No physics service implementation valid to set "
+            "the step response mode.");
+
+        return "No physics service implementation valid to set the step "
+            "response mode.";
+    }
+
+    // Get the requested mode and its change epsilon (ignoring the blanks
+    // around them)
+    std::vector<std::string_view> modeArguments;
+    const std::string requestedMode = 
+        parseOptionField(messagePayload, &modeArguments);
+
+    // Check for errors. Only the active set mode takes an argument
+    if(requestedMode.empty())
+    {
+        LOG_WARNING(Messages, "Error on parsing set step response mode "
+            "message info. No mode given.");
+        return "Error on parsing set step response mode message info. No "
+            "mode given.";
+    }
+
+    if(modeArguments.size() > (requestedMode == "activeset" ? 1u : 0u))
+    {
+        LOG_WARNING(Messages, "Too many fields for step response mode: %s",
+            requestedMode.c_str());
+
+        return "Error: Too many fields for step response mode: " 
+            + requestedMode;
+    }
+
+    if(requestedMode == "full")
+    {
+        clientConnectionSettings->stepResponseMode = EStepResponseMode::Full;
+
+        // Stop gathering the world's events for the client
+        physicsServiceImplementation->RemoveActiveSetClient
+            (&clientConnectionSettings->activeSet);
+    }
+    else if(requestedMode == "activeset")
+    {
+        // Get the optional change epsilon
+        double changeEpsilon = 0.0;
+        if(!modeArguments.empty() && !parseDecimalField
+            (modeArguments[0], changeEpsilon))
+        {
+            const std::string changeEpsilonField { modeArguments[0] };
+            LOG_WARNING(Messages, "Invalid active set change epsilon: %s",
+                changeEpsilonField.c_str());
+
+            return "Error: Invalid active set change epsilon: " 
+                + changeEpsilonField;
+        }
+
+        // A negative epsilon would report every candidate body, so the mode
+        // would stop filtering
+        if(!std::isfinite(static_cast<float>(changeEpsilon)) 
+            || changeEpsilon < 0.0)
+        {
+            const std::string changeEpsilonField { modeArguments[0] };
+            LOG_WARNING(Messages, "Invalid active set change epsilon: %s. It "
+                "must be finite and not negative.", 
+                changeEpsilonField.c_str());
+
+            return "Error: Invalid active set change epsilon: " 
+                + changeEpsilonField + " (must be finite and not negative)";
+        }
+
+        clientConnectionSettings->stepResponseMode = 
+            EStepResponseMode::ActiveSet;
+        clientConnectionSettings->activeSetChangeEpsilon = 
+            static_cast<float>(changeEpsilon);
+    }
+    else
+    {
+        LOG_WARNING(Messages, "Unknown step response mode: %s",
+            requestedMode.c_str());
+
+        return "Error: Unknown step response mode: " + requestedMode;
+    }
+
+    LOG_INFO(Messages, "Step response mode set to: %s", requestedMode.c_str());
+    return "Step response mode set to: " + requestedMode;
+}
@@ -0,0 +1,38 @@
+#ifndef MESSAGEHANDLER_SETSTEPRESPONSEMODE_H
+#define MESSAGEHANDLER_SETSTEPRESPONSEMODE_H
+
+#include "MessageHandlerBase.h"
+
+/** 
+* The set step response mode message handler. Will set which bodies the
+* client connection wants to receive on the step physics responses: every 
+* body ("full") or only the active set of bodies ("activeset"). This is
+* negotiated per connection, so old clients keep receiving every body.
+*/
+class MessageHandler_SetStepResponseMode : public MessageHandlerBase
+{
+public:
+    /** 
+    * Sets the step response mode for the client's connection.
+    * The message template should be:
+    * 
+    * "SetStepResponseMode\n
+    * mode;changeEpsilon\n
+    * MessageEnd\n"
+    * 
+    * Where mode is either "full" or "activeset". The change epsilon is 
+    * optional and only used on "activeset" mode: an active body is only
+    * reported if any of its state components changed more than it since it
+    * was last reported (defaults to 0).
+    * 
+    * @param messagePayload The received message from the client with the requested
+    * step response mode
+    * 
+    * @return The result of setting the step response mode. May return a
+    * failure message if the mode is unknown
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+};
+
+#endif
@@ -1,34 +1,188 @@
 #include "MessageHandler_StepPhysicsSystem.h"
 #include "../../../PhysicsSimulation/PhysicsServiceImpl.h"
+#include "../../../Serialization/TextRecordParser.h"
 
 /* 
 * Message template:
 *
 * "Step\n
+* ack;stepNumber\n (optional)
 * MessageEnd\n"
 *
 */
-std::string MessageHandler_StepPhysicsSystem::handleMessage
-    (std::string& message)
+std::string MessageHandler_StepPhysicsSystem::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "Step physics system requested.\n";
+    std::string responseBuffer;
+    const std::string_view stepPhysicsResult = 
+        handleMessagePayloadAsView(messagePayload, responseBuffer);
 
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    return std::string(stepPhysicsResult);
+}
+
+std::string_view MessageHandler_StepPhysicsSystem::handleMessagePayloadAsView
+    (std::string_view messagePayload, std::string& responseBuffer)
+{
+    LOG_TRACE(Messages, "Step physics system requested.");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to step physics "
-            "system.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to step "
+            "physics system.");
+
+        responseBuffer = "No physics service implementation valid to step "
+            "physics system.";
+        return responseBuffer;
+    }
+
+    if(!physicsServiceImplementation->IsInitialized())
+    {
+        LOG_WARNING(Messages, "Could not step the physics system, as it is "
+            "not initialized.");
+
+        responseBuffer = "Error: The physics system is not initialized.";
+        return responseBuffer;
+    }
 
-        return "No physics service implementation valid to step physics "
-            "system.";
+    // Check if the client has negotiated the binary step response format.
+    // The quantized formats are the binary one with quantized body records
+    const EStepResponseFormat stepResponseFormat = clientConnectionSettings 
+        ? clientConnectionSettings->stepResponseFormat 
+        : EStepResponseFormat::Text;
+    const bool bShouldUseBinaryFormat = 
+        stepResponseFormat != EStepResponseFormat::Text;
+    const StateQuantizationSettings* quantizationSettings = 
+        stepResponseFormat == EStepResponseFormat::Quantized 
+        || stepResponseFormat == EStepResponseFormat::QuantizedDelta
+        ? &clientConnectionSettings->stateQuantization : nullptr;
+
+    // Check if the client has negotiated the delta format, and take the
+    // step it acknowledged (if any) as the baseline of this step
+    StateDeltaHistory* deltaHistory = nullptr;
+    if(stepResponseFormat == EStepResponseFormat::QuantizedDelta)
+    {
+        deltaHistory = &clientConnectionSettings->stateDeltaHistory;
+        acknowledgeStep(messagePayload, *deltaHistory);
     }
 
-    // Step the physics system 
-    std::string stepPhysicsResult = 
-        physicsServiceImplementation->StepPhysicsSimulation(); 
+    // Check if the client has negotiated the active set step response mode
+    const bool bShouldReportActiveSetOnly = clientConnectionSettings && 
+        clientConnectionSettings->stepResponseMode == 
+        EStepResponseMode::ActiveSet;
+
+    // Check if the client has set any region of interest
+    const bool bShouldReportInterestOnly = clientConnectionSettings &&
+        clientConnectionSettings->interest.HasRegions();
+
+    // Only the client with the world's step authority advances it. Every 
+    // other client sharing the world is served the latest step's state
+    const bool bShouldStepWorld = 
+        physicsServiceImplementation->ClaimStepAuthority
+        (clientConnectionSettings);
+
+    // Step the physics system. The binary (and every non legacy) responses
+    // are views on the physics service's reusable buffers, so they are not
+    // copied until they are queued to the client
+    std::string_view stepPhysicsResult;
+    if(!bShouldStepWorld)
+    {
+        stepPhysicsResult = writeSpectatorStepResponse(bShouldUseBinaryFormat,
+            quantizationSettings, deltaHistory);
+    }
+    else if(bShouldReportActiveSetOnly)
+    {
+        stepPhysicsResult = 
+            physicsServiceImplementation->StepPhysicsSimulationActiveSet
+            (clientConnectionSettings->activeSet, bShouldUseBinaryFormat, 
+            clientConnectionSettings->activeSetChangeEpsilon, 
+            quantizationSettings);
+    }
+    else if(bShouldReportInterestOnly)
+    {
+        stepPhysicsResult = 
+            physicsServiceImplementation->StepPhysicsSimulationInterest
+            (clientConnectionSettings->interest, bShouldUseBinaryFormat,
+            quantizationSettings);
+    }
+    else if(physicsServiceImplementation->IsPipelinedSteppingEnabled())
+    {
+        stepPhysicsResult = 
+            physicsServiceImplementation->StepPhysicsSimulationPipelined
+            (bShouldUseBinaryFormat, quantizationSettings, deltaHistory);
+    }
+    else if(bShouldUseBinaryFormat)
+    {
+        stepPhysicsResult = 
+            physicsServiceImplementation->StepPhysicsSimulationBinary
+            (quantizationSettings, deltaHistory);
+    }
+    else
+    {
+        stepPhysicsResult = 
+            physicsServiceImplementation->StepPhysicsSimulation();
+    }
 
-    std::cout << "Physics system step finished.\n\n";
+    LOG_TRACE(Messages, "Physics system step finished.");
     return stepPhysicsResult;
 }
+
+std::string_view MessageHandler_StepPhysicsSystem::writeSpectatorStepResponse
+    (bool bShouldUseBinaryFormat, 
+    const StateQuantizationSettings* quantizationSettings, 
+    StateDeltaHistory* deltaHistory)
+{
+    LOG_TRACE(Messages, "Step requested by a spectator, the world is not "
+        "stepped.");
+
+    if(clientConnectionSettings->stepResponseMode == 
+        EStepResponseMode::ActiveSet)
+    {
+        return physicsServiceImplementation->WriteActiveSetStepResponse
+            (clientConnectionSettings->activeSet, bShouldUseBinaryFormat, 
+            clientConnectionSettings->activeSetChangeEpsilon, 
+            quantizationSettings);
+    }
+
+    if(clientConnectionSettings->interest.HasRegions())
+    {
+        return physicsServiceImplementation->WriteInterestStepResponse
+            (clientConnectionSettings->interest, bShouldUseBinaryFormat,
+            quantizationSettings);
+    }
+
+    return physicsServiceImplementation->WriteLatestStepResponse
+        (bShouldUseBinaryFormat, quantizationSettings, deltaHistory);
+}
+
+void MessageHandler_StepPhysicsSystem::acknowledgeStep
+    (std::string_view messagePayload, StateDeltaHistory& deltaHistory)
+{
+    std::vector<std::string_view> stepRecords;
+    splitPayloadIntoRecords(messagePayload, stepRecords);
+    if(stepRecords.empty())
+    {
+        return;
+    }
+
+    // An invalid acknowledgement only costs a keyframe, so the step is 
+    // still taken
+    std::vector<std::string_view> ackFields;
+    splitRecordIntoFields(stepRecords[0], ackFields);
+
+    std::uint32_t acknowledgedStepNumber = 0;
+    if(ackFields.size() != 2 || ackFields[0] != "ack" 
+        || !TextRecordParser::ParseNumberField(ackFields[1], 
+        acknowledgedStepNumber))
+    {
+        LOG_WARNING(Messages, "Invalid step acknowledgement: %.*s", 
+            ServiceLogger::ClampTextLength(stepRecords[0].size()), 
+            stepRecords[0].data());
+        return;
+    }
+
+    if(!deltaHistory.AcknowledgeStep(acknowledgedStepNumber))
+    {
+        LOG_DEBUG(Messages, "Step %u acknowledged, but it is not a newer "
+            "baseline.", static_cast<unsigned int>(acknowledgedStepNumber));
+    }
+}
@@ -17,15 +17,75 @@ public:
     * 
     * The message's template should be:
     * "Step\n
+    * ack;stepNumber\n (optional)
     * MessageEnd\n"
     * 
-    * @param message 
+    * Where the optional record acknowledges the last step response the
+    * client received, on the delta step response format (see 
+    * "SetStepResponseFormat"). That step becomes the baseline the response
+    * is delta compressed against. It is ignored on any other format.
+    * 
+    * @param messagePayload The received message from the client, with its
+    * acknowledged step (if any)
     * 
     * @return The step physics simulation result. This will send each actor's
     * Id, position and rotation of the current physics system state back to
-    * the client
+    * the client. The result is either text or binary, according to the
+    * step response format negotiated by the client (see 
+    * "SetStepResponseFormat"), and has either every body or only the active
+    * set of bodies, according to the step response mode negotiated by the
+    * client (see "SetStepResponseMode"). On "Full" mode, a client with
+    * regions of interest only gets the bodies inside them (see 
+    * "SetInterestRegions"). Only the client with the world's step authority
+    * steps it (see "SetStepAuthority"), the others get the latest step's 
+    * state
+    */
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
+
+    /** 
+    * Steps the current physics system simulation, giving a view on the step
+    * response. The step responses are written into the physics service's
+    * reusable buffers, so this does not copy them (see 
+    * "handleMessagePayload()" for the message and response).
+    * 
+    * @param messagePayload The received message from the client
+    * @param responseBuffer The buffer the error responses are written into
+    * 
+    * @return The step physics simulation result. The view is valid until the
+    * next step
+    */
+    std::string_view handleMessagePayloadAsView
+        (std::string_view messagePayload, std::string& responseBuffer) 
+        override;
+
+private:
+    /** 
+    * Writes the step response of a client without the world's step 
+    * authority, from the latest step's state and with the client's format
+    * and mode. The world is not stepped.
+    * 
+    * @param bShouldUseBinaryFormat True to encode the response on the 
+    * binary format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if any
+    * @param deltaHistory The client's delta history, if any
+    * 
+    * @return A view on the step response. The view is valid until the next
+    * step
+    */
+    std::string_view writeSpectatorStepResponse(bool bShouldUseBinaryFormat,
+        const StateQuantizationSettings* quantizationSettings, 
+        StateDeltaHistory* deltaHistory);
+
+    /** 
+    * Takes the step acknowledged on the message (if any) as the client's
+    * new baseline. Invalid acknowledgements are logged and ignored.
+    * 
+    * @param messagePayload The received message from the client
+    * @param deltaHistory The client's delta history
     */
-    std::string handleMessage(std::string& message) override;
+    static void acknowledgeStep(std::string_view messagePayload, 
+        StateDeltaHistory& deltaHistory);
 };
 
 #endif
\ No newline at end of file
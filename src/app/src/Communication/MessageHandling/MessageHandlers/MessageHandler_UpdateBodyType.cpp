@@ -5,74 +5,95 @@
 * Message template:
 *
 "UpdateBodyType\n
-*id;newBodyType\n
+*id_0;newBodyType_0\n
+*id_1;newBodyType_1\n
+*...
 *MessageEnd\n"
 *
 */
-std::string MessageHandler_UpdateBodyType::handleMessage
-    (std::string& message)
+std::string MessageHandler_UpdateBodyType::handleMessagePayload
+    (std::string_view messagePayload)
 {
-    std::cout << "Update body type requested.\n";
-
-    // Call the base to remove the first and last line
-    MessageHandlerBase::handleMessage(message);
+    LOG_DEBUG(Messages, "Update body type requested.");
 
     if(!physicsServiceImplementation)
     {
-        std::cout << "No physics service implementation valid to update body "
-            "type.\n";
+        LOG_ERROR(Messages, "No physics service implementation valid to "
+            "update body type.");
 
         return "No physics service implementation valid to update body type.\n";
     }
 
-    // Split info with ";" delimiter
-	std::stringstream updateBodyTypeDataStream(message);
-	std::vector<std::string> updateBodyTypeParsedData;
-
-	std::string line {};
-	while (std::getline(updateBodyTypeDataStream, line, ';')) 
-	{
-		updateBodyTypeParsedData.push_back(line);
-	}
-
-    // Check for errors
-    if (updateBodyTypeParsedData.size() < 2)
+    if(!physicsServiceImplementation->IsInitialized())
     {
-        std::cout << "Error on parsing update body type message info. Line "
-            "with less than 2 params: " << message << '\n';
-        return "Error on parsing update body type message info. Line with less "
-            "than 2 params.";
+        LOG_WARNING(Messages, "Could not update body types, as the physics "
+            "system is not initialized.");
+
+        return "Error: The physics system is not initialized.";
     }
 
-    // Get the body id to update from the message
-	const int bodyIdToUpdateAsInt { std::stoi(updateBodyTypeParsedData[0]) };
+    // Get every record (i.e. body type update) on the message
+    std::vector<std::string_view> updateRecords;
+    splitPayloadIntoRecords(messagePayload, updateRecords);
 
-    // Create the BodyID
-    const BodyID bodyIdToUpdate(bodyIdToUpdateAsInt);
+    std::vector<std::string> recordErrors(updateRecords.size());
 
-    // Get the new body type
-	const std::string newBodyTypeAsString
-        { updateBodyTypeParsedData[1] };
-    // Set the new body type
-    EBodyType newBodyType{};
-    if (newBodyTypeAsString == "primary")
-    {
-        newBodyType = EBodyType::Primary;
-    }
-    else if (newBodyTypeAsString == "clone")
+    // The body type updates and the record each one came from
+    std::vector<std::pair<BodyID, EBodyType>> bodyTypeUpdates;
+    std::vector<size_t> updatesRecordIndex;
+    bodyTypeUpdates.reserve(updateRecords.size());
+    updatesRecordIndex.reserve(updateRecords.size());
+
+    std::vector<std::string_view> recordFields;
+    for(size_t i = 0; i < updateRecords.size(); i++)
     {
-        newBodyType = EBodyType::Clone;
+        // Split info with ";" delimiter
+        splitRecordIntoFields(updateRecords[i], recordFields);
+
+        // Check for errors
+        if (recordFields.size() < 2)
+        {
+            LOG_WARNING(Messages, "Error on parsing update body type message "
+                "info. Line with less than 2 params: %.*s",
+                ServiceLogger::ClampTextLength(updateRecords[i].size()), 
+                updateRecords[i].data());
+            recordErrors[i] = "Line with less than 2 params.";
+            continue;
+        }
+
+        // Get the body id to update from the message
+        int bodyIdToUpdateAsInt = 0;
+        if(!parseIntegerField(recordFields[0], bodyIdToUpdateAsInt))
+        {
+            recordErrors[i] = "Invalid body ID.";
+            continue;
+        }
+
+        // Get the new body type
+        EBodyType newBodyType {};
+        if(!BodyRuntimeData::ParseBodyType(recordFields[1], newBodyType))
+        {
+            LOG_WARNING(Messages, "Unknown body type: %.*s",
+                static_cast<int>(recordFields[1].size()), 
+                recordFields[1].data());
+            recordErrors[i] = "Unknown body type.";
+            continue;
+        }
+
+        bodyTypeUpdates.emplace_back(BodyID(bodyIdToUpdateAsInt), 
+            newBodyType);
+        updatesRecordIndex.push_back(i);
     }
-    else
+
+    // Request every body type update as a single batch
+    std::vector<std::string> updatesErrors;
+    physicsServiceImplementation->UpdateBodiesType(bodyTypeUpdates, 
+        &updatesErrors);
+
+    for(size_t i = 0; i < updatesErrors.size(); i++)
     {
-        std::cout << "Unknown body type: " << newBodyTypeAsString << '\n';
+        recordErrors[updatesRecordIndex[i]] = std::move(updatesErrors[i]);
     }
 
-    // Request the body type update
-    std::string updateBodyReturn = 
-        physicsServiceImplementation->UpdateBodyType(bodyIdToUpdate, 
-        newBodyType);
-
-    std::cout << updateBodyReturn << "\n\n";
-    return updateBodyReturn;
+    return buildRecordStatusesResponse(recordErrors);
 }
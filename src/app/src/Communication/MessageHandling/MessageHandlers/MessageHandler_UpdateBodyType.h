@@ -4,28 +4,31 @@
 #include "MessageHandlerBase.h"
 
 /** 
-* The update body type message handler. Will update a body type on the physics
-* system according to the given BodyID.
+* The update body type message handler. Will update the body types on the 
+* physics system according to the given BodyIDs. Every update on the message
+* is applied as a single batch.
 */
 class MessageHandler_UpdateBodyType : public MessageHandlerBase
 {
 public:
     /** 
-    * Updates a body type on the physics system.
+    * Updates body types on the physics system, one per line.
     * The message template should be:
     * 
     * "UpdateBodyType\n
-    * id;newBodyType\n
+    * id_0;newBodyType_0\n
+    * id_1;newBodyType_1\n
+    * ...
     * MessageEnd\n"
     * 
-    * @param message The received message from the client with the info to 
-    * update the body type
+    * @param messagePayload The received message from the client with the info to 
+    * update the body types
     * 
-    * @return The result of updating the body type. May return a failure 
-    * message if could not successfully update the body type on the physics 
-    * system
+    * @return A status line per update, on the same order as the message 
+    * lines: "ok" if the body type was updated or "error;reason" otherwise
     */
-    std::string handleMessage(std::string& message) override;
+    std::string handleMessagePayload(std::string_view messagePayload) 
+        override;
 };
 
 #endif
\ No newline at end of file
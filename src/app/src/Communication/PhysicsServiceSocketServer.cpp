@@ -1,60 +1,36 @@
 #include "PhysicsServiceSocketServer.h"
 #include "../Communication/MessageHandling/MessageHandlerParser.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_InitPhysicsSystem.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_StepPhysicsSystem.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_RemoveBody.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_AddBody.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_UpdateBodyType.h"
-#include "../Communication/MessageHandling/MessageHandlers/MessageHandler_GetSimulationMeasures.h"
+#include "MessageFraming.h"
+#include "../Logging/ServiceLogger.h"
 #include <sstream>
 #include <chrono>
 #include <fstream>
 #include <filesystem>
+#include <fcntl.h>
+#include <sys/epoll.h>
 
 namespace fs = std::filesystem;
 
-void PhysicsServiceSocketServer::RunDebugSimulation()
+namespace
 {
-    // Creating a new physics service implementation
-    physicsServiceImplementation = new PhysicsServiceImpl();
-
-    // Create the physics service message handler parser to parse and
-    // delegate incoming messages
-    physicsServiceMessageHandlerParser = new MessageHandlerParser();
-
-    // Register all handlers:
+    /** @return The elapsed time since a time point, in nanoseconds */
+    std::int64_t GetNanosecondsSince
+        (std::chrono::steady_clock::time_point startTime)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now() - startTime).count();
+    }
+}
 
-    // Register InitPhysicsSystem handler (message type: "Init")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_InitPhysicsSystem>("Init", 
-        physicsServiceImplementation);
+void PhysicsServiceSocketServer::RunDebugSimulation()
+{
+    // Create the physics service and register all handlers
+    InitializePhysicsService();
 
-    // Register InitPhysicsSystem handler (message type: "Step")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_StepPhysicsSystem>("Step", 
-        physicsServiceImplementation);
+    // The debug simulation runs on the first world
+    MessageHandlerParser* physicsServiceMessageHandlerParser = 
+        FindWorldMessageHandlerParser(0);
 
-    // Register RemoveBody handler (message type: "RemoveBody")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_RemoveBody>("RemoveBody", 
-        physicsServiceImplementation);
-    
-    // Register AddBody handler (message type: "AddBody")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_AddBody>("AddBody", 
-        physicsServiceImplementation);
-
-    // Register UpdateBodyType handler (message type: "UpdateBodyType")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_UpdateBodyType>("UpdateBodyType", 
-        physicsServiceImplementation);
-
-    // Register GetSimulationMeasures handler (message type: 
-    // "GetSimulationMeasures")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_GetSimulationMeasures>("GetSimulationMeasures", 
-        physicsServiceImplementation);
-        
     // Initializing physics system with two spheres and a floor 
     std::string initPhysicsSystemMessage = 
         "Init\n"
@@ -63,15 +39,20 @@ void PhysicsServiceSocketServer::RunDebugSimulation()
         "sphere;2;primary;250;0;250\n"
         "MessageEnd\n";
 
+    // The buffer the responses are written into
+    std::string debugResponseBuffer;
+
     // Handle the init message
-    physicsServiceMessageHandlerParser->handleMessage(initPhysicsSystemMessage);
+    physicsServiceMessageHandlerParser->handleMessage
+        (initPhysicsSystemMessage, debugResponseBuffer);
 
     // Testing body removal handler
     std::string removeBodyMessage = 
         "RemoveBody\n"
         "1\n"
         "MessageEnd\n";
-    physicsServiceMessageHandlerParser->handleMessage(removeBodyMessage);
+    physicsServiceMessageHandlerParser->handleMessage(removeBodyMessage, 
+        debugResponseBuffer);
 
     // Testing add body handler (note that the bodyID is not 1, so the body ID
     // 1 should not exist and the bodyID 4 should)
@@ -79,36 +60,111 @@ void PhysicsServiceSocketServer::RunDebugSimulation()
         "AddBody\n"
         "sphere;4;primary;0;0;250;0;0;0;0;0;0\n"
         "MessageEnd\n";
-    physicsServiceMessageHandlerParser->handleMessage(addBodyMessage);
+    physicsServiceMessageHandlerParser->handleMessage(addBodyMessage, 
+        debugResponseBuffer);
 
     // Testing update body type handler
     std::string updateBodyTypeMessage = 
         "UpdateBodyType\n"
         "4;clone\n"
         "MessageEnd\n";
-    physicsServiceMessageHandlerParser->handleMessage(updateBodyTypeMessage);
+    physicsServiceMessageHandlerParser->handleMessage(updateBodyTypeMessage, 
+        debugResponseBuffer);
 
-    std::cout << "Steping physics...\n";
+    LOG_INFO(Network, "Steping physics...");
 
     // Execute 30 physics steps
     for(int i = 0; i < 20; i++)
     { 
         std::string stepPhysicsSystemMessage = "Step\nMessageEnd\n";
 
-        // Step physics simulation and get result
-        std::string stepSimulationResult = 
-            physicsServiceMessageHandlerParser->handleMessage
-            (stepPhysicsSystemMessage);
+        // Step physics simulation
+        physicsServiceMessageHandlerParser->handleMessage
+            (stepPhysicsSystemMessage, debugResponseBuffer);
     }
 
-    std::cout << "Getting measures...\n";
+    LOG_INFO(Network, "Getting measures...");
 
     // Testing the get simulation measures message
     std::string getSimulationMeasuresMessage = 
         "GetSimulationMeasures\n"
         "MessageEnd\n";
     physicsServiceMessageHandlerParser->handleMessage
-        (getSimulationMeasuresMessage);
+        (getSimulationMeasuresMessage, debugResponseBuffer);
+
+    // Testing the get phase profile message
+    std::string getPhaseProfileMessage = 
+        "GetPhaseProfile\n"
+        "MessageEnd\n";
+    physicsServiceMessageHandlerParser->handleMessage
+        (getPhaseProfileMessage, debugResponseBuffer);
+}
+
+void PhysicsServiceSocketServer::SetPhysicsServiceConfig
+    (const PhysicsServiceConfig& newPhysicsServiceConfig)
+{
+    physicsServiceConfig = newPhysicsServiceConfig;
+}
+
+void PhysicsServiceSocketServer::InitializePhysicsService()
+{
+    // Create the physics service implementation of every world
+    physicsWorldHost.CreateWorlds(physicsServiceConfig);
+
+    for(size_t worldId = 0; worldId < physicsWorldHost.GetWorldCount(); 
+        worldId++)
+    {
+        // Create the world's message handler parser to parse and delegate 
+        // its incoming messages
+        MessageHandlerParser* worldMessageHandlerParser = 
+            new MessageHandlerParser();
+
+        // Register all handlers
+        worldMessageHandlerParser->registerPhysicsServiceHandlers
+            (physicsWorldHost.GetWorld(static_cast<std::uint32_t>(worldId)));
+
+        worldMessageHandlerParsers.push_back(worldMessageHandlerParser);
+    }
+}
+
+MessageHandlerParser* PhysicsServiceSocketServer::FindWorldMessageHandlerParser
+    (std::uint32_t worldId) const
+{
+    return worldId < worldMessageHandlerParsers.size() 
+        ? worldMessageHandlerParsers[worldId] : nullptr;
+}
+
+void PhysicsServiceSocketServer::SelectClientWorld
+    (ClientConnection& clientConnection, std::uint32_t worldId, 
+    std::uint16_t opcode)
+{
+    // Only stepping or initializing a world uses the client's state of it, 
+    // so any other message (e.g. "GetSimulationMeasures") is answered 
+    // without leaving the client's world
+    if(clientConnection.worldId == worldId 
+        || (opcode != static_cast<std::uint16_t>(EMessageOpcode::Step)
+        && opcode != static_cast<std::uint16_t>(EMessageOpcode::Init)))
+    {
+        return;
+    }
+
+    // The next delta compressed step response is a keyframe of the new 
+    // world, and every body inside the client's regions of interest enters
+    clientConnection.settings.stateDeltaHistory.Reset();
+    clientConnection.settings.interest.ClearBodiesInside();
+
+    // Stop gathering the old world's events for the client, and let another
+    // client step the old world. The client subscribes to the new world on
+    // its next active set step
+    if(PhysicsServiceImpl* previousWorld = 
+        physicsWorldHost.GetWorld(clientConnection.worldId))
+    {
+        previousWorld->RemoveActiveSetClient
+            (&clientConnection.settings.activeSet);
+        previousWorld->ReleaseStepAuthority(&clientConnection.settings);
+    }
+
+    clientConnection.worldId = worldId;
 }
 
 bool PhysicsServiceSocketServer::OpenServerSocket(const char* serverPort)
@@ -126,7 +182,7 @@ bool PhysicsServiceSocketServer::OpenServerSocket(const char* serverPort)
         &addrInfoResult);
     if (getAddrInfoReturnValue != 0)
     {
-        printf("getaddrinfo failed with error: %s\n", 
+        LOG_ERROR(Network, "getaddrinfo failed with error: %s", 
             gai_strerror(getAddrInfoReturnValue));
         return false;
     }
@@ -149,125 +205,133 @@ bool PhysicsServiceSocketServer::OpenServerSocket(const char* serverPort)
     // Free addrinfo as we don't need it anymore
     freeaddrinfo(addrInfoResult);
 
-    // Await for the client connection on the listening socket
-    int clientSocket = AwaitClientConnection(serverListenSocket);
-    if (clientSocket == -1) 
+    // Start listening for client connections. The listen socket is kept 
+    // open, so clients may connect at any time
+    if(!StartListening(serverListenSocket))
     {
         return false;
     }
 
-    // Once the connection has been established, close the listening socket 
-    // as we won't need it anymore (the communication is done via the new 
-    // client socket)
-    close(serverListenSocket);
+    // Create the epoll instance and watch the listen socket for new client
+    // connections
+    epollFileDescriptor = epoll_create1(0);
+    if (epollFileDescriptor == -1) 
+    {
+        LOG_ERROR(Network, "epoll_create1 failed with error: %s", 
+            strerror(errno));
+        close(serverListenSocket);
+        return false;
+    }
 
-    // Create a new physics service implementation object
-    physicsServiceImplementation = new PhysicsServiceImpl();
-
-    // Create the physics service message handler parser to parse and
-    // delegate incoming messages
-    physicsServiceMessageHandlerParser = new MessageHandlerParser();
-
-    // Register all handlers:
-
-    // Register InitPhysicsSystem handler (message type: "Init")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_InitPhysicsSystem>("Init", 
-        physicsServiceImplementation);
-
-    // Register InitPhysicsSystem handler (message type: "Step")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_StepPhysicsSystem>("Step", 
-        physicsServiceImplementation);
-
-    // Register REmoveBody handler (message type: "RemoveBody")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_RemoveBody>("RemoveBody", 
-        physicsServiceImplementation);
-
-    // Register AddBody handler (message type: "AddBody")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_AddBody>("AddBody", 
-        physicsServiceImplementation);
-
-    // Register UpdateBodyType handler (message type: "UpdateBodyType")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_UpdateBodyType>("UpdateBodyType", 
-        physicsServiceImplementation);
-
-    // Register GetSimulationMeasures handler (message type: 
-    // "GetSimulationMeasures")
-    physicsServiceMessageHandlerParser->registerHandler
-        <MessageHandler_GetSimulationMeasures>("GetSimulationMeasures", 
-        physicsServiceImplementation);
-
-    // Receive messages until the peer shuts down the connection
-    ssize_t messageReceivalReturnValue = 0;
-    do 
-    {
-        std::cout << "Awaiting client message...\n";
-
-        // Will stall this process thread until receives a new message from 
-        // client.
-        // The message will be passed on the buffer and the amount of received 
-        // bytes is the return value
-        // @note Passing a default buffer len. For bigger messages, this should 
-        // be increased
-        char receivingBuffer[DEFAULT_BUFLEN];
-        messageReceivalReturnValue = ReceiveMessageFromClient(clientSocket, 
-            receivingBuffer, DEFAULT_BUFLEN);
-        if(messageReceivalReturnValue <= 0)
+    epoll_event listenSocketEvent {};
+    listenSocketEvent.events = EPOLLIN;
+    listenSocketEvent.data.fd = serverListenSocket;
+    if (epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, serverListenSocket, 
+        &listenSocketEvent) == -1) 
+    {
+        LOG_ERROR(Network, "epoll_ctl failed with error: %s", strerror(errno));
+        close(epollFileDescriptor);
+        close(serverListenSocket);
+        return false;
+    }
+
+    // Create the physics service and register all handlers. Every client
+    // shares these physics worlds, so each one is a single authoritative 
+    // world
+    InitializePhysicsService();
+
+    // Allocate the buffer to receive the client's data on
+    // @note Passing a default buffer len. Bigger messages are received in 
+    // chunks
+    receivingBuffer.resize(DEFAULT_BUFLEN);
+
+    LOG_INFO(Network, "Awaiting client connections...");
+
+    // Run the event loop until an unrecoverable error occurs
+    bool bEventLoopSucceeded = true;
+    epoll_event readyEvents[MAX_EPOLL_EVENTS];
+    while(true)
+    {
+        // Will stall this process thread until any socket is ready
+        const int readyEventsAmount = epoll_wait(epollFileDescriptor, 
+            readyEvents, MAX_EPOLL_EVENTS, -1);
+        if (readyEventsAmount == -1) 
         {
+            // Interrupted by a signal, just wait again
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR(Network, "epoll_wait failed with error: %s", 
+                strerror(errno));
+            bEventLoopSucceeded = false;
             break;
         }
 
-        // Debug: Print received message
-        if(messageReceivalReturnValue > 0)
+        for(int i = 0; i < readyEventsAmount; i++)
         {
-            // Append the decoded message as string (the 
-            // "messageReceivalReturnValue" indicates the message length)
-            decodedMessage += std::string(receivingBuffer, receivingBuffer 
-                + messageReceivalReturnValue);
-            
-            //  (DEBUG) Print received message
-            std::cout << "Decoded message:" << decodedMessage << "\n=======\n";
-
-            // While the decoded message does not find "MessageEnd" on the 
-            // decoded message, keep appending to the string. This is needed
-            // as we may be getting chunks of the actual message
-            if(decodedMessage.find("MessageEnd") == std::string::npos)
+            const int readySocket = readyEvents[i].data.fd;
+
+            // New client connections on the listen socket
+            if(readySocket == serverListenSocket)
             {
+                AcceptPendingClientConnections(serverListenSocket);
                 continue;
             }
 
-            // Handle the decoded message by passing it to the parser. He will
-            // call the proper handler or generate an error if could not find 
-            // a proper handler
-            std::string messageHandlerReturn = 
-                physicsServiceMessageHandlerParser->handleMessage
-                (decodedMessage);
+            // Check if the client is still connected (it may have been closed
+            // by a previous event)
+            auto clientConnectionIt = clientConnections.find(readySocket);
+            if(clientConnectionIt == clientConnections.end())
+            {
+                continue;
+            }
+            ClientConnection& clientConnection = clientConnectionIt->second;
+
+            // Check for socket errors or hang ups
+            const uint32_t readyEventFlags = readyEvents[i].events;
+            if(readyEventFlags & (EPOLLERR | EPOLLHUP) 
+                && !(readyEventFlags & EPOLLIN))
+            {
+                CloseClientConnection(readySocket);
+                continue;
+            }
 
-            // Send the handler return to the client
-            SendMessageToClient(clientSocket, messageHandlerReturn);
+            // Send the pending data if the socket is writable again
+            if(readyEventFlags & EPOLLOUT)
+            {
+                if(!FlushPendingSendBuffer(clientConnection))
+                {
+                    CloseClientConnection(readySocket);
+                    continue;
+                }
+            }
 
-            // Empty the current decoded message
-            decodedMessage = "";
+            // Receive and handle the client's messages
+            if(readyEventFlags & EPOLLIN)
+            {
+                if(!ReceiveMessagesFromClient(clientConnection))
+                {
+                    CloseClientConnection(readySocket);
+                    continue;
+                }
+            }
         }
-    } while (messageReceivalReturnValue > 0);
+    }
 
-    // shutdown the connection since we're done
-    const int shutdownResult = shutdown(clientSocket, SHUT_RDWR);
-    if (shutdownResult == -1) 
+    // Finished work, clean up every connection
+    while(!clientConnections.empty())
     {
-        printf("Shutdown failed with error: %s\n", strerror(errno));
-        close(clientSocket);
-        return false;
+        CloseClientConnection(clientConnections.begin()->first);
     }
 
-    // Finished work, clean up
-    close(clientSocket);
+    close(epollFileDescriptor);
+    epollFileDescriptor = -1;
 
-    return true;
+    close(serverListenSocket);
+
+    return bEventLoopSucceeded;
 }
 
 int PhysicsServiceSocketServer::CreateListenSocket
@@ -280,10 +344,19 @@ int PhysicsServiceSocketServer::CreateListenSocket
     // Check if creation was successful
     if (newListenSocket == -1) 
     {
-        printf("Socket failed with error: %s\n", strerror(errno));
+        LOG_ERROR(Network, "Socket failed with error: %s", strerror(errno));
         return -1;
     }
 
+    // Allow the port to be reused right away if the server is restarted, as
+    // the listen socket stays open for the whole server's lifetime
+    const int reuseAddressOption = 1;
+    if (setsockopt(newListenSocket, SOL_SOCKET, SO_REUSEADDR, 
+        &reuseAddressOption, sizeof(reuseAddressOption)) == -1) 
+    {
+        LOG_ERROR(Network, "setsockopt failed with error: %s", strerror(errno));
+    }
+
     return newListenSocket;
 }
 
@@ -298,7 +371,7 @@ bool PhysicsServiceSocketServer::BindListenSocket
     // Check for errors
     if (bindReturnValue == -1) 
     {
-        printf("Bind failed with error: %s\n", strerror(errno));
+        LOG_ERROR(Network, "Bind failed with error: %s", strerror(errno));
         close(listenSocketToSetup);
         return false;
     }
@@ -306,97 +379,514 @@ bool PhysicsServiceSocketServer::BindListenSocket
     return true;
 }
 
-int PhysicsServiceSocketServer::AwaitClientConnection(int listenSocket)
+bool PhysicsServiceSocketServer::StartListening(int listenSocket)
 {
     const int listenReturnValue = 
         listen(listenSocket, SOMAXCONN);
 
     if (listenReturnValue == -1) 
     {
-        printf("Listen failed with error: %s\n", strerror(errno));
+        LOG_ERROR(Network, "Listen failed with error: %s", strerror(errno));
         close(listenSocket);
-        return -1;
+        return false;
     }
 
-    // Await a client connection to the listening socket
-    printf("Awaiting client connection...\n");
+    // Set the listen socket as non-blocking, so accepting never stalls the
+    // event loop
+    if (fcntl(listenSocket, F_SETFL, 
+        fcntl(listenSocket, F_GETFL, 0) | O_NONBLOCK) == -1) 
+    {
+        LOG_ERROR(Network, "fcntl failed with error: %s", strerror(errno));
+        close(listenSocket);
+        return false;
+    }
 
-    // Once connection is done, the library will create a new socket for it
-    int connectedClientSocket = accept(listenSocket, NULL, NULL);
+    return true;
+}
 
-    // Check for errors on the client socket creation
-    if (connectedClientSocket == -1) 
+void PhysicsServiceSocketServer::AcceptPendingClientConnections
+    (int listenSocket)
+{
+    // Accept every pending connection. Once connection is done, the library
+    // will create a new (non-blocking) socket for it
+    while(true)
     {
-        printf("Socket accept failed with error: %s\n", strerror(errno));
-        close(listenSocket);
-        return -1;
+        int connectedClientSocket = accept4(listenSocket, NULL, NULL, 
+            SOCK_NONBLOCK);
+
+        // Check for errors on the client socket creation
+        if (connectedClientSocket == -1) 
+        {
+            // No more pending connections
+            if(errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                LOG_ERROR(Network, "Socket accept failed with error: %s", 
+                    strerror(errno));
+            }
+
+            return;
+        }
+
+        // Watch the client socket for incoming messages
+        epoll_event clientSocketEvent {};
+        clientSocketEvent.events = EPOLLIN;
+        clientSocketEvent.data.fd = connectedClientSocket;
+        if (epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, 
+            connectedClientSocket, &clientSocketEvent) == -1) 
+        {
+            LOG_ERROR(Network, "epoll_ctl failed with error: %s", 
+                strerror(errno));
+            close(connectedClientSocket);
+            continue;
+        }
+
+        // Create the client's connection state
+        ClientConnection& newClientConnection = 
+            clientConnections[connectedClientSocket];
+        newClientConnection.clientSocket = connectedClientSocket;
+
+        LOG_INFO(Network, "Client connected (socket: %d, connected clients: "
+            "%zu)", connectedClientSocket, clientConnections.size());
     }
+}
 
-    return connectedClientSocket;
+bool PhysicsServiceSocketServer::ReceiveMessagesFromClient
+    (ClientConnection& clientConnection)
+{
+    // Receive until there is no more available data on the socket
+    while(true)
+    {
+        // The message received will be on "receivingBuffer", given the buffer 
+        // length
+        // The returning value will be the amount of bytes on the received 
+        // message
+        const ssize_t bytesReceivedAmount = recv(clientConnection.clientSocket,
+            receivingBuffer.data(), receivingBuffer.size(), 0);
+
+        // If received 0, that means the client is requesting to close the 
+        // connection
+        if(bytesReceivedAmount == 0)
+        {
+            LOG_DEBUG(Network, "Received a close connection message (0 "
+                "bytes)");
+            LOG_DEBUG(Network, "Closing connection...");
+            return false;
+        }
+
+        // If received value is < 0, we either have read all the available 
+        // data or have an error
+        if(bytesReceivedAmount < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR(Network, "recv failed with error: %s", strerror(errno));
+            return false;
+        }
+
+        // Append the decoded message as string (the "bytesReceivedAmount" 
+        // indicates the message length)
+        clientConnection.decodedMessage.append(receivingBuffer.data(), 
+            bytesReceivedAmount);
+    }
+
+    //  (DEBUG) Print received message. Framed messages may be binary, so
+    // only their size is printed
+    if(clientConnection.settings.messageFraming == EMessageFraming::Delimited)
+    {
+        LOG_TRACE(Network, "Decoded message:%.*s\n=======", 
+            ServiceLogger::ClampTextLength
+            (clientConnection.decodedMessage.size()), 
+            clientConnection.decodedMessage.data());
+    }
+    else
+    {
+        LOG_TRACE(Network, "Decoded bytes: %zu", 
+            clientConnection.decodedMessage.size());
+    }
+
+    return HandleReceivedMessages(clientConnection);
+}
+
+bool PhysicsServiceSocketServer::HandleReceivedMessages
+    (ClientConnection& clientConnection)
+{
+    std::string& decodedMessage = clientConnection.decodedMessage;
+
+    // Handle every complete message on the decoded message. The handled
+    // messages are only erased from the decoded message once every complete
+    // message has been handled, so the remaining data is moved only once
+    size_t handledBytesAmount = 0;
+    bool bHandledSuccessfully = true;
+    while(bHandledSuccessfully)
+    {
+        // The data not handled yet. The handlers receive views on it, so the
+        // messages are not copied
+        const std::string_view pendingData = 
+            std::string_view(decodedMessage).substr(handledBytesAmount);
+
+        // The framing is checked for every message, as a message (i.e. 
+        // "SetMessageFraming") may change it for the following ones
+        size_t handledMessageLength = 0;
+        if(clientConnection.settings.messageFraming == EMessageFraming::Framed)
+        {
+            bHandledSuccessfully = HandleNextFramedMessage(clientConnection, 
+                pendingData, handledMessageLength);
+        }
+        else
+        {
+            bHandledSuccessfully = HandleNextDelimitedMessage
+                (clientConnection, pendingData, handledMessageLength);
+        }
+
+        // Stop if there is no complete message left. Keep the remaining data,
+        // as we may be getting chunks of the actual message
+        if(handledMessageLength == 0)
+        {
+            break;
+        }
+
+        handledBytesAmount += handledMessageLength;
+    }
+
+    decodedMessage.erase(0, handledBytesAmount);
+
+    // The scan offset is relative to the decoded message's start
+    clientConnection.decodedMessageScanOffset = 
+        clientConnection.decodedMessageScanOffset > handledBytesAmount 
+        ? clientConnection.decodedMessageScanOffset - handledBytesAmount : 0;
+
+    return bHandledSuccessfully;
 }
 
-ssize_t PhysicsServiceSocketServer::ReceiveMessageFromClient(int clientSocket,
-    char* receivingBuffer, int receivingBufferLength)
+bool PhysicsServiceSocketServer::HandleNextDelimitedMessage
+    (ClientConnection& clientConnection, std::string_view pendingData, 
+    size_t& outHandledMessageLength)
 {
-    // This call will stall this process thread until we receive a message 
-    // from the client (game)
-    // The message received will be on "receivingBuffer", given the buffer 
-    // length
-    // The returning value will be the amount of bytes on the received message
-    const ssize_t bytesReceivedAmount =
-        recv(clientSocket, receivingBuffer, receivingBufferLength, 0);
+    const std::string_view messageEndFlag = "MessageEnd";
+    outHandledMessageLength = 0;
+
+    // Search for the "MessageEnd" flag only on the data that was not 
+    // scanned before. The last scanned bytes are scanned again, as the flag
+    // may have been split between two chunks
+    const size_t pendingDataOffset = 
+        clientConnection.decodedMessage.size() - pendingData.size();
+    const size_t scanOffset = clientConnection.decodedMessageScanOffset 
+        > pendingDataOffset + messageEndFlag.size() - 1
+        ? clientConnection.decodedMessageScanOffset - pendingDataOffset 
+        - (messageEndFlag.size() - 1) : 0;
+
+    const size_t messageEndFlagPos = 
+        pendingData.find(messageEndFlag, scanOffset);
+    if(messageEndFlagPos == std::string_view::npos)
+    {
+        // Check if the pending message is bigger than any message allowed, so
+        // a connection that never sends "MessageEnd" can't grow the buffer
+        // without limit
+        if(pendingData.size() > MessageFraming::maxFramePayloadLength)
+        {
+            LOG_ERROR(Network, "Delimited message length (%zu) is bigger than "
+                "the maximum allowed (%u) and has no \"MessageEnd\".", 
+                pendingData.size(), MessageFraming::maxFramePayloadLength);
+            return false;
+        }
+
+        // No complete message, the next search starts from the data's end
+        clientConnection.decodedMessageScanOffset = 
+            clientConnection.decodedMessage.size();
+        return true;
+    }
 
-    // If received 0, that means the client is requesting to close the 
-    // connection
-    if(bytesReceivedAmount == 0)
+    // The message goes until the end of the "MessageEnd" line
+    size_t messageEndPos = messageEndFlagPos + messageEndFlag.size();
+    if(messageEndPos < pendingData.size() && pendingData[messageEndPos] == '\n')
     {
-        printf("Received a close connection message (0 bytes)\n");
-        printf("Closing connection...\n");
-        return 0;
+        messageEndPos++;
     }
 
-    // If received a value > 0, we have a valid message from the client
-    if(bytesReceivedAmount > 0)
+    outHandledMessageLength = messageEndPos;
+
+    // The server timing the message came in with, as the message may change
+    // it for the following ones
+    const bool bServerTiming = clientConnection.settings.bServerTiming;
+    const auto handleStartTime = std::chrono::steady_clock::now();
+
+    // Find the parser of the world the message is for
+    const std::string_view message = pendingData.substr(0, messageEndPos);
+    std::string_view messageType;
+    std::uint32_t worldId = 0;
+    MessageHandlerParser* worldMessageHandlerParser = 
+        MessageFraming::SplitMessageTypeLine(message, messageType, worldId) 
+        ? FindWorldMessageHandlerParser(worldId) : nullptr;
+
+    // Handle the decoded message by passing it to the parser. He will call 
+    // the proper handler or generate an error if could not find a proper 
+    // handler
+    std::string_view messageHandlerReturn;
+    if(worldMessageHandlerParser)
     {
-        //printf("Received bytes amount: %ld\n", bytesReceivedAmount);
+        SelectClientWorld(clientConnection, worldId, 
+            MessageFraming::FindMessageTypeOpcode(messageType));
+        messageHandlerReturn = worldMessageHandlerParser->handleMessage
+            (message, messageResponseBuffer, &clientConnection.settings);
+    }
+    else
+    {
+        const std::string_view messageTypeLine = 
+            message.substr(0, message.find('\n'));
+        LOG_WARNING(Network, "Message for an unknown world: %.*s", 
+            ServiceLogger::ClampTextLength(messageTypeLine.size()), 
+            messageTypeLine.data());
+        messageHandlerReturn = "Error: Unknown world ID.";
+    }
+
+    // Send the handler return to the client. The response is delimited, even
+    // if the message changed the connection's framing
+    return SendMessageToClient(clientConnection, messageHandlerReturn, 
+        EMessageFraming::Delimited, 0, 0, bServerTiming 
+        ? GetNanosecondsSince(handleStartTime) : -1);
+}
+
+bool PhysicsServiceSocketServer::HandleNextFramedMessage
+    (ClientConnection& clientConnection, std::string_view pendingData, 
+    size_t& outHandledMessageLength)
+{
+    outHandledMessageLength = 0;
 
-        // return the amount of received bytes
-        return bytesReceivedAmount;
+    // Wait for the whole frame header
+    if(pendingData.size() < MessageFraming::frameHeaderSize)
+    {
+        return true;
     }
 
-    // If received value is < 0, we have an error. Let's close the connection
-    printf("recv failed with error: %s\n", strerror(errno));
-    close(clientSocket);
+    std::uint32_t payloadLength = 0;
+    std::uint16_t opcode = 0;
+    std::uint16_t worldId = 0;
+    MessageFraming::ReadFrameHeader(pendingData.data(), payloadLength, opcode,
+        worldId);
+
+    // Check if the client is speaking the framed protocol
+    if(payloadLength > MessageFraming::maxFramePayloadLength)
+    {
+        LOG_WARNING(Network, "Frame payload length (%u) is bigger than the "
+            "maximum allowed (%u).", payloadLength, 
+            MessageFraming::maxFramePayloadLength);
+        return false;
+    }
+
+    // Wait for the whole frame payload. As the header carries the payload 
+    // length, the remaining data does not need to be scanned
+    const size_t frameLength = MessageFraming::frameHeaderSize + payloadLength;
+    if(pendingData.size() < frameLength)
+    {
+        return true;
+    }
+
+    outHandledMessageLength = frameLength;
+
+    // The server timing the frame came in with, as the frame may change it
+    // for the following ones
+    const bool bServerTiming = clientConnection.settings.bServerTiming;
+    const auto handleStartTime = std::chrono::steady_clock::now();
+
+    // Handle the frame's payload on the world it is for
+    std::string_view messageHandlerReturn;
+    if(MessageHandlerParser* worldMessageHandlerParser = 
+        FindWorldMessageHandlerParser(worldId))
+    {
+        SelectClientWorld(clientConnection, worldId, opcode);
+        messageHandlerReturn = worldMessageHandlerParser->handleFramedMessage
+            (opcode, pendingData.substr(MessageFraming::frameHeaderSize, 
+            payloadLength), messageResponseBuffer, 
+            &clientConnection.settings);
+    }
+    else
+    {
+        LOG_WARNING(Network, "Frame for an unknown world (opcode: %u, world "
+            "ID: %u)", static_cast<unsigned int>(opcode), 
+            static_cast<unsigned int>(worldId));
+        messageHandlerReturn = "Error: Unknown world ID.";
+    }
 
-    return -1;
+    // Send the handler return to the client. The response is framed, even if
+    // the message changed the connection's framing
+    return SendMessageToClient(clientConnection, messageHandlerReturn, 
+        EMessageFraming::Framed, opcode 
+        | static_cast<std::uint16_t>(EMessageOpcode::Response), worldId, 
+        bServerTiming ? GetNanosecondsSince(handleStartTime) : -1);
 }
 
-bool PhysicsServiceSocketServer::SendMessageToClient(int clientSocket, 
-    std::string& messageToSend)
+bool PhysicsServiceSocketServer::SendMessageToClient
+    (ClientConnection& clientConnection, std::string_view messageToSend,
+    EMessageFraming messageFraming, std::uint16_t responseOpcode,
+    std::uint16_t responseWorldId, std::int64_t serverTimeNanoseconds)
 {
-    // Check if message does not have "MessageEnd" on it
-    if(messageToSend.find("MessageEnd") == std::string::npos)
+    std::string& pendingSendBuffer = clientConnection.pendingSendBuffer;
+    const bool bWithServerTime = serverTimeNanoseconds >= 0;
+
+    // Framed responses are prefixed by the frame header, so the client knows
+    // the response's length up front
+    if(messageFraming == EMessageFraming::Framed)
+    {
+        const size_t serverTimeSize = 
+            bWithServerTime ? MessageFraming::serverTimeSize : 0;
+        MessageFraming::AppendFrameHeader(pendingSendBuffer, 
+            static_cast<std::uint32_t>(messageToSend.size() + serverTimeSize),
+            responseOpcode, responseWorldId);
+
+        // The server time is written on the send buffer, so the response is
+        // not copied to make room for it
+        if(bWithServerTime)
+        {
+            ByteBufferWriter::AppendUInt64(pendingSendBuffer, 
+                static_cast<std::uint64_t>(serverTimeNanoseconds));
+        }
+
+        pendingSendBuffer += messageToSend;
+
+        LOG_TRACE(Network, "Framed message sent (opcode: %u)", 
+            static_cast<unsigned int>(responseOpcode));
+        LOG_TRACE(Network, "Bytes sent: %zu", 
+            messageToSend.size() + MessageFraming::frameHeaderSize);
+
+        // Send as much as the socket allows
+        return FlushPendingSendBuffer(clientConnection);
+    }
+
+    // The server time line goes before the response
+    if(bWithServerTime)
+    {
+        pendingSendBuffer += MessageFraming::serverTimeLinePrefix;
+        pendingSendBuffer += std::to_string(serverTimeNanoseconds);
+        pendingSendBuffer += '\n';
+    }
+
+    // Queue the message on the client's pending send buffer
+    pendingSendBuffer += messageToSend;
+
+    // Check if message does not end with "MessageEnd". Only the message's
+    // end is checked, as binary responses may contain any byte sequence
+    const std::string_view messageEndFlag = "MessageEnd\n";
+    if(messageToSend.size() < messageEndFlag.size() || messageToSend.compare
+        (messageToSend.size() - messageEndFlag.size(), messageEndFlag.size(),
+        messageEndFlag) != 0)
     {
         // If not, append to it
-        messageToSend += "\nMessageEnd\n";
+        pendingSendBuffer += "\nMessageEnd\n";
     }
 
-    // Convert the message to send to char*
-    const char* messageBuffer = messageToSend.c_str();
+    LOG_TRACE(Network, "Message sent: %.*s", 
+        ServiceLogger::ClampTextLength(messageToSend.size()), 
+        messageToSend.data());
+    LOG_TRACE(Network, "Bytes sent: %zu", messageToSend.size());
+
+    // Send as much as the socket allows
+    return FlushPendingSendBuffer(clientConnection);
+}
+
+bool PhysicsServiceSocketServer::FlushPendingSendBuffer
+    (ClientConnection& clientConnection)
+{
+    std::string& pendingSendBuffer = clientConnection.pendingSendBuffer;
+
+    // Send the pending data to the client. The buffer's size is used instead
+    // of "strlen()", as binary responses may contain '\0' bytes
+    while(clientConnection.pendingSendOffset < pendingSendBuffer.size())
+    {
+        const ssize_t sendReturnValue = send(clientConnection.clientSocket, 
+            pendingSendBuffer.data() + clientConnection.pendingSendOffset, 
+            pendingSendBuffer.size() - clientConnection.pendingSendOffset, 
+            MSG_NOSIGNAL);
+
+        // Check for sending error
+        if (sendReturnValue == -1) 
+        {
+            // The socket can't take more data for now
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR(Network, "send failed with error: %s", strerror(errno));
+            return false;
+        }
+
+        clientConnection.pendingSendOffset += sendReturnValue;
+    }
 
-    // Send the given message to the client
-    const ssize_t sendReturnValue = send(clientSocket, messageBuffer, 
-        strlen(messageBuffer), 0);
+    // Check if all the pending data was sent
+    const bool bHasPendingData = 
+        clientConnection.pendingSendOffset < pendingSendBuffer.size();
+    if(!bHasPendingData)
+    {
+        pendingSendBuffer.clear();
+        clientConnection.pendingSendOffset = 0;
+    }
 
-    // Check for sending error
-    if (sendReturnValue == -1) 
+    // Only watch for writability while there is pending data
+    epoll_event clientSocketEvent {};
+    clientSocketEvent.events = bHasPendingData ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    clientSocketEvent.data.fd = clientConnection.clientSocket;
+    if (epoll_ctl(epollFileDescriptor, EPOLL_CTL_MOD, 
+        clientConnection.clientSocket, &clientSocketEvent) == -1) 
     {
-        printf("send failed with error: %s\n", strerror(errno));
-        close(clientSocket);
+        LOG_ERROR(Network, "epoll_ctl failed with error: %s", strerror(errno));
         return false;
     }
 
-    printf("Message sent: %s\n", messageBuffer);
-    printf("Bytes sent: %ld\n", sendReturnValue);
     return true;
 }
+
+void PhysicsServiceSocketServer::CloseClientConnection(int clientSocket)
+{
+    // Stop watching the socket and shutdown the connection since we're done
+    epoll_ctl(epollFileDescriptor, EPOLL_CTL_DEL, clientSocket, NULL);
+
+    const int shutdownResult = shutdown(clientSocket, SHUT_RDWR);
+    if (shutdownResult == -1 && errno != ENOTCONN) 
+    {
+        LOG_ERROR(Network, "Shutdown failed with error: %s", strerror(errno));
+    }
+
+    // Unsubscribe the client from its world's events and release its step
+    // authority, as its settings are destroyed with the connection. The 
+    // client may have set the step authority of any world (see 
+    // "SetStepAuthority"), not only of the one it steps
+    const auto clientConnectionIterator = clientConnections.find(clientSocket);
+    if(clientConnectionIterator != clientConnections.end())
+    {
+        ClientConnection& clientConnection = clientConnectionIterator->second;
+        if(PhysicsServiceImpl* clientWorld = 
+            physicsWorldHost.GetWorld(clientConnection.worldId))
+        {
+            clientWorld->RemoveActiveSetClient
+                (&clientConnection.settings.activeSet);
+        }
+
+        for(size_t worldId = 0; worldId < physicsWorldHost.GetWorldCount(); 
+            worldId++)
+        {
+            physicsWorldHost.GetWorld(static_cast<std::uint32_t>(worldId))
+                ->ReleaseStepAuthority(&clientConnection.settings);
+        }
+    }
+
+    // Clean up the client
+    close(clientSocket);
+    clientConnections.erase(clientSocket);
+
+    LOG_INFO(Network, "Client disconnected (socket: %d, connected clients: "
+        "%zu)", clientSocket, clientConnections.size());
+}
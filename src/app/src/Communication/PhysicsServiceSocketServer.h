@@ -6,16 +6,31 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <errno.h>
+#include <unordered_map>
+#include <vector>
+#include <string_view>
 #include "../PhysicsSimulation/PhysicsServiceImpl.h"
+#include "../PhysicsSimulation/PhysicsWorldHost.h"
+#include "ClientConnection.h"
 
 #define DEFAULT_BUFLEN 1048576
 
+#define MAX_EPOLL_EVENTS 64
+
 /** 
 * This class is responsible for opening a socket server. Thus, will act as the
 * physics service server. This will open the socket connection on the given
 * port and await client's messages. The received messages will be processed
 * and delegated to the physics system. Once the physics system process the
 * requested functionality, will send the client a response.
+*
+* The server runs a non-blocking epoll event loop, so it keeps the listen
+* socket open and serves several concurrent clients. Every client has its own
+* decode buffer and negotiated settings, but all of them share the same
+* (authoritative) physics worlds. The server hosts the config's "worldCount"
+* worlds (see "PhysicsWorldHost"), and each message is routed to the world of
+* its world ID (see MessageFraming). Only one client steps each world (see 
+* "SetStepAuthority"), the others are served its latest step.
 */
 class PhysicsServiceSocketServer
 {
@@ -30,19 +45,64 @@ public:
     * Opens the server socket. The server port to open the socket is given by
     * the param. 
     * 
-    * Moreover, this method will keep a loop to receive client's messages until
-    * he requests to close this server. The received messages will be processed
-    * and the requested functionality will be delegated to the physics service
-    * implementation.
+    * Moreover, this method will keep an event loop to accept client 
+    * connections and receive their messages. Clients may connect and 
+    * disconnect at any time, and the loop keeps running while they do. The 
+    * received messages will be processed and the requested functionality 
+    * will be delegated to the physics service implementation.
     * 
     * @param serverPort The port to open the server on
     * 
-    * @return True if could successfully open the socket on the given port and
-    * false otherwise.
+    * @return False if could not open the socket on the given port or if the
+    * event loop failed.
     */
     bool OpenServerSocket(const char* serverPort);
 
+    /** 
+    * Sets the config of the physics service. Must be called before running
+    * the service (see "RunDebugSimulation()" and "OpenServerSocket()").
+    * 
+    * @param newPhysicsServiceConfig The (validated) physics service config
+    */
+    void SetPhysicsServiceConfig
+        (const PhysicsServiceConfig& newPhysicsServiceConfig);
+
 private:
+    /** 
+    * Creates the hosted physics worlds and a message handler parser per 
+    * world, and registers every message handler on the parsers.
+    */
+    void InitializePhysicsService();
+
+    /** 
+    * Finds the message handler parser of a world.
+    * 
+    * @param worldId The world's ID
+    * 
+    * @return The world's message handler parser, or null if there is no 
+    * world with the given ID
+    */
+    class MessageHandlerParser* FindWorldMessageHandlerParser
+        (std::uint32_t worldId) const;
+
+    /** 
+    * Records the world a client's message is for. A connection steps one
+    * world at a time: the client's delta history (see "StateDeltaHistory"),
+    * active set (see "ClientActiveSet") and bodies inside its regions of 
+    * interest (see "ClientInterest") hold the state of a single world, so 
+    * they are reset when the client steps or initializes another world. 
+    * The regions themselves are kept. The client's step authority on the 
+    * old world is released. Any other message (e.g. "GetSimulationMeasures")
+    * is handled without changing the client's world.
+    * 
+    * @param clientConnection The client connection the message came from
+    * @param worldId The ID of the world the message is for
+    * @param opcode The message's opcode (see "EMessageOpcode"), or 0 if its
+    * type is unknown
+    */
+    void SelectClientWorld(ClientConnection& clientConnection, 
+        std::uint32_t worldId, std::uint16_t opcode);
+
     /** 
     * Creates a listen socket on the given addrinfo. This socket will await a
     * client connection
@@ -68,63 +128,167 @@ private:
         addrinfo* listenSocketAddrInfo);
     
     /** 
-    * Awaits client connection. This will stall the thread until a client
-    * connects to this physics socket server.
+    * Starts listening for client connections on the given listen socket. The
+    * listen socket is set as non-blocking, so it can be watched by the epoll
+    * event loop.
+    * 
+    * @param listenSocket The listen socket to start listening on
+    * 
+    * @return True if the socket is listening and false otherwise
+    */
+    bool StartListening(int listenSocket);
+
+    /** 
+    * Accepts every pending client connection on the listen socket. Each new
+    * client socket is set as non-blocking and added to the epoll instance.
+    * 
+    * @param listenSocket The listen socket with the pending connections
+    */
+    void AcceptPendingClientConnections(int listenSocket);
+
+    /** 
+    * Receives all the available data from a client and handles every 
+    * complete message on it. 
+    * 
+    * @param clientConnection The client connection to receive data from
+    * 
+    * @return False if the client closed the connection or if any error has
+    * occured while receiving, and true otherwise.
+    */
+    bool ReceiveMessagesFromClient(ClientConnection& clientConnection);
+
+    /** 
+    * Handles every complete message on the client's decoded message, sending
+    * the handler's responses to the client. Each message is decoded with the
+    * framing of the client's connection (see EMessageFraming).
+    * 
+    * @param clientConnection The client connection to handle messages from
+    * 
+    * @return False if could not send a response to the client and true
+    * otherwise.
+    */
+    bool HandleReceivedMessages(ClientConnection& clientConnection);
+
+    /** 
+    * Handles the next delimited message (i.e. that reached the "MessageEnd" 
+    * flag) on the given pending data, if it is complete. The "MessageEnd"
+    * flag is only searched on the data not scanned by a previous call.
     * 
-    * @param listenSocket The listen socket to await connection
+    * @param clientConnection The client connection to handle the message from
+    * @param pendingData The client's decoded data not handled yet
+    * @param outHandledMessageLength The length of the handled message, or 0
+    * if there is no complete message on the pending data
     * 
-    * @return The connected client's socket for communication and -1 if any
-    * error has occured while connecting to client
+    * @return False if could not send a response to the client and true
+    * otherwise.
     */
-    int AwaitClientConnection(int listenSocket);
+    bool HandleNextDelimitedMessage(ClientConnection& clientConnection, 
+        std::string_view pendingData, size_t& outHandledMessageLength);
 
     /** 
-    * Awaits the receival of a client's message. This will call the socket's 
-    * "recv" method to await any client's message.
+    * Handles the next frame on the given pending data, if it is complete.
     * 
-    * @param clientSocket The client's connected socket to await messages on
-    * @param receivingBuffer The buffer to store the received client's messages
-    * @param receivingBufferLength The buffer's length to received the client's
-    * messages
+    * @param clientConnection The client connection to handle the frame from
+    * @param pendingData The client's decoded data not handled yet
+    * @param outHandledMessageLength The length of the handled frame, or 0 if
+    * there is no complete frame on the pending data
     * 
-    * @return The number of bytes received on the client's message.
+    * @return False if the frame is invalid or if could not send a response
+    * to the client and true otherwise.
+    * 
+    * @see MessageFraming
     */
-    ssize_t ReceiveMessageFromClient(int clientSocket, char* receivingBuffer, 
-        int receivingBufferLength);
+    bool HandleNextFramedMessage(ClientConnection& clientConnection, 
+        std::string_view pendingData, size_t& outHandledMessageLength);
     
     /** 
-    * Sends a message to the client. 
+    * Sends a message to the client. The message is queued on the client's
+    * pending send buffer and sent as far as the socket allows. The remaining
+    * data is sent once the socket is writable again.
     * 
-    * @param clientSocket The connected client's socket to send the message to
-    * @param messageToSend The message to send the client
+    * @param clientConnection The connected client to send the message to
+    * @param messageToSend The message to send the client. It is copied once,
+    * straight into the client's pending send buffer
+    * @param messageFraming The framing to send the message with
+    * @param responseOpcode The opcode on the frame header. Only used on
+    * "Framed" framing
+    * @param responseWorldId The world ID on the frame header. Only used on
+    * "Framed" framing
+    * @param serverTimeNanoseconds The time the server took to handle the
+    * message, sent before the response (see MessageFraming), or -1 if the 
+    * response has no server time
     * 
-    * @return True if could successfully send the message to the client and
-    * false otherwise
+    * @return True if could successfully send (or queue) the message to the
+    * client and false otherwise
     */
-    bool SendMessageToClient(int clientSocket, std::string& messageToSend);
+    bool SendMessageToClient(ClientConnection& clientConnection, 
+        std::string_view messageToSend, EMessageFraming messageFraming,
+        std::uint16_t responseOpcode, std::uint16_t responseWorldId,
+        std::int64_t serverTimeNanoseconds = -1);
+
+    /** 
+    * Sends the client's pending send buffer until it is empty or the socket
+    * can't take more data. The client socket is watched for writability on
+    * the epoll instance while there is pending data.
+    * 
+    * @param clientConnection The connected client to send the pending data to
+    * 
+    * @return True if no error has occured while sending and false otherwise
+    */
+    bool FlushPendingSendBuffer(ClientConnection& clientConnection);
+
+    /** 
+    * Closes a client connection, removing it from the epoll instance and 
+    * from the connected clients.
+    * 
+    * @param clientSocket The client's socket to close
+    */
+    void CloseClientConnection(int clientSocket);
 
     /** Saves the step physics measurement to a file. */
     void SaveStepPhysicsMeasureToFile();
 
 private:
     /** 
-    * The physics system implementation. This implement the JoltPhysics that
-    * will initialize and update a physics world for this server
+    * The host of the physics worlds. Each world is a physics service 
+    * implementation, which implements the JoltPhysics that will initialize
+    * and update a physics world for this server
     */
-    PhysicsServiceImpl* physicsServiceImplementation = nullptr;
+    PhysicsWorldHost physicsWorldHost;
+
+    /** The config given to the physics service implementations */
+    PhysicsServiceConfig physicsServiceConfig;
+
+    /** 
+    * The physics service message handler parsers, by world ID. Each parser 
+    * is responsible for interperting and handling the incoming messages of
+    * its world. Will call the proper functionality.
+    */
+    std::vector<class MessageHandlerParser*> worldMessageHandlerParsers;
+
+    /** 
+    * The connected clients, by their socket. Each client has its own decode
+    * buffer and negotiated settings.
+    */
+    std::unordered_map<int, ClientConnection> clientConnections;
+
+    /** The epoll instance watching the listen and client sockets */
+    int epollFileDescriptor = -1;
 
     /** 
-    * The physics service message handler parser. This class is responsible
-    * for interperting and handling the incoming messages. Will call the proper 
-    * functionality.
+    * The buffer to receive the client's data on. Shared by every client, as 
+    * the data is appended to the client's decoded message right after it is
+    * received.
     */
-    class MessageHandlerParser* physicsServiceMessageHandlerParser = nullptr;
+    std::vector<char> receivingBuffer;
 
     /** 
-    * The current decoded message. This is the current message received from
-    * the client connected to this server.
+    * The buffer the handlers' responses may be written into. Shared by every
+    * client, as each response is queued on the client's pending send buffer
+    * right after it is handled. The step responses are not written here, as
+    * they are already on the physics service's reusable buffers.
     */
-    std::string decodedMessage = "";
+    std::string messageResponseBuffer;
 };
 
 #endif
@@ -1,23 +1,83 @@
 #include "Communication/PhysicsServiceSocketServer.h"
+#include "Logging/ServiceLogger.h"
+#include <cstdlib>
 
 int main(int argc, char** argv) 
 {
+    // Set the runtime log level (e.g. "debug") from the environment, if given
+    if(const char* logLevelName = std::getenv("JOLTSERVICE_LOG_LEVEL"))
+    {
+        ELogLevel logLevel {};
+        if(ServiceLogger::ParseLevel(logLevelName, logLevel))
+        {
+            ServiceLogger::SetLevel(logLevel);
+        }
+        else
+        {
+            LOG_WARNING(Network, "Unknown log level: %s", logLevelName);
+        }
+    }
+
+    // Set the log rate limit (records per category per second, 0 for no 
+    // limit) from the environment, if given
+    if(const char* logRateLimit = std::getenv("JOLTSERVICE_LOG_RATE_LIMIT"))
+    {
+        ServiceLogger::Get().SetMaxRecordsPerSecond
+            (static_cast<std::uint32_t>(std::strtoul(logRateLimit, nullptr, 
+            10)));
+    }
+
+    // Load the physics service config from the command line ("--key=value"
+    // and "--config=<file>" arguments) and validate it before anything runs
+    PhysicsServiceConfig physicsServiceConfig;
+    std::string physicsServiceConfigError;
+    if(!physicsServiceConfig.LoadFromCommandLine(argc, argv, 
+        physicsServiceConfigError) 
+        || !physicsServiceConfig.Validate(physicsServiceConfigError))
+    {
+        LOG_ERROR(Network, "Invalid physics service config: %s", 
+            physicsServiceConfigError.c_str());
+        return 1;
+    }
+
+    LOG_INFO(Network, "%s", 
+        physicsServiceConfig.GetMemoryFootprintReport().c_str());
+
+    // Isolate the network thread (which also updates the physics system) on
+    // its own CPU. The physics workers skip it
+    if(physicsServiceConfig.networkThreadCpu >= 0 
+        && !WorkStealingJobSystem::SetCurrentThreadAffinity
+        (physicsServiceConfig.networkThreadCpu))
+    {
+        LOG_WARNING(Network, "Could not pin the network thread to CPU %d.", 
+            physicsServiceConfig.networkThreadCpu);
+    }
+
     // Open socket acting as a server socket
     // The proxy will await for the game's connection on him
     PhysicsServiceSocketServer* PhysicsServiceServer = 
         new PhysicsServiceSocketServer();
     if(!PhysicsServiceServer)
     {
-        printf("Error when creating socket server.\n");
+        LOG_ERROR(Network, "Error when creating socket server.");
         return 0;
     }
+
+    PhysicsServiceServer->SetPhysicsServiceConfig(physicsServiceConfig);
+
+    // Get the first command arg that is not a config option
+    const char* firstCommandArg = nullptr;
+    for(int i = 1; i < argc && !firstCommandArg; i++)
+    {
+        if(strncmp(argv[i], "--", 2) != 0)
+        {
+            firstCommandArg = argv[i];
+        }
+    }
     
     // Check if there are additional command arguments
-    if(argc > 1)
+    if(firstCommandArg)
     {
-        // Get the first command arg
-        const auto firstCommandArg = argv[1];
-
         // Check if command is "nosocket"
         if(strcmp(firstCommandArg, "nosocket") == 0)
         {
@@ -28,7 +88,7 @@ int main(int argc, char** argv)
             return 0;
         }
 
-        std::cout << "Opening physics service...\n";
+        LOG_INFO(Network, "Opening physics service...");
 
         // Else, the first command should be the server port
         // Open server socket to listen for client's (game) connection
@@ -38,15 +98,17 @@ int main(int argc, char** argv)
         // Check for errors
         if(!bWasSocketConnectionSuccess)
         {
-            printf("Could not open socket connection. Check logs.\n");
+            LOG_ERROR(Network, "Could not open socket connection. Check "
+                "logs.");
             return 0;
         }
 
         return 0;
     }
 
-    std::cout 
-        << "The command should have at least one argument. Either the server's port or \"nosocket\"";
+    LOG_ERROR(Network, "The command should have at least one argument. Either "
+        "the server's port or \"nosocket\", optionally followed by config "
+        "options (\"--config=<file>\" or \"--key=value\")");
 
     return 0;
 }
@@ -0,0 +1,331 @@
+#include "ServiceLogger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+
+namespace
+{
+    /** The name of each level, as written on the records */
+    const char* const logLevelNames[] = 
+        { "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "OFF" };
+
+    /** The name of each category, as written on the records */
+    const char* const logCategoryNames[] = 
+        { "Physics", "Network", "Messages" };
+
+    /** The time the logger's thread sleeps when there is nothing to write */
+    constexpr std::chrono::milliseconds writerIdleSleepTime { 2 };
+}
+
+std::atomic<std::uint8_t> ServiceLogger::categoryLevels
+    [static_cast<size_t>(ELogCategory::Count)] = 
+{
+    { static_cast<std::uint8_t>(ELogLevel::Info) },
+    { static_cast<std::uint8_t>(ELogLevel::Info) },
+    { static_cast<std::uint8_t>(ELogLevel::Info) }
+};
+
+ServiceLogger& ServiceLogger::Get()
+{
+    static ServiceLogger logger;
+    return logger;
+}
+
+ServiceLogger::ServiceLogger()
+    : records(new LogRecord[ringBufferCapacity]),
+    startTime(std::chrono::steady_clock::now())
+{
+    static_assert((ringBufferCapacity & (ringBufferCapacity - 1)) == 0, 
+        "The ring buffer's capacity must be a power of 2");
+
+    // Every slot starts free for the position with its index
+    for(size_t i = 0; i < ringBufferCapacity; i++)
+    {
+        records[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    writerThread = std::thread(&ServiceLogger::RunWriterLoop, this);
+}
+
+ServiceLogger::~ServiceLogger()
+{
+    bShouldStop.store(true, std::memory_order_release);
+    if(writerThread.joinable())
+    {
+        writerThread.join();
+    }
+}
+
+void ServiceLogger::SetLevel(ELogLevel level)
+{
+    for(auto& categoryLevel : categoryLevels)
+    {
+        categoryLevel.store(static_cast<std::uint8_t>(level), 
+            std::memory_order_relaxed);
+    }
+}
+
+void ServiceLogger::SetCategoryLevel(ELogCategory category, ELogLevel level)
+{
+    categoryLevels[static_cast<size_t>(category)].store
+        (static_cast<std::uint8_t>(level), std::memory_order_relaxed);
+}
+
+bool ServiceLogger::ParseLevel(const char* levelName, ELogLevel& outLevel)
+{
+    for(size_t i = 0; i < sizeof(logLevelNames) / sizeof(logLevelNames[0]); 
+        i++)
+    {
+        if(strcasecmp(levelName, logLevelNames[i]) == 0)
+        {
+            outLevel = static_cast<ELogLevel>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ServiceLogger::SetMaxRecordsPerSecond(std::uint32_t inMaxRecordsPerSecond)
+{
+    maxRecordsPerSecond.store(inMaxRecordsPerSecond, 
+        std::memory_order_relaxed);
+}
+
+void ServiceLogger::Log(ELogLevel level, ELogCategory category, 
+    const char* format, ...)
+{
+    const std::uint64_t nowMicroseconds = GetNowMicroseconds();
+    if(!ConsumeRateLimit(category, nowMicroseconds))
+    {
+        return;
+    }
+
+    va_list formatArgs;
+    va_start(formatArgs, format);
+    const bool bWasPushed = TryPushRecord(level, category, nowMicroseconds, 
+        format, formatArgs);
+    va_end(formatArgs);
+
+    if(!bWasPushed)
+    {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ServiceLogger::Flush()
+{
+    // Wait until the logger's thread has drained every claimed position
+    const size_t positionToFlush = 
+        enqueuePosition.load(std::memory_order_acquire);
+    while(dequeuePosition.load(std::memory_order_acquire) < positionToFlush
+        && writerThread.joinable())
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    std::fflush(stdout);
+}
+
+bool ServiceLogger::ConsumeRateLimit(ELogCategory category, 
+    std::uint64_t nowMicroseconds)
+{
+    const std::uint32_t maxRecords = 
+        maxRecordsPerSecond.load(std::memory_order_relaxed);
+    if(maxRecords == 0)
+    {
+        return true;
+    }
+
+    CategoryRateLimit& rateLimit = 
+        categoryRateLimits[static_cast<size_t>(category)];
+
+    // Start a new second if needed. Only the thread that wins the exchange 
+    // resets the counters and reports the suppressed records
+    const std::uint64_t nowSecond = nowMicroseconds / 1000000;
+    std::uint64_t currentSecond = 
+        rateLimit.currentSecond.load(std::memory_order_relaxed);
+    if(nowSecond != currentSecond && rateLimit.currentSecond
+        .compare_exchange_strong(currentSecond, nowSecond, 
+        std::memory_order_relaxed))
+    {
+        rateLimit.recordsOnCurrentSecond.store(0, std::memory_order_relaxed);
+
+        const std::uint32_t suppressedRecords = 
+            rateLimit.suppressedRecords.exchange(0, std::memory_order_relaxed);
+        if(suppressedRecords > 0)
+        {
+            TryPushRecordf(ELogLevel::Warning, category, nowMicroseconds, 
+                "%u records suppressed by the rate limit (%u per second)", 
+                suppressedRecords, maxRecords);
+        }
+    }
+
+    if(rateLimit.recordsOnCurrentSecond.fetch_add(1, 
+        std::memory_order_relaxed) >= maxRecords)
+    {
+        rateLimit.suppressedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+bool ServiceLogger::TryPushRecord(ELogLevel level, ELogCategory category, 
+    std::uint64_t timestampMicroseconds, const char* format, 
+    va_list formatArgs)
+{
+    // Claim a slot. A slot is free for position "p" when its sequence is "p"
+    // and holds the record of position "p" when its sequence is "p + 1"
+    LogRecord* record = nullptr;
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    while(true)
+    {
+        record = &records[position & (ringBufferCapacity - 1)];
+        const size_t sequence = 
+            record->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t sequenceDifference = 
+            static_cast<std::ptrdiff_t>(sequence) 
+            - static_cast<std::ptrdiff_t>(position);
+
+        if(sequenceDifference == 0)
+        {
+            if(enqueuePosition.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(sequenceDifference < 0)
+        {
+            // The slot still holds a record not drained, the buffer is full
+            return false;
+        }
+        else
+        {
+            // Another producer claimed this position
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->level = level;
+    record->category = category;
+    record->timestampMicroseconds = timestampMicroseconds;
+
+    const int formattedLength = 
+        vsnprintf(record->text, recordTextCapacity, format, formatArgs);
+    record->textLength = formattedLength < 0 ? 0 : static_cast<std::uint32_t>
+        (std::min<size_t>(formattedLength, recordTextCapacity - 1));
+
+    // Mark the truncated records
+    if(formattedLength >= static_cast<int>(recordTextCapacity))
+    {
+        std::memcpy(record->text + recordTextCapacity - 4, "...", 3);
+    }
+
+    // Publish the record
+    record->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool ServiceLogger::TryPushRecordf(ELogLevel level, ELogCategory category, 
+    std::uint64_t timestampMicroseconds, const char* format, ...)
+{
+    va_list formatArgs;
+    va_start(formatArgs, format);
+    const bool bWasPushed = TryPushRecord(level, category, 
+        timestampMicroseconds, format, formatArgs);
+    va_end(formatArgs);
+
+    return bWasPushed;
+}
+
+size_t ServiceLogger::DrainRecords(std::string& outBatch)
+{
+    size_t drainedRecordsAmount = 0;
+    size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    while(true)
+    {
+        LogRecord& record = records[position & (ringBufferCapacity - 1)];
+        if(record.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            // Not published yet
+            break;
+        }
+
+        // Write the record as "[seconds.micros][LEVEL][Category] text\n"
+        char recordPrefix[64];
+        const int recordPrefixLength = snprintf(recordPrefix, 
+            sizeof(recordPrefix), "[%llu.%06llu][%s][%s] ", 
+            static_cast<unsigned long long>
+            (record.timestampMicroseconds / 1000000),
+            static_cast<unsigned long long>
+            (record.timestampMicroseconds % 1000000),
+            logLevelNames[static_cast<size_t>(record.level)],
+            logCategoryNames[static_cast<size_t>(record.category)]);
+        outBatch.append(recordPrefix, recordPrefixLength);
+        outBatch.append(record.text, record.textLength);
+        outBatch.push_back('\n');
+
+        // Free the slot for the position one lap ahead
+        record.sequence.store(position + ringBufferCapacity, 
+            std::memory_order_release);
+
+        position++;
+        drainedRecordsAmount++;
+        dequeuePosition.store(position, std::memory_order_release);
+    }
+
+    return drainedRecordsAmount;
+}
+
+void ServiceLogger::RunWriterLoop()
+{
+    std::string batch;
+    std::uint64_t reportedDroppedRecords = 0;
+
+    while(true)
+    {
+        const bool bWasStopRequested = 
+            bShouldStop.load(std::memory_order_acquire);
+
+        batch.clear();
+        const size_t drainedRecordsAmount = DrainRecords(batch);
+
+        // Report the records dropped because the buffer was full
+        const std::uint64_t currentDroppedRecords = 
+            droppedRecords.load(std::memory_order_relaxed);
+        if(currentDroppedRecords != reportedDroppedRecords)
+        {
+            batch += "[WARNING] " + std::to_string(currentDroppedRecords 
+                - reportedDroppedRecords) + " log records dropped (ring "
+                "buffer full)\n";
+            reportedDroppedRecords = currentDroppedRecords;
+        }
+
+        if(!batch.empty())
+        {
+            std::fwrite(batch.data(), 1, batch.size(), stdout);
+            std::fflush(stdout);
+        }
+
+        // The stop is only honored once everything logged before it is out
+        if(bWasStopRequested && drainedRecordsAmount == 0)
+        {
+            return;
+        }
+
+        if(drainedRecordsAmount == 0)
+        {
+            std::this_thread::sleep_for(writerIdleSleepTime);
+        }
+    }
+}
+
+std::uint64_t ServiceLogger::GetNowMicroseconds() const
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast
+        <std::chrono::microseconds>(std::chrono::steady_clock::now() 
+        - startTime).count());
+}
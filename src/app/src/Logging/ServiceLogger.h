@@ -0,0 +1,322 @@
+#ifndef SERVICELOGGER_H
+#define SERVICELOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+
+/** 
+* The log levels, from the most to the least verbose. A record is only logged
+* if its level is at least the compile time level (see 
+* "SERVICE_LOG_COMPILE_LEVEL") and the runtime level of its category.
+*/
+enum class ELogLevel : std::uint8_t
+{
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4,
+    Off = 5
+};
+
+/** 
+* The log categories. Each category has its own runtime level and rate limit,
+* so e.g. the network traces can be enabled without the physics ones.
+*/
+enum class ELogCategory : std::uint8_t
+{
+    /** The physics simulation (PhysicsSimulation/) */
+    Physics = 0,
+
+    /** The socket server (i.e. connections, sent and received data) */
+    Network = 1,
+
+    /** The message handlers and parser */
+    Messages = 2,
+
+    /** The amount of categories. Not a category */
+    Count = 3
+};
+
+/** 
+* The minimum level compiled in. The records with a lower level are compiled
+* out, so their arguments are not even evaluated. The distribution builds set
+* this to "Info" (see the CMakeLists).
+*/
+#ifndef SERVICE_LOG_COMPILE_LEVEL
+#define SERVICE_LOG_COMPILE_LEVEL 0
+#endif
+
+/** 
+* Logs a printf-style record on the given level and category. The record is
+* formatted on the calling thread into a slot of the logger's ring buffer and
+* written to stdout by the logger's thread. A trailing new line is added to
+* every record.
+*/
+#define SERVICE_LOG(level, category, ...)                                     \
+    do                                                                        \
+    {                                                                         \
+        if constexpr (static_cast<int>(level) >= SERVICE_LOG_COMPILE_LEVEL)   \
+        {                                                                     \
+            if (ServiceLogger::IsEnabled(level, category))                    \
+            {                                                                 \
+                ServiceLogger::Get().Log(level, category, __VA_ARGS__);       \
+            }                                                                 \
+        }                                                                     \
+    } while (0)
+
+/** 
+* Checks if a level is logged on a category, on both the compile time and the
+* runtime levels. Used to skip gathering data that is only logged.
+*/
+#define SERVICE_LOG_IS_ENABLED(level, category)                               \
+    (static_cast<int>(level) >= SERVICE_LOG_COMPILE_LEVEL                     \
+        && ServiceLogger::IsEnabled(level, category))
+
+#define LOG_TRACE(category, ...) \
+    SERVICE_LOG(ELogLevel::Trace, ELogCategory::category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) \
+    SERVICE_LOG(ELogLevel::Debug, ELogCategory::category, __VA_ARGS__)
+#define LOG_INFO(category, ...) \
+    SERVICE_LOG(ELogLevel::Info, ELogCategory::category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) \
+    SERVICE_LOG(ELogLevel::Warning, ELogCategory::category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) \
+    SERVICE_LOG(ELogLevel::Error, ELogCategory::category, __VA_ARGS__)
+
+/** 
+* The service's asynchronous logger. The threads that log (the service's 
+* thread, the physics jobs, the pipelined update worker) never block on 
+* stdout: each record is formatted into a slot of a bounded lock-free ring
+* buffer, and a background thread drains the buffer into stdout in batches.
+* If the ring buffer is full, the record is dropped and counted, so a burst of
+* logs never stalls the simulation.
+*
+* Each category is rate limited to a maximum amount of records per second.
+* The records over the limit are dropped, and the amount of suppressed records
+* is logged once the next second starts.
+*
+* Use the "LOG_*" macros instead of calling "Log()" directly, so the records
+* under the compile time level are compiled out and the disabled records cost
+* a single relaxed atomic load.
+*/
+class ServiceLogger
+{
+public:
+    /** The maximum length of a record's text. Longer texts are truncated */
+    static constexpr size_t recordTextCapacity = 480;
+
+    /** The amount of records the ring buffer holds. Must be a power of 2 */
+    static constexpr size_t ringBufferCapacity = 4096;
+
+    /** The default maximum amount of records per category per second */
+    static constexpr std::uint32_t defaultMaxRecordsPerSecond = 2000;
+
+public:
+    /** @return The logger. The logger's thread is started on the first call */
+    static ServiceLogger& Get();
+
+    /** 
+    * Checks if a record should be logged on the runtime levels.
+    * 
+    * @param level The record's level
+    * @param category The record's category
+    * 
+    * @return True if the level is at least the category's runtime level
+    */
+    static bool IsEnabled(ELogLevel level, ELogCategory category)
+    {
+        return static_cast<std::uint8_t>(level) >= categoryLevels
+            [static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    /** 
+    * Clamps the length of a text logged with "%.*s" to the record's 
+    * capacity. This keeps the formatting cost bounded when logging big texts
+    * (e.g. a whole message), as they are truncated anyway.
+    * 
+    * @param textLength The text's length
+    * 
+    * @return The length to pass as the "%.*s" precision
+    */
+    static int ClampTextLength(size_t textLength)
+    {
+        return static_cast<int>(textLength < recordTextCapacity 
+            ? textLength : recordTextCapacity);
+    }
+
+    /** 
+    * Sets the runtime level of every category.
+    * 
+    * @param level The minimum level to log
+    */
+    static void SetLevel(ELogLevel level);
+
+    /** 
+    * Sets the runtime level of a category.
+    * 
+    * @param category The category to set the level of
+    * @param level The minimum level to log on the category
+    */
+    static void SetCategoryLevel(ELogCategory category, ELogLevel level);
+
+    /** 
+    * Parses a level name ("trace", "debug", "info", "warning", "error" or 
+    * "off").
+    * 
+    * @param levelName The level name to parse
+    * @param outLevel The parsed level
+    * 
+    * @return True if the level name is known and false otherwise
+    */
+    static bool ParseLevel(const char* levelName, ELogLevel& outLevel);
+
+    /** 
+    * Sets the maximum amount of records logged per category per second.
+    * 
+    * @param maxRecordsPerSecond The maximum records per second. Zero 
+    * disables the rate limiting
+    */
+    void SetMaxRecordsPerSecond(std::uint32_t maxRecordsPerSecond);
+
+    /** 
+    * Logs a printf-style record. Prefer the "LOG_*" macros.
+    * 
+    * @param level The record's level
+    * @param category The record's category
+    * @param format The printf-style format of the record's text
+    */
+    void Log(ELogLevel level, ELogCategory category, const char* format, ...)
+        __attribute__((format(printf, 4, 5)));
+
+    /** 
+    * Blocks until every record logged so far was written to stdout. Used 
+    * before the process may stop abruptly (e.g. on a failed assert).
+    */
+    void Flush();
+
+    /** Writes every pending record and stops the logger's thread */
+    ~ServiceLogger();
+
+private:
+    /** A slot on the ring buffer */
+    struct LogRecord
+    {
+        /** 
+        * The slot's sequence. Tells the producers and the consumer if the
+        * slot is free or holds a record (see "TryPushRecord()")
+        */
+        std::atomic<size_t> sequence { 0 };
+
+        ELogLevel level = ELogLevel::Info;
+        ELogCategory category = ELogCategory::Physics;
+
+        /** The time the record was logged, since the logger started */
+        std::uint64_t timestampMicroseconds = 0;
+
+        /** The length of "text" */
+        std::uint32_t textLength = 0;
+
+        char text[recordTextCapacity];
+    };
+
+    /** A category's rate limit state for the current second */
+    struct CategoryRateLimit
+    {
+        /** The second (since the logger started) the counters refer to */
+        std::atomic<std::uint64_t> currentSecond { 0 };
+
+        /** The amount of records logged on the current second */
+        std::atomic<std::uint32_t> recordsOnCurrentSecond { 0 };
+
+        /** The amount of records dropped on the current second */
+        std::atomic<std::uint32_t> suppressedRecords { 0 };
+    };
+
+private:
+    ServiceLogger();
+
+    /** 
+    * Checks the category's rate limit, starting a new second if needed.
+    * 
+    * @param category The record's category
+    * @param nowMicroseconds The current time, since the logger started
+    * 
+    * @return True if the record may be logged and false if it is over the
+    * category's limit
+    */
+    bool ConsumeRateLimit(ELogCategory category, 
+        std::uint64_t nowMicroseconds);
+
+    /** 
+    * Claims a slot on the ring buffer and formats a record into it. This is
+    * lock-free: a producer claims a slot with a compare and swap on the 
+    * enqueue position, and publishes the record by setting the slot's 
+    * sequence.
+    * 
+    * @return False if the ring buffer is full and true otherwise
+    */
+    bool TryPushRecord(ELogLevel level, ELogCategory category, 
+        std::uint64_t timestampMicroseconds, const char* format, 
+        va_list formatArgs);
+
+    /** @see TryPushRecord */
+    bool TryPushRecordf(ELogLevel level, ELogCategory category, 
+        std::uint64_t timestampMicroseconds, const char* format, ...)
+        __attribute__((format(printf, 5, 6)));
+
+    /** 
+    * Writes every published record to the given batch, freeing their slots.
+    * 
+    * @return The amount of records drained
+    */
+    size_t DrainRecords(std::string& outBatch);
+
+    /** The logger's thread loop. Drains the ring buffer into stdout */
+    void RunWriterLoop();
+
+    /** @return The current time, since the logger started */
+    std::uint64_t GetNowMicroseconds() const;
+
+private:
+    /** The runtime level of each category */
+    static std::atomic<std::uint8_t> 
+        categoryLevels[static_cast<size_t>(ELogCategory::Count)];
+
+    /** The ring buffer's slots */
+    std::unique_ptr<LogRecord[]> records;
+
+    /** The next position producers claim. Only grows */
+    alignas(64) std::atomic<size_t> enqueuePosition { 0 };
+
+    /** The next position the logger's thread drains. Only grows */
+    alignas(64) std::atomic<size_t> dequeuePosition { 0 };
+
+    /** The amount of records dropped because the ring buffer was full */
+    std::atomic<std::uint64_t> droppedRecords { 0 };
+
+    /** The rate limit state of each category */
+    CategoryRateLimit 
+        categoryRateLimits[static_cast<size_t>(ELogCategory::Count)];
+
+    /** The maximum amount of records per category per second (0: no limit) */
+    std::atomic<std::uint32_t> maxRecordsPerSecond 
+        { defaultMaxRecordsPerSecond };
+
+    /** The time the logger started */
+    std::chrono::steady_clock::time_point startTime;
+
+    /** Flag that asks the logger's thread to exit */
+    std::atomic<bool> bShouldStop { false };
+
+    /** The logger's thread */
+    std::thread writerThread;
+};
+
+#endif
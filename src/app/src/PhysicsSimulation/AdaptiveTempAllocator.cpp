@@ -0,0 +1,253 @@
+#include "AdaptiveTempAllocator.h"
+#include "../Logging/ServiceLogger.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <Jolt/Core/Memory.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /** The huge page size mapped when huge pages are used */
+    constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    /** The page size used where it can not be queried */
+    constexpr std::size_t defaultPageSize = 4096;
+
+    /** @return The size rounded up to the alignment (a power of 2) */
+    std::size_t AlignSizeUp(std::size_t size, std::size_t alignment)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    /** @return The size in MiB, for the reports */
+    double ToMebibytes(std::size_t sizeInBytes)
+    {
+        return static_cast<double>(sizeInBytes) / (1024.0 * 1024.0);
+    }
+}
+
+AdaptiveTempAllocator::AdaptiveTempAllocator(const Settings& settings)
+    : settings(settings)
+{
+    MapBuffer(std::clamp(settings.initialCapacity, settings.minCapacity,
+        settings.maxCapacity));
+}
+
+AdaptiveTempAllocator::~AdaptiveTempAllocator()
+{
+    UnmapBuffer();
+}
+
+void* AdaptiveTempAllocator::Allocate(uint size)
+{
+    if(size == 0)
+    {
+        return nullptr;
+    }
+
+    const std::size_t alignedSize = AlignSizeUp(size, JPH_RVECTOR_ALIGNMENT);
+
+    void* address = nullptr;
+    if(bufferTop + alignedSize <= bufferCapacity)
+    {
+        address = buffer + bufferTop;
+        bufferTop += alignedSize;
+    }
+    else
+    {
+        // Fall back to the heap. The buffer grows after the step, so the
+        // next steps fit
+        address = AlignedAllocate(alignedSize, JPH_RVECTOR_ALIGNMENT);
+        overflowUsage += alignedSize;
+        overflowCount++;
+    }
+
+    currentStepPeakUsage = std::max(currentStepPeakUsage,
+        bufferTop + overflowUsage);
+
+    return address;
+}
+
+void AdaptiveTempAllocator::Free(void* address, uint size)
+{
+    if(address == nullptr)
+    {
+        return;
+    }
+
+    const std::size_t alignedSize = AlignSizeUp(size, JPH_RVECTOR_ALIGNMENT);
+
+    if(IsOnBuffer(address))
+    {
+        // The allocations are freed in reverse order, as on a stack
+        bufferTop -= alignedSize;
+    }
+    else
+    {
+        AlignedFree(address);
+        overflowUsage -= alignedSize;
+    }
+}
+
+void AdaptiveTempAllocator::OnStepFinished()
+{
+    lastStepPeakUsage = currentStepPeakUsage;
+    highWaterMark = std::max(highWaterMark, lastStepPeakUsage);
+    currentStepPeakUsage = bufferTop + overflowUsage;
+
+    // The buffer can only be remapped with every allocation freed
+    if(bufferTop != 0 || overflowUsage != 0)
+    {
+        return;
+    }
+
+    const std::size_t growUsage = static_cast<std::size_t>
+        (static_cast<double>(bufferCapacity) * settings.growThreshold);
+
+    // Grow to twice the peak usage, so the next peaks fit with room to
+    // spare
+    if(lastStepPeakUsage >= growUsage && bufferCapacity < settings.maxCapacity)
+    {
+        const std::size_t oldCapacity = bufferCapacity;
+        MapBuffer(std::min(std::max(lastStepPeakUsage, bufferCapacity) * 2,
+            settings.maxCapacity));
+
+        growCount++;
+        lowUsageStepCount = 0;
+        cooldownPeakUsage = 0;
+
+        LOG_INFO(Physics, "Temp allocator grew from %.1f MiB to %.1f MiB "
+            "(step peak usage %.1f MiB).", ToMebibytes(oldCapacity),
+            ToMebibytes(bufferCapacity), ToMebibytes(lastStepPeakUsage));
+        return;
+    }
+
+    // Shrink once the peak usage stayed under a quarter of the capacity for
+    // the whole cool-down
+    if(settings.shrinkCooldownSteps == 0
+        || lastStepPeakUsage >= bufferCapacity / 4
+        || bufferCapacity <= settings.minCapacity)
+    {
+        lowUsageStepCount = 0;
+        cooldownPeakUsage = 0;
+        return;
+    }
+
+    cooldownPeakUsage = std::max(cooldownPeakUsage, lastStepPeakUsage);
+    if(++lowUsageStepCount < settings.shrinkCooldownSteps)
+    {
+        return;
+    }
+
+    const std::size_t oldCapacity = bufferCapacity;
+    const std::size_t shrunkCapacity = std::max(cooldownPeakUsage * 2,
+        settings.minCapacity);
+
+    // Rounding up to the pages may leave the capacity as it is
+    if(shrunkCapacity < bufferCapacity)
+    {
+        MapBuffer(shrunkCapacity);
+    }
+
+    if(bufferCapacity < oldCapacity)
+    {
+        shrinkCount++;
+
+        LOG_INFO(Physics, "Temp allocator shrank from %.1f MiB to %.1f MiB "
+            "(cool-down peak usage %.1f MiB).", ToMebibytes(oldCapacity),
+            ToMebibytes(bufferCapacity), ToMebibytes(cooldownPeakUsage));
+    }
+
+    lowUsageStepCount = 0;
+    cooldownPeakUsage = 0;
+}
+
+std::string AdaptiveTempAllocator::GetStatsReport() const
+{
+    char report[256];
+    std::snprintf(report, sizeof(report), "Temp allocator: %.1f MiB capacity"
+        "%s, last step peak %.1f MiB, high-water mark %.1f MiB, %llu "
+        "overflows, grew %u times, shrank %u times.",
+        ToMebibytes(bufferCapacity),
+        bIsBufferOnHugePages ? " (huge pages)" : "",
+        ToMebibytes(lastStepPeakUsage), ToMebibytes(highWaterMark),
+        static_cast<unsigned long long>(overflowCount), growCount,
+        shrinkCount);
+
+    return report;
+}
+
+void AdaptiveTempAllocator::MapBuffer(std::size_t newCapacity)
+{
+    UnmapBuffer();
+
+#ifdef __linux__
+    void* mappedAddress = MAP_FAILED;
+    std::size_t mappedSize = 0;
+
+    // Explicit huge pages only map if the system reserved them
+    if(settings.bUseHugePages)
+    {
+        mappedSize = AlignSizeUp(newCapacity, hugePageSize);
+        mappedAddress = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        bIsBufferOnHugePages = mappedAddress != MAP_FAILED;
+    }
+
+    if(mappedAddress == MAP_FAILED)
+    {
+        const long systemPageSize = sysconf(_SC_PAGESIZE);
+        const std::size_t pageSize = systemPageSize > 0
+            ? static_cast<std::size_t>(systemPageSize) : defaultPageSize;
+
+        mappedSize = AlignSizeUp(newCapacity, pageSize);
+        mappedAddress = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        // Otherwise, ask for transparent huge pages (best effort)
+        if(mappedAddress != MAP_FAILED && settings.bUseHugePages)
+        {
+            madvise(mappedAddress, mappedSize, MADV_HUGEPAGE);
+        }
+    }
+
+    if(mappedAddress == MAP_FAILED)
+    {
+        LOG_ERROR(Physics, "Could not map a %.1f MiB temp allocator buffer. "
+            "Every temp allocation falls back to the heap.",
+            ToMebibytes(newCapacity));
+        return;
+    }
+
+    buffer = static_cast<std::uint8_t*>(mappedAddress);
+    bufferCapacity = mappedSize;
+#else
+    bufferCapacity = AlignSizeUp(newCapacity, defaultPageSize);
+    buffer = static_cast<std::uint8_t*>(AlignedAllocate(bufferCapacity,
+        defaultPageSize));
+#endif
+}
+
+void AdaptiveTempAllocator::UnmapBuffer()
+{
+    if(buffer == nullptr)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    munmap(buffer, bufferCapacity);
+#else
+    AlignedFree(buffer);
+#endif
+
+    buffer = nullptr;
+    bufferCapacity = 0;
+    bIsBufferOnHugePages = false;
+}
@@ -0,0 +1,163 @@
+#ifndef ADAPTIVETEMPALLOCATOR_H
+#define ADAPTIVETEMPALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/TempAllocator.h>
+
+using namespace JPH;
+
+/**
+* The temp allocator of the physics update. As Jolt's "TempAllocatorImpl",
+* it allocates from a pre-allocated buffer as a stack, but the buffer adapts
+* to the physics world between steps:
+* - Allocations that do not fit on the buffer fall back to the heap (they
+* are counted as overflows), so a large step never fails.
+* - After each step (see "OnStepFinished()"), the buffer grows if the step's
+* peak usage neared its capacity, or shrinks if the peak usage stayed low
+* for a cool-down of steps.
+*
+* The buffer is page aligned memory, mapped on huge pages when they are
+* available (and requested), which saves TLB misses on large buffers.
+*
+* As "TempAllocatorImpl", it may only be used by one thread at a time.
+*/
+class AdaptiveTempAllocator final : public TempAllocator
+{
+public:
+    /** The allocator's settings */
+    struct Settings
+    {
+        /** The buffer's initial capacity */
+        std::size_t initialCapacity = 10 * 1024 * 1024;
+
+        /** The buffer's min capacity. It never shrinks under it */
+        std::size_t minCapacity = 1024 * 1024;
+
+        /** The buffer's max capacity. It never grows past it */
+        std::size_t maxCapacity = 256 * 1024 * 1024;
+
+        /**
+        * The fraction of the capacity a step's peak usage must reach for the
+        * buffer to grow
+        */
+        float growThreshold = 0.8f;
+
+        /**
+        * The number of consecutive steps with a low peak usage (under a
+        * quarter of the capacity) for the buffer to shrink. 0 never shrinks
+        */
+        std::uint32_t shrinkCooldownSteps = 600;
+
+        /** If the buffer should be mapped on huge pages when available */
+        bool bUseHugePages = true;
+    };
+
+    /**
+    * Creates the allocator and maps its buffer.
+    *
+    * @param settings The allocator's settings
+    */
+    explicit AdaptiveTempAllocator(const Settings& settings);
+
+    /** Unmaps the buffer */
+    ~AdaptiveTempAllocator() override;
+
+    void* Allocate(uint size) override;
+    void Free(void* address, uint size) override;
+
+    /**
+    * Records the peak usage of the step that just finished and resizes the
+    * buffer if needed. Must be called between steps, with every allocation
+    * freed.
+    */
+    void OnStepFinished();
+
+    /** @return The buffer's capacity, in bytes */
+    std::size_t GetCapacity() const { return bufferCapacity; }
+
+    /** @return The peak usage of the last finished step, in bytes */
+    std::size_t GetLastStepPeakUsage() const { return lastStepPeakUsage; }
+
+    /** @return The peak usage of any step, in bytes */
+    std::size_t GetHighWaterMark() const { return highWaterMark; }
+
+    /** @return The number of allocations that fell back to the heap */
+    std::uint64_t GetOverflowCount() const { return overflowCount; }
+
+    /** @return The number of times the buffer grew */
+    std::uint32_t GetGrowCount() const { return growCount; }
+
+    /** @return The number of times the buffer shrank */
+    std::uint32_t GetShrinkCount() const { return shrinkCount; }
+
+    /** @return True if the buffer is mapped on huge pages */
+    bool IsUsingHugePages() const { return bIsBufferOnHugePages; }
+
+    /** @return A report (single line) with the allocator's telemetry */
+    std::string GetStatsReport() const;
+
+private:
+    /**
+    * Maps a new buffer, unmapping the current one. The capacity is rounded
+    * up to the page size (or the huge page size, if huge pages are used).
+    *
+    * @param newCapacity The new buffer's min capacity
+    */
+    void MapBuffer(std::size_t newCapacity);
+
+    /** Unmaps the current buffer, if any */
+    void UnmapBuffer();
+
+    /** @return True if the address is on the buffer */
+    bool IsOnBuffer(const void* address) const
+    {
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(address);
+        return bytes >= buffer && bytes < buffer + bufferCapacity;
+    }
+
+    /** The allocator's settings */
+    Settings settings;
+
+    /** The buffer */
+    std::uint8_t* buffer = nullptr;
+
+    /** The buffer's capacity (its mapped size) */
+    std::size_t bufferCapacity = 0;
+
+    /** Flag that indicates if the buffer is mapped on huge pages */
+    bool bIsBufferOnHugePages = false;
+
+    /** The buffer's used bytes (the top of the stack) */
+    std::size_t bufferTop = 0;
+
+    /** The bytes allocated on the heap and not yet freed */
+    std::size_t overflowUsage = 0;
+
+    /** The peak usage (buffer and heap) of the current step */
+    std::size_t currentStepPeakUsage = 0;
+
+    /** The peak usage of the last finished step */
+    std::size_t lastStepPeakUsage = 0;
+
+    /** The peak usage of any step */
+    std::size_t highWaterMark = 0;
+
+    /** The peak usage since the buffer last grew or shrank */
+    std::size_t cooldownPeakUsage = 0;
+
+    /** The consecutive steps with a low peak usage */
+    std::uint32_t lowUsageStepCount = 0;
+
+    /** The allocations that fell back to the heap */
+    std::uint64_t overflowCount = 0;
+
+    /** The times the buffer grew and shrank */
+    std::uint32_t growCount = 0;
+    std::uint32_t shrinkCount = 0;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef BODYCREATIONINFO_H
+#define BODYCREATIONINFO_H
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Math/Vec3.h>
+
+#include "BodyRuntimeData.h"
+
+using namespace JPH;
+
+/**
+* The shape of a body created by the service. A "Sphere" is a dynamic body on
+* the moving layer, and a "Floor" is a static body on the non moving layer.
+*/
+enum class EBodyShapeType
+{
+    Sphere,
+    Floor
+};
+
+/**
+* The info needed to create a body on the physics world. Bodies are created
+* from a list of these infos, so they can be inserted on the physics world as
+* a batch.
+*
+* @see PhysicsServiceImpl::AddNewBodiesToPhysicsWorld
+*/
+struct BodyCreationInfo
+{
+    /** The shape of the body to create */
+    EBodyShapeType shapeType = EBodyShapeType::Sphere;
+
+    /** The body's ID */
+    BodyID bodyId;
+
+    /** The body's type */
+    EBodyType bodyType = EBodyType::Primary;
+
+    /** The body's initial position */
+    RVec3 initialPosition = RVec3::sZero();
+
+    /** The body's initial linear velocity. Ignored for static bodies */
+    RVec3 initialLinearVelocity = RVec3::sZero();
+
+    /** The body's initial angular velocity. Ignored for static bodies */
+    RVec3 initialAngularVelocity = RVec3::sZero();
+};
+
+#endif
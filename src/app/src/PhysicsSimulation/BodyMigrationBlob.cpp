@@ -0,0 +1,133 @@
+#include "BodyMigrationBlob.h"
+#include "../Serialization/ByteBufferReader.h"
+#include "../Serialization/ByteBufferWriter.h"
+
+namespace
+{
+    /** The flag of the active bodies on a body record */
+    constexpr std::uint8_t activeBodyFlag = 1 << 0;
+}
+
+void BodyMigrationBlob::AppendHeader(std::string& buffer,
+    std::uint32_t bodyCount)
+{
+    buffer += blobMagic;
+    ByteBufferWriter::AppendUInt32(buffer, blobVersion);
+    ByteBufferWriter::AppendUInt32(buffer, bodyCount);
+}
+
+void BodyMigrationBlob::AppendBody(std::string& buffer,
+    const BodyMigrationRecord& bodyRecord)
+{
+    ByteBufferWriter::AppendUInt32(buffer,
+        bodyRecord.bodyId.GetIndexAndSequenceNumber());
+    ByteBufferWriter::AppendUInt8(buffer,
+        static_cast<std::uint8_t>(bodyRecord.shapeType));
+    ByteBufferWriter::AppendUInt8(buffer,
+        static_cast<std::uint8_t>(bodyRecord.bodyType));
+    ByteBufferWriter::AppendUInt8(buffer,
+        bodyRecord.bIsActive ? activeBodyFlag : 0);
+    ByteBufferWriter::AppendUInt8(buffer, 0);
+    ByteBufferWriter::AppendUInt32(buffer, bodyRecord.ownerRegion);
+    ByteBufferWriter::AppendUInt32(buffer,
+        static_cast<std::uint32_t>(bodyRecord.bodyState.size()));
+    buffer += bodyRecord.bodyState;
+}
+
+bool BodyMigrationBlob::Parse(std::string_view blob,
+    std::vector<BodyMigrationRecord>& outBodyRecords, std::string& outError)
+{
+    outBodyRecords.clear();
+
+    if(blob.size() < headerSize
+        || blob.substr(0, blobMagic.size()) != blobMagic)
+    {
+        outError = "Not a body migration blob.";
+        return false;
+    }
+
+    std::uint32_t version = 0;
+    std::uint32_t bodyCount = 0;
+    const char* blobField = blob.data() + blobMagic.size();
+    blobField = ByteBufferReader::ReadUInt32(blobField, version);
+    ByteBufferReader::ReadUInt32(blobField, bodyCount);
+
+    if(version != blobVersion)
+    {
+        outError = "The body migration blob has the version "
+            + std::to_string(version) + ", expected "
+            + std::to_string(blobVersion) + ".";
+        return false;
+    }
+
+    // Each body takes at least its record's header, so a corrupt count is
+    // refused before anything is reserved for it
+    if(bodyCount > (blob.size() - headerSize) / bodyRecordHeaderSize)
+    {
+        outError = "The body migration blob is truncated.";
+        return false;
+    }
+
+    outBodyRecords.resize(bodyCount);
+
+    size_t recordStart = headerSize;
+    for(BodyMigrationRecord& bodyRecord : outBodyRecords)
+    {
+        if(blob.size() - recordStart < bodyRecordHeaderSize)
+        {
+            outError = "The body migration blob is truncated.";
+            outBodyRecords.clear();
+            return false;
+        }
+
+        std::uint32_t bodyIdValue = 0;
+        std::uint8_t shapeType = 0;
+        std::uint8_t bodyType = 0;
+        std::uint8_t flags = 0;
+        std::uint32_t bodyStateSize = 0;
+
+        const char* recordField = blob.data() + recordStart;
+        recordField = ByteBufferReader::ReadUInt32(recordField, bodyIdValue);
+        recordField = ByteBufferReader::ReadUInt8(recordField, shapeType);
+        recordField = ByteBufferReader::ReadUInt8(recordField, bodyType);
+        recordField = ByteBufferReader::ReadUInt8(recordField, flags);
+        recordField += 1;
+        recordField = ByteBufferReader::ReadUInt32(recordField,
+            bodyRecord.ownerRegion);
+        ByteBufferReader::ReadUInt32(recordField, bodyStateSize);
+
+        recordStart += bodyRecordHeaderSize;
+        if(blob.size() - recordStart < bodyStateSize)
+        {
+            outError = "The body migration blob is truncated.";
+            outBodyRecords.clear();
+            return false;
+        }
+
+        if(shapeType > static_cast<std::uint8_t>(EBodyShapeType::Floor)
+            || bodyType > EBodyType::Clone)
+        {
+            outError = "Unknown shape or body type for body with ID: "
+                + std::to_string(bodyIdValue);
+            outBodyRecords.clear();
+            return false;
+        }
+
+        bodyRecord.bodyId = BodyID(bodyIdValue);
+        bodyRecord.shapeType = static_cast<EBodyShapeType>(shapeType);
+        bodyRecord.bodyType = static_cast<EBodyType>(bodyType);
+        bodyRecord.bIsActive = (flags & activeBodyFlag) != 0;
+        bodyRecord.bodyState = blob.substr(recordStart, bodyStateSize);
+
+        recordStart += bodyStateSize;
+    }
+
+    if(recordStart != blob.size())
+    {
+        outError = "The body migration blob has data after its last body.";
+        outBodyRecords.clear();
+        return false;
+    }
+
+    return true;
+}
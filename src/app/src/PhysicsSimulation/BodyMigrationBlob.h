@@ -0,0 +1,106 @@
+#ifndef BODYMIGRATIONBLOB_H
+#define BODYMIGRATIONBLOB_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BodyCreationInfo.h"
+
+/** A body on a body migration blob */
+struct BodyMigrationRecord
+{
+    /** The body's ID, with its sequence number */
+    BodyID bodyId;
+
+    /** The body's shape, which also gives its motion type and layer */
+    EBodyShapeType shapeType = EBodyShapeType::Sphere;
+
+    /** The body's type (meaningful for the bodies tracked by the service) */
+    EBodyType bodyType = EBodyType::Primary;
+
+    /** The region that owns the body */
+    std::uint32_t ownerRegion = 0;
+
+    /** If the body is active (i.e. not sleeping) */
+    bool bIsActive = false;
+
+    /**
+    * The body's Jolt state, saved by "Body::SaveState()": its exact 
+    * position, rotation, velocities and sleep test state. A view on the blob
+    * when parsed
+    */
+    std::string_view bodyState;
+};
+
+/**
+* The blob bodies are handed off between services with (see 
+* "ExportBodies" and "ImportBodies"). It has the following little-endian 
+* layout:
+*
+* char magic[4] ("JPBM")
+* uint32 version
+* uint32 bodyCount
+* bodyCount * {
+*     uint32 bodyId (index and sequence number)
+*     uint8 shapeType (0: sphere, 1: floor)
+*     uint8 bodyType (0: primary, 1: clone)
+*     uint8 flags (1: active)
+*     uint8 reserved (0)
+*     uint32 ownerRegion
+*     uint32 bodyStateSize
+*     bodyStateSize bytes of body state
+* }
+*
+* The body states are Jolt's own bytes, so every float is handed off bit for
+* bit, but they are only valid for the same Jolt build (version and 
+* precision) that saved them.
+*/
+namespace BodyMigrationBlob
+{
+    /** The first bytes of every blob */
+    constexpr std::string_view blobMagic = "JPBM";
+
+    /** The version of the blob's layout */
+    constexpr std::uint32_t blobVersion = 1;
+
+    /** The size in bytes of the blob's header */
+    constexpr size_t headerSize = 12;
+
+    /** The size in bytes of a body record, without its body state */
+    constexpr size_t bodyRecordHeaderSize = 16;
+
+    /**
+    * Appends the blob's header to the given buffer.
+    *
+    * @param buffer The buffer to append the header to
+    * @param bodyCount The number of bodies on the blob
+    */
+    void AppendHeader(std::string& buffer, std::uint32_t bodyCount);
+
+    /**
+    * Appends a body record to the given buffer, after the header.
+    *
+    * @param buffer The buffer to append the record to
+    * @param bodyRecord The body to append, with its body state
+    */
+    void AppendBody(std::string& buffer,
+        const BodyMigrationRecord& bodyRecord);
+
+    /**
+    * Parses a blob. The whole blob is checked before any record is given.
+    *
+    * @param blob The blob to parse
+    * @param outBodyRecords The blob's bodies. Their body states are views
+    * on the blob
+    * @param outError The error, if the blob is not valid
+    *
+    * @return True if parsed
+    */
+    bool Parse(std::string_view blob,
+        std::vector<BodyMigrationRecord>& outBodyRecords,
+        std::string& outError);
+}
+
+#endif
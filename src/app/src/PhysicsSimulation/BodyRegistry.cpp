@@ -0,0 +1,56 @@
+#include "BodyRegistry.h"
+
+bool BodyRegistry::Add(const BodyID bodyId)
+{
+    const uint32 bodyIndex = bodyId.GetIndex();
+
+    // Grow the sparse array to fit the body index
+    if(bodyIndex >= denseIndexByBodyIndex.size())
+    {
+        denseIndexByBodyIndex.resize(bodyIndex + 1, invalidDenseIndex);
+    }
+
+    if(denseIndexByBodyIndex[bodyIndex] != invalidDenseIndex)
+    {
+        return false;
+    }
+
+    denseIndexByBodyIndex[bodyIndex] =
+        static_cast<std::uint32_t>(denseBodyIds.size());
+    denseBodyIds.push_back(bodyId);
+
+    return true;
+}
+
+bool BodyRegistry::Remove(const BodyID bodyId)
+{
+    if(!Contains(bodyId))
+    {
+        return false;
+    }
+
+    const std::uint32_t removedDenseIndex =
+        denseIndexByBodyIndex[bodyId.GetIndex()];
+
+    // Move the last body into the removed body's position
+    const BodyID lastBodyId = denseBodyIds.back();
+    denseBodyIds[removedDenseIndex] = lastBodyId;
+    denseIndexByBodyIndex[lastBodyId.GetIndex()] = removedDenseIndex;
+
+    denseBodyIds.pop_back();
+    denseIndexByBodyIndex[bodyId.GetIndex()] = invalidDenseIndex;
+
+    return true;
+}
+
+void BodyRegistry::Clear()
+{
+    // Only reset the indices on the registry, so the sparse array is not
+    // walked entirely
+    for(const BodyID bodyId : denseBodyIds)
+    {
+        denseIndexByBodyIndex[bodyId.GetIndex()] = invalidDenseIndex;
+    }
+
+    denseBodyIds.clear();
+}
@@ -0,0 +1,101 @@
+#ifndef BODYREGISTRY_H
+#define BODYREGISTRY_H
+
+#include <cstdint>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+
+using namespace JPH;
+
+/**
+* The registry of the bodies tracked by the service. This is a dense/sparse
+* set keyed by the body's index: the dense array holds the BodyIDs packed,
+* so they can be iterated contiguously (e.g. on each step), and the sparse
+* array maps each body index to its position on the dense array, so adding,
+* removing and looking up a body are O(1).
+*
+* Removing a body moves the last body on the dense array into its position
+* (swap-remove). Thus, the iteration order is only changed by removals, and
+* it is the same for every step between them.
+*/
+class BodyRegistry final
+{
+public:
+    /**
+    * Adds a body to the registry.
+    *
+    * @param bodyId The BodyID of the body to add
+    *
+    * @return True if the body was added and false if a body with the same
+    * index is already on the registry
+    */
+    bool Add(const BodyID bodyId);
+
+    /**
+    * Removes a body from the registry. The last body on the registry takes
+    * the removed body's position on the iteration order.
+    *
+    * @param bodyId The BodyID of the body to remove
+    *
+    * @return True if the body was removed and false if it is not on the
+    * registry
+    */
+    bool Remove(const BodyID bodyId);
+
+    /**
+    * Checks if a body is on the registry. The body's sequence number must
+    * match too, so a stale BodyID of a reused index is not on the registry.
+    *
+    * @param bodyId The BodyID of the body to check
+    *
+    * @return True if the body is on the registry and false otherwise
+    */
+    bool Contains(const BodyID bodyId) const
+    {
+        const uint32 bodyIndex = bodyId.GetIndex();
+        return bodyIndex < denseIndexByBodyIndex.size()
+            && denseIndexByBodyIndex[bodyIndex] != invalidDenseIndex
+            && denseBodyIds[denseIndexByBodyIndex[bodyIndex]] == bodyId;
+    }
+
+    /** Removes every body from the registry */
+    void Clear();
+
+    /** @return The number of bodies on the registry */
+    size_t size() const { return denseBodyIds.size(); }
+
+    /** @return True if there is no body on the registry */
+    bool empty() const { return denseBodyIds.empty(); }
+
+    /** @return The registered BodyIDs, packed on the iteration order */
+    const std::vector<BodyID>& GetBodyIds() const { return denseBodyIds; }
+
+    /** @return The iterator to the first registered BodyID */
+    std::vector<BodyID>::const_iterator begin() const
+    {
+        return denseBodyIds.begin();
+    }
+
+    /** @return The iterator past the last registered BodyID */
+    std::vector<BodyID>::const_iterator end() const
+    {
+        return denseBodyIds.end();
+    }
+
+private:
+    /** The position of a body index not on the registry */
+    static constexpr std::uint32_t invalidDenseIndex = 0xFFFFFFFF;
+
+    /** The registered BodyIDs, packed */
+    std::vector<BodyID> denseBodyIds;
+
+    /**
+    * The position on "denseBodyIds" of each body index, or
+    * "invalidDenseIndex" if the index is not on the registry
+    */
+    std::vector<std::uint32_t> denseIndexByBodyIndex;
+};
+
+#endif
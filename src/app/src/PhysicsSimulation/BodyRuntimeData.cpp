@@ -1,9 +1,62 @@
 #include "BodyRuntimeData.h"
+#include <algorithm>
 
-std::string BodyRuntimeData::GetBodyTypeAsString()
+void BodyRuntimeData::AllocateBodyData(const BodyID bodyId, 
+    EBodyType bodyType)
 {
-    // Switch on the current body type and return a string from the enum type
-    switch(currentBodyType)
+    const uint32 bodyIndex = bodyId.GetIndex();
+
+    // Grow every field to fit the body index. The size is at least doubled,
+    // so the table grows a few times until it fits the world's size
+    if(bodyIndex >= bodyFlags.size())
+    {
+        const size_t newTableSize = std::max(static_cast<size_t>(bodyIndex) 
+            + 1, bodyFlags.size() * 2);
+
+        bodyTypes.resize(newTableSize, EBodyType::Primary);
+        bodyOwnerRegions.resize(newTableSize, 0);
+        bodyFlags.resize(newTableSize, 0);
+        bodyIdValues.resize(newTableSize, BodyID::cInvalidBodyID);
+    }
+
+    if(!(bodyFlags[bodyIndex] & EBodyRuntimeDataFlags::HasRuntimeData))
+    {
+        bodyDataCount++;
+    }
+
+    bodyTypes[bodyIndex] = bodyType;
+    bodyOwnerRegions[bodyIndex] = 0;
+    bodyFlags[bodyIndex] = EBodyRuntimeDataFlags::HasRuntimeData;
+    bodyIdValues[bodyIndex] = bodyId.GetIndexAndSequenceNumber();
+}
+
+void BodyRuntimeData::FreeBodyData(const BodyID bodyId)
+{
+    if(!HasBodyData(bodyId))
+    {
+        return;
+    }
+
+    const uint32 bodyIndex = bodyId.GetIndex();
+    bodyFlags[bodyIndex] = 0;
+    bodyIdValues[bodyIndex] = BodyID::cInvalidBodyID;
+
+    bodyDataCount--;
+}
+
+void BodyRuntimeData::Clear()
+{
+    std::fill(bodyFlags.begin(), bodyFlags.end(), 0);
+    std::fill(bodyIdValues.begin(), bodyIdValues.end(), 
+        BodyID::cInvalidBodyID);
+
+    bodyDataCount = 0;
+}
+
+std::string BodyRuntimeData::GetBodyTypeAsString(EBodyType bodyType)
+{
+    // Switch on the body type and return a string from the enum type
+    switch(bodyType)
     {
         case EBodyType::Primary:
             return "Primary";
@@ -13,3 +66,21 @@ std::string BodyRuntimeData::GetBodyTypeAsString()
             return "";
     }
 }
+
+bool BodyRuntimeData::ParseBodyType(std::string_view bodyTypeAsString, 
+    EBodyType& outBodyType)
+{
+    if(bodyTypeAsString == "primary")
+    {
+        outBodyType = EBodyType::Primary;
+        return true;
+    }
+
+    if(bodyTypeAsString == "clone")
+    {
+        outBodyType = EBodyType::Clone;
+        return true;
+    }
+
+    return false;
+}
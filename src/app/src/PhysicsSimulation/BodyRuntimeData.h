@@ -2,6 +2,14 @@
 #define  BODYRUNTIMEDATA_H
 
 #include <iostream>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+
+using namespace JPH;
 
 /** 
 * This enum stores the body type. The body can be from type "primary", which 
@@ -10,43 +18,153 @@
 * as a way maintain physics simulation consistency. Thus, this actual body will 
 * be driven by another pyhsics service instead.
 */
-enum EBodyType
+enum EBodyType : std::uint8_t
 {
     Primary,
     Clone
 };
 
+/** The flags of a body's runtime data */
+enum EBodyRuntimeDataFlags : std::uint8_t
+{
+    /** The body has runtime data (i.e. it is tracked by the service) */
+    HasRuntimeData = 1 << 0
+};
+
 /** 
-* The body's runtime data. This is custom to this physics service and may store
-* any body data that should exist during runtime. Thus, this is an extension
-* of the Body.h class, which allows us to store and data we want.
+* The bodies' runtime data. This is custom to this physics service and may 
+* store any body data that should exist during runtime. Thus, this is an
+* extension of the Body.h class, which allows us to store and data we want.
+*
+* The data is stored as a side table indexed by the body's index, with a 
+* separate array per field (structure of arrays), so per-frame loops can scan
+* a single field contiguously. The arrays only grow: the slot of a removed 
+* body is freed and recycled by the next body with the same index, so adding
+* a body does not allocate once the table has grown to the world's size.
 */
 class BodyRuntimeData final
 {
 public:
+    /**
+    * Allocates the runtime data of a body. Any data left on the body's slot
+    * is reset.
+    *
+    * @param bodyId The BodyID of the body
+    * @param bodyType The body's type
+    */
+    void AllocateBodyData(const BodyID bodyId, EBodyType bodyType);
+
+    /**
+    * Frees the runtime data of a body, so its slot can be recycled.
+    *
+    * @param bodyId The BodyID of the body
+    */
+    void FreeBodyData(const BodyID bodyId);
+
+    /** 
+    * Checks if a body has runtime data. The body's sequence number must
+    * match too, so a stale BodyID of a recycled slot has no runtime data.
+    * 
+    * @param bodyId The BodyID of the body
+    * 
+    * @return True if the body has runtime data and false otherwise
+    */
+    bool HasBodyData(const BodyID bodyId) const
+    {
+        const uint32 bodyIndex = bodyId.GetIndex();
+        return bodyIndex < bodyFlags.size() 
+            && (bodyFlags[bodyIndex] & EBodyRuntimeDataFlags::HasRuntimeData)
+            && bodyIdValues[bodyIndex] == bodyId.GetIndexAndSequenceNumber();
+    }
+
     /** 
-    * Set this body's current type.
+    * Set a body's current type. The body must have runtime data.
     * 
+    * @param bodyId The BodyID of the body
     * @param newBodyType The new body type
     */
-    void SetBodyType(EBodyType newBodyType)
+    void SetBodyType(const BodyID bodyId, EBodyType newBodyType)
     {
-        currentBodyType = newBodyType;
+        bodyTypes[bodyId.GetIndex()] = newBodyType;
     }
 
+    /** 
+    * Getter to a body's current type. The body must have runtime data.
+    * 
+    * @param bodyId The BodyID of the body
+    */
+    EBodyType GetBodyType(const BodyID bodyId) const 
+    { 
+        return bodyTypes[bodyId.GetIndex()]; 
+    }
+
+    /** 
+    * Set the region that owns a body. The body must have runtime data.
+    * 
+    * @param bodyId The BodyID of the body
+    * @param newOwnerRegion The new owner region
+    */
+    void SetOwnerRegion(const BodyID bodyId, std::uint32_t newOwnerRegion)
+    {
+        bodyOwnerRegions[bodyId.GetIndex()] = newOwnerRegion;
+    }
+
+    /** 
+    * Getter to the region that owns a body. The body must have runtime data.
+    * 
+    * @param bodyId The BodyID of the body
+    */
+    std::uint32_t GetOwnerRegion(const BodyID bodyId) const
+    {
+        return bodyOwnerRegions[bodyId.GetIndex()];
+    }
+
+    /** 
+    * Getter to a body's flags (see EBodyRuntimeDataFlags).
+    * 
+    * @param bodyId The BodyID of the body
+    */
+    std::uint8_t GetFlags(const BodyID bodyId) const
+    {
+        return bodyFlags[bodyId.GetIndex()];
+    }
+
+    /** 
+    * Getter to every body's type, indexed by the body's index. Only the 
+    * entries of bodies with runtime data are meaningful
+    */
+    const std::vector<EBodyType>& GetBodyTypes() const { return bodyTypes; }
+
+    /** @return The number of bodies with runtime data */
+    size_t GetBodyDataCount() const { return bodyDataCount; }
+
+    /** Frees the runtime data of every body, keeping the table's capacity */
+    void Clear();
+
     /**
-    * Getter to the body's type as a string.
+    * Getter to a body's type as a string.
+    * 
+    * @param bodyType The body type
     * 
     * @return The body's type as a string
     */
-    std::string GetBodyTypeAsString();
+    static std::string GetBodyTypeAsString(EBodyType bodyType);
 
-    /** Getter to the current body type */
-    EBodyType GetBodyType() { return currentBodyType; }
+    /**
+    * Parses a body type from its message representation ("primary" or 
+    * "clone").
+    * 
+    * @param bodyTypeAsString The body type as sent on the messages
+    * @param outBodyType The parsed body type
+    * 
+    * @return True if the body type is known and false otherwise
+    */
+    static bool ParseBodyType(std::string_view bodyTypeAsString, 
+        EBodyType& outBodyType);
 
 private:
     /**
-    * The current body type. The body can be from type "primary", which 
+    * The body type of each body. The body can be from type "primary", which 
     * means that the physics service is actively controlling the body on the 
     * game; or from type "clone", which means that he only exists on this 
     * physics service as a way maintain physics simulation consistency. Thus, 
@@ -54,7 +172,22 @@ private:
     *
     * @see EBodyType
     */
-    EBodyType currentBodyType = EBodyType::Primary;
+    std::vector<EBodyType> bodyTypes;
+
+    /** The region that owns each body */
+    std::vector<std::uint32_t> bodyOwnerRegions;
+
+    /** The flags of each body (see EBodyRuntimeDataFlags) */
+    std::vector<std::uint8_t> bodyFlags;
+
+    /** 
+    * The BodyID (with its sequence number) each slot was allocated for. Used
+    * to tell stale BodyIDs apart from the slot's current body
+    */
+    std::vector<uint32> bodyIdValues;
+
+    /** The number of bodies with runtime data */
+    size_t bodyDataCount = 0;
 };
 
 #endif
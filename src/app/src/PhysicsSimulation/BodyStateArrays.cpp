@@ -0,0 +1,166 @@
+#include "BodyStateArrays.h"
+
+#include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+
+void BodyStateArrays::Extract(const BodyLockInterface& bodyLockInterface,
+    const BodyRuntimeData& bodyRuntimeData, const BodyID* bodyIdsToExtract,
+    size_t bodyIdsToExtractCount)
+{
+    // Size the arrays for every body, and shrink them to the extracted ones
+    // afterwards. Resizing keeps the capacity
+    ResizeArrays(bodyIdsToExtractCount);
+
+    size_t extractedBodyCount = 0;
+    for(size_t i = 0; i < bodyIdsToExtractCount; i++)
+    {
+        const BodyID bodyId = bodyIdsToExtract[i];
+
+        // Only the bodies with runtime data are tracked by the service (e.g.
+        // the floor is not reported)
+        if(!bodyRuntimeData.HasBodyData(bodyId))
+        {
+            continue;
+        }
+
+        // The non locking interface does not take any mutex
+        BodyLockRead lockRead(bodyLockInterface, bodyId);
+        if(!lockRead.SucceededAndIsInBroadPhase())
+        {
+            continue;
+        }
+
+        const Body& body = lockRead.GetBody();
+        const size_t n = extractedBodyCount;
+
+        bodyIds[n] = bodyId;
+
+        const RVec3 position = body.GetCenterOfMassPosition();
+        positionX[n] = position.GetX();
+        positionY[n] = position.GetY();
+        positionZ[n] = position.GetZ();
+
+        const Quat rotation = body.GetRotation();
+        rotationQuatX[n] = rotation.GetX();
+        rotationQuatY[n] = rotation.GetY();
+        rotationQuatZ[n] = rotation.GetZ();
+        rotationQuatW[n] = rotation.GetW();
+
+        const Vec3 linearVelocity = body.GetLinearVelocity();
+        linearVelocityX[n] = linearVelocity.GetX();
+        linearVelocityY[n] = linearVelocity.GetY();
+        linearVelocityZ[n] = linearVelocity.GetZ();
+
+        const Vec3 angularVelocity = body.GetAngularVelocity();
+        angularVelocityX[n] = angularVelocity.GetX();
+        angularVelocityY[n] = angularVelocity.GetY();
+        angularVelocityZ[n] = angularVelocity.GetZ();
+
+        bodyTypes[n] = bodyRuntimeData.GetBodyType(bodyId);
+
+        extractedBodyCount++;
+    }
+
+    ResizeArrays(extractedBodyCount);
+
+    // Pad the quaternions with the identity, so the conversion of the last
+    // 4 bodies does not read uninitialized values
+    for(size_t i = extractedBodyCount; i < rotationQuatX.size(); i++)
+    {
+        rotationQuatX[i] = 0.f;
+        rotationQuatY[i] = 0.f;
+        rotationQuatZ[i] = 0.f;
+        rotationQuatW[i] = 1.f;
+    }
+
+    ConvertRotationsToEulerAngles();
+}
+
+BodyStepState BodyStateArrays::GetBodyStepState(size_t bodyIndexOnArrays) const
+{
+    const size_t i = bodyIndexOnArrays;
+
+    BodyStepState bodyStepState;
+    bodyStepState.bodyId = bodyIds[i];
+    bodyStepState.position = RVec3(positionX[i], positionY[i], positionZ[i]);
+    bodyStepState.rotation = Vec3(rotationX[i], rotationY[i], rotationZ[i]);
+    bodyStepState.linearVelocity = Vec3(linearVelocityX[i],
+        linearVelocityY[i], linearVelocityZ[i]);
+    bodyStepState.angularVelocity = Vec3(angularVelocityX[i],
+        angularVelocityY[i], angularVelocityZ[i]);
+    bodyStepState.bodyType = bodyTypes[i];
+
+    return bodyStepState;
+}
+
+void BodyStateArrays::ResizeArrays(size_t bodyCount)
+{
+    // Round the rotations up to a multiple of 4
+    const size_t paddedBodyCount = (bodyCount + 3) & ~static_cast<size_t>(3);
+
+    bodyIds.resize(bodyCount);
+
+    positionX.resize(bodyCount);
+    positionY.resize(bodyCount);
+    positionZ.resize(bodyCount);
+
+    rotationQuatX.resize(paddedBodyCount);
+    rotationQuatY.resize(paddedBodyCount);
+    rotationQuatZ.resize(paddedBodyCount);
+    rotationQuatW.resize(paddedBodyCount);
+
+    rotationX.resize(paddedBodyCount);
+    rotationY.resize(paddedBodyCount);
+    rotationZ.resize(paddedBodyCount);
+
+    linearVelocityX.resize(bodyCount);
+    linearVelocityY.resize(bodyCount);
+    linearVelocityZ.resize(bodyCount);
+
+    angularVelocityX.resize(bodyCount);
+    angularVelocityY.resize(bodyCount);
+    angularVelocityZ.resize(bodyCount);
+
+    bodyTypes.resize(bodyCount);
+}
+
+void BodyStateArrays::ConvertRotationsToEulerAngles()
+{
+    const Vec4 one = Vec4::sReplicate(1.f);
+    const Vec4 minusOne = Vec4::sReplicate(-1.f);
+
+    // Each lane is a body. The arrays are padded to a multiple of 4, so
+    // there is no scalar remainder
+    for(size_t i = 0; i < rotationQuatX.size(); i += 4)
+    {
+        const Vec4 x = Vec4::sLoadFloat4
+            (reinterpret_cast<const Float4*>(&rotationQuatX[i]));
+        const Vec4 y = Vec4::sLoadFloat4
+            (reinterpret_cast<const Float4*>(&rotationQuatY[i]));
+        const Vec4 z = Vec4::sLoadFloat4
+            (reinterpret_cast<const Float4*>(&rotationQuatZ[i]));
+        const Vec4 w = Vec4::sLoadFloat4
+            (reinterpret_cast<const Float4*>(&rotationQuatW[i]));
+
+        const Vec4 ySquared = y * y;
+
+        // Rotation on the x-axis
+        const Vec4 t0 = (w * x + y * z) * 2.f;
+        const Vec4 t1 = one - (x * x + ySquared) * 2.f;
+
+        // Rotation on the y-axis. Clamped, as rounding may take it out of
+        // the arc sine's domain
+        const Vec4 t2 = Vec4::sMin(Vec4::sMax((w * y - z * x) * 2.f,
+            minusOne), one);
+
+        // Rotation on the z-axis
+        const Vec4 t3 = (w * z + x * y) * 2.f;
+        const Vec4 t4 = one - (ySquared + z * z) * 2.f;
+
+        Vec4::sATan2(t0, t1).StoreFloat4
+            (reinterpret_cast<Float4*>(&rotationX[i]));
+        t2.ASin().StoreFloat4(reinterpret_cast<Float4*>(&rotationY[i]));
+        Vec4::sATan2(t3, t4).StoreFloat4
+            (reinterpret_cast<Float4*>(&rotationZ[i]));
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef BODYSTATEARRAYS_H
+#define BODYSTATEARRAYS_H
+
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Body/BodyLockInterface.h>
+
+#include "BodyRuntimeData.h"
+#include "BodyStepState.h"
+
+using namespace JPH;
+
+/**
+* The reported state of a set of bodies after a physics step, as a structure
+* of arrays: the n-th entry of every array is the state of the n-th body. The
+* state is extracted once per step, and every step response encoder reads it
+* from these arrays.
+*
+* The rotation arrays are padded to a multiple of 4 entries, as the rotations
+* are converted to euler angles 4 bodies at a time. Only the first "size()"
+* entries are meaningful.
+*/
+struct BodyStateArrays
+{
+    /**
+    * Extracts the state of the given bodies. The bodies are read without
+    * taking any body lock, so this must only be called while no physics
+    * update is running and nothing else changes the physics world (e.g.
+    * right after the update, on the thread that ran it).
+    *
+    * Bodies that are not on the physics world or not tracked by the service
+    * (i.e. without runtime data) are skipped. Every array keeps its
+    * capacity, so no allocation happens once they have grown to the world's
+    * size.
+    *
+    * @param bodyLockInterface The (non locking) body lock interface of the
+    * physics system
+    * @param bodyRuntimeData The runtime data of the bodies
+    * @param bodyIdsToExtract The BodyIDs of the bodies to extract
+    * @param bodyIdsToExtractCount The number of bodies to extract
+    */
+    void Extract(const BodyLockInterface& bodyLockInterface,
+        const BodyRuntimeData& bodyRuntimeData,
+        const BodyID* bodyIdsToExtract, size_t bodyIdsToExtractCount);
+
+    /** @return The number of bodies on the arrays */
+    size_t size() const { return bodyIds.size(); }
+
+    /**
+    * Gathers a body's state from the arrays.
+    *
+    * @param bodyIndexOnArrays The body's position on the arrays
+    *
+    * @return The body's state
+    */
+    BodyStepState GetBodyStepState(size_t bodyIndexOnArrays) const;
+
+    /** The bodies' IDs */
+    std::vector<BodyID> bodyIds;
+
+    /** The bodies' center of mass positions */
+    std::vector<Real> positionX;
+    std::vector<Real> positionY;
+    std::vector<Real> positionZ;
+
+    /**
+    * The bodies' rotation quaternions (padded, as the euler angles). Read by
+    * the encoders that send the rotations as quaternions
+    */
+    std::vector<float> rotationQuatX;
+    std::vector<float> rotationQuatY;
+    std::vector<float> rotationQuatZ;
+    std::vector<float> rotationQuatW;
+
+    /** The bodies' rotations as euler angles (padded, see above) */
+    std::vector<float> rotationX;
+    std::vector<float> rotationY;
+    std::vector<float> rotationZ;
+
+    /** The bodies' linear velocities */
+    std::vector<float> linearVelocityX;
+    std::vector<float> linearVelocityY;
+    std::vector<float> linearVelocityZ;
+
+    /** The bodies' angular velocities */
+    std::vector<float> angularVelocityX;
+    std::vector<float> angularVelocityY;
+    std::vector<float> angularVelocityZ;
+
+    /** The bodies' types */
+    std::vector<EBodyType> bodyTypes;
+
+private:
+    /**
+    * Resizes every array to the given number of bodies. The rotation arrays
+    * are padded to a multiple of 4 entries.
+    *
+    * @param bodyCount The number of bodies
+    */
+    void ResizeArrays(size_t bodyCount);
+
+    /**
+    * Converts the extracted rotation quaternions to euler angles, 4 bodies
+    * at a time. This is the same conversion as "Quat::GetEulerAngles()".
+    */
+    void ConvertRotationsToEulerAngles();
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef BODYSTEPSTATE_H
+#define BODYSTEPSTATE_H
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Math/Vec3.h>
+
+#include "BodyRuntimeData.h"
+
+using namespace JPH;
+
+/** 
+* The state of a body after a physics step. This is what is reported to the
+* client for each body on the step physics response.
+*/
+struct BodyStepState
+{
+    /** The body's ID */
+    BodyID bodyId;
+
+    /** The body's center of mass position */
+    RVec3 position;
+
+    /** The body's rotation as euler angles */
+    Vec3 rotation;
+
+    /** The body's linear velocity */
+    Vec3 linearVelocity;
+
+    /** The body's angular velocity */
+    Vec3 angularVelocity;
+
+    /** The body's type */
+    EBodyType bodyType = EBodyType::Primary;
+};
+
+#endif
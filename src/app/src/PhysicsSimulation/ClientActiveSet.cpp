@@ -0,0 +1,97 @@
+#include "ClientActiveSet.h"
+
+void ClientActiveSet::AddActivationEvents
+    (const std::vector<BodyID>& newWokeUpBodyIds,
+    const std::vector<BodyID>& newWentToSleepBodyIds)
+{
+    wokeUpBodyIds.insert(wokeUpBodyIds.end(), newWokeUpBodyIds.begin(),
+        newWokeUpBodyIds.end());
+    wentToSleepBodyIds.insert(wentToSleepBodyIds.end(),
+        newWentToSleepBodyIds.begin(), newWentToSleepBodyIds.end());
+}
+
+void ClientActiveSet::MarkBodyChanged(const BodyID bodyId)
+{
+    changedBodyIds.push_back(bodyId);
+}
+
+void ClientActiveSet::ForgetBody(const BodyID bodyId)
+{
+    if(bodyId.GetIndex() < wasBodyReported.size())
+    {
+        wasBodyReported[bodyId.GetIndex()] = false;
+    }
+}
+
+void ClientActiveSet::Reset()
+{
+    lastReportedStates.clear();
+    wasBodyReported.clear();
+    changedBodyIds.clear();
+    wokeUpBodyIds.clear();
+    wentToSleepBodyIds.clear();
+}
+
+void ClientActiveSet::BeginReport()
+{
+    for(const BodyID& bodyId : changedBodyIds)
+    {
+        ForgetBody(bodyId);
+    }
+
+    for(const BodyID& bodyId : wentToSleepBodyIds)
+    {
+        ForgetBody(bodyId);
+    }
+}
+
+void ClientActiveSet::EndReport()
+{
+    // The lists keep their capacity, so no allocation happens once they have
+    // grown to the world's activity
+    changedBodyIds.clear();
+    wokeUpBodyIds.clear();
+    wentToSleepBodyIds.clear();
+}
+
+bool ClientActiveSet::HasBodyChangedSinceLastReport
+    (const BodyStepState& bodyStepState, float changeEpsilon) const
+{
+    // Bodies that were never reported have always changed
+    const uint32 bodyIndex = bodyStepState.bodyId.GetIndex();
+    if(bodyIndex >= wasBodyReported.size() || !wasBodyReported[bodyIndex])
+    {
+        return true;
+    }
+
+    const BodyStepState& lastReportedState = lastReportedStates[bodyIndex];
+
+    // Compare each component with the last reported one
+    const Vec3 positionDelta = Vec3(bodyStepState.position
+        - lastReportedState.position).Abs();
+    const Vec3 rotationDelta =
+        (bodyStepState.rotation - lastReportedState.rotation).Abs();
+    const Vec3 linearVelocityDelta = (bodyStepState.linearVelocity
+        - lastReportedState.linearVelocity).Abs();
+    const Vec3 angularVelocityDelta = (bodyStepState.angularVelocity
+        - lastReportedState.angularVelocity).Abs();
+
+    return positionDelta.ReduceMax() > changeEpsilon
+        || rotationDelta.ReduceMax() > changeEpsilon
+        || linearVelocityDelta.ReduceMax() > changeEpsilon
+        || angularVelocityDelta.ReduceMax() > changeEpsilon
+        || bodyStepState.bodyType != lastReportedState.bodyType;
+}
+
+void ClientActiveSet::RecordReportedState(const BodyStepState& bodyStepState)
+{
+    const uint32 bodyIndex = bodyStepState.bodyId.GetIndex();
+    if(bodyIndex >= lastReportedStates.size())
+    {
+        lastReportedStates.resize(bodyIndex + 1);
+        wasBodyReported.resize(bodyIndex + 1, false);
+    }
+
+    lastReportedStates[bodyIndex] = bodyStepState;
+    wasBodyReported[bodyIndex] = true;
+}
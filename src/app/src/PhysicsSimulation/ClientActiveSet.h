@@ -0,0 +1,138 @@
+#ifndef CLIENTACTIVESET_H
+#define CLIENTACTIVESET_H
+
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+
+#include "BodyStepState.h"
+
+using namespace JPH;
+
+/**
+* The state a client was last reported with on the active set step response
+* mode, and the events it has not been reported yet. Each client has its own,
+* so several clients on the active set mode each get every event and their
+* own deltas, whichever client steps the world.
+*
+* The physics world fans its events out to every client subscribed to it
+* (see "PhysicsServiceImpl::AddActiveSetClient()"): the bodies that woke up
+* and went to sleep, and the bodies that changed through the service (e.g.
+* added or had their type updated). They are kept until the client's next
+* active set step response.
+*/
+class ClientActiveSet final
+{
+public:
+    /**
+    * Adds the activation events of a physics step, to be reported on the
+    * client's next response.
+    *
+    * @param wokeUpBodyIds The bodies that woke up
+    * @param wentToSleepBodyIds The bodies that went to sleep
+    */
+    void AddActivationEvents(const std::vector<BodyID>& wokeUpBodyIds,
+        const std::vector<BodyID>& wentToSleepBodyIds);
+
+    /**
+    * Marks a body to be reported on the client's next response, even if it
+    * is sleeping (e.g. it was just added or its type was updated).
+    *
+    * @param bodyId The BodyID of the changed body
+    */
+    void MarkBodyChanged(const BodyID bodyId);
+
+    /**
+    * Forgets the state a body was last reported with (e.g. it was removed,
+    * so its index may be reused by a new body).
+    *
+    * @param bodyId The BodyID of the body to forget
+    */
+    void ForgetBody(const BodyID bodyId);
+
+    /**
+    * Forgets every reported state and pending event (e.g. the physics world
+    * was cleared, or the client moved to another world).
+    */
+    void Reset();
+
+    /**
+    * Starts a response: the bodies that changed or went to sleep since the
+    * last one are always reported, so the client has their latest state.
+    * Their last reported state is forgotten, so they are not filtered by the
+    * change epsilon.
+    */
+    void BeginReport();
+
+    /**
+    * Ends a response, dropping the events it reported. The reported states
+    * are kept (see "RecordReportedState()").
+    */
+    void EndReport();
+
+    /**
+    * Checks if a body's state differs from the state it was last reported
+    * with.
+    *
+    * @param bodyStepState The body's current state
+    * @param changeEpsilon The maximum difference on any component for the
+    * state to be considered unchanged
+    *
+    * @return True if the body was never reported or if any of its position,
+    * rotation or velocity components (or its type) changed beyond the
+    * epsilon
+    */
+    bool HasBodyChangedSinceLastReport(const BodyStepState& bodyStepState,
+        float changeEpsilon) const;
+
+    /**
+    * Records the state a body was reported with on the current response.
+    *
+    * @param bodyStepState The reported state
+    */
+    void RecordReportedState(const BodyStepState& bodyStepState);
+
+    /** @return The bodies that woke up since the last response */
+    std::vector<BodyID>& GetWokeUpBodyIds() { return wokeUpBodyIds; }
+
+    /** @return The bodies that went to sleep since the last response */
+    std::vector<BodyID>& GetWentToSleepBodyIds()
+    {
+        return wentToSleepBodyIds;
+    }
+
+    /**
+    * @return The bodies that changed through the service since the last
+    * response
+    */
+    const std::vector<BodyID>& GetChangedBodyIds() const
+    {
+        return changedBodyIds;
+    }
+
+private:
+    /**
+    * The state each body was last reported with, indexed by the body's
+    * index. Used to skip active bodies whose state did not change beyond the
+    * client's epsilon.
+    */
+    std::vector<BodyStepState> lastReportedStates;
+
+    /**
+    * Flags if the body on the same index on "lastReportedStates" has ever
+    * been reported. Bodies that were never reported are always reported.
+    */
+    std::vector<bool> wasBodyReported;
+
+    /** The bodies that changed through the service since the last response */
+    std::vector<BodyID> changedBodyIds;
+
+    /** The bodies that woke up since the last response */
+    std::vector<BodyID> wokeUpBodyIds;
+
+    /** The bodies that went to sleep since the last response */
+    std::vector<BodyID> wentToSleepBodyIds;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "ClientInterest.h"
+#include "BPLayerInterfaceImpl.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <Jolt/Geometry/AABox.h>
+
+namespace
+{
+    /**
+    * Collects the bodies found by a broad phase query straight into a
+    * vector, which keeps its capacity between queries.
+    */
+    class InterestBodyCollector final : public CollideShapeBodyCollector
+    {
+    public:
+        explicit InterestBodyCollector(std::vector<BodyID>& outBodyIds)
+            : bodyIds(outBodyIds)
+        {
+        }
+
+        void AddHit(const BodyID& inBodyId) override
+        {
+            bodyIds.push_back(inBodyId);
+        }
+
+    private:
+        std::vector<BodyID>& bodyIds;
+    };
+
+    /**
+    * Only lets the queries into the moving bodies' tree, as the bodies
+    * tracked by the service are moving. The static bodies (e.g. the floor)
+    * are never visited.
+    */
+    class MovingBroadPhaseLayerFilter final : public BroadPhaseLayerFilter
+    {
+    public:
+        bool ShouldCollide(BroadPhaseLayer inLayer) const override
+        {
+            return inLayer == BroadPhaseLayers::MOVING;
+        }
+    };
+}
+
+void ClientInterest::SetRegions(std::vector<InterestRegion> newRegions)
+{
+    regions = std::move(newRegions);
+}
+
+void ClientInterest::ClearRegions()
+{
+    regions.clear();
+    ClearBodiesInside();
+}
+
+void ClientInterest::ClearBodiesInside()
+{
+    bodiesInside.clear();
+    enteredBodyIds.clear();
+    leftBodyIds.clear();
+}
+
+void ClientInterest::QueryBodiesInside(const BroadPhaseQuery& broadPhaseQuery,
+    const BodyRuntimeData& bodyRuntimeData)
+{
+    queriedBodyIds.clear();
+
+    InterestBodyCollector bodyCollector(queriedBodyIds);
+    const MovingBroadPhaseLayerFilter broadPhaseLayerFilter;
+    for(const InterestRegion& region : regions)
+    {
+        if(region.shape == EInterestRegionShape::Box)
+        {
+            broadPhaseQuery.CollideAABox(AABox(region.boxMin, region.boxMax),
+                bodyCollector, broadPhaseLayerFilter);
+        }
+        else
+        {
+            broadPhaseQuery.CollideSphere(region.sphereCenter,
+                region.sphereRadius, bodyCollector, broadPhaseLayerFilter);
+        }
+    }
+
+    // Only the bodies tracked by the service are reported
+    queriedBodyIds.erase(std::remove_if(queriedBodyIds.begin(),
+        queriedBodyIds.end(), [&bodyRuntimeData](const BodyID& bodyId)
+        {
+            return !bodyRuntimeData.HasBodyData(bodyId);
+        }), queriedBodyIds.end());
+
+    // A body inside overlapping regions is found once per region
+    std::sort(queriedBodyIds.begin(), queriedBodyIds.end());
+    queriedBodyIds.erase(std::unique(queriedBodyIds.begin(),
+        queriedBodyIds.end()), queriedBodyIds.end());
+
+    // Both sets are sorted, so the bodies that entered and left are found in
+    // a single pass over each
+    enteredBodyIds.clear();
+    std::set_difference(queriedBodyIds.begin(), queriedBodyIds.end(),
+        bodiesInside.begin(), bodiesInside.end(),
+        std::back_inserter(enteredBodyIds));
+
+    leftBodyIds.clear();
+    std::set_difference(bodiesInside.begin(), bodiesInside.end(),
+        queriedBodyIds.begin(), queriedBodyIds.end(),
+        std::back_inserter(leftBodyIds));
+
+    bodiesInside.swap(queriedBodyIds);
+}
@@ -0,0 +1,130 @@
+#ifndef CLIENTINTEREST_H
+#define CLIENTINTEREST_H
+
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h>
+
+#include "BodyRuntimeData.h"
+
+using namespace JPH;
+
+/** The shape of a region of interest */
+enum class EInterestRegionShape
+{
+    Box,
+    Sphere
+};
+
+/** A region of the world a client wants the bodies of */
+struct InterestRegion
+{
+    /** The region's shape, which tells which of the fields below are used */
+    EInterestRegionShape shape = EInterestRegionShape::Box;
+
+    /** The box's corners, on the "Box" shape */
+    Vec3 boxMin = Vec3::sZero();
+    Vec3 boxMax = Vec3::sZero();
+
+    /** The sphere's center and radius, on the "Sphere" shape */
+    Vec3 sphereCenter = Vec3::sZero();
+    float sphereRadius = 0.f;
+};
+
+/**
+* The regions of the world a client is interested in, and the bodies that
+* were inside them on the client's last step. Each step, the bodies inside
+* the regions are queried on the broad phase (so the cost depends on the
+* bodies inside, not on the world's size), and compared with the last ones
+* to find the bodies that entered and left the client's interest.
+*
+* A body is inside a region if its bounding box overlaps it. Only the bodies
+* tracked by the service (i.e. with runtime data) are ever inside.
+*/
+class ClientInterest final
+{
+public:
+    /**
+    * Replaces the regions of interest. The bodies inside the previous regions
+    * are kept, so on the next query only the bodies that are not inside the
+    * new regions leave, and only the bodies that were not inside the previous
+    * ones enter.
+    *
+    * @param newRegions The new regions of interest
+    */
+    void SetRegions(std::vector<InterestRegion> newRegions);
+
+    /**
+    * Removes every region of interest, and forgets the bodies inside them.
+    * The client is interested in the whole world again.
+    */
+    void ClearRegions();
+
+    /**
+    * Forgets the bodies inside the regions, keeping the regions (e.g. the
+    * client moved to another world, whose bodies are unrelated). On the next
+    * query, every body inside the regions enters and none leaves.
+    */
+    void ClearBodiesInside();
+
+    /** @return True if the client has any region of interest */
+    bool HasRegions() const { return !regions.empty(); }
+
+    /** @return The regions of interest */
+    const std::vector<InterestRegion>& GetRegions() const { return regions; }
+
+    /**
+    * Queries the bodies inside the regions of interest, and finds the bodies
+    * that entered and left them since the last query. Must not be called
+    * while a physics step is running.
+    *
+    * @param broadPhaseQuery The broad phase query of the physics system
+    * @param bodyRuntimeData The runtime data of the bodies
+    */
+    void QueryBodiesInside(const BroadPhaseQuery& broadPhaseQuery,
+        const BodyRuntimeData& bodyRuntimeData);
+
+    /** @return The bodies inside the regions on the last query, sorted */
+    const std::vector<BodyID>& GetBodiesInside() const
+    {
+        return bodiesInside;
+    }
+
+    /** @return The bodies that entered the regions on the last query */
+    const std::vector<BodyID>& GetEnteredBodyIds() const
+    {
+        return enteredBodyIds;
+    }
+
+    /**
+    * @return The bodies that left the regions on the last query (or that
+    * were removed from the physics world)
+    */
+    const std::vector<BodyID>& GetLeftBodyIds() const
+    {
+        return leftBodyIds;
+    }
+
+private:
+    /** The regions of interest */
+    std::vector<InterestRegion> regions;
+
+    /** The bodies inside the regions on the last query, sorted */
+    std::vector<BodyID> bodiesInside;
+
+    /**
+    * The bodies found by the current query. Swapped with "bodiesInside" once
+    * the query is done, so both keep their capacity
+    */
+    std::vector<BodyID> queriedBodyIds;
+
+    /** The bodies that entered the regions on the last query */
+    std::vector<BodyID> enteredBodyIds;
+
+    /** The bodies that left the regions on the last query */
+    std::vector<BodyID> leftBodyIds;
+};
+
+#endif
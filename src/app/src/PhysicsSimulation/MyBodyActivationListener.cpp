@@ -3,11 +3,34 @@
 void MyBodyActivationListener::OnBodyActivated(const BodyID &inBodyID, 
 	uint64 inBodyUserData)
 {
-	cout << "A body got activated" << endl;
+	std::lock_guard<std::mutex> activationEventsLock(activationEventsMutex);
+	activatedBodyIds.push_back(inBodyID);
 }
 
 void MyBodyActivationListener::OnBodyDeactivated(const BodyID &inBodyID, 
 	uint64 inBodyUserData)
 {
-	cout << "A body went to sleep" << endl;
+	std::lock_guard<std::mutex> activationEventsLock(activationEventsMutex);
+	deactivatedBodyIds.push_back(inBodyID);
+}
+
+void MyBodyActivationListener::ConsumeActivationEvents
+	(std::vector<BodyID>& outActivatedBodyIds, 
+	std::vector<BodyID>& outDeactivatedBodyIds)
+{
+	outActivatedBodyIds.clear();
+	outDeactivatedBodyIds.clear();
+
+	// Swap the recorded events into the given lists. This keeps the capacity
+	// of both sides, so no allocation happens after the first steps
+	std::lock_guard<std::mutex> activationEventsLock(activationEventsMutex);
+	activatedBodyIds.swap(outActivatedBodyIds);
+	deactivatedBodyIds.swap(outDeactivatedBodyIds);
+}
+
+void MyBodyActivationListener::ClearActivationEvents()
+{
+	std::lock_guard<std::mutex> activationEventsLock(activationEventsMutex);
+	activatedBodyIds.clear();
+	deactivatedBodyIds.clear();
 }
@@ -12,6 +12,8 @@
 
 // STL includes
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 // All Jolt symbols are in the JPH namespace
 using namespace JPH;
@@ -24,7 +26,15 @@ using namespace JPH::literals;
 // We're also using STL classes in this example
 using namespace std;
 
-// An example activation listener
+/** 
+* The body activation listener. This records which bodies woke up and which
+* went to sleep, so the physics service can report only the active set of
+* bodies on each step (and tell the client to freeze or resume a body's 
+* interpolation).
+* 
+* Note that the callbacks are called from the physics jobs, so the recorded
+* events are protected by a mutex.
+*/
 class MyBodyActivationListener : public BodyActivationListener
 {
 public:
@@ -33,6 +43,29 @@ public:
 
 	virtual void OnBodyDeactivated(const BodyID &inBodyID,
 		uint64 inBodyUserData) override;
+
+	/** 
+	* Moves the activation events recorded since the last call into the given
+	* lists. The given lists are cleared before receiving the events.
+	* 
+	* @param outActivatedBodyIds The bodies that woke up
+	* @param outDeactivatedBodyIds The bodies that went to sleep
+	*/
+	void ConsumeActivationEvents(std::vector<BodyID>& outActivatedBodyIds,
+		std::vector<BodyID>& outDeactivatedBodyIds);
+
+	/** Discards every activation event recorded so far */
+	void ClearActivationEvents();
+
+private:
+	/** Protects the recorded activation events */
+	std::mutex activationEventsMutex;
+
+	/** The bodies that woke up since the events were last consumed */
+	std::vector<BodyID> activatedBodyIds;
+
+	/** The bodies that went to sleep since the events were last consumed */
+	std::vector<BodyID> deactivatedBodyIds;
 };
 
 #endif
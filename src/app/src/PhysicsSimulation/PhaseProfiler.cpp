@@ -0,0 +1,460 @@
+#include "PhaseProfiler.h"
+#include "../Logging/ServiceLogger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Profiler.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace
+{
+    /** @return The slot a name (pointer) starts probing on a table */
+    std::size_t GetNameSlot(const char* name, std::size_t tableSize)
+    {
+        // The names are string literals, so their low bits carry little
+        return static_cast<std::size_t>((reinterpret_cast<std::uintptr_t>
+            (name) >> 3) * 0x9E3779B97F4A7C15ull) & (tableSize - 1);
+    }
+
+    /** @return The duration in microseconds, for the reports */
+    double ToMicroseconds(std::uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+#ifdef JPH_EXTERNAL_PROFILE
+    /** The max number of distinct scopes on a thread (a power of 2) */
+    constexpr std::size_t maxThreadScopeCount = 512;
+
+    /**
+    * The measures of a scope on a thread. Only the thread writes the
+    * counts, the profiler only reads them, so no read-modify-write is
+    * needed. The read counts are the ones the profiler last gathered
+    */
+    struct ScopeCounter
+    {
+        std::atomic<const char*> name {nullptr};
+        std::atomic<std::uint64_t> callCount {0};
+        std::atomic<std::uint64_t> totalNanoseconds {0};
+        std::uint64_t readCallCount = 0;
+        std::uint64_t readNanoseconds = 0;
+    };
+
+    /**
+    * The scope counters of a thread. When the thread exits, they are kept
+    * for the next thread (e.g. the workers of a new job system)
+    */
+    struct ThreadScopeCounters
+    {
+        std::array<ScopeCounter, maxThreadScopeCount> counters;
+        std::atomic<std::uint64_t> droppedScopeCount {0};
+        char threadName[16] = {};
+        bool bIsInUse = true;
+    };
+
+    /**
+    * Every thread's scope counters. Never destroyed, as threads may still
+    * exit while the process is shutting down
+    */
+    struct ScopeCountersRegistry
+    {
+        std::mutex mutex;
+        std::vector<ThreadScopeCounters*> threads;
+    };
+
+    ScopeCountersRegistry& GetScopeCountersRegistry()
+    {
+        static ScopeCountersRegistry* registry = new ScopeCountersRegistry();
+        return *registry;
+    }
+
+    /** Frees the thread's counters for the next threads when it exits */
+    struct CurrentThreadScopeCounters
+    {
+        ThreadScopeCounters* counters = nullptr;
+
+        ~CurrentThreadScopeCounters()
+        {
+            if(counters)
+            {
+                ScopeCountersRegistry& registry = GetScopeCountersRegistry();
+                std::lock_guard<std::mutex> registryLock(registry.mutex);
+                counters->bIsInUse = false;
+            }
+        }
+    };
+
+    thread_local CurrentThreadScopeCounters currentThreadScopeCounters;
+
+    /** @return The current thread's counters, taken on its first scope */
+    ThreadScopeCounters& GetCurrentThreadScopeCounters()
+    {
+        if(currentThreadScopeCounters.counters)
+        {
+            return *currentThreadScopeCounters.counters;
+        }
+
+        ScopeCountersRegistry& registry = GetScopeCountersRegistry();
+        std::lock_guard<std::mutex> registryLock(registry.mutex);
+
+        ThreadScopeCounters* counters = nullptr;
+        for(ThreadScopeCounters* threadCounters : registry.threads)
+        {
+            if(!threadCounters->bIsInUse)
+            {
+                counters = threadCounters;
+                break;
+            }
+        }
+
+        if(!counters)
+        {
+            counters = new ThreadScopeCounters();
+            registry.threads.push_back(counters);
+        }
+
+        counters->bIsInUse = true;
+#ifdef __linux__
+        pthread_getname_np(pthread_self(), counters->threadName,
+            sizeof(counters->threadName));
+#endif
+
+        currentThreadScopeCounters.counters = counters;
+        return *counters;
+    }
+
+    /** @return The thread's counter of the scope, or null if full */
+    ScopeCounter* FindScopeCounter(ThreadScopeCounters& threadCounters,
+        const char* name)
+    {
+        std::size_t slot = GetNameSlot(name, maxThreadScopeCount);
+        for(std::size_t i = 0; i < maxThreadScopeCount; i++)
+        {
+            ScopeCounter& counter = threadCounters.counters[slot];
+
+            // Only this thread claims its counters
+            const char* counterName =
+                counter.name.load(std::memory_order_relaxed);
+            if(counterName == name)
+            {
+                return &counter;
+            }
+
+            if(counterName == nullptr)
+            {
+                counter.name.store(name, std::memory_order_release);
+                return &counter;
+            }
+
+            slot = (slot + 1) & (maxThreadScopeCount - 1);
+        }
+
+        return nullptr;
+    }
+
+    /** @return The current time, in nanoseconds */
+    std::uint64_t GetTimeNanoseconds()
+    {
+        return static_cast<std::uint64_t>
+            (std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /** The measurement of a running scope, kept on the scope's user data */
+    struct ScopeMeasurement
+    {
+        const char* name;
+        std::uint64_t startNanoseconds;
+    };
+#endif
+}
+
+#ifdef JPH_EXTERNAL_PROFILE
+JPH::ExternalProfileMeasurement::ExternalProfileMeasurement
+    (const char* inName, uint32 /*inColor*/)
+{
+    static_assert(sizeof(ScopeMeasurement) <= sizeof(mUserData),
+        "The scope measurement does not fit on the profile user data");
+
+    new (mUserData) ScopeMeasurement {inName, GetTimeNanoseconds()};
+}
+
+JPH::ExternalProfileMeasurement::~ExternalProfileMeasurement()
+{
+    const ScopeMeasurement& measurement =
+        *std::launder(reinterpret_cast<const ScopeMeasurement*>(mUserData));
+    const std::uint64_t durationNanoseconds =
+        GetTimeNanoseconds() - measurement.startNanoseconds;
+
+    ThreadScopeCounters& threadCounters = GetCurrentThreadScopeCounters();
+    ScopeCounter* counter = FindScopeCounter(threadCounters,
+        measurement.name);
+    if(!counter)
+    {
+        threadCounters.droppedScopeCount.store(threadCounters.
+            droppedScopeCount.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+        return;
+    }
+
+    counter->callCount.store(counter->callCount.load
+        (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    counter->totalNanoseconds.store(counter->totalNanoseconds.load
+        (std::memory_order_relaxed) + durationNanoseconds,
+        std::memory_order_relaxed);
+}
+#endif
+
+bool PhaseProfiler::IsAvailable()
+{
+#ifdef JPH_EXTERNAL_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PhaseProfiler::SetSettings(const Settings& newSettings)
+{
+    settings = newSettings;
+}
+
+void PhaseProfiler::EndStep(std::uint32_t stepNumber,
+    std::uint64_t stepDurationNanoseconds)
+{
+#ifdef JPH_EXTERNAL_PROFILE
+    const bool bShouldDump = settings.dumpThresholdNanoseconds > 0
+        && stepDurationNanoseconds >= settings.dumpThresholdNanoseconds
+        && dumpCount < settings.maxDumps;
+
+    // Only built for the dumped steps, so the other steps do not allocate
+    std::string scopeLines;
+    char scopeLine[512];
+
+    {
+        ScopeCountersRegistry& registry = GetScopeCountersRegistry();
+        std::lock_guard<std::mutex> registryLock(registry.mutex);
+
+        for(ThreadScopeCounters* threadCounters : registry.threads)
+        {
+            for(ScopeCounter& counter : threadCounters->counters)
+            {
+                const char* name =
+                    counter.name.load(std::memory_order_acquire);
+                if(!name)
+                {
+                    continue;
+                }
+
+                const std::uint64_t callCount =
+                    counter.callCount.load(std::memory_order_relaxed);
+                const std::uint64_t totalNanoseconds =
+                    counter.totalNanoseconds.load(std::memory_order_relaxed);
+                if(callCount == counter.readCallCount)
+                {
+                    continue;
+                }
+
+                const std::uint64_t stepCallCount =
+                    callCount - counter.readCallCount;
+                const std::uint64_t stepNanoseconds =
+                    totalNanoseconds - counter.readNanoseconds;
+                counter.readCallCount = callCount;
+                counter.readNanoseconds = totalNanoseconds;
+
+                if(bShouldDump)
+                {
+                    std::snprintf(scopeLine, sizeof(scopeLine),
+                        "%s;%s;%llu;%.3f\n", threadCounters->threadName,
+                        name, static_cast<unsigned long long>(stepCallCount),
+                        ToMicroseconds(stepNanoseconds));
+                    scopeLines += scopeLine;
+                }
+
+                PhaseStats* phase = FindPhase(name);
+                if(!phase)
+                {
+                    continue;
+                }
+
+                const std::uint16_t phaseIndex =
+                    static_cast<std::uint16_t>(phase - phases.data());
+                if(stepPhaseNanoseconds[phaseIndex] == 0)
+                {
+                    stepPhaseIndices[stepPhaseCount++] = phaseIndex;
+                }
+
+                phase->callCount += stepCallCount;
+                phase->totalNanoseconds += stepNanoseconds;
+                stepPhaseNanoseconds[phaseIndex] +=
+                    std::max<std::uint64_t>(stepNanoseconds, 1);
+            }
+        }
+    }
+
+    // A phase's step time is the sum of its time on every thread
+    for(std::size_t i = 0; i < stepPhaseCount; i++)
+    {
+        const std::uint16_t phaseIndex = stepPhaseIndices[i];
+        phases[phaseIndex].maxStepNanoseconds = std::max(phases[phaseIndex].
+            maxStepNanoseconds, stepPhaseNanoseconds[phaseIndex]);
+        stepPhaseNanoseconds[phaseIndex] = 0;
+    }
+
+    stepPhaseCount = 0;
+    profiledStepCount++;
+
+    if(bShouldDump)
+    {
+        WriteDump(stepNumber, stepDurationNanoseconds, scopeLines);
+    }
+#else
+    (void)stepNumber;
+    (void)stepDurationNanoseconds;
+#endif
+}
+
+void PhaseProfiler::Reset()
+{
+    phases.fill(PhaseStats());
+    profiledStepCount = 0;
+}
+
+std::string PhaseProfiler::GetReport() const
+{
+    if(!IsAvailable())
+    {
+        return "phaseProfiling;disabled\n";
+    }
+
+    // Merge the phases with the same name (the same string literal may
+    // have a different address on each translation unit)
+    std::vector<PhaseStats> mergedPhases;
+    for(const PhaseStats& phase : phases)
+    {
+        if(!phase.name)
+        {
+            continue;
+        }
+
+        auto mergedPhase = std::find_if(mergedPhases.begin(),
+            mergedPhases.end(), [&phase](const PhaseStats& otherPhase)
+            {
+                return std::strcmp(otherPhase.name, phase.name) == 0;
+            });
+
+        if(mergedPhase == mergedPhases.end())
+        {
+            mergedPhases.push_back(phase);
+            continue;
+        }
+
+        mergedPhase->callCount += phase.callCount;
+        mergedPhase->totalNanoseconds += phase.totalNanoseconds;
+        mergedPhase->maxStepNanoseconds = std::max(mergedPhase->
+            maxStepNanoseconds, phase.maxStepNanoseconds);
+    }
+
+    std::sort(mergedPhases.begin(), mergedPhases.end(),
+        [](const PhaseStats& phase, const PhaseStats& otherPhase)
+        {
+            return phase.totalNanoseconds > otherPhase.totalNanoseconds;
+        });
+
+    std::uint64_t droppedScopeCount = 0;
+#ifdef JPH_EXTERNAL_PROFILE
+    {
+        ScopeCountersRegistry& registry = GetScopeCountersRegistry();
+        std::lock_guard<std::mutex> registryLock(registry.mutex);
+
+        for(const ThreadScopeCounters* threadCounters : registry.threads)
+        {
+            droppedScopeCount += threadCounters->droppedScopeCount.load
+                (std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    char reportLine[512];
+    std::snprintf(reportLine, sizeof(reportLine), "phaseProfiling;enabled\n"
+        "profiledSteps;%u\nprofileDumps;%u\ndroppedScopes;%llu\nphases;%zu\n",
+        profiledStepCount, dumpCount,
+        static_cast<unsigned long long>(droppedScopeCount),
+        mergedPhases.size());
+    std::string report = reportLine;
+
+    const double stepCount = std::max<double>(profiledStepCount, 1.0);
+    for(const PhaseStats& phase : mergedPhases)
+    {
+        std::snprintf(reportLine, sizeof(reportLine),
+            "%s;%llu;%.3f;%.3f;%.3f\n", phase.name,
+            static_cast<unsigned long long>(phase.callCount),
+            ToMicroseconds(phase.totalNanoseconds),
+            ToMicroseconds(phase.totalNanoseconds) / stepCount,
+            ToMicroseconds(phase.maxStepNanoseconds));
+        report += reportLine;
+    }
+
+    return report;
+}
+
+PhaseProfiler::PhaseStats* PhaseProfiler::FindPhase(const char* name)
+{
+    std::size_t slot = GetNameSlot(name, maxPhaseCount);
+    for(std::size_t i = 0; i < maxPhaseCount; i++)
+    {
+        PhaseStats& phase = phases[slot];
+        if(phase.name == name)
+        {
+            return &phase;
+        }
+
+        if(phase.name == nullptr)
+        {
+            phase.name = name;
+            return &phase;
+        }
+
+        slot = (slot + 1) & (maxPhaseCount - 1);
+    }
+
+    return nullptr;
+}
+
+void PhaseProfiler::WriteDump(std::uint32_t stepNumber,
+    std::uint64_t stepDurationNanoseconds, const std::string& scopeLines)
+{
+    dumpCount++;
+
+    const std::string dumpPath = settings.dumpDirectory
+        + "/PhysicsProfile_Step" + std::to_string(stepNumber) + ".csv";
+
+    std::ofstream dumpFile(dumpPath);
+    if(!dumpFile.is_open())
+    {
+        LOG_WARNING(Physics, "Step %u took %.3f us, but its profile could "
+            "not be written to: %s", stepNumber,
+            ToMicroseconds(stepDurationNanoseconds), dumpPath.c_str());
+        return;
+    }
+
+    dumpFile << "# Step " << stepNumber << " took "
+        << ToMicroseconds(stepDurationNanoseconds) << " us\n"
+        << "thread;scope;calls;totalUs\n" << scopeLines;
+
+    LOG_WARNING(Physics, "Step %u took %.3f us. Profile dumped to: %s",
+        stepNumber, ToMicroseconds(stepDurationNanoseconds),
+        dumpPath.c_str());
+}
@@ -0,0 +1,131 @@
+#ifndef PHASEPROFILER_H
+#define PHASEPROFILER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+* Profiles the phases of the physics update (broad phase, narrow phase,
+* island building, constraint solving, integration...), i.e. Jolt's profile
+* scopes: each of its jobs and instrumented functions.
+*
+* The scopes are only measured on the phase profiling build (the CMake
+* option "SERVICE_PHASE_PROFILING"), which compiles Jolt with
+* JPH_EXTERNAL_PROFILE. Every Jolt scope then adds its duration to counters
+* of the thread it ran on, and "EndStep()" gathers every thread's counters
+* into the step's phase times. On other builds "IsAvailable()" is false and
+* nothing is measured.
+*
+* The phase times are inclusive: a scope nested on another one (e.g. a
+* function called from a job) is counted on both. As Jolt's scopes are
+* process wide, a single physics system should be profiled at a time (the
+* worlds sharing a job system share a profiler, see "PhysicsWorldHost").
+*
+* Steps slower than a threshold may be dumped to a file, with the time of
+* every scope on every thread (see "Settings").
+*/
+class PhaseProfiler final
+{
+public:
+    /** The settings of the automatic dumps of slow steps */
+    struct Settings
+    {
+        /** Steps at least this long are dumped. 0 never dumps them */
+        std::uint64_t dumpThresholdNanoseconds = 0;
+
+        /** The directory the dumps are written to */
+        std::string dumpDirectory = ".";
+
+        /** The max number of dumps, so a slow world does not fill the disk */
+        std::uint32_t maxDumps = 16;
+    };
+
+    /** The measures of a phase since the last reset */
+    struct PhaseStats
+    {
+        /** The phase's (scope's) name */
+        const char* name = nullptr;
+
+        /** The number of times the phase ran */
+        std::uint64_t callCount = 0;
+
+        /** The phase's total time, on every thread */
+        std::uint64_t totalNanoseconds = 0;
+
+        /** The phase's longest time on a step */
+        std::uint64_t maxStepNanoseconds = 0;
+    };
+
+    /** @return If the phases are measured on this build */
+    static bool IsAvailable();
+
+    /**
+    * Sets the settings of the automatic dumps. The dump count is not reset.
+    *
+    * @param newSettings The new settings
+    */
+    void SetSettings(const Settings& newSettings);
+
+    /**
+    * Gathers the phase times of the step that just finished. Should be
+    * called after every physics update, on the thread that updated it.
+    *
+    * @param stepNumber The step's number, for the dumps
+    * @param stepDurationNanoseconds How long the step took, to decide if it
+    * is dumped
+    */
+    void EndStep(std::uint32_t stepNumber,
+        std::uint64_t stepDurationNanoseconds);
+
+    /** Removes every phase measure (the dump count is kept) */
+    void Reset();
+
+    /**
+    * Gets the phase measures, a "name;value" line per measure:
+    * "phaseProfiling" (enabled or disabled), "profiledSteps",
+    * "profileDumps", "droppedScopes" and "phases;N", followed by the N
+    * phases from the slowest, as
+    * "phaseName;callCount;totalUs;meanStepUs;maxStepUs". Phases with the
+    * same name are merged.
+    *
+    * @return The phase measures
+    */
+    std::string GetReport() const;
+
+private:
+    /** The max number of distinct phases (a power of 2) */
+    static constexpr std::size_t maxPhaseCount = 1024;
+
+    /** @return The phase of the name, added if new, or null if full */
+    PhaseStats* FindPhase(const char* name);
+
+    /** Writes the dump of a step with its scopes' times */
+    void WriteDump(std::uint32_t stepNumber,
+        std::uint64_t stepDurationNanoseconds,
+        const std::string& scopeLines);
+
+    /** The automatic dump settings */
+    Settings settings;
+
+    /** The phases, on an open addressing table by name (pointer) */
+    std::array<PhaseStats, maxPhaseCount> phases {};
+
+    /** Each phase's time on the current step */
+    std::array<std::uint64_t, maxPhaseCount> stepPhaseNanoseconds {};
+
+    /** The phases that ran on the current step */
+    std::array<std::uint16_t, maxPhaseCount> stepPhaseIndices {};
+
+    /** The number of phases that ran on the current step */
+    std::size_t stepPhaseCount = 0;
+
+    /** The number of steps since the last reset */
+    std::uint32_t profiledStepCount = 0;
+
+    /** The number of dumps written */
+    std::uint32_t dumpCount = 0;
+};
+
+#endif
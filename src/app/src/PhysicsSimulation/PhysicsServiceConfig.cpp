@@ -0,0 +1,654 @@
+#include "PhysicsServiceConfig.h"
+#include "BodyRuntimeData.h"
+#include "BodyStepState.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Body/BodyID.h>
+
+namespace
+{
+    /**
+    * Approximate sizes of Jolt's internal structures, which are not exposed
+    * by its headers. Only used to estimate the memory footprint
+    */
+    constexpr std::uint64_t estimatedQuadTreeNodeSize = 128;
+    constexpr std::uint64_t estimatedBroadPhaseTrackingSize = 12;
+    constexpr std::uint64_t estimatedCachedBodyPairSize = 48;
+    constexpr std::uint64_t estimatedCachedManifoldSize = 168;
+    constexpr std::uint64_t estimatedJobSize = 128;
+
+    /** The minimum temp allocator size accepted */
+    constexpr std::uint32_t minTempAllocatorSize = 1024 * 1024;
+
+    /** The max number of physics worker threads accepted */
+    constexpr int maxPhysicsWorkerThreadCount = 256;
+
+    /** The CPU indices accepted are below this (the size of a CPU set) */
+    constexpr int maxCpuIndex = 1024;
+
+    /** The max number of physics worlds accepted */
+    constexpr std::uint32_t maxWorldCount = 256;
+
+    /** @return The text without leading and trailing spaces and tabs */
+    std::string_view TrimConfigText(std::string_view text)
+    {
+        const size_t textStart = text.find_first_not_of(" \t\r");
+        if(textStart == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+
+        const size_t textEnd = text.find_last_not_of(" \t\r");
+        return text.substr(textStart, textEnd - textStart + 1);
+    }
+
+    bool ParseConfigValue(std::string_view value, std::uint32_t& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd;
+    }
+
+    bool ParseConfigValue(std::string_view value, int& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd;
+    }
+
+    bool ParseConfigValue(std::string_view value, float& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd
+            && std::isfinite(outValue);
+    }
+
+    bool ParseConfigValue(std::string_view value, bool& outValue)
+    {
+        if(value == "true" || value == "1")
+        {
+            outValue = true;
+            return true;
+        }
+
+        if(value == "false" || value == "0")
+        {
+            outValue = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ParseConfigValue(std::string_view value, std::string& outValue)
+    {
+        outValue = value;
+        return true;
+    }
+
+    /** Parses a value into the gravity's component */
+    bool ParseGravityComponent(std::string_view value, Vec3& gravity,
+        void (Vec3::*setGravityComponent)(float))
+    {
+        float component = 0.f;
+        if(!ParseConfigValue(value, component))
+        {
+            return false;
+        }
+
+        (gravity.*setGravityComponent)(component);
+        return true;
+    }
+
+    /** Sets a config value from its text */
+    using ConfigValueSetter =
+        bool (*)(PhysicsServiceConfig&, std::string_view);
+
+    /** A config key and the setter of its value */
+    struct ConfigKey
+    {
+        std::string_view key;
+        ConfigValueSetter setValue;
+    };
+
+    /** Every config key */
+    const ConfigKey configKeys[] =
+    {
+        { "maxBodies", [](PhysicsServiceConfig& config, std::string_view value)
+            { return ParseConfigValue(value, config.maxBodies); } },
+        { "numBodyMutexes", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.numBodyMutexes); } },
+        { "maxBodyPairs", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.maxBodyPairs); } },
+        { "maxContactConstraints", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.maxContactConstraints); } },
+        { "tempAllocatorSize", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.tempAllocatorSize); } },
+        { "tempAllocatorMinSize", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.tempAllocatorMinSize); } },
+        { "tempAllocatorMaxSize", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.tempAllocatorMaxSize); } },
+        { "tempAllocatorGrowThreshold", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.tempAllocatorGrowThreshold); } },
+        { "tempAllocatorShrinkCooldownSteps", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.tempAllocatorShrinkCooldownSteps); } },
+        { "tempAllocatorUseHugePages", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.tempAllocatorUseHugePages); } },
+        { "maxPhysicsJobs", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.maxPhysicsJobs); } },
+        { "maxPhysicsBarriers", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.maxPhysicsBarriers); } },
+        { "physicsWorkerThreadCount", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsWorkerThreadCount); } },
+        { "pinPhysicsWorkerThreads", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.pinPhysicsWorkerThreads); } },
+        { "physicsWorkerFirstCpu", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.physicsWorkerFirstCpu); } },
+        { "networkThreadCpu", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.networkThreadCpu); } },
+        { "physicsWorkerIdleSpinCount", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsWorkerIdleSpinCount); } },
+        { "broadPhaseOptimizationBodyThreshold", [](PhysicsServiceConfig&
+            config, std::string_view value)
+            { return ParseConfigValue(value,
+                config.broadPhaseOptimizationBodyThreshold); } },
+        { "profileDumpThresholdMicroseconds", [](PhysicsServiceConfig&
+            config, std::string_view value)
+            { return ParseConfigValue(value,
+                config.profileDumpThresholdMicroseconds); } },
+        { "profileDumpDirectory", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.profileDumpDirectory); } },
+        { "profileMaxDumps", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.profileMaxDumps); } },
+        { "snapshotDirectory", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.snapshotDirectory); } },
+        { "worldCount", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value, config.worldCount); } },
+        { "gravityX", [](PhysicsServiceConfig& config, std::string_view value)
+            { return ParseGravityComponent(value, config.gravity,
+                &Vec3::SetX); } },
+        { "gravityY", [](PhysicsServiceConfig& config, std::string_view value)
+            { return ParseGravityComponent(value, config.gravity,
+                &Vec3::SetY); } },
+        { "gravityZ", [](PhysicsServiceConfig& config, std::string_view value)
+            { return ParseGravityComponent(value, config.gravity,
+                &Vec3::SetZ); } },
+        { "numVelocitySteps", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mNumVelocitySteps); } },
+        { "numPositionSteps", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mNumPositionSteps); } },
+        { "baumgarte", [](PhysicsServiceConfig& config, std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mBaumgarte); } },
+        { "speculativeContactDistance", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mSpeculativeContactDistance); } },
+        { "penetrationSlop", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mPenetrationSlop); } },
+        { "minVelocityForRestitution", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mMinVelocityForRestitution); } },
+        { "timeBeforeSleep", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mTimeBeforeSleep); } },
+        { "pointVelocitySleepThreshold", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mPointVelocitySleepThreshold); } },
+        { "deterministicSimulation", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mDeterministicSimulation); } },
+        { "constraintWarmStart", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mConstraintWarmStart); } },
+        { "useBodyPairContactCache", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mUseBodyPairContactCache); } },
+        { "useManifoldReduction", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mUseManifoldReduction); } },
+        { "useLargeIslandSplitter", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mUseLargeIslandSplitter); } },
+        { "allowSleeping", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mAllowSleeping); } },
+        { "checkActiveEdges", [](PhysicsServiceConfig& config,
+            std::string_view value)
+            { return ParseConfigValue(value,
+                config.physicsSettings.mCheckActiveEdges); } }
+    };
+
+    /**
+    * The config keys an "Init" message may set: the world's capacities, its
+    * solver settings and its temp allocator's settings. The others (e.g. the
+    * threading, the directories or the world count) are only set when the
+    * service starts
+    */
+    constexpr std::string_view initConfigKeys[] =
+    {
+        "maxBodies", "numBodyMutexes", "maxBodyPairs", 
+        "maxContactConstraints", "broadPhaseOptimizationBodyThreshold",
+        "tempAllocatorSize", "tempAllocatorMinSize", "tempAllocatorMaxSize", 
+        "tempAllocatorGrowThreshold", "tempAllocatorShrinkCooldownSteps", 
+        "tempAllocatorUseHugePages", "gravityX", "gravityY", "gravityZ", 
+        "numVelocitySteps", "numPositionSteps", "baumgarte", 
+        "speculativeContactDistance", "penetrationSlop", 
+        "minVelocityForRestitution", "timeBeforeSleep", 
+        "pointVelocitySleepThreshold", "deterministicSimulation", 
+        "constraintWarmStart", "useBodyPairContactCache", 
+        "useManifoldReduction", "useLargeIslandSplitter", "allowSleeping", 
+        "checkActiveEdges"
+    };
+
+    /** @return The size in MiB, for the reports */
+    double ToMebibytes(std::uint64_t sizeInBytes)
+    {
+        return static_cast<double>(sizeInBytes) / (1024.0 * 1024.0);
+    }
+}
+
+bool PhysicsServiceConfig::SetValue(std::string_view key,
+    std::string_view value, std::string& outError)
+{
+    for(const ConfigKey& configKey : configKeys)
+    {
+        if(configKey.key != key)
+        {
+            continue;
+        }
+
+        if(!configKey.setValue(*this, value))
+        {
+            outError = "Invalid value for \"" + std::string(key) + "\": "
+                + std::string(value);
+            return false;
+        }
+
+        return true;
+    }
+
+    outError = "Unknown config key: " + std::string(key);
+    return false;
+}
+
+bool PhysicsServiceConfig::SetKeyValuePair(std::string_view keyValuePair,
+    std::string& outError)
+{
+    const size_t separatorPos = keyValuePair.find('=');
+    if(separatorPos == std::string_view::npos)
+    {
+        outError = "Config value without \"=\": " + std::string(keyValuePair);
+        return false;
+    }
+
+    return SetValue(TrimConfigText(keyValuePair.substr(0, separatorPos)),
+        TrimConfigText(keyValuePair.substr(separatorPos + 1)), outError);
+}
+
+bool PhysicsServiceConfig::SetInitKeyValuePair(std::string_view keyValuePair,
+    std::string& outError)
+{
+    const std::string_view key =
+        TrimConfigText(keyValuePair.substr(0, keyValuePair.find('=')));
+
+    if(std::find(std::begin(initConfigKeys), std::end(initConfigKeys), key)
+        == std::end(initConfigKeys))
+    {
+        outError = "Config key can't be set on Init: " + std::string(key);
+        return false;
+    }
+
+    return SetKeyValuePair(keyValuePair, outError);
+}
+
+bool PhysicsServiceConfig::LoadFromFile(const std::string& configFilePath,
+    std::string& outError)
+{
+    std::ifstream configFile(configFilePath);
+    if(!configFile.is_open())
+    {
+        outError = "Could not open config file: " + configFilePath;
+        return false;
+    }
+
+    std::string configLine;
+    size_t configLineNumber = 0;
+    while(std::getline(configFile, configLine))
+    {
+        configLineNumber++;
+
+        const std::string_view trimmedConfigLine =
+            TrimConfigText(configLine);
+        if(trimmedConfigLine.empty() || trimmedConfigLine.front() == '#')
+        {
+            continue;
+        }
+
+        std::string configLineError;
+        if(!SetKeyValuePair(trimmedConfigLine, configLineError))
+        {
+            outError = configFilePath + ":"
+                + std::to_string(configLineNumber) + ": " + configLineError;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PhysicsServiceConfig::LoadFromCommandLine(int argc, char** argv,
+    std::string& outError)
+{
+    constexpr std::string_view optionPrefix = "--";
+    constexpr std::string_view configFileOption = "config=";
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if(argument.substr(0, optionPrefix.size()) != optionPrefix)
+        {
+            continue;
+        }
+
+        argument.remove_prefix(optionPrefix.size());
+
+        const bool bWasSet =
+            argument.substr(0, configFileOption.size()) == configFileOption
+            ? LoadFromFile(std::string(argument.substr
+                (configFileOption.size())), outError)
+            : SetKeyValuePair(argument, outError);
+
+        if(!bWasSet)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PhysicsServiceConfig::Validate(std::string& outError) const
+{
+    const auto fail = [&outError](const char* error)
+    {
+        outError = error;
+        return false;
+    };
+
+    if(maxBodies == 0 || maxBodies > BodyID::cMaxBodyIndex + 1)
+    {
+        return fail("maxBodies must be between 1 and 8388608");
+    }
+
+    if(maxBodyPairs == 0)
+    {
+        return fail("maxBodyPairs must be at least 1");
+    }
+
+    if(maxContactConstraints == 0)
+    {
+        return fail("maxContactConstraints must be at least 1");
+    }
+
+    if(tempAllocatorMinSize < minTempAllocatorSize)
+    {
+        return fail("tempAllocatorMinSize must be at least 1048576 bytes");
+    }
+
+    if(tempAllocatorSize < tempAllocatorMinSize
+        || tempAllocatorSize > tempAllocatorMaxSize)
+    {
+        return fail("tempAllocatorSize must be between tempAllocatorMinSize "
+            "and tempAllocatorMaxSize");
+    }
+
+    if(!(tempAllocatorGrowThreshold > 0.f)
+        || tempAllocatorGrowThreshold > 1.f)
+    {
+        return fail("tempAllocatorGrowThreshold must be greater than 0 and "
+            "at most 1");
+    }
+
+    // The job system's free list takes the max jobs as its page size, which
+    // must be a power of 2
+    if(maxPhysicsJobs == 0 || (maxPhysicsJobs & (maxPhysicsJobs - 1)) != 0)
+    {
+        return fail("maxPhysicsJobs must be a power of 2");
+    }
+
+    if(maxPhysicsBarriers == 0)
+    {
+        return fail("maxPhysicsBarriers must be at least 1");
+    }
+
+    if(physicsWorkerThreadCount < -1
+        || physicsWorkerThreadCount > maxPhysicsWorkerThreadCount)
+    {
+        return fail("physicsWorkerThreadCount must be between -1 and 256");
+    }
+
+    if(physicsWorkerFirstCpu < 0 || physicsWorkerFirstCpu >= maxCpuIndex)
+    {
+        return fail("physicsWorkerFirstCpu must be between 0 and 1023");
+    }
+
+    if(networkThreadCpu < -1 || networkThreadCpu >= maxCpuIndex)
+    {
+        return fail("networkThreadCpu must be between -1 and 1023");
+    }
+
+    if(profileDumpThresholdMicroseconds > 0 && profileDumpDirectory.empty())
+    {
+        return fail("profileDumpDirectory must not be empty if the slow "
+            "steps are dumped");
+    }
+
+    if(snapshotDirectory.empty())
+    {
+        return fail("snapshotDirectory must not be empty");
+    }
+
+    if(worldCount == 0 || worldCount > maxWorldCount)
+    {
+        return fail("worldCount must be between 1 and 256");
+    }
+
+    // Each physics step waits on a barrier of the job system, so the worlds
+    // sharing it need one each to step at once
+    if(worldCount > maxPhysicsBarriers)
+    {
+        return fail("maxPhysicsBarriers must be at least worldCount");
+    }
+
+    // Friction is applied with the non penetration impulse of the previous
+    // velocity step, so at least 2 are needed
+    if(physicsSettings.mNumVelocitySteps < 2)
+    {
+        return fail("numVelocitySteps must be at least 2");
+    }
+
+    if(physicsSettings.mBaumgarte < 0.f || physicsSettings.mBaumgarte > 1.f)
+    {
+        return fail("baumgarte must be between 0 and 1");
+    }
+
+    if(physicsSettings.mSpeculativeContactDistance < 0.f
+        || physicsSettings.mPenetrationSlop < 0.f
+        || physicsSettings.mMinVelocityForRestitution < 0.f
+        || physicsSettings.mTimeBeforeSleep < 0.f
+        || physicsSettings.mPointVelocitySleepThreshold < 0.f)
+    {
+        return fail("Contact distances, velocity thresholds and sleep times "
+            "must not be negative");
+    }
+
+    return true;
+}
+
+PhysicsServiceConfig::MemoryFootprint
+    PhysicsServiceConfig::EstimateMemoryFootprint() const
+{
+    MemoryFootprint memoryFootprint;
+
+    // Each body slot has a pointer and an entry on the active bodies list
+    memoryFootprint.bodies = static_cast<std::uint64_t>(maxBodies)
+        * (sizeof(Body*) + sizeof(BodyID) + sizeof(Body)
+        + sizeof(MotionProperties));
+
+    // The broad phase pools the nodes of its trees (two per layer, as they
+    // are rebuilt double buffered) by the number of bodies
+    const std::uint64_t broadPhaseLeafCount = (maxBodies + 1) / 2;
+    const std::uint64_t broadPhaseNodeCount = 2
+        * (broadPhaseLeafCount + (broadPhaseLeafCount + 2) / 3);
+    memoryFootprint.broadPhase = broadPhaseNodeCount
+        * estimatedQuadTreeNodeSize
+        + static_cast<std::uint64_t>(maxBodies)
+        * estimatedBroadPhaseTrackingSize;
+
+    // The contact caches of the last and the current step
+    memoryFootprint.contactCaches = 2
+        * (static_cast<std::uint64_t>(maxBodyPairs)
+        * estimatedCachedBodyPairSize
+        + static_cast<std::uint64_t>(maxContactConstraints)
+        * estimatedCachedManifoldSize);
+
+    memoryFootprint.tempAllocator = tempAllocatorSize;
+
+    // Every worker's deque is as large as the job pool
+    memoryFootprint.jobSystem = static_cast<std::uint64_t>(maxPhysicsJobs)
+        * (estimatedJobSize + static_cast<std::uint64_t>
+        (GetResolvedPhysicsWorkerThreadCount()) * sizeof(void*));
+
+    // The registry (dense and sparse), the runtime data, the extracted step
+    // states and the active set's last reported states
+    const std::uint64_t serviceTablesBodySize =
+        sizeof(BodyID) + sizeof(std::uint32_t)
+        + sizeof(EBodyType) + sizeof(std::uint32_t) + sizeof(std::uint8_t)
+        + sizeof(uint32)
+        + sizeof(BodyID) + 3 * sizeof(Real) + 13 * sizeof(float)
+        + sizeof(EBodyType)
+        + sizeof(BodyStepState) + sizeof(bool);
+    memoryFootprint.serviceTables = static_cast<std::uint64_t>(maxBodies)
+        * serviceTablesBodySize;
+
+    return memoryFootprint;
+}
+
+std::string PhysicsServiceConfig::GetMemoryFootprintReport() const
+{
+    const MemoryFootprint memoryFootprint = EstimateMemoryFootprint();
+
+    char report[512];
+    std::snprintf(report, sizeof(report), "Physics config: %u max bodies, "
+        "%u max body pairs, %u max contact constraints, %d worker threads, "
+        "%u velocity and %u position steps. Estimated memory footprint: "
+        "%.1f MiB (bodies %.1f MiB, broad phase %.1f MiB, contact caches "
+        "%.1f MiB, temp allocator %.1f MiB, job system %.1f MiB, service "
+        "tables %.1f MiB).", maxBodies, maxBodyPairs, maxContactConstraints,
+        GetResolvedPhysicsWorkerThreadCount(),
+        static_cast<unsigned>(physicsSettings.mNumVelocitySteps),
+        static_cast<unsigned>(physicsSettings.mNumPositionSteps),
+        ToMebibytes(memoryFootprint.GetTotal()),
+        ToMebibytes(memoryFootprint.bodies),
+        ToMebibytes(memoryFootprint.broadPhase),
+        ToMebibytes(memoryFootprint.contactCaches),
+        ToMebibytes(memoryFootprint.tempAllocator),
+        ToMebibytes(memoryFootprint.jobSystem),
+        ToMebibytes(memoryFootprint.serviceTables));
+
+    return report;
+}
+
+int PhysicsServiceConfig::GetResolvedPhysicsWorkerThreadCount() const
+{
+    if(physicsWorkerThreadCount >= 0)
+    {
+        return physicsWorkerThreadCount;
+    }
+
+    // The thread updating the physics system runs jobs too
+    const int hardwareThreadCount =
+        static_cast<int>(std::thread::hardware_concurrency());
+    return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0;
+}
+
+PhysicsSettings PhysicsServiceConfig::GetDefaultPhysicsSettings()
+{
+    PhysicsSettings physicsSettingsData;
+    physicsSettingsData.mNumVelocitySteps = 10;
+    physicsSettingsData.mNumPositionSteps = 2;
+    physicsSettingsData.mBaumgarte = 0.2f;
+
+    physicsSettingsData.mSpeculativeContactDistance = 0.02f;
+    physicsSettingsData.mPenetrationSlop = 0.02f;
+    physicsSettingsData.mMinVelocityForRestitution = 1.0f;
+    physicsSettingsData.mTimeBeforeSleep = 0.5f;
+    physicsSettingsData.mPointVelocitySleepThreshold = 0.03f;
+
+    physicsSettingsData.mDeterministicSimulation = true;
+    physicsSettingsData.mConstraintWarmStart = true;
+    physicsSettingsData.mUseBodyPairContactCache = true;
+    physicsSettingsData.mUseManifoldReduction = true;
+    physicsSettingsData.mUseLargeIslandSplitter = true;
+    physicsSettingsData.mAllowSleeping = true;
+    physicsSettingsData.mCheckActiveEdges = true;
+
+    return physicsSettingsData;
+}
@@ -0,0 +1,282 @@
+#ifndef PHYSICSSERVICECONFIG_H
+#define PHYSICSSERVICECONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Math/Vec3.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+
+using namespace JPH;
+
+/**
+* The runtime configuration of a physics service instance: the physics
+* system's capacity, the solver settings and the threading of the physics
+* update. Every value defaults to the service's former hard-coded value.
+*
+* The values are given as "key=value" pairs, which may come from a config
+* file (see "LoadFromFile()"), the command line (see
+* "LoadFromCommandLine()") or an "Init" message (see
+* "PhysicsServiceImpl::InitPhysicsSystem()"). The keys are the names of the
+* fields below (e.g. "maxBodies=50000" or "numVelocitySteps=8").
+*
+* A config should be validated (see "Validate()") before it is used to
+* initialize a physics system.
+*/
+struct PhysicsServiceConfig
+{
+    /**
+    * Sets a config value from its text.
+    *
+    * @param key The value's key (e.g. "maxBodies")
+    * @param value The value's text
+    * @param outError The error, if the key is unknown or the value could not
+    * be parsed
+    *
+    * @return True if the value was set
+    */
+    bool SetValue(std::string_view key, std::string_view value,
+        std::string& outError);
+
+    /**
+    * Sets a config value from a "key=value" pair.
+    *
+    * @param keyValuePair The "key=value" pair
+    * @param outError The error, if the pair is malformed or the value could
+    * not be set
+    *
+    * @return True if the value was set
+    */
+    bool SetKeyValuePair(std::string_view keyValuePair, std::string& outError);
+
+    /**
+    * Sets a config value from a "key=value" pair of an "Init" message. Only
+    * the world's capacities, solver settings and temp allocator settings may
+    * be set on Init, as the other values are only read when the service
+    * starts.
+    *
+    * @param keyValuePair The "key=value" pair
+    * @param outError The error, if the key can't be set on Init, the pair is
+    * malformed or the value could not be set
+    *
+    * @return True if the value was set
+    */
+    bool SetInitKeyValuePair(std::string_view keyValuePair,
+        std::string& outError);
+
+    /**
+    * Loads the config values from a file. The file has a "key=value" pair
+    * per line. Empty lines and lines starting with '#' are ignored.
+    *
+    * @param configFilePath The path of the config file
+    * @param outError The error, with the line it happened on, if the file
+    * could not be read or any of its values could not be set
+    *
+    * @return True if every value on the file was set
+    */
+    bool LoadFromFile(const std::string& configFilePath,
+        std::string& outError);
+
+    /**
+    * Loads the config values from the command line arguments. Every argument
+    * of the form "--key=value" sets a value, and "--config=<path>" loads a
+    * config file (see "LoadFromFile()") at its position, so the values given
+    * after it override the file's. Any other argument is ignored.
+    *
+    * @param argc The number of command line arguments
+    * @param argv The command line arguments (the first one is skipped, as
+    * it is the program's name)
+    * @param outError The error, if any of the values could not be set
+    *
+    * @return True if every value was set
+    */
+    bool LoadFromCommandLine(int argc, char** argv, std::string& outError);
+
+    /**
+    * Checks if every value is within the range accepted by the physics
+    * system.
+    *
+    * @param outError The error, with the first invalid value
+    *
+    * @return True if the config is valid
+    */
+    bool Validate(std::string& outError) const;
+
+    /** The estimated memory footprint of a physics system, by part */
+    struct MemoryFootprint
+    {
+        /** The bodies and their motion properties */
+        std::uint64_t bodies = 0;
+
+        /** The broad phase's trees and body tracking */
+        std::uint64_t broadPhase = 0;
+
+        /** The (double buffered) body pair and contact manifold caches */
+        std::uint64_t contactCaches = 0;
+
+        /** The pre-allocated temp allocator (its initial size) */
+        std::uint64_t tempAllocator = 0;
+
+        /** The job system's job pool and worker deques */
+        std::uint64_t jobSystem = 0;
+
+        /** The service's per body tables (registry, runtime data, states) */
+        std::uint64_t serviceTables = 0;
+
+        /** @return The total memory footprint, in bytes */
+        std::uint64_t GetTotal() const
+        {
+            return bodies + broadPhase + contactCaches + tempAllocator 
+                + jobSystem + serviceTables;
+        }
+    };
+
+    /**
+    * Estimates the memory used by a physics system with this config, with
+    * every body slot in use by a dynamic body. Jolt's internal structures
+    * are approximated, so this is an estimate.
+    *
+    * @return The estimated memory footprint, in bytes
+    */
+    MemoryFootprint EstimateMemoryFootprint() const;
+
+    /**
+    * @return A report (single line) with the main values of the config and
+    * the estimated memory footprint, broken down by part
+    */
+    std::string GetMemoryFootprintReport() const;
+
+    /** The max amount of rigid bodies on the physics system */
+    std::uint32_t maxBodies = 128000;
+
+    /**
+    * How many mutexes to allocate to protect the rigid bodies from
+    * concurrent access. 0 for the default settings
+    */
+    std::uint32_t numBodyMutexes = 0;
+
+    /**
+    * The max amount of body pairs that can be queued at any time. If too
+    * small, the broad phase jobs start doing narrow phase work
+    */
+    std::uint32_t maxBodyPairs = 65536;
+
+    /**
+    * The max amount of contact constraints. Further contacts are ignored,
+    * and the bodies start interpenetrating
+    */
+    std::uint32_t maxContactConstraints = 10240;
+
+    /**
+    * The initial size of the temp allocator, which is pre-allocated to avoid
+    * allocations during the physics update
+    */
+    std::uint32_t tempAllocatorSize = 10 * 1024 * 1024;
+
+    /** The size the temp allocator never shrinks under */
+    std::uint32_t tempAllocatorMinSize = 1024 * 1024;
+
+    /** The size the temp allocator never grows past */
+    std::uint32_t tempAllocatorMaxSize = 256 * 1024 * 1024;
+
+    /**
+    * The fraction of the temp allocator's size a step's peak usage must
+    * reach for it to grow
+    */
+    float tempAllocatorGrowThreshold = 0.8f;
+
+    /**
+    * The number of consecutive steps using under a quarter of the temp
+    * allocator for it to shrink. 0 never shrinks it
+    */
+    std::uint32_t tempAllocatorShrinkCooldownSteps = 600;
+
+    /** If the temp allocator is mapped on huge pages when available */
+    bool tempAllocatorUseHugePages = true;
+
+    /** The max amount of jobs of the physics job system */
+    std::uint32_t maxPhysicsJobs = cMaxPhysicsJobs;
+
+    /** The max amount of barriers of the physics job system */
+    std::uint32_t maxPhysicsBarriers = cMaxPhysicsBarriers;
+
+    /**
+    * The number of worker threads of the physics job system (the thread
+    * updating the physics system runs jobs too). -1 to use one less than
+    * the number of hardware threads
+    */
+    int physicsWorkerThreadCount = -1;
+
+    /** If each physics worker thread is pinned to a CPU */
+    bool pinPhysicsWorkerThreads = false;
+
+    /**
+    * The CPU the first physics worker thread is pinned to, if they are
+    * pinned. The next workers take the next CPUs
+    */
+    int physicsWorkerFirstCpu = 0;
+
+    /**
+    * The CPU the network thread (which also updates the physics system) is
+    * pinned to, or -1 to leave it unpinned. The physics workers skip it
+    */
+    int networkThreadCpu = -1;
+
+    /**
+    * How many times an idle physics worker looks for jobs before it sleeps
+    */
+    std::uint32_t physicsWorkerIdleSpinCount = 256;
+
+    /**
+    * The minimum number of bodies on a batch for the broad phase to be
+    * optimized after the batch is added. 0 disables the optimization
+    */
+    std::uint32_t broadPhaseOptimizationBodyThreshold = 1000;
+
+    /**
+    * The steps at least this long (in microseconds) have their profile
+    * dumped, on the phase profiling build (see "PhaseProfiler"). 0 never
+    * dumps them
+    */
+    std::uint32_t profileDumpThresholdMicroseconds = 0;
+
+    /** The directory the profiles of the slow steps are dumped to */
+    std::string profileDumpDirectory = ".";
+
+    /** The max number of slow step profiles dumped */
+    std::uint32_t profileMaxDumps = 16;
+
+    /**
+    * The directory the world snapshots are saved to and loaded from (see
+    * "SaveSnapshot" and "LoadSnapshot")
+    */
+    std::string snapshotDirectory = ".";
+
+    /**
+    * The number of physics worlds hosted by the service, each addressed by
+    * its world ID (see "PhysicsWorldHost"). With more than one, the worlds
+    * share a job system and a pool of temp allocators. Only read when the
+    * service starts
+    */
+    std::uint32_t worldCount = 1;
+
+    /** The gravity (on the z-axis by default, as Unreal's gravity) */
+    Vec3 gravity = Vec3(0.f, 0.f, -980.f);
+
+    /** The solver and sleeping settings of the physics system */
+    PhysicsSettings physicsSettings = GetDefaultPhysicsSettings();
+
+    /**
+    * @return The number of worker threads of the physics job system, with
+    * -1 resolved to the hardware threads
+    */
+    int GetResolvedPhysicsWorkerThreadCount() const;
+
+private:
+    /** @return The service's default physics settings */
+    static PhysicsSettings GetDefaultPhysicsSettings();
+};
+
+#endif
@@ -1,253 +1,421 @@
 #include "PhysicsServiceImpl.h"
+#include "PhysicsWorldHost.h"
 #include <ctime>
 #include <cstdlib>
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <mutex>
 
-void PhysicsServiceImpl::InitPhysicsSystem
-	(const std::string initializationActorsInfo)
+namespace
 {
-    std::cout << "Initializing physics system...\n";
-    std::cout << "InitializationInfo:\n" << initializationActorsInfo << '\n';
+	/** Guards the registration of Jolt's types */
+	std::mutex joltTypesMutex;
 
-	// If physics system is already initialized, clear the last initialization
-	if(bIsInitialized)
+	/** The physics systems using Jolt's types */
+	std::uint32_t joltTypesUserCount = 0;
+
+	/** 
+	* Registers Jolt's allocator, factory and types for the first physics 
+	* system. They are global, so the worlds of a host share them
+	*/
+	void AcquireJoltTypes()
 	{
-		ClearPhysicsSystem();
+		std::lock_guard<std::mutex> joltTypesLock(joltTypesMutex);
+		if(joltTypesUserCount++ > 0)
+		{
+			return;
+		}
+
+		// Register allocation hook
+		RegisterDefaultAllocator();
+
+		// Create a factory
+		Factory::sInstance = new Factory();
+
+		// Register all Jolt physics types
+		RegisterTypes();
 	}
 
-	// Register allocation hook
-	RegisterDefaultAllocator();
+	/** Unregisters Jolt's types once the last physics system is destroyed */
+	void ReleaseJoltTypes()
+	{
+		std::lock_guard<std::mutex> joltTypesLock(joltTypesMutex);
+		if(--joltTypesUserCount > 0)
+		{
+			return;
+		}
 
-	// Install callbacks
-	//Trace = TraceImpl;
-	JPH_IF_ENABLE_ASSERTS(AssertFailed = AssertFailedImpl;)
+		// Unregisters all types with the factory and cleans up the default 
+		// material
+		UnregisterTypes();
 
-	// Create a factory
-	Factory::sInstance = new Factory();
-
-	// Register all Jolt physics types
-	RegisterTypes();
-
-	// We need a temp allocator for temporary allocations during the physics 
-	// update. We're pre-allocating 10 * 1024 * 1024 MB to avoid having to do 
-	// allocations during the physics update. 
-	// If you don't want to pre-allocate you can also use TempAllocatorMalloc 
-	// to fall back to malloc/free.
-	temp_allocator = new TempAllocatorImpl(10 * 1024 * 1024);
-
-	// We need a job system that will execute physics jobs on multiple threads. 
-	// Typically you would implement the JobSystem interface yourself and let 
-	// Jolt Physics run on top of your own job scheduler. JobSystemThreadPool 
-	// is an example implementation.
-	job_system = new JobSystemThreadPool(cMaxPhysicsJobs, cMaxPhysicsBarriers,
-		thread::hardware_concurrency() - 1);
-
-	// This is the max amount of rigid bodies that you can add to the physics 
-	// system. If you try to add more you'll get an error.
-	// Note: This value is low because this is a simple test. For a real 
-	// project use something in the order of 65536.
-	const uint cMaxBodies = 128000;
-
-	// This determines how many mutexes to allocate to protect rigid bodies 
-	// from concurrent access. Set it to 0 for the default settings.
-	const uint cNumBodyMutexes = 0;
-
-	// This is the max amount of body pairs that can be queued at any time 
-	// (the broad phase will detect overlapping
-	// body pairs based on their bounding boxes and will insert them into a 
-	// queue for the narrowphase). If you make this buffer
-	// too small the queue will fill up and the broad phase jobs will start to
-	// do narrow phase work. This is slightly less efficient.
-	// Note: This value is low because this is a simple test. For a real 
-	// project use something in the order of 65536.
-	const uint cMaxBodyPairs = 65536;
-
-	// This is the maximum size of the contact constraint buffer. If more 
-	// contacts (collisions between bodies) are detected than this
-	// number then these contacts will be ignored and bodies will start 
-	// interpenetrating / fall through the world.
-	// Note: This value is low because this is a simple test. For a real 
-	// project use something in the order of 10240.
-	const uint cMaxContactConstraints = 10240;
+		// Destroy the factory
+		delete Factory::sInstance;
+		Factory::sInstance = nullptr;
+	}
+}
 
-	// Now we can create the actual physics system.
-	physics_system = new PhysicsSystem();
-	physics_system->Init(cMaxBodies, cNumBodyMutexes, cMaxBodyPairs, 
-		cMaxContactConstraints, broad_phase_layer_interface, 
-		object_vs_broadphase_layer_filter, object_vs_object_layer_filter);
-
-	// Define the physics world settings
-	PhysicsSettings physicsSettingsData;
-	physicsSettingsData.mNumVelocitySteps = 10;
-	physicsSettingsData.mNumPositionSteps = 2;
-	physicsSettingsData.mBaumgarte = 0.2f;
-
-	physicsSettingsData.mSpeculativeContactDistance = 0.02f;
-	physicsSettingsData.mPenetrationSlop = 0.02f;
-	physicsSettingsData.mMinVelocityForRestitution = 1.0f;
-	physicsSettingsData.mTimeBeforeSleep = 0.5f;
-	physicsSettingsData.mPointVelocitySleepThreshold = 0.03f;
-
-	physicsSettingsData.mDeterministicSimulation = true;
-	physicsSettingsData.mConstraintWarmStart = true;
-	physicsSettingsData.mUseBodyPairContactCache = true;
-	physicsSettingsData.mUseManifoldReduction = true;
-	physicsSettingsData.mUseLargeIslandSplitter = true;
-	physicsSettingsData.mAllowSleeping = true;
-	physicsSettingsData.mCheckActiveEdges = true;
-
-	// Set the new physics settings
-	physics_system->SetPhysicsSettings(physicsSettingsData);
-
-	// Define gravity to act on the z-axis 
-	// (so it is the same as Unreal's gravity)
-	Vec3Arg newGravity(0.f, 0.f, -980.f);
-	physics_system->SetGravity(newGravity);
+#ifdef JPH_TRACK_BROADPHASE_STATS
+namespace
+{
+	/** The lines traced by Jolt while they are captured */
+	std::string* capturedTraceLines = nullptr;
 
-	// A body activation listener gets notified when bodies activate and go 
-	// to sleep
-	// Note that this is called from a job so whatever you do here needs to be 
-	// thread safe.
-	// Registering one is entirely optional.
-	physics_system->SetBodyActivationListener(body_activation_listener);
+	/** Appends a traced line to the captured lines */
+	void CaptureTrace(const char* inFMT, ...)
+	{
+		va_list list;
+		va_start(list, inFMT);
+		char buffer[1024];
+		vsnprintf(buffer, sizeof(buffer), inFMT, list);
+		va_end(list);
+
+		*capturedTraceLines += buffer;
+		*capturedTraceLines += '\n';
+	}
+}
+#endif
 
-	// A contact listener gets notified when bodies (are about to) collide, 
-	// and when they separate again.
-	// Note that this is called from a job so whatever you do here needs to 
-	// be thread safe.
-	// Registering one is entirely optional.
-	physics_system->SetContactListener(contact_listener);
+std::string PhysicsServiceImpl::InitPhysicsSystem
+	(std::string_view initializationActorsInfo)
+{
+    LOG_INFO(Physics, "Initializing physics system...");
+    LOG_DEBUG(Physics, "InitializationInfo:\n%.*s", 
+		ServiceLogger::ClampTextLength(initializationActorsInfo.size()), 
+		initializationActorsInfo.data());
 
-	// The main way to interact with the bodies in the physics system is 
-	// through the body interface. There is a locking and a non-locking
-	// variant of this. We're going to use the locking version (even though 
-	// we're not planning to access bodies from multiple threads)
-	body_interface = &physics_system->GetBodyInterface();
+	const auto initStartTime = std::chrono::steady_clock::now();
 
-	// Split actors info from initialization into lines
-	std::stringstream initializationStringStream(initializationActorsInfo);
-    std::vector<std::string> initializationActorsInfoLines;
+	// Split actors info from initialization into lines. The lines are views
+	// on the initialization info, so the (possibly large) info is not copied
+    std::vector<std::string_view> initializationActorsInfoLines;
 
-	std::string line;
-    while (std::getline(initializationStringStream, line)) 
+	size_t lineStartPos = 0;
+	while (lineStartPos < initializationActorsInfo.size()) 
 	{
-        initializationActorsInfoLines.push_back(line);
+		size_t lineEndPos = initializationActorsInfo.find('\n', lineStartPos);
+		if(lineEndPos == std::string_view::npos)
+		{
+			lineEndPos = initializationActorsInfo.size();
+		}
+
+        initializationActorsInfoLines.push_back(initializationActorsInfo.substr
+			(lineStartPos, lineEndPos - lineStartPos));
+
+		lineStartPos = lineEndPos + 1;
     }
 
-	// for each line, create a new body with according to the
-	// body's type, id and initial location
-	for(int i = 0; i < initializationActorsInfoLines.size(); i++)
+	// Apply the config lines ("config;key=value") on top of the service's 
+	// config. This initialization's config is validated before the current 
+	// physics system is touched, so an invalid one keeps it running
+	PhysicsServiceConfig initConfig = serviceConfig;
+	std::string initConfigError;
+
+	for(const std::string_view actorInfoLine : initializationActorsInfoLines)
+	{
+		if(!IsInitConfigLine(actorInfoLine))
+		{
+			continue;
+		}
+
+		if(!initConfig.SetInitKeyValuePair(actorInfoLine.substr
+			(initConfigLinePrefix.size()), initConfigError))
+		{
+			break;
+		}
+	}
+
+	if(initConfigError.empty())
 	{
-		// Split info with ";" delimiter
-		std::stringstream actorInfoStringStream
-			(initializationActorsInfoLines[i]);
-		std::vector<std::string> actorInfoList;
+		initConfig.Validate(initConfigError);
+	}
+
+	if(!initConfigError.empty())
+	{
+		LOG_WARNING(Physics, "Invalid initialization config: %s", 
+			initConfigError.c_str());
+		return "Error: Physics system was not initialized. Invalid config: " 
+			+ initConfigError;
+	}
 
-		std::string actorInfoData;
-		while (std::getline(actorInfoStringStream, actorInfoData, ';')) 
+	// for each line, get the info of a new body with according to the
+	// body's type, id and initial location. The bodies are created and 
+	// inserted on the physics world as a single batch afterwards. The lines
+	// are parsed before the current physics system is touched, so a 
+	// malformed one keeps it running
+	std::vector<BodyCreationInfo> initialBodiesCreationInfo;
+	initialBodiesCreationInfo.reserve(initializationActorsInfoLines.size());
+	std::vector<std::string_view> actorInfoList;
+
+	for(const std::string_view actorInfoLine : initializationActorsInfoLines)
+	{
+		// The config lines were already applied
+		if(IsInitConfigLine(actorInfoLine))
 		{
-			actorInfoList.push_back(actorInfoData);
+			continue;
 		}
 
+		// Split info with ";" delimiter. The fields are views on the line,
+		// read with the same rules as the other messages' records
+		TextRecordParser::SplitRecordIntoFields(actorInfoLine, actorInfoList);
+
 		// Check for errors
 		if(actorInfoList.size() < 6)
 		{
-        	std::cout << "Error on parsing addBody message info. Line with "
-			"less than 6 params: " << initializationActorsInfoLines[i] << '\n';
+        	LOG_WARNING(Physics, "Error on parsing addBody message info. Line "
+				"with less than 6 params: %.*s", ServiceLogger::ClampTextLength
+				(actorInfoLine.size()), actorInfoLine.data());
 			continue;
 		}
 
 		// Get the actor's type to be creates
-		const std::string actorType { actorInfoList[0] };
+		const std::string_view actorType { actorInfoList[0] };
 
-		// Get the actor ID from the init info
-		const int actorId { std::stoi(actorInfoList[1])} ;
-		const BodyID newBodyID(actorId);
+		BodyCreationInfo bodyCreationInfo;
+
+		// Check if we should create a floor or a sphere
+		if(actorType.find("floor") != std::string::npos)
+		{
+			bodyCreationInfo.shapeType = EBodyShapeType::Floor;
+		}
+		else if(actorType.find("sphere") != std::string::npos)
+		{
+			bodyCreationInfo.shapeType = EBodyShapeType::Sphere;
+		}
+		else
+		{
+			LOG_WARNING(Physics, "Unknown actor type: %.*s", 
+				ServiceLogger::ClampTextLength(actorType.size()), 
+				actorType.data());
+			continue;
+		}
+
+		// Get the actor ID and initial position from the init info
+		int actorId = 0;
+		double initialPosX = 0.0;
+		double initialPosY = 0.0;
+		double initialPosZ = 0.0;
+		if(!TextRecordParser::ParseNumberField(actorInfoList[1], actorId)
+			|| !TextRecordParser::ParseNumberField(actorInfoList[3], 
+			initialPosX)
+			|| !TextRecordParser::ParseNumberField(actorInfoList[4], 
+			initialPosY)
+			|| !TextRecordParser::ParseNumberField(actorInfoList[5], 
+			initialPosZ))
+		{
+			LOG_WARNING(Physics, "Error on parsing init message info. Invalid"
+				" actor ID or position: %.*s", ServiceLogger::ClampTextLength
+				(actorInfoLine.size()), actorInfoLine.data());
+			return "Error: Physics system was not initialized. Invalid actor "
+				"ID or position: " + std::string(actorInfoLine);
+		}
+		bodyCreationInfo.bodyId = BodyID(actorId);
 
 		// Get the new body type as string
-		const std::string newBodyTypeAsString { actorInfoList[2] };
+		const std::string_view newBodyTypeAsString { actorInfoList[2] };
 
 		// Set the new body type
-		EBodyType newBodyType {};
 		if(newBodyTypeAsString == "primary")
 		{
-			newBodyType = EBodyType::Primary;
+			bodyCreationInfo.bodyType = EBodyType::Primary;
 		}
 		else if(newBodyTypeAsString == "clone")
 		{
-			newBodyType = EBodyType::Clone;
+			bodyCreationInfo.bodyType = EBodyType::Clone;
 		}
 		else
 		{
-			std::cout << "Unknown body type: " << newBodyTypeAsString << '\n';
+			LOG_WARNING(Physics, "Unknown body type: %.*s", 
+				ServiceLogger::ClampTextLength(newBodyTypeAsString.size()), 
+				newBodyTypeAsString.data());
 		}
 
-		// Get actor initial pos
-		const double initialPosX { std::stod(actorInfoList[3]) };
-		const double initialPosY { std::stod(actorInfoList[4]) };
-		const double initialPosZ { std::stod(actorInfoList[5]) };
+		bodyCreationInfo.initialPosition = RVec3(initialPosX, initialPosY,
+			initialPosZ);
 
-		const RVec3 bodyInitialPosition { RVec3(initialPosX, initialPosY,
-			initialPosZ) };
+		initialBodiesCreationInfo.push_back(bodyCreationInfo);
+	}
 
-		// Check if we should create a floor
-		if(actorType.find("floor") != std::string::npos)
-		{
-			// Add new floor to the physics world
-			AddNewFloorToPhysicsSystem(newBodyID, bodyInitialPosition);
-			continue;
-		}
+	LOG_INFO(Physics, "%s", initConfig.GetMemoryFootprintReport().c_str());
 
-		// Check if we should create a sphere
-		if(actorType.find("sphere") != std::string::npos)
-		{
-			// Add new sphere to the physics world
-			AddNewSphereToPhysicsWorld(newBodyID, newBodyType, 
-				bodyInitialPosition, RVec3(), RVec3());
-			continue;
-		}
+	// If physics system is already initialized, clear the last initialization
+	if(bIsInitialized)
+	{
+		ClearPhysicsSystem();
 	}
 
-	// Seed the random number generator with the current time
-	srand(static_cast<unsigned int>(time(0)));
+	// Create the physics system with this initialization's config
+	CreatePhysicsSystem(initConfig);
 
-	// Optional step: Before starting the physics simulation you can optimize 
-	// the broad phase. This improves collision detection performance 
-	// (it's pointless here because we only have 2 bodies).
-	// You should definitely not call this every frame or when e.g. 
-	// streaming in a new level section as it is an expensive operation.
-	// Instead insert all new objects in batches instead of 1 at a time to 
-	// keep the broad phase efficient.
-	//physics_system->OptimizeBroadPhase();
+	const auto bodiesParsedTime = std::chrono::steady_clock::now();
 
-	// Reset the step physics time measurement 
-    physicsStepSimulationTimeMeasure = "";
+	// Create and insert every body on the physics world in a batch. This 
+	// also optimizes the broad phase if the batch is large enough
+	const size_t initialBodiesCount = 
+		AddNewBodiesToPhysicsWorld(initialBodiesCreationInfo);
 
-	bIsInitialized = true;
+	// Reset the measures, so they start with the new world
+	StartSimulation(initConfig);
+
+	// Measure how long the initialization took
+	const auto initEndTime = std::chrono::steady_clock::now();
+
+	const double initDurationMs = std::chrono::duration<double, std::milli>
+		(initEndTime - initStartTime).count();
+	const double bodiesInsertionDurationMs = 
+		std::chrono::duration<double, std::milli>
+		(initEndTime - bodiesParsedTime).count();
+
+	char initReport[256];
+	snprintf(initReport, sizeof(initReport), "Physics system initialized with"
+		" %zu bodies in %.3f ms (%.3f ms creating and inserting bodies).",
+		initialBodiesCount, initDurationMs, bodiesInsertionDurationMs);
+
+    LOG_INFO(Physics, "Physics world has been initialized and is running. %s",
+		initReport);
 
-    std::cout << "Physics world has been initialized and is running.\n";
+	return initReport;
 }
 
-std::string PhysicsServiceImpl::StepPhysicsSimulation()
+void PhysicsServiceImpl::CreatePhysicsSystem
+	(const PhysicsServiceConfig& worldConfig)
 {
-	// If you take larger steps than 1 / 60th of a second you need to do 
-	// multiple collision steps in order to keep the simulation stable. 
-	// Do 1 collision step per 1 / 60th of a second (round up).
-	const int cCollisionSteps = 1;
+	// Register Jolt's allocator, factory and types, unless another world 
+	// already did
+	AcquireJoltTypes();
 
-	// If you want more accurate step results you can do multiple sub steps 
-	// within a collision step. Usually you would set this to 1.
-	const int cIntegrationSubSteps = 1;
+	// Install callbacks
+	//Trace = TraceImpl;
+	JPH_IF_ENABLE_ASSERTS(AssertFailed = AssertFailedImpl;)
 
-	// We simulate the physics world in discrete time steps. 60 Hz is a good 
-	// rate to update the physics system.
-	const float cDeltaTime = 1.0f / 60.f;
+	// The estimated footprint of the world. The resources shared with the
+	// other worlds are reported by the host
+	const PhysicsServiceConfig::MemoryFootprint memoryFootprint = 
+		worldConfig.EstimateMemoryFootprint();
+	worldMemoryFootprintBytes = memoryFootprint.GetTotal();
+
+	if(UsesSharedResources())
+	{
+		// The physics steps take a temp allocator from the host's pool, and
+		// run their jobs on the host's job system
+		job_system = worldHost->GetSharedJobSystem();
+		worldMemoryFootprintBytes -= 
+			memoryFootprint.tempAllocator + memoryFootprint.jobSystem;
+	}
+	else
+	{
+		// We need a temp allocator for temporary allocations during the 
+		// physics update. It is pre-allocated (see the config's 
+		// "tempAllocatorSize") to avoid having to do allocations during the
+		// physics update, and adapts its size to the physics world between
+		// steps (see "AdaptiveTempAllocator").
+		temp_allocator = new AdaptiveTempAllocator
+			(GetTempAllocatorSettings(worldConfig));
+
+		// We need a job system that will execute physics jobs on multiple 
+		// threads. The service's job system gives each worker thread its own
+		// deque of jobs, and idle workers steal from the others (see 
+		// "WorkStealingJobSystem").
+		job_system = new WorkStealingJobSystem
+			(GetJobSystemSettings(worldConfig));
+	}
+
+	// Now we can create the actual physics system. The capacities are given
+	// by the config:
+	// - maxBodies is the max amount of rigid bodies that you can add to the 
+	// physics system. If you try to add more you'll get an error.
+	// - numBodyMutexes determines how many mutexes to allocate to protect 
+	// rigid bodies from concurrent access. 0 for the default settings.
+	// - maxBodyPairs is the max amount of body pairs that can be queued at 
+	// any time (the broad phase will detect overlapping body pairs based on 
+	// their bounding boxes and will insert them into a queue for the 
+	// narrowphase). If you make this buffer too small the queue will fill up
+	// and the broad phase jobs will start to do narrow phase work. This is 
+	// slightly less efficient.
+	// - maxContactConstraints is the maximum size of the contact constraint 
+	// buffer. If more contacts (collisions between bodies) are detected than
+	// this number then these contacts will be ignored and bodies will start 
+	// interpenetrating / fall through the world.
+	physics_system = new PhysicsSystem();
+	physics_system->Init(worldConfig.maxBodies, worldConfig.numBodyMutexes, 
+		worldConfig.maxBodyPairs, worldConfig.maxContactConstraints, 
+		broad_phase_layer_interface, object_vs_broadphase_layer_filter, 
+		object_vs_object_layer_filter);
+
+	// Set the physics world settings (solver steps, contact and sleeping 
+	// thresholds)
+	physics_system->SetPhysicsSettings(worldConfig.physicsSettings);
+
+	// Set the gravity (by default it acts on the z-axis, so it is the same 
+	// as Unreal's gravity)
+	physics_system->SetGravity(worldConfig.gravity);
+
+	broadPhaseOptimizationBodyThreshold = 
+		worldConfig.broadPhaseOptimizationBodyThreshold;
+
+	// A body activation listener gets notified when bodies activate and go 
+	// to sleep
+	// Note that this is called from a job so whatever you do here needs to be 
+	// thread safe.
+	// Registering one is needed for the active set step responses.
+	body_activation_listener = new MyBodyActivationListener();
+	physics_system->SetBodyActivationListener(body_activation_listener);
+
+	// A contact listener gets notified when bodies (are about to) collide, 
+	// and when they separate again.
+	// Note that this is called from a job so whatever you do here needs to 
+	// be thread safe.
+	// Registering one is entirely optional.
+	physics_system->SetContactListener(contact_listener);
+
+	// The main way to interact with the bodies in the physics system is 
+	// through the body interface. There is a locking and a non-locking
+	// variant of this. We're going to use the locking version (even though 
+	// we're not planning to access bodies from multiple threads)
+	body_interface = &physics_system->GetBodyInterface();
+
+	// Pre-warm the shape cache with the shapes of the service's bodies, so
+	// the bodies created from now on only take a reference to them
+	GetSphereBodyShape();
+	GetFloorBodyShape();
+
+	LOG_DEBUG(Physics, "Shape cache pre-warmed with %zu shapes.", 
+		shapeCache.size());
+}
+
+void PhysicsServiceImpl::StartSimulation
+	(const PhysicsServiceConfig& worldConfig)
+{
+	// Seed the random number generator with the current time
+	srand(static_cast<unsigned int>(time(0)));
+
+	// Reset the step physics measurements
+	stepMeasurements.Reset();
+
+	// Dump the profile of the steps slower than the config's threshold. The
+	// profiler shared by the host's worlds is kept, as it has their phases
+	if(!UsesSharedResources())
+	{
+		phaseProfiler.SetSettings(GetPhaseProfilerSettings(worldConfig));
+		phaseProfiler.Reset();
+	}
+
+	// The bodies created on the initialization are already reported as 
+	// changed. Drop their activation events, as the client knows about them
+	body_activation_listener->ClearActivationEvents();
+
+	bIsInitialized = true;
+}
 
-	// response string
-	std::string stepPhysicsResponse = "";
+const std::string& PhysicsServiceImpl::StepPhysicsSimulation()
+{
+	// Finish any pipelined step, as the world is stepped right away
+	FinishPipelinedStepping();
 
 	// Foreach body:
 	/*		
-	for(auto& bodyId : BodyIdList)
+	for(const BodyID bodyId : bodyRegistry)
 	{
 
 		BodyLockWrite lockWrite(physics_system->GetBodyLockInterface(), 
@@ -283,308 +451,1940 @@ std::string PhysicsServiceImpl::StepPhysicsSimulation()
 	}
 	*/
 
+	// Step the world
+	UpdatePhysicsSystem();
+	DispatchActivationEvents();
+
+	// Extract the state of every body on the physics system, and write each
+	// body's Id, position, rotation and velocities into the reusable buffer
+	const auto serializationStartTime = std::chrono::steady_clock::now();
+	ExtractBodyStates(bodyRegistry.GetBodyIds().data(), bodyRegistry.size(),
+		stepBodyStates);
+	WriteFullStepResponse(stepBodyStates, stepPhysicsCounter, false, nullptr,
+		nullptr, textStepResponseBuffer);
+	RecordSerializationTime(serializationStartTime);
+
+	// Print each body's result. The records are only written again if the
+	// trace is logged
+	if(SERVICE_LOG_IS_ENABLED(ELogLevel::Trace, ELogCategory::Physics))
+	{
+		std::string bodyStepResultInfo;
+		for(size_t i = 0; i < stepBodyStates.size(); i++)
+		{
+			bodyStepResultInfo.clear();
+			StepResponseWriter::AppendBodyRecordAsText(bodyStepResultInfo, 
+				stepBodyStates, i);
+
+			// Get the body type
+			const std::string bodyTypeAsString = 
+				BodyRuntimeData::GetBodyTypeAsString
+				(stepBodyStates.bodyTypes[i]);
+
+			// The result already ends with a new line
+			LOG_TRACE(Physics, "\t(%s)%.*s", bodyTypeAsString.c_str(), 
+				static_cast<int>(bodyStepResultInfo.size() - 1), 
+				bodyStepResultInfo.data());
+		}
+	}
+
+	/*
+	std::cout << "(Step:" << stepPhysicsCounter++ << ")" 
+		<< "StepPhysics response:\n" << textStepResponseBuffer << "\n";
+	*/
+	
+	return textStepResponseBuffer;
+}
+
+void PhysicsServiceImpl::UpdatePhysicsSystem()
+{
+	// If you take larger steps than 1 / 60th of a second you need to do 
+	// multiple collision steps in order to keep the simulation stable. 
+	// Do 1 collision step per 1 / 60th of a second (round up).
+	const int cCollisionSteps = 1;
+
+	// If you want more accurate step results you can do multiple sub steps 
+	// within a collision step. Usually you would set this to 1.
+	const int cIntegrationSubSteps = 1;
+
+	// We simulate the physics world in discrete time steps. 60 Hz is a good 
+	// rate to update the physics system.
+	const float cDeltaTime = 1.0f / 60.f;
+
+	// Take a temp allocator from the host's pool for this step, if the 
+	// world shares it
+	AdaptiveTempAllocator* stepTempAllocator = UsesSharedResources()
+		? worldHost->AcquireTempAllocator() : temp_allocator;
+
     // Get pre step physics time
     std::chrono::steady_clock::time_point preStepPhysicsTime = 
 		std::chrono::steady_clock::now();
 
 	// Step the world
-	std::cout << "Stepping physics...\n";
+	LOG_TRACE(Physics, "Stepping physics...");
 	physics_system->Update(cDeltaTime, cCollisionSteps, cIntegrationSubSteps, 
-		temp_allocator, job_system);
-	std::cout << "Physics stepping finished.\n";
+		stepTempAllocator, job_system);
+	LOG_TRACE(Physics, "Physics stepping finished.");
+
+	// Resize the temp allocator for the next steps, if needed
+	stepTempAllocator->OnStepFinished();
+	const std::size_t stepTempAllocatorPeakUsage = 
+		stepTempAllocator->GetLastStepPeakUsage();
+
+	if(UsesSharedResources())
+	{
+		worldHost->ReleaseTempAllocator(stepTempAllocator);
+	}
 
     // Get post physics communication time
     std::chrono::steady_clock::time_point postStepPhysicsTime = 
 		std::chrono::steady_clock::now();
 
-    // Calculate the microsseconds all step physics simulation
-    // (considering communication )took
-    std::stringstream ss;
-    ss << std::chrono::duration_cast<std::chrono::microseconds>
-		(postStepPhysicsTime - preStepPhysicsTime).count();
-    const std::string elapsedTime = ss.str();
+	const std::uint64_t stepDurationNanoseconds = static_cast<std::uint64_t>
+		(std::chrono::duration_cast<std::chrono::nanoseconds>
+		(postStepPhysicsTime - preStepPhysicsTime).count());
 
-    // Append the delta time to the current step measurement
-    physicsStepSimulationTimeMeasure += elapsedTime + "\n";
+	// Record how long the step took and the temp allocator's peak usage on
+	// it. The measurements have a fixed size, so this never allocates
+	stepMeasurements.RecordStep(stepPhysicsCounter, stepDurationNanoseconds, 
+		stepTempAllocatorPeakUsage);
 
-	std::cout << "(Step:" << stepPhysicsCounter++ << ")\n";
-
-	// For each body on the physics system:
-	for(auto& bodyId : BodyIdList)
+	// Gather the step's phase times (only on the phase profiling build). The
+	// worlds sharing a job system gather them on their host's profiler, as
+	// their jobs' scopes can't be told apart
+	if(UsesSharedResources())
+	{
+		worldHost->EndPhaseProfilerStep(stepPhysicsCounter, 
+			stepDurationNanoseconds);
+	}
+	else
 	{
-		std::string bodyStepResultInfo {};
+		phaseProfiler.EndStep(stepPhysicsCounter, stepDurationNanoseconds);
+	}
 
-		// Apend the body Id as the first info on the body physics response
-		bodyStepResultInfo += std::to_string(bodyId.GetIndex()) + ";";
+	// The counter is not incremented inside the log, as the log's arguments
+	// are only evaluated if it is enabled
+	LOG_DEBUG(Physics, "(Step:%u)", stepPhysicsCounter);
+	stepPhysicsCounter++;
+}
 
-		// Output current position of the sphere
-		RVec3 position = body_interface->GetCenterOfMassPosition(bodyId);
+const std::string& PhysicsServiceImpl::StepPhysicsSimulationBinary
+	(const StateQuantizationSettings* quantizationSettings, 
+	StateDeltaHistory* deltaHistory)
+{
+	// Finish any pipelined step, as the world is stepped right away
+	FinishPipelinedStepping();
 
-		const std::string actorStepPhysicsPositionResult = 
-			std::to_string(position.GetX()) + ";" 
-			+ std::to_string(position.GetY()) 
-			+ ";" + std::to_string(position.GetZ());
+	// Step the world
+	UpdatePhysicsSystem();
+	DispatchActivationEvents();
+
+	// Extract the state of every body on the physics system and write the
+	// response into the reusable buffer
+	const auto serializationStartTime = std::chrono::steady_clock::now();
+	ExtractBodyStates(bodyRegistry.GetBodyIds().data(), bodyRegistry.size(),
+		stepBodyStates);
+	WriteFullStepResponse(stepBodyStates, stepPhysicsCounter, true, 
+		quantizationSettings, deltaHistory, binaryStepResponseBuffer);
+	RecordSerializationTime(serializationStartTime);
+
+	return binaryStepResponseBuffer;
+}
 
-		// Append the body's physics position result
-		bodyStepResultInfo += actorStepPhysicsPositionResult + ";";
-		
-		// Output current rotation of the sphere
-		RVec3 rotation = body_interface->GetRotation(bodyId).GetEulerAngles();
+const std::string& PhysicsServiceImpl::StepPhysicsSimulationActiveSet
+	(ClientActiveSet& clientActiveSet, bool bUseBinaryFormat, 
+	float changeEpsilon, 
+	const StateQuantizationSettings* quantizationSettings)
+{
+	// Subscribe the client on its first active set step, so it gets the
+	// step's events
+	AddActiveSetClient(&clientActiveSet);
 
-		const std::string actorStepPhysicsRotationResult = 
-			std::to_string(rotation.GetX()) + ";"
-			+ std::to_string(rotation.GetY()) + ";" 
-			+ std::to_string(rotation.GetZ());
+	// Finish any pipelined step, as the world is stepped right away. The 
+	// activation events of the pipelined steps are still reported here
+	FinishPipelinedStepping();
 
-		// Append the the body's physics rotation result
-		bodyStepResultInfo += actorStepPhysicsRotationResult + ";";
+	// Step the world and hand its events to every subscribed client
+	UpdatePhysicsSystem();
+	DispatchActivationEvents();
 
-		// Get the linear and angular velocity
-		const auto linearVelocity { body_interface->GetLinearVelocity(bodyId) };
-		const auto angularVelocity 
-			{ body_interface->GetAngularVelocity(bodyId) };
+	return WriteActiveSetStepResponse(clientActiveSet, bUseBinaryFormat, 
+		changeEpsilon, quantizationSettings);
+}
 
-		// Create the velocities string
-		const std::string actorStepPhysicsVelocitiesResult = 
-			std::to_string(linearVelocity.GetX()) + ";"
-			+ std::to_string(linearVelocity.GetY()) + ";" 
-			+ std::to_string(linearVelocity.GetZ()) + ";" 
-			+ std::to_string(angularVelocity.GetX()) + ";" 
-			+ std::to_string(angularVelocity.GetY()) + ";" 
-			+ std::to_string(angularVelocity.GetZ()); 
+const std::string& PhysicsServiceImpl::WriteActiveSetStepResponse
+	(ClientActiveSet& clientActiveSet, bool bUseBinaryFormat, 
+	float changeEpsilon, 
+	const StateQuantizationSettings* quantizationSettings)
+{
+	// The world is read below, so wait for any pipelined step in flight
+	WaitForPipelinedUpdate();
+	const auto serializationStartTime = std::chrono::steady_clock::now();
 
-		// Append the the body's physics velocity result
-		bodyStepResultInfo += actorStepPhysicsVelocitiesResult + '\n';
+	// A spectator is subscribed on its first response, so it has every body
+	AddActiveSetClient(&clientActiveSet);
 
-		// Create the bodyType variable
-		std::string bodyTypeAsString {};
+	std::vector<BodyID>& wokeUpBodyIds = clientActiveSet.GetWokeUpBodyIds();
+	std::vector<BodyID>& wentToSleepBodyIds = 
+		clientActiveSet.GetWentToSleepBodyIds();
 
-		// Get the body lock
-		BodyLockWrite lockWrite(physics_system->GetBodyLockInterface(), 
-			bodyId);
-		if(lockWrite.Succeeded())
-		{
-			// Get the body
-			Body& body = lockWrite.GetBody();
+	// Remove the events from bodies that are not tracked by the service
+	// anymore (e.g. a body that was removed is deactivated) or never were
+	// (e.g. the floor)
+	auto isNotReportableBody = [this](const BodyID& bodyId)
+	{
+		return !bodyRuntimeData.HasBodyData(bodyId);
+	};
+	wokeUpBodyIds.erase(std::remove_if(wokeUpBodyIds.begin(), 
+		wokeUpBodyIds.end(), isNotReportableBody), wokeUpBodyIds.end());
+	wentToSleepBodyIds.erase(std::remove_if(wentToSleepBodyIds.begin(), 
+		wentToSleepBodyIds.end(), isNotReportableBody), 
+		wentToSleepBodyIds.end());
+
+	// The candidates to report are the active bodies, plus the bodies that
+	// changed through the service or went to sleep since the client's last
+	// response. The latter are always reported, so the client has their 
+	// final state
+	const std::vector<BodyID>& changedBodyIds = 
+		clientActiveSet.GetChangedBodyIds();
+	physics_system->GetActiveBodies(activeSetCandidateBodyIds);
+	activeSetCandidateBodyIds.insert(activeSetCandidateBodyIds.end(), 
+		changedBodyIds.begin(), changedBodyIds.end());
+	activeSetCandidateBodyIds.insert(activeSetCandidateBodyIds.end(), 
+		wentToSleepBodyIds.begin(), wentToSleepBodyIds.end());
+
+	// Forget the last reported state of the bodies that should always be
+	// reported, so they are not filtered by the epsilon
+	clientActiveSet.BeginReport();
+
+	// Remove duplicated candidates (e.g. a body added on this step is both
+	// changed and active)
+	std::sort(activeSetCandidateBodyIds.begin(), 
+		activeSetCandidateBodyIds.end());
+	activeSetCandidateBodyIds.erase(std::unique
+		(activeSetCandidateBodyIds.begin(), activeSetCandidateBodyIds.end()),
+		activeSetCandidateBodyIds.end());
+
+	// Write the header. The body record count is fixed once all the records
+	// are written
+	const bool bUseQuantizedRecords = bUseBinaryFormat && quantizationSettings;
+	const std::uint32_t bodyIdBits = GetQuantizedBodyIdBits();
+	activeSetStepResponseBuffer.clear();
+	if(bUseBinaryFormat)
+	{
+		ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 
+			stepPhysicsCounter);
+		ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 0);
+	}
+	if(bUseQuantizedRecords)
+	{
+		ByteBufferWriter::AppendUInt8(activeSetStepResponseBuffer, 
+			static_cast<std::uint8_t>(bodyIdBits));
+	}
 
-			// Access the body's user data
-			uint64_t bodyRuntimeDataAddress = body.GetUserData();
+	// Extract the state of the candidates. The bodies that are not tracked by
+	// the service (e.g. the floor) are skipped
+	ExtractBodyStates(activeSetCandidateBodyIds.data(), 
+		activeSetCandidateBodyIds.size(), stepBodyStates);
 
-			// Cast to BodyRuntimeData
-			BodyRuntimeData* bodyRuntimeData = 
-				reinterpret_cast<BodyRuntimeData*>(bodyRuntimeDataAddress);
+	// For each candidate body, write its record if it changed
+	BitWriter recordBitWriter(activeSetStepResponseBuffer);
+	std::uint32_t bodyRecordCount = 0;
+	for(size_t i = 0; i < stepBodyStates.size(); i++)
+	{
+		const BodyStepState bodyStepState = stepBodyStates.GetBodyStepState(i);
 
-			// Get the body type
-			bodyTypeAsString = bodyRuntimeData->GetBodyTypeAsString();
+		// Skip the bodies that did not change enough since last reported
+		if(!clientActiveSet.HasBodyChangedSinceLastReport(bodyStepState, 
+			changeEpsilon))
+		{
+			continue;
+		}
 
-			lockWrite.ReleaseLock();
+		// Write the body's record
+		if(bUseQuantizedRecords)
+		{
+			StepResponseWriter::AppendBodyRecordAsQuantized(recordBitWriter,
+				*quantizationSettings, bodyIdBits, stepBodyStates, i);
+		}
+		else if(bUseBinaryFormat)
+		{
+			const size_t recordPosition = activeSetStepResponseBuffer.size();
+			activeSetStepResponseBuffer.resize(recordPosition 
+				+ StepResponseWriter::binaryBodyRecordSize);
+			StepResponseWriter::WriteBodyRecordAsBinary
+				(activeSetStepResponseBuffer.data() + recordPosition, 
+				stepBodyStates, i);
+		}
+		else
+		{
+			StepResponseWriter::AppendBodyRecordAsText
+				(activeSetStepResponseBuffer, stepBodyStates, i);
 		}
 
-		// Print the body's result
-		std::cout <<  "\t(" << bodyTypeAsString << ")" << bodyStepResultInfo;
+		// Store the reported state
+		clientActiveSet.RecordReportedState(bodyStepState);
 
-		// Append the body step result info to the step physics response
-		stepPhysicsResponse += bodyStepResultInfo;
+		bodyRecordCount++;
 	}
 
-	/*
-	std::cout << "(Step:" << stepPhysicsCounter++ << ")" 
-		<< "StepPhysics response:\n" << stepPhysicsResponse << "\n";
-	*/
-	
-	return stepPhysicsResponse;
-}
+	// The quantized records end on a whole byte
+	recordBitWriter.Flush();
 
-std::string PhysicsServiceImpl::AddNewSphereToPhysicsWorld
-	(BodyID newBodyId, EBodyType newBodyType, RVec3 newBodyInitialPosition,
-    RVec3 newBodyInitialLinearVelocity, RVec3 newBodyInitialAngularVelocity)
-{
-	std::cout << "NewSphere addition to physics world requested.\n";
+	// Write the woke up and went to sleep events
+	if(bUseBinaryFormat)
+	{
+		// Fix the body record count on the header
+		ByteBufferWriter::WriteUInt32(activeSetStepResponseBuffer.data() + 4,
+			bodyRecordCount);
 
-	// Check if body interface is valid
-	if(!body_interface)
+		ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 
+			static_cast<std::uint32_t>(wokeUpBodyIds.size()));
+		for(const BodyID& bodyId : wokeUpBodyIds)
+		{
+			ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 
+				bodyId.GetIndex());
+		}
+
+		ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 
+			static_cast<std::uint32_t>(wentToSleepBodyIds.size()));
+		for(const BodyID& bodyId : wentToSleepBodyIds)
+		{
+			ByteBufferWriter::AppendUInt32(activeSetStepResponseBuffer, 
+				bodyId.GetIndex());
+		}
+	}
+	else
 	{
-		std::cout << "No body interface valid when adding new sphere to world.\n";
-		return "No body interface valid when adding new sphere to world.\n";
+		for(const BodyID& bodyId : wokeUpBodyIds)
+		{
+			activeSetStepResponseBuffer += "wake;" 
+				+ std::to_string(bodyId.GetIndex()) + '\n';
+		}
+
+		for(const BodyID& bodyId : wentToSleepBodyIds)
+		{
+			activeSetStepResponseBuffer += "sleep;" 
+				+ std::to_string(bodyId.GetIndex()) + '\n';
+		}
 	}
 
-	// Create the settings for the body itself
-	BodyCreationSettings sphere_settings(new SphereShape(50.f),
-		newBodyInitialPosition, Quat::sIdentity(), 
-		EMotionType::Dynamic, Layers::MOVING);
+	LOG_DEBUG(Physics, "Active set step response: %u bodies reported, %zu "
+		"woke up, %zu went to sleep.", bodyRecordCount, 
+		wokeUpBodyIds.size(), wentToSleepBodyIds.size());
 
-	// Set the sphere's restitution 
-	sphere_settings.mRestitution = 1.f;
-	sphere_settings.mMassPropertiesOverride.mMass = 10.f;
+	// Drop the reported events. The lists keep their capacity
+	clientActiveSet.EndReport();
 
-	// Create the actual rigid body
-	// Note that if we run out of bodies this can return nullptr
-	Body* newSphereBody = body_interface->CreateBodyWithID(newBodyId,
-		sphere_settings);
+	RecordSerializationTime(serializationStartTime);
+	return activeSetStepResponseBuffer;
+}
 
-	// Check for errors
-	if(!newSphereBody)
-	{
-		std::string creationErrorString = "Fail in creation of body with ID: " 
-			+ std::to_string(newBodyId.GetIndexAndSequenceNumber()) + '\n';
-		return creationErrorString;
+const std::string& PhysicsServiceImpl::StepPhysicsSimulationInterest
+	(ClientInterest& clientInterest, bool bUseBinaryFormat, 
+	const StateQuantizationSettings* quantizationSettings)
+{
+	// Finish any pipelined step, as the world is stepped right away and the
+	// broad phase is queried afterwards
+	FinishPipelinedStepping();
+
+	// Step the world
+	UpdatePhysicsSystem();
+	DispatchActivationEvents();
+
+	return WriteInterestStepResponse(clientInterest, bUseBinaryFormat, 
+		quantizationSettings);
+}
+
+const std::string& PhysicsServiceImpl::WriteInterestStepResponse
+	(ClientInterest& clientInterest, bool bUseBinaryFormat, 
+	const StateQuantizationSettings* quantizationSettings)
+{
+	// The broad phase can't be queried while a pipelined step runs
+	WaitForPipelinedUpdate();
+	const auto serializationStartTime = std::chrono::steady_clock::now();
+
+	// Query the bodies inside the client's regions on the broad phase, and 
+	// find the ones that entered and left them since the client's last step
+	clientInterest.QueryBodiesInside(physics_system->GetBroadPhaseQuery(),
+		bodyRuntimeData);
+
+	const std::vector<BodyID>& bodiesInside = 
+		clientInterest.GetBodiesInside();
+	const std::vector<BodyID>& enteredBodyIds = 
+		clientInterest.GetEnteredBodyIds();
+	const std::vector<BodyID>& leftBodyIds = clientInterest.GetLeftBodyIds();
+
+	// Extract and write the state of the bodies inside only
+	ExtractBodyStates(bodiesInside.data(), bodiesInside.size(), 
+		stepBodyStates);
+	WriteFullStepResponse(stepBodyStates, stepPhysicsCounter, 
+		bUseBinaryFormat, quantizationSettings, nullptr, 
+		interestStepResponseBuffer);
+
+	// Write the entered and left events
+	if(bUseBinaryFormat)
+	{
+		ByteBufferWriter::AppendUInt32(interestStepResponseBuffer, 
+			static_cast<std::uint32_t>(enteredBodyIds.size()));
+		for(const BodyID& bodyId : enteredBodyIds)
+		{
+			ByteBufferWriter::AppendUInt32(interestStepResponseBuffer, 
+				bodyId.GetIndex());
+		}
+
+		ByteBufferWriter::AppendUInt32(interestStepResponseBuffer, 
+			static_cast<std::uint32_t>(leftBodyIds.size()));
+		for(const BodyID& bodyId : leftBodyIds)
+		{
+			ByteBufferWriter::AppendUInt32(interestStepResponseBuffer, 
+				bodyId.GetIndex());
+		}
 	}
+	else
+	{
+		for(const BodyID& bodyId : enteredBodyIds)
+		{
+			interestStepResponseBuffer += "enter;" 
+				+ std::to_string(bodyId.GetIndex()) + '\n';
+		}
 
-	// Create the new body runtime data
-	auto newBodyRuntimeData = new BodyRuntimeData();
+		for(const BodyID& bodyId : leftBodyIds)
+		{
+			interestStepResponseBuffer += "leave;" 
+				+ std::to_string(bodyId.GetIndex()) + '\n';
+		}
+	}
 
-	// Set the new body type
-	newBodyRuntimeData->SetBodyType(newBodyType);
+	LOG_DEBUG(Physics, "Interest step response: %zu bodies inside %zu "
+		"regions, %zu entered, %zu left.", stepBodyStates.size(), 
+		clientInterest.GetRegions().size(), enteredBodyIds.size(), 
+		leftBodyIds.size());
 
-	// Cast to a uint64_t so we can store it on user data
-	uint64_t bodyRuntimeDataAsInt = reinterpret_cast<uint64_t>
-		(newBodyRuntimeData);
-	newSphereBody->SetUserData(bodyRuntimeDataAsInt);
+	RecordSerializationTime(serializationStartTime);
+	return interestStepResponseBuffer;
+}
 
-	// Add the body's ID to the list of IDs
-	BodyIdList.push_back(newBodyId);
+const std::string& PhysicsServiceImpl::StepPhysicsSimulationPipelined
+	(bool bUseBinaryFormat, 
+	const StateQuantizationSettings* quantizationSettings, 
+	StateDeltaHistory* deltaHistory)
+{
+	const size_t backSnapshotIndex = 1 - pipelinedFrontSnapshotIndex;
 
-	// Set the body's linear velocity
-	newSphereBody->SetLinearVelocity(newBodyInitialLinearVelocity);
+	// Get the snapshot of the step started by the previous pipelined step. If
+	// there is none, step the world right away
+	if(bIsPipelinedSnapshotPending)
+	{
+		pipelinedUpdateWorker.WaitForUpdate();
+	}
+	else
+	{
+		UpdatePhysicsSystem();
+		CapturePhysicsStateSnapshot(pipelinedSnapshots[backSnapshotIndex]);
+	}
 
-	// Set the body's angular velocity
-	newSphereBody->SetAngularVelocity(newBodyInitialAngularVelocity);
+	// Dispatch the events of the finished step before the next one starts
+	// recording more on the worker thread
+	DispatchActivationEvents();
 
-	// Add the new sphere to the world
-	body_interface->AddBody(newSphereBody->GetID(), EActivation::Activate);
+	// The new snapshot is the front one, to be serialized by this step
+	pipelinedFrontSnapshotIndex = backSnapshotIndex;
+	const PhysicsStateSnapshot& frontSnapshot = 
+		pipelinedSnapshots[pipelinedFrontSnapshotIndex];
 
-	return "New sphere body created successfully.";
+	// Start the next step on the worker thread. It only writes the back 
+	// snapshot, so the front one can be serialized meanwhile
+	const size_t nextBackSnapshotIndex = 1 - pipelinedFrontSnapshotIndex;
+	pipelinedUpdateWorker.StartUpdate([this, nextBackSnapshotIndex]()
+	{
+		UpdatePhysicsSystem();
+		CapturePhysicsStateSnapshot(pipelinedSnapshots[nextBackSnapshotIndex]);
+	});
+	bIsPipelinedSnapshotPending = true;
+
+	// Serialize the front snapshot while the next step runs
+	const auto serializationStartTime = std::chrono::steady_clock::now();
+	WriteFullStepResponse(frontSnapshot.bodyStates, frontSnapshot.stepNumber,
+		bUseBinaryFormat, quantizationSettings, deltaHistory, 
+		pipelinedStepResponseBuffer);
+	RecordSerializationTime(serializationStartTime);
+
+	return pipelinedStepResponseBuffer;
 }
 
-std::string PhysicsServiceImpl::AddNewFloorToPhysicsSystem
-	(const BodyID newBodyId, const RVec3 newBodyInitialPosition)
+const std::string& PhysicsServiceImpl::WriteLatestStepResponse
+	(bool bUseBinaryFormat, 
+	const StateQuantizationSettings* quantizationSettings, 
+	StateDeltaHistory* deltaHistory)
 {
-	std::cout << "NewFloor addition to physics world requested.\n";
+	// The pipelined step in flight only writes the back snapshot, so the 
+	// front one (the last pipelined step response) is served meanwhile
+	const auto serializationStartTime = std::chrono::steady_clock::now();
+	if(bIsPipelinedSnapshotPending)
+	{
+		const PhysicsStateSnapshot& frontSnapshot = 
+			pipelinedSnapshots[pipelinedFrontSnapshotIndex];
+		WriteFullStepResponse(frontSnapshot.bodyStates, 
+			frontSnapshot.stepNumber, bUseBinaryFormat, quantizationSettings,
+			deltaHistory, latestStepResponseBuffer);
+
+		RecordSerializationTime(serializationStartTime);
+		return latestStepResponseBuffer;
+	}
 
-	// Create the settings for the collision volume (the shape)
-	BoxShapeSettings floor_shape_settings(Vec3(1000.0f, 1000.f, 100.0f));
+	// The world is not stepping, so its current state is the latest step's
+	ExtractBodyStates(bodyRegistry.GetBodyIds().data(), bodyRegistry.size(),
+		stepBodyStates);
+	WriteFullStepResponse(stepBodyStates, stepPhysicsCounter, 
+		bUseBinaryFormat, quantizationSettings, deltaHistory, 
+		latestStepResponseBuffer);
 
-	// Create the shape
-	ShapeSettings::ShapeResult floor_shape_result = 
-		floor_shape_settings.Create();
+	RecordSerializationTime(serializationStartTime);
+	return latestStepResponseBuffer;
+}
 
-	// We don't expect an error here, but you can check floor_shape_result for 
-	// HasError() / GetError()
-	ShapeRefC floor_shape = floor_shape_result.Get(); 
+bool PhysicsServiceImpl::ClaimStepAuthority
+	(const ClientConnectionSettings* client)
+{
+	// Callers without a connection do not share the world with clients
+	if(!client)
+	{
+		return true;
+	}
 
-	// Create the settings for the body itself. Note that here you can also set 
-	// other properties like the restitution / friction.
-	BodyCreationSettings floor_settings(floor_shape, newBodyInitialPosition, 
-		Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+	if(!stepAuthorityClient)
+	{
+		stepAuthorityClient = client;
+		LOG_INFO(Physics, "Step authority claimed by the first client to "
+			"step the world.");
+	}
 
-	// Create the actual rigid body
-	// Note that if we run out of bodies this can return nullptr
-	Body* floor = body_interface->CreateBodyWithID(newBodyId, floor_settings); 
+	return stepAuthorityClient == client;
+}
 
-	// Check if floor was created successfully
-	if(!floor)
+void PhysicsServiceImpl::SetStepAuthority
+	(const ClientConnectionSettings* client)
+{
+	stepAuthorityClient = client;
+}
+
+void PhysicsServiceImpl::ReleaseStepAuthority
+	(const ClientConnectionSettings* client)
+{
+	if(stepAuthorityClient == client)
+	{
+		stepAuthorityClient = nullptr;
+	}
+}
+
+void PhysicsServiceImpl::SetPipelinedStepping(bool bEnablePipelinedStepping)
+{
+	if(!bEnablePipelinedStepping)
+	{
+		FinishPipelinedStepping();
+	}
+
+	bIsPipelinedSteppingEnabled = bEnablePipelinedStepping;
+}
+
+std::uint32_t PhysicsServiceImpl::GetQuantizedBodyIdBits() const
+{
+	// The physics system's max bodies never change while it runs, so this
+	// may be read while a pipelined step is in flight
+	const std::uint32_t maxBodies = physics_system 
+		? physics_system->GetMaxBodies() : serviceConfig.maxBodies;
+
+	return StateQuantization::GetBodyIdBits(maxBodies);
+}
+
+void PhysicsServiceImpl::WaitForPipelinedUpdate()
+{
+	pipelinedUpdateWorker.WaitForUpdate();
+}
+
+void PhysicsServiceImpl::FinishPipelinedStepping()
+{
+	pipelinedUpdateWorker.WaitForUpdate();
+	bIsPipelinedSnapshotPending = false;
+}
+
+void PhysicsServiceImpl::CapturePhysicsStateSnapshot
+	(PhysicsStateSnapshot& outSnapshot) const
+{
+	outSnapshot.stepNumber = stepPhysicsCounter;
+
+	// The snapshot's arrays keep their capacity, so they are reused
+	ExtractBodyStates(bodyRegistry.GetBodyIds().data(), bodyRegistry.size(),
+		outSnapshot.bodyStates);
+}
+
+void PhysicsServiceImpl::ExtractBodyStates(const BodyID* bodyIdsToExtract, 
+	size_t bodyIdsToExtractCount, BodyStateArrays& outBodyStates) const
+{
+	// Nothing changes the physics world while the state is extracted (the
+	// pipelined step extracts it right after its update, on the worker 
+	// thread), so the bodies are read without locks
+	outBodyStates.Extract(physics_system->GetBodyLockInterfaceNoLock(), 
+		bodyRuntimeData, bodyIdsToExtract, bodyIdsToExtractCount);
+}
+
+void PhysicsServiceImpl::RecordSerializationTime
+	(std::chrono::steady_clock::time_point serializationStartTime)
+{
+	stepMeasurements.RecordSerialization(static_cast<std::uint64_t>
+		(std::chrono::duration_cast<std::chrono::nanoseconds>
+		(std::chrono::steady_clock::now() - serializationStartTime).count()));
+}
+
+void PhysicsServiceImpl::WriteFullStepResponse
+	(const BodyStateArrays& bodyStates, std::uint32_t stepNumber, 
+	bool bUseBinaryFormat, 
+	const StateQuantizationSettings* quantizationSettings,
+	StateDeltaHistory* deltaHistory, std::string& outStepResponse) const
+{
+	const size_t bodyCount = bodyStates.size();
+
+	if(!bUseBinaryFormat)
+	{
+		outStepResponse.clear();
+		for(size_t i = 0; i < bodyCount; i++)
+		{
+			StepResponseWriter::AppendBodyRecordAsText(outStepResponse, 
+				bodyStates, i);
+		}
+
+		return;
+	}
+
+	if(quantizationSettings && deltaHistory)
+	{
+		// The history keeps the step's quantized states as a baseline for
+		// the client's next steps
+		deltaHistory->WriteStepResponse(*quantizationSettings, 
+			GetQuantizedBodyIdBits(), bodyStates, stepNumber, 
+			outStepResponse);
+
+		return;
+	}
+
+	if(quantizationSettings)
+	{
+		// Write the header: step number, body count and body ID bits
+		const std::uint32_t bodyIdBits = GetQuantizedBodyIdBits();
+		outStepResponse.clear();
+		ByteBufferWriter::AppendUInt32(outStepResponse, stepNumber);
+		ByteBufferWriter::AppendUInt32(outStepResponse, 
+			static_cast<std::uint32_t>(bodyCount));
+		ByteBufferWriter::AppendUInt8(outStepResponse, 
+			static_cast<std::uint8_t>(bodyIdBits));
+
+		// For each body, write its bit packed record
+		BitWriter recordBitWriter(outStepResponse);
+		for(size_t i = 0; i < bodyCount; i++)
+		{
+			StepResponseWriter::AppendBodyRecordAsQuantized(recordBitWriter,
+				*quantizationSettings, bodyIdBits, bodyStates, i);
+		}
+		recordBitWriter.Flush();
+
+		return;
+	}
+
+	// Size the reusable buffer for the header and every body record. Resizing
+	// to the same (or a smaller) size does not reallocate
+	outStepResponse.resize(binaryStepResponseHeaderSize 
+		+ bodyCount * StepResponseWriter::binaryBodyRecordSize);
+
+	// Write the header: step number and body count
+	char* writePosition = outStepResponse.data();
+	writePosition = ByteBufferWriter::WriteUInt32(writePosition, stepNumber);
+	writePosition = ByteBufferWriter::WriteUInt32(writePosition, 
+		static_cast<std::uint32_t>(bodyCount));
+
+	// For each body, write its record
+	for(size_t i = 0; i < bodyCount; i++)
+	{
+		writePosition = StepResponseWriter::WriteBodyRecordAsBinary
+			(writePosition, bodyStates, i);
+	}
+}
+
+void PhysicsServiceImpl::MarkBodyChangedForActiveSet(const BodyID bodyId)
+{
+	for(ClientActiveSet* clientActiveSet : activeSetClients)
+	{
+		clientActiveSet->MarkBodyChanged(bodyId);
+	}
+}
+
+void PhysicsServiceImpl::DispatchActivationEvents()
+{
+	if(!body_activation_listener)
+	{
+		return;
+	}
+
+	// The events are consumed even if no client is subscribed, so they do
+	// not pile up on the listener
+	body_activation_listener->ConsumeActivationEvents(activeSetWokeUpBodyIds,
+		activeSetWentToSleepBodyIds);
+	for(ClientActiveSet* clientActiveSet : activeSetClients)
+	{
+		clientActiveSet->AddActivationEvents(activeSetWokeUpBodyIds, 
+			activeSetWentToSleepBodyIds);
+	}
+}
+
+void PhysicsServiceImpl::AddActiveSetClient(ClientActiveSet* clientActiveSet)
+{
+	if(std::find(activeSetClients.begin(), activeSetClients.end(), 
+		clientActiveSet) != activeSetClients.end())
+	{
+		return;
+	}
+
+	// The events recorded so far belong to the clients already subscribed
+	DispatchActivationEvents();
+	activeSetClients.push_back(clientActiveSet);
+
+	// The client knows nothing about the world yet, so every body (even the
+	// sleeping ones) is reported on its next response
+	clientActiveSet->Reset();
+	for(const BodyID& bodyId : bodyRegistry.GetBodyIds())
+	{
+		clientActiveSet->MarkBodyChanged(bodyId);
+	}
+}
+
+void PhysicsServiceImpl::RemoveActiveSetClient
+	(ClientActiveSet* clientActiveSet)
+{
+	activeSetClients.erase(std::remove(activeSetClients.begin(), 
+		activeSetClients.end(), clientActiveSet), activeSetClients.end());
+	clientActiveSet->Reset();
+}
+
+std::string PhysicsServiceImpl::AddNewSphereToPhysicsWorld
+	(BodyID newBodyId, EBodyType newBodyType, RVec3 newBodyInitialPosition,
+    RVec3 newBodyInitialLinearVelocity, RVec3 newBodyInitialAngularVelocity)
+{
+	LOG_DEBUG(Physics, "NewSphere addition to physics world requested.");
+
+	// Check if body interface is valid
+	if(!body_interface)
+	{
+		LOG_ERROR(Physics, "No body interface valid when adding new sphere to "
+			"world.");
+		return "No body interface valid when adding new sphere to world.\n";
+	}
+
+	BodyCreationInfo sphereCreationInfo;
+	sphereCreationInfo.shapeType = EBodyShapeType::Sphere;
+	sphereCreationInfo.bodyId = newBodyId;
+	sphereCreationInfo.bodyType = newBodyType;
+	sphereCreationInfo.initialPosition = newBodyInitialPosition;
+	sphereCreationInfo.initialLinearVelocity = newBodyInitialLinearVelocity;
+	sphereCreationInfo.initialAngularVelocity = newBodyInitialAngularVelocity;
+
+	// Add the new sphere to the world as a batch of one
+	if(AddNewBodiesToPhysicsWorld({ sphereCreationInfo }) == 0)
 	{
 		std::string creationErrorString = "Fail in creation of body with ID: " 
 			+ std::to_string(newBodyId.GetIndexAndSequenceNumber()) + '\n';
 		return creationErrorString;
 	}
 
-	// Set the floor's friction and add a small rotation on y-axis
-    floor->SetFriction(1.0f);
-	//floor->AddRotationStep(RVec3(0.f, -0.01f, 0.f));
+	return "New sphere body created successfully.";
+}
+
+std::string PhysicsServiceImpl::AddNewFloorToPhysicsSystem
+	(const BodyID newBodyId, const RVec3 newBodyInitialPosition)
+{
+	LOG_DEBUG(Physics, "NewFloor addition to physics world requested.");
 
-	// Add it to the world
-	body_interface->AddBody(floor->GetID(), EActivation::DontActivate);
+	// Check if body interface is valid
+	if(!body_interface)
+	{
+		LOG_ERROR(Physics, "No body interface valid when adding new floor to "
+			"world.");
+		return "No body interface valid when adding new floor to world.\n";
+	}
+
+	BodyCreationInfo floorCreationInfo;
+	floorCreationInfo.shapeType = EBodyShapeType::Floor;
+	floorCreationInfo.bodyId = newBodyId;
+	floorCreationInfo.initialPosition = newBodyInitialPosition;
+
+	// Add the new floor to the world as a batch of one
+	if(AddNewBodiesToPhysicsWorld({ floorCreationInfo }) == 0)
+	{
+		std::string creationErrorString = "Fail in creation of body with ID: " 
+			+ std::to_string(newBodyId.GetIndexAndSequenceNumber()) + '\n';
+		return creationErrorString;
+	}
 
 	return "New floor body created successfully.";
 }
 
-std::string PhysicsServiceImpl::RemoveBodyByID(const BodyID bodyToRemoveID)
+size_t PhysicsServiceImpl::AddNewBodiesToPhysicsWorld
+	(const std::vector<BodyCreationInfo>& bodiesCreationInfo,
+	std::vector<std::string>* outBodiesErrors)
 {
-	std::cout << "Remove body by ID requested for id: " 
-		+ std::to_string(bodyToRemoveID.GetIndex()) + "\n";
+	// The world can't change while a pipelined step is in flight
+	WaitForPipelinedUpdate();
+
+	if(outBodiesErrors)
+	{
+		outBodiesErrors->assign(bodiesCreationInfo.size(), std::string());
+	}
 
 	// Check if body interface is valid
 	if(!body_interface)
 	{
-		return "No body interface valid when removing body by ID.";
+		LOG_ERROR(Physics, "No body interface valid when adding new bodies to "
+			"world.");
+
+		if(outBodiesErrors)
+		{
+			outBodiesErrors->assign(bodiesCreationInfo.size(), 
+				"No body interface valid when adding new bodies to world.");
+		}
+		return 0;
 	}
 
-	// Remove the ID from the list
-	BodyIdList.erase(std::remove(BodyIdList.begin(), BodyIdList.end(), 
-		bodyToRemoveID), BodyIdList.end());
+	// Create every body first, grouping them by their object layer. Each 
+	// layer is then inserted on the broad phase at once, instead of updating
+	// the broad phase tree once per body
+	batchMovingBodyIds.clear();
+	batchNonMovingBodyIds.clear();
+
+	for(size_t i = 0; i < bodiesCreationInfo.size(); i++)
+	{
+		const BodyCreationInfo& bodyCreationInfo = bodiesCreationInfo[i];
 
-	// Remove the body by its ID and destroy it
-	body_interface->RemoveBody(bodyToRemoveID);
-	body_interface->DestroyBody(bodyToRemoveID);
+		Body* newBody = bodyCreationInfo.shapeType == EBodyShapeType::Floor? 
+			CreateFloorBody(bodyCreationInfo) : 
+			CreateSphereBody(bodyCreationInfo);
 
-	return "Body removal processed successfully";
+		// Check for errors. Note that the creation fails if the ID is 
+		// already in use
+		if(!newBody)
+		{
+			LOG_WARNING(Physics, "Fail in creation of body with ID: %u", 
+				bodyCreationInfo.bodyId.GetIndexAndSequenceNumber());
+
+			if(outBodiesErrors)
+			{
+				(*outBodiesErrors)[i] = "Fail in creation of body with ID: " 
+					+ std::to_string(bodyCreationInfo.bodyId
+					.GetIndexAndSequenceNumber());
+			}
+			continue;
+		}
+
+		if(newBody->GetObjectLayer() == Layers::NON_MOVING)
+		{
+			batchNonMovingBodyIds.push_back(newBody->GetID());
+		}
+		else
+		{
+			batchMovingBodyIds.push_back(newBody->GetID());
+		}
+	}
+
+	// Add the static bodies without activating them, and the moving ones 
+	// already activated
+	AddBodiesInBatch(batchNonMovingBodyIds, EActivation::DontActivate);
+	AddBodiesInBatch(batchMovingBodyIds, EActivation::Activate);
+
+	const size_t addedBodiesCount = batchNonMovingBodyIds.size() 
+		+ batchMovingBodyIds.size();
+
+	OptimizeBroadPhaseAfterBatch(addedBodiesCount);
+
+	return addedBodiesCount;
 }
 
-std::string PhysicsServiceImpl::UpdateBodyType(BodyID bodyIdToUpdate,
-	EBodyType newBodyType)
+void PhysicsServiceImpl::SetBroadPhaseOptimizationBodyThreshold
+	(size_t newBroadPhaseOptimizationBodyThreshold)
 {
-	// Get the body lock
-	BodyLockWrite lockWrite(physics_system->GetBodyLockInterface(),
-		bodyIdToUpdate);
+	broadPhaseOptimizationBodyThreshold = 
+		newBroadPhaseOptimizationBodyThreshold;
+}
 
-	// Check if got the lock
-	if (lockWrite.Succeeded())
-	{
-		// Get the body
-		Body &body = lockWrite.GetBody();
+void PhysicsServiceImpl::SetServiceConfig
+	(const PhysicsServiceConfig& newServiceConfig)
+{
+	serviceConfig = newServiceConfig;
+}
 
-		// Access the body's user data
-		uint64_t bodyRuntimeDataAddress = body.GetUserData();
+bool PhysicsServiceImpl::UsesSharedResources() const
+{
+	return worldHost && worldHost->IsSharingResources();
+}
 
-		// Cast to BodyRuntimeData
-		BodyRuntimeData *bodyRuntimeData =
-			reinterpret_cast<BodyRuntimeData *>(bodyRuntimeDataAddress);
+void PhysicsServiceImpl::SetWorldHost(PhysicsWorldHost* newWorldHost, 
+	std::uint32_t newWorldId)
+{
+	worldHost = newWorldHost;
+	worldId = newWorldId;
+}
 
-		// Update the body type
-		bodyRuntimeData->SetBodyType(newBodyType);
+PhysicsServiceImpl::WorldCostMeasures 
+	PhysicsServiceImpl::GetWorldCostMeasures()
+{
+	// The measures are written by the pipelined steps
+	WaitForPipelinedUpdate();
+
+	const StepTimeHistogram& stepTimeHistogram = 
+		stepMeasurements.GetStepTimeHistogram();
+
+	WorldCostMeasures worldCostMeasures;
+	worldCostMeasures.bIsInitialized = bIsInitialized;
+	worldCostMeasures.bodyCount = bodyRegistry.size();
+	worldCostMeasures.stepCount = stepTimeHistogram.GetCount();
+	worldCostMeasures.stepTimeMeanNanoseconds = stepTimeHistogram.GetMean();
+	worldCostMeasures.stepTimeP99Nanoseconds = 
+		stepTimeHistogram.GetValueAtPercentile(99.0);
+	worldCostMeasures.stepTimeTotalNanoseconds = 
+		worldCostMeasures.stepTimeMeanNanoseconds 
+		* static_cast<double>(worldCostMeasures.stepCount);
+	worldCostMeasures.tempAllocatorPeakBytes = 
+		stepMeasurements.GetTempAllocatorPeakBytes();
+	worldCostMeasures.memoryFootprintBytes = 
+		bIsInitialized ? worldMemoryFootprintBytes : 0;
+
+	return worldCostMeasures;
+}
 
-		lockWrite.ReleaseLock();
-	}
+PhaseProfiler::Settings PhysicsServiceImpl::GetPhaseProfilerSettings
+	(const PhysicsServiceConfig& worldConfig)
+{
+	PhaseProfiler::Settings phaseProfilerSettings;
+	phaseProfilerSettings.dumpThresholdNanoseconds = static_cast<std::uint64_t>
+		(worldConfig.profileDumpThresholdMicroseconds) * 1000;
+	phaseProfilerSettings.dumpDirectory = worldConfig.profileDumpDirectory;
+	phaseProfilerSettings.maxDumps = worldConfig.profileMaxDumps;
 
-	return "Body type updated successfully.";
+	return phaseProfilerSettings;
 }
 
-void PhysicsServiceImpl::ClearPhysicsSystem()
+AdaptiveTempAllocator::Settings PhysicsServiceImpl::GetTempAllocatorSettings
+	(const PhysicsServiceConfig& worldConfig)
 {
-    std::cout << "Cleaning physics system...\n";
+	AdaptiveTempAllocator::Settings tempAllocatorSettings;
+	tempAllocatorSettings.initialCapacity = worldConfig.tempAllocatorSize;
+	tempAllocatorSettings.minCapacity = worldConfig.tempAllocatorMinSize;
+	tempAllocatorSettings.maxCapacity = worldConfig.tempAllocatorMaxSize;
+	tempAllocatorSettings.growThreshold = 
+		worldConfig.tempAllocatorGrowThreshold;
+	tempAllocatorSettings.shrinkCooldownSteps = 
+		worldConfig.tempAllocatorShrinkCooldownSteps;
+	tempAllocatorSettings.bUseHugePages = 
+		worldConfig.tempAllocatorUseHugePages;
+
+	return tempAllocatorSettings;
+}
 
-	for(auto& bodyId : BodyIdList)
-	{
-    	// Remove the sphere from the physics system. Note that the sphere 
-		// itself keeps all of its state and can be re-added at any time.
-		body_interface->RemoveBody(bodyId);
+WorkStealingJobSystem::Settings PhysicsServiceImpl::GetJobSystemSettings
+	(const PhysicsServiceConfig& worldConfig)
+{
+	WorkStealingJobSystem::Settings jobSystemSettings;
+	jobSystemSettings.maxJobs = worldConfig.maxPhysicsJobs;
+	jobSystemSettings.maxBarriers = worldConfig.maxPhysicsBarriers;
+	jobSystemSettings.workerThreadCount = 
+		worldConfig.GetResolvedPhysicsWorkerThreadCount();
+	jobSystemSettings.bPinWorkerThreads = 
+		worldConfig.pinPhysicsWorkerThreads;
+	jobSystemSettings.firstWorkerCpu = worldConfig.physicsWorkerFirstCpu;
+	jobSystemSettings.excludedCpu = worldConfig.networkThreadCpu;
+	jobSystemSettings.idleSpinCount = worldConfig.physicsWorkerIdleSpinCount;
+
+	return jobSystemSettings;
+}
 
-		// Destroy the sphere. After this the sphere ID is no longer valid.
-		body_interface->DestroyBody(bodyId);
+bool PhysicsServiceImpl::IsInitConfigLine(std::string_view initInfoLine)
+{
+	return initInfoLine.substr(0, initConfigLinePrefix.size()) 
+		== initConfigLinePrefix;
+}
+
+Body* PhysicsServiceImpl::CreateSphereBody
+	(const BodyCreationInfo& sphereCreationInfo)
+{
+	// Create the settings for the body itself. The shape is shared by every
+	// sphere
+	BodyCreationSettings sphere_settings(GetSphereBodyShape(),
+		sphereCreationInfo.initialPosition, Quat::sIdentity(), 
+		EMotionType::Dynamic, Layers::MOVING);
+
+	// Set the sphere's restitution 
+	sphere_settings.mRestitution = 1.f;
+	sphere_settings.mMassPropertiesOverride.mMass = 10.f;
+
+	// Create the actual rigid body
+	// Note that if we run out of bodies this can return nullptr
+	Body* newSphereBody = body_interface->CreateBodyWithID
+		(sphereCreationInfo.bodyId, sphere_settings);
+
+	// Check for errors
+	if(!newSphereBody)
+	{
+		return nullptr;
 	}
 
-	// Remove and destroy the floor
-	//body_interface->RemoveBody(floor_id);
-	//body_interface->DestroyBody(floor_id);
+	// Allocate the new body runtime data with the new body type
+	bodyRuntimeData.AllocateBodyData(sphereCreationInfo.bodyId, 
+		sphereCreationInfo.bodyType);
 
-	// Unregisters all types with the factory and cleans up the default 
-	// material
-	UnregisterTypes();
+	// Register the body, so it is reported on each step
+	bodyRegistry.Add(sphereCreationInfo.bodyId);
 
-	// Destroy the factory
-	delete Factory::sInstance;
-	Factory::sInstance = nullptr;
+	// Report the new body on the next active set step response
+	MarkBodyChangedForActiveSet(sphereCreationInfo.bodyId);
 
-	if(contact_listener) delete contact_listener;
-	if(physics_system) delete physics_system;
+	// Set the body's linear velocity
+	newSphereBody->SetLinearVelocity(sphereCreationInfo.initialLinearVelocity);
 
-	bIsInitialized = false;
+	// Set the body's angular velocity
+	newSphereBody->SetAngularVelocity
+		(sphereCreationInfo.initialAngularVelocity);
 
-    std::cout << "Physics system was cleared. Exiting process...\n";
+	return newSphereBody;
 }
 
-std::string PhysicsServiceImpl::GetSimulationMeasures() const
+Body* PhysicsServiceImpl::CreateFloorBody
+	(const BodyCreationInfo& floorCreationInfo)
 {
-	return physicsStepSimulationTimeMeasure;
+	// Get the collision volume (the shape), shared by every floor
+	ShapeRefC floor_shape = GetFloorBodyShape();
+
+	// We don't expect an error here, as the floor's shape is created on the
+	// initialization
+	if(floor_shape == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Create the settings for the body itself. Note that here you can also set 
+	// other properties like the restitution / friction.
+	BodyCreationSettings floor_settings(floor_shape, 
+		floorCreationInfo.initialPosition, Quat::sIdentity(), 
+		EMotionType::Static, Layers::NON_MOVING);
+
+	// Create the actual rigid body
+	// Note that if we run out of bodies this can return nullptr
+	Body* floor = body_interface->CreateBodyWithID(floorCreationInfo.bodyId,
+		floor_settings); 
+
+	// Check if floor was created successfully
+	if(!floor)
+	{
+		return nullptr;
+	}
+
+	// Set the floor's friction and add a small rotation on y-axis
+    floor->SetFriction(1.0f);
+	//floor->AddRotationStep(RVec3(0.f, -0.01f, 0.f));
+
+	return floor;
+}
+
+ShapeRefC PhysicsServiceImpl::GetSphereBodyShape()
+{
+	return shapeCache.GetSphereShape(50.f);
+}
+
+ShapeRefC PhysicsServiceImpl::GetFloorBodyShape()
+{
+	return shapeCache.GetBoxShape(Vec3(1000.0f, 1000.f, 100.0f));
+}
+
+void PhysicsServiceImpl::AddBodiesInBatch(BodyIDVector& bodyIdsToAdd, 
+	EActivation activationMode)
+{
+	if(bodyIdsToAdd.empty())
+	{
+		return;
+	}
+
+	// Prepare builds the broad phase nodes for the whole batch, and finalize
+	// inserts them on the broad phase tree with a single update. Note that
+	// prepare may reorder the given IDs
+	const int bodiesToAddCount = static_cast<int>(bodyIdsToAdd.size());
+
+	BodyInterface::AddState addState = body_interface->AddBodiesPrepare
+		(bodyIdsToAdd.data(), bodiesToAddCount);
+	body_interface->AddBodiesFinalize(bodyIdsToAdd.data(), bodiesToAddCount,
+		addState, activationMode);
+}
+
+void PhysicsServiceImpl::OptimizeBroadPhaseAfterBatch(size_t addedBodiesCount)
+{
+	// After a large batch, rebuild the broad phase tree so the next steps 
+	// don't run on an unbalanced tree. This is an expensive operation, so it
+	// is not done for small batches
+	if(broadPhaseOptimizationBodyThreshold > 0 
+		&& addedBodiesCount >= broadPhaseOptimizationBodyThreshold)
+	{
+		const auto optimizationStartTime = std::chrono::steady_clock::now();
+
+		physics_system->OptimizeBroadPhase();
+
+		LOG_DEBUG(Physics, "Broad phase optimized after adding %zu bodies in "
+			"%.3f ms.", addedBodiesCount, std::chrono::duration<double, 
+			std::milli>(std::chrono::steady_clock::now() 
+			- optimizationStartTime).count());
+	}
+}
+
+std::string PhysicsServiceImpl::RemoveBodyByID(const BodyID bodyToRemoveID)
+{
+	LOG_DEBUG(Physics, "Remove body by ID requested for id: %u", 
+		bodyToRemoveID.GetIndex());
+
+	// Check if body interface is valid
+	if(!body_interface)
+	{
+		return "No body interface valid when removing body by ID.";
+	}
+
+	// Remove the body as a batch of one
+	std::vector<std::string> bodiesErrors;
+	RemoveBodiesByID({ bodyToRemoveID }, &bodiesErrors);
+
+	if(!bodiesErrors[0].empty())
+	{
+		return bodiesErrors[0];
+	}
+
+	return "Body removal processed successfully";
+}
+
+size_t PhysicsServiceImpl::RemoveBodiesByID
+	(const std::vector<BodyID>& bodiesToRemoveIDs,
+	std::vector<std::string>* outBodiesErrors)
+{
+	// The world can't change while a pipelined step is in flight
+	WaitForPipelinedUpdate();
+
+	if(outBodiesErrors)
+	{
+		outBodiesErrors->assign(bodiesToRemoveIDs.size(), std::string());
+	}
+
+	// Check if body interface is valid
+	if(!body_interface)
+	{
+		LOG_ERROR(Physics, "No body interface valid when removing bodies.");
+
+		if(outBodiesErrors)
+		{
+			outBodiesErrors->assign(bodiesToRemoveIDs.size(), 
+				"No body interface valid when removing bodies.");
+		}
+		return 0;
+	}
+
+	// Gather the bodies that can be removed. The whole batch is removed from
+	// the broad phase at once, so every body on it must be on the physics 
+	// world and be removed only once
+	batchRemovedBodyIds.clear();
+
+	for(size_t i = 0; i < bodiesToRemoveIDs.size(); i++)
+	{
+		const BodyID bodyToRemoveID = bodiesToRemoveIDs[i];
+
+		bool bIsBodyOnWorld = false;
+		{
+			BodyLockRead lockRead(physics_system->GetBodyLockInterface(),
+				bodyToRemoveID);
+			bIsBodyOnWorld = lockRead.SucceededAndIsInBroadPhase();
+		}
+
+		const uint32 bodyIndex = bodyToRemoveID.GetIndex();
+		const bool bIsBodyAlreadyOnBatch = bIsBodyOnWorld 
+			&& bodyIndex < batchRemovedBodyFlags.size() 
+			&& batchRemovedBodyFlags[bodyIndex];
+
+		if(!bIsBodyOnWorld || bIsBodyAlreadyOnBatch)
+		{
+			if(outBodiesErrors)
+			{
+				(*outBodiesErrors)[i] = (bIsBodyAlreadyOnBatch? 
+					"Body removal already requested for ID: " 
+					: "No body on the physics world with ID: ")
+					+ std::to_string(bodyToRemoveID
+					.GetIndexAndSequenceNumber());
+			}
+			continue;
+		}
+
+		if(bodyIndex >= batchRemovedBodyFlags.size())
+		{
+			batchRemovedBodyFlags.resize(bodyIndex + 1, false);
+		}
+		batchRemovedBodyFlags[bodyIndex] = true;
+
+		batchRemovedBodyIds.push_back(bodyToRemoveID);
+	}
+
+	if(batchRemovedBodyIds.empty())
+	{
+		return 0;
+	}
+
+	for(const BodyID removedBodyId : batchRemovedBodyIds)
+	{
+		batchRemovedBodyFlags[removedBodyId.GetIndex()] = false;
+
+		// Unregister the body and free its runtime data. Floors are not 
+		// registered, so this is a no-op for them
+		bodyRegistry.Remove(removedBodyId);
+		bodyRuntimeData.FreeBodyData(removedBodyId);
+
+		// Forget the body's last reported state, as its index may be reused
+		// by a new body
+		for(ClientActiveSet* clientActiveSet : activeSetClients)
+		{
+			clientActiveSet->ForgetBody(removedBodyId);
+		}
+	}
+
+	// Remove the bodies from the broad phase at once and destroy them
+	const int bodiesToRemoveCount = static_cast<int>(batchRemovedBodyIds.size());
+	body_interface->RemoveBodies(batchRemovedBodyIds.data(), 
+		bodiesToRemoveCount);
+	body_interface->DestroyBodies(batchRemovedBodyIds.data(), 
+		bodiesToRemoveCount);
+
+	return batchRemovedBodyIds.size();
+}
+
+std::string PhysicsServiceImpl::UpdateBodyType(BodyID bodyIdToUpdate,
+	EBodyType newBodyType)
+{
+	// Update the body type as a batch of one
+	std::vector<std::string> bodiesErrors;
+	UpdateBodiesType({ { bodyIdToUpdate, newBodyType } }, &bodiesErrors);
+
+	if(!bodiesErrors[0].empty())
+	{
+		return bodiesErrors[0];
+	}
+
+	return "Body type updated successfully.";
+}
+
+size_t PhysicsServiceImpl::UpdateBodiesType
+	(const std::vector<std::pair<BodyID, EBodyType>>& bodyTypeUpdates,
+	std::vector<std::string>* outBodiesErrors)
+{
+	// The world can't change while a pipelined step is in flight
+	WaitForPipelinedUpdate();
+
+	if(outBodiesErrors)
+	{
+		outBodiesErrors->assign(bodyTypeUpdates.size(), std::string());
+	}
+
+	if(!physics_system)
+	{
+		if(outBodiesErrors)
+		{
+			outBodiesErrors->assign(bodyTypeUpdates.size(), 
+				"No physics system valid when updating body types.");
+		}
+		return 0;
+	}
+
+	size_t updatedBodiesCount = 0;
+
+	for(size_t i = 0; i < bodyTypeUpdates.size(); i++)
+	{
+		const BodyID bodyIdToUpdate = bodyTypeUpdates[i].first;
+
+		// Only the bodies tracked by the service have a body type. The 
+		// runtime data is not part of the body, so no body lock is needed
+		if(!bodyRuntimeData.HasBodyData(bodyIdToUpdate))
+		{
+			if(outBodiesErrors)
+			{
+				(*outBodiesErrors)[i] = "No body with runtime data on the "
+					"physics world with ID: " + std::to_string(bodyIdToUpdate
+					.GetIndexAndSequenceNumber());
+			}
+			continue;
+		}
+
+		// Update the body type
+		bodyRuntimeData.SetBodyType(bodyIdToUpdate, bodyTypeUpdates[i].second);
+
+		// Report the new body type on the next active set step response
+		MarkBodyChangedForActiveSet(bodyIdToUpdate);
+
+		updatedBodiesCount++;
+	}
+
+	return updatedBodiesCount;
+}
+
+void PhysicsServiceImpl::ClearPhysicsSystem()
+{
+    LOG_INFO(Physics, "Cleaning physics system...");
+
+	// Stop the pipelined stepping, as the world is about to be destroyed
+	pipelinedUpdateWorker.Stop();
+	bIsPipelinedSnapshotPending = false;
+
+	for(const BodyID bodyId : bodyRegistry)
+	{
+    	// Remove the sphere from the physics system. Note that the sphere 
+		// itself keeps all of its state and can be re-added at any time.
+		body_interface->RemoveBody(bodyId);
+
+		// Destroy the sphere. After this the sphere ID is no longer valid.
+		body_interface->DestroyBody(bodyId);
+	}
+
+	bodyRegistry.Clear();
+	bodyRuntimeData.Clear();
+
+	// Release the shared shapes, as no body uses them anymore
+	LOG_DEBUG(Physics, "Shape cache served %llu shape requests with %llu "
+		"shape creations.", static_cast<unsigned long long>
+		(shapeCache.GetHitCount() + shapeCache.GetMissCount()), 
+		static_cast<unsigned long long>(shapeCache.GetMissCount()));
+	shapeCache.Clear();
+
+	// Remove and destroy the floor
+	//body_interface->RemoveBody(floor_id);
+	//body_interface->DestroyBody(floor_id);
+
+	// The body interface belongs to the physics system, so it goes with it
+	if(contact_listener) delete contact_listener;
+	if(physics_system) delete physics_system;
+	if(body_activation_listener) delete body_activation_listener;
+	contact_listener = nullptr;
+	physics_system = nullptr;
+	body_activation_listener = nullptr;
+	body_interface = nullptr;
+
+	// Unregister Jolt's types, unless other worlds still use them
+	ReleaseJoltTypes();
+
+	// The next initialization creates them again, with its own config. The
+	// job system shared by the world's host is kept for the other worlds
+	if(!UsesSharedResources())
+	{
+		if(job_system)
+		{
+			LOG_INFO(Physics, "%s", job_system->GetStatsReport().c_str());
+		}
+
+		if(temp_allocator)
+		{
+			LOG_INFO(Physics, "%s", 
+				temp_allocator->GetStatsReport().c_str());
+		}
+		delete job_system;
+		delete temp_allocator;
+	}
+	job_system = nullptr;
+	temp_allocator = nullptr;
+
+	// Forget every active set report, as the bodies do not exist anymore.
+	// The clients stay subscribed, and get the bodies of the next 
+	// initialization as changed
+	for(ClientActiveSet* clientActiveSet : activeSetClients)
+	{
+		clientActiveSet->Reset();
+	}
+
+	bIsInitialized = false;
+
+    LOG_INFO(Physics, "Physics system was cleared.");
+}
+
+std::string PhysicsServiceImpl::GetSimulationMeasures(bool bResetOnRead, 
+	bool bIncludeRecentSamples)
+{
+	// The measures are written by the pipelined steps
+	WaitForPipelinedUpdate();
+
+	const StepTimeHistogram& stepTimeHistogram = 
+		stepMeasurements.GetStepTimeHistogram();
+
+	// The step times are reported in microseconds
+	const auto toMicroseconds = [](double nanoseconds)
+	{
+		return nanoseconds / 1000.0;
+	};
+
+	char measureLine[128];
+	std::string simulationMeasures;
+
+	const auto appendMeasure = [&](const char* measureName, double measure)
+	{
+		std::snprintf(measureLine, sizeof(measureLine), "%s;%.3f\n", 
+			measureName, measure);
+		simulationMeasures += measureLine;
+	};
+
+	const auto appendCount = [&](const char* measureName, 
+		std::uint64_t measure)
+	{
+		std::snprintf(measureLine, sizeof(measureLine), "%s;%llu\n", 
+			measureName, static_cast<unsigned long long>(measure));
+		simulationMeasures += measureLine;
+	};
+
+	appendCount("stepCount", stepTimeHistogram.GetCount());
+	appendMeasure("stepTimeMeanUs", toMicroseconds
+		(stepTimeHistogram.GetMean()));
+	appendMeasure("stepTimeP50Us", toMicroseconds(static_cast<double>
+		(stepTimeHistogram.GetValueAtPercentile(50.0))));
+	appendMeasure("stepTimeP90Us", toMicroseconds(static_cast<double>
+		(stepTimeHistogram.GetValueAtPercentile(90.0))));
+	appendMeasure("stepTimeP99Us", toMicroseconds(static_cast<double>
+		(stepTimeHistogram.GetValueAtPercentile(99.0))));
+	appendMeasure("stepTimeP999Us", toMicroseconds(static_cast<double>
+		(stepTimeHistogram.GetValueAtPercentile(99.9))));
+	appendMeasure("stepTimeMaxUs", toMicroseconds(static_cast<double>
+		(stepTimeHistogram.GetMax())));
+
+	// How long the step responses took to be written
+	const StepTimeHistogram& serializationTimeHistogram = 
+		stepMeasurements.GetSerializationTimeHistogram();
+	appendMeasure("serializationTimeMeanUs", toMicroseconds
+		(serializationTimeHistogram.GetMean()));
+	appendMeasure("serializationTimeP50Us", toMicroseconds
+		(static_cast<double>(serializationTimeHistogram.GetValueAtPercentile
+		(50.0))));
+	appendMeasure("serializationTimeP90Us", toMicroseconds
+		(static_cast<double>(serializationTimeHistogram.GetValueAtPercentile
+		(90.0))));
+	appendMeasure("serializationTimeP99Us", toMicroseconds
+		(static_cast<double>(serializationTimeHistogram.GetValueAtPercentile
+		(99.0))));
+	appendMeasure("serializationTimeP999Us", toMicroseconds
+		(static_cast<double>(serializationTimeHistogram.GetValueAtPercentile
+		(99.9))));
+	appendMeasure("serializationTimeMaxUs", toMicroseconds
+		(static_cast<double>(serializationTimeHistogram.GetMax())));
+
+	// The temp allocators of a host sharing its resources are pooled
+	const bool bUsesSharedResources = UsesSharedResources();
+	PhysicsWorldHost::TempAllocatorPoolStats tempAllocatorStats;
+	if(bUsesSharedResources)
+	{
+		tempAllocatorStats = worldHost->GetTempAllocatorPoolStats();
+	}
+	else if(temp_allocator)
+	{
+		tempAllocatorStats.capacityBytes = temp_allocator->GetCapacity();
+		tempAllocatorStats.overflowCount = temp_allocator->GetOverflowCount();
+	}
+
+	appendCount("tempAllocatorPeakBytes", 
+		stepMeasurements.GetTempAllocatorPeakBytes());
+	appendCount("tempAllocatorCapacityBytes", 
+		tempAllocatorStats.capacityBytes);
+	appendCount("tempAllocatorOverflows", tempAllocatorStats.overflowCount);
+
+	const WorkStealingJobSystem::Stats jobSystemStats = job_system 
+		? job_system->GetStats() : WorkStealingJobSystem::Stats();
+	appendCount("jobsExecuted", jobSystemStats.executedJobs);
+	appendCount("jobsStolen", jobSystemStats.stolenJobs);
+	appendCount("jobWorkerIdleSleeps", jobSystemStats.idleSleeps);
+	appendCount("jobWorkerIdleSleepUs", jobSystemStats.idleSleepMicroseconds);
+
+	// The recent steps, from the oldest, as "step;durationUs;peakBytes"
+	if(bIncludeRecentSamples)
+	{
+		appendCount("recentSteps", stepMeasurements.GetRecentSampleCount());
+
+		for(size_t i = 0; i < stepMeasurements.GetRecentSampleCount(); i++)
+		{
+			const StepMeasurementSample& sample = 
+				stepMeasurements.GetRecentSample(i);
+
+			std::snprintf(measureLine, sizeof(measureLine), "%u;%.3f;%llu\n",
+				sample.stepNumber, toMicroseconds(static_cast<double>
+				(sample.durationNanoseconds)), static_cast<unsigned long long>
+				(sample.tempAllocatorPeakBytes));
+			simulationMeasures += measureLine;
+		}
+	}
+
+	if(bResetOnRead)
+	{
+		stepMeasurements.Reset();
+
+		// The shared job system's counters are summed over every world
+		if(job_system && !bUsesSharedResources)
+		{
+			job_system->ResetStats();
+		}
+	}
+
+	return simulationMeasures;
+}
+
+std::string PhysicsServiceImpl::GetPhaseProfile(bool bResetOnRead)
+{
+	// The phases are gathered by the pipelined steps
+	WaitForPipelinedUpdate();
+
+	// The phases of the worlds sharing resources are process wide
+	std::string phaseProfile;
+	if(UsesSharedResources())
+	{
+		phaseProfile = "phaseProfileScope;process\n";
+		phaseProfile += worldHost->GetPhaseProfilerReport(bResetOnRead);
+	}
+	else
+	{
+		phaseProfile = "phaseProfileScope;world\n";
+		phaseProfile += phaseProfiler.GetReport();
+		if(bResetOnRead)
+		{
+			phaseProfiler.Reset();
+		}
+	}
+
+#ifdef JPH_TRACK_BROADPHASE_STATS
+	// The broad phase reports its query stats through Jolt's trace, so it 
+	// is captured while they are reported. No physics update is running, so
+	// nothing else traces meanwhile
+	if(physics_system)
+	{
+		std::string broadPhaseStats;
+		capturedTraceLines = &broadPhaseStats;
+
+		const TraceFunction previousTrace = Trace;
+		Trace = CaptureTrace;
+		physics_system->ReportBroadphaseStats();
+		Trace = previousTrace;
+
+		capturedTraceLines = nullptr;
+
+		phaseProfile += "broadPhaseStats;" + std::to_string(std::count
+			(broadPhaseStats.begin(), broadPhaseStats.end(), '\n')) + "\n";
+		phaseProfile += broadPhaseStats;
+	}
+#endif
+
+	return phaseProfile;
+}
+
+bool PhysicsServiceImpl::ExportBodies
+	(const std::vector<BodyID>& bodyIdsToExport, bool bRemoveExportedBodies,
+	std::string& outBlob, std::string& outError)
+{
+	outBlob.clear();
+
+	if(!bIsInitialized)
+	{
+		outError = "The physics system is not initialized.";
+		return false;
+	}
+
+	// The world can't change while the bodies are exported
+	WaitForPipelinedUpdate();
+
+	// A handoff is all or nothing, so every body is checked first
+	std::vector<BodyID> sortedBodyIds = bodyIdsToExport;
+	std::sort(sortedBodyIds.begin(), sortedBodyIds.end());
+	const auto repeatedBodyId = std::adjacent_find(sortedBodyIds.begin(), 
+		sortedBodyIds.end());
+	if(repeatedBodyId != sortedBodyIds.end())
+	{
+		outError = "Body export already requested for ID: " 
+			+ std::to_string(repeatedBodyId->GetIndexAndSequenceNumber());
+		return false;
+	}
+
+	BodyMigrationBlob::AppendHeader(outBlob, 
+		static_cast<std::uint32_t>(bodyIdsToExport.size()));
+
+	const BodyLockInterfaceNoLock& bodyLockInterface = 
+		physics_system->GetBodyLockInterfaceNoLock();
+
+	// The recorder's buffer is reused by every body
+	WorldSnapshotStateRecorder bodyStateRecorder;
+
+	for(const BodyID bodyId : bodyIdsToExport)
+	{
+		BodyLockRead lockRead(bodyLockInterface, bodyId);
+		if(!lockRead.SucceededAndIsInBroadPhase())
+		{
+			outError = "No body on the physics world with ID: " 
+				+ std::to_string(bodyId.GetIndexAndSequenceNumber());
+			outBlob.clear();
+			return false;
+		}
+
+		const Body& body = lockRead.GetBody();
+
+		BodyMigrationRecord bodyRecord;
+		bodyRecord.bodyId = bodyId;
+		bodyRecord.shapeType = body.GetObjectLayer() == Layers::NON_MOVING?
+			EBodyShapeType::Floor : EBodyShapeType::Sphere;
+		bodyRecord.bIsActive = body.IsActive();
+
+		if(bodyRuntimeData.HasBodyData(bodyId))
+		{
+			bodyRecord.bodyType = bodyRuntimeData.GetBodyType(bodyId);
+			bodyRecord.ownerRegion = bodyRuntimeData.GetOwnerRegion(bodyId);
+		}
+
+		bodyStateRecorder.ClearRecordedData();
+		body.SaveState(bodyStateRecorder);
+		bodyRecord.bodyState = bodyStateRecorder.GetRecordedData();
+
+		BodyMigrationBlob::AppendBody(outBlob, bodyRecord);
+	}
+
+	if(bRemoveExportedBodies)
+	{
+		RemoveBodiesByID(bodyIdsToExport);
+	}
+
+	LOG_DEBUG(Physics, "Exported %zu bodies (%zu bytes)%s.", 
+		bodyIdsToExport.size(), outBlob.size(), 
+		bRemoveExportedBodies? " and removed them" : "");
+
+	return true;
+}
+
+size_t PhysicsServiceImpl::ImportBodies(std::string_view blob, 
+	std::vector<std::string>& outBodiesErrors, std::string& outError)
+{
+	outBodiesErrors.clear();
+
+	if(!bIsInitialized)
+	{
+		outError = "The physics system is not initialized.";
+		return 0;
+	}
+
+	// The whole blob is checked before any body is created
+	std::vector<BodyMigrationRecord> bodyRecords;
+	if(!BodyMigrationBlob::Parse(blob, bodyRecords, outError))
+	{
+		return 0;
+	}
+
+	// The world can't change while a pipelined step is in flight
+	WaitForPipelinedUpdate();
+
+	outBodiesErrors.assign(bodyRecords.size(), std::string());
+
+	// Create every body first and restore its state, so it is inserted on 
+	// the broad phase with its exact place. The sleeping bodies are inserted
+	// without activating them
+	batchMovingBodyIds.clear();
+	batchNonMovingBodyIds.clear();
+	BodyIDVector sleepingBodyIds;
+
+	for(size_t i = 0; i < bodyRecords.size(); i++)
+	{
+		const BodyMigrationRecord& bodyRecord = bodyRecords[i];
+
+		BodyCreationInfo bodyCreationInfo;
+		bodyCreationInfo.shapeType = bodyRecord.shapeType;
+		bodyCreationInfo.bodyId = bodyRecord.bodyId;
+		bodyCreationInfo.bodyType = bodyRecord.bodyType;
+
+		Body* newBody = bodyCreationInfo.shapeType == EBodyShapeType::Floor? 
+			CreateFloorBody(bodyCreationInfo) : 
+			CreateSphereBody(bodyCreationInfo);
+
+		// Check for errors. Note that the creation fails if the ID is 
+		// already in use
+		if(!newBody)
+		{
+			outBodiesErrors[i] = "Fail in creation of body with ID: " 
+				+ std::to_string(bodyRecord.bodyId
+				.GetIndexAndSequenceNumber());
+			continue;
+		}
+
+		WorldSnapshotStateRecorder bodyStateRecorder(bodyRecord.bodyState);
+		newBody->RestoreState(bodyStateRecorder);
+
+		// The whole state must be read, or it was saved by another Jolt 
+		// build (or for another shape)
+		if(bodyStateRecorder.IsFailed() || !bodyStateRecorder.IsEOF())
+		{
+			outBodiesErrors[i] = "The state of body with ID " 
+				+ std::to_string(bodyRecord.bodyId
+				.GetIndexAndSequenceNumber()) + " could not be restored.";
+
+			bodyRegistry.Remove(bodyRecord.bodyId);
+			bodyRuntimeData.FreeBodyData(bodyRecord.bodyId);
+			body_interface->DestroyBody(bodyRecord.bodyId);
+			continue;
+		}
+
+		if(bodyRuntimeData.HasBodyData(bodyRecord.bodyId))
+		{
+			bodyRuntimeData.SetOwnerRegion(bodyRecord.bodyId, 
+				bodyRecord.ownerRegion);
+		}
+
+		if(newBody->GetObjectLayer() == Layers::NON_MOVING)
+		{
+			batchNonMovingBodyIds.push_back(bodyRecord.bodyId);
+		}
+		else if(bodyRecord.bIsActive)
+		{
+			batchMovingBodyIds.push_back(bodyRecord.bodyId);
+		}
+		else
+		{
+			sleepingBodyIds.push_back(bodyRecord.bodyId);
+		}
+	}
+
+	AddBodiesInBatch(batchNonMovingBodyIds, EActivation::DontActivate);
+	AddBodiesInBatch(sleepingBodyIds, EActivation::DontActivate);
+	AddBodiesInBatch(batchMovingBodyIds, EActivation::Activate);
+
+	const size_t importedBodiesCount = batchNonMovingBodyIds.size() 
+		+ sleepingBodyIds.size() + batchMovingBodyIds.size();
+
+	OptimizeBroadPhaseAfterBatch(importedBodiesCount);
+
+	LOG_DEBUG(Physics, "Imported %zu of %zu bodies.", importedBodiesCount, 
+		bodyRecords.size());
+
+	return importedBodiesCount;
+}
+
+std::string PhysicsServiceImpl::SaveSnapshot(std::string_view snapshotName)
+{
+	if(!bIsInitialized)
+	{
+		return "Error: The physics system is not initialized.";
+	}
+
+	if(!WorldSnapshotFile::IsValidName(snapshotName))
+	{
+		return "Error: Invalid snapshot name: " + std::string(snapshotName);
+	}
+
+	// The world can't change while it is saved
+	WaitForPipelinedUpdate();
+
+	const auto saveStartTime = std::chrono::steady_clock::now();
+
+	WorldSnapshotHeader snapshotHeader;
+	snapshotHeader.stepNumber = stepPhysicsCounter;
+	snapshotHeader.maxBodies = physics_system->GetMaxBodies();
+
+	// Jolt only saves the state of the bodies on the broad phase, so only 
+	// those are on the snapshot. The tracked bodies go first, on the 
+	// registry's order, so the restored registry iterates them the same way
+	BodyIDVector worldBodyIds;
+	physics_system->GetBodies(worldBodyIds);
+
+	std::vector<WorldSnapshotBody> snapshotBodies;
+	snapshotBodies.reserve(worldBodyIds.size());
+
+	const BodyLockInterfaceNoLock& bodyLockInterface = 
+		physics_system->GetBodyLockInterfaceNoLock();
+
+	const auto appendSnapshotBody = [&](const BodyID bodyId)
+	{
+		BodyLockRead lockRead(bodyLockInterface, bodyId);
+		if(!lockRead.SucceededAndIsInBroadPhase())
+		{
+			return;
+		}
+
+		const Body& body = lockRead.GetBody();
+		const RVec3 bodyPosition = body.GetPosition();
+
+		WorldSnapshotBody snapshotBody;
+		snapshotBody.bodyId = bodyId;
+		snapshotBody.shapeType = body.GetObjectLayer() == Layers::NON_MOVING?
+			EBodyShapeType::Floor : EBodyShapeType::Sphere;
+		snapshotBody.positionX = static_cast<float>(bodyPosition.GetX());
+		snapshotBody.positionY = static_cast<float>(bodyPosition.GetY());
+		snapshotBody.positionZ = static_cast<float>(bodyPosition.GetZ());
+
+		if(bodyRuntimeData.HasBodyData(bodyId))
+		{
+			snapshotBody.bodyType = bodyRuntimeData.GetBodyType(bodyId);
+			snapshotBody.ownerRegion = bodyRuntimeData.GetOwnerRegion(bodyId);
+		}
+
+		snapshotBodies.push_back(snapshotBody);
+	};
+
+	for(const BodyID bodyId : bodyRegistry)
+	{
+		appendSnapshotBody(bodyId);
+	}
+
+	for(const BodyID bodyId : worldBodyIds)
+	{
+		if(!bodyRegistry.Contains(bodyId))
+		{
+			appendSnapshotBody(bodyId);
+		}
+	}
+
+	// Save the rest of the world's state (rotations, velocities, sleep 
+	// states, active bodies, contact cache...) through Jolt
+	WorldSnapshotStateRecorder stateRecorder;
+	physics_system->SaveState(stateRecorder);
+
+	const std::string snapshotPath = 
+		serviceConfig.snapshotDirectory + "/" + std::string(snapshotName);
+
+	std::string snapshotError;
+	const size_t snapshotSize = WorldSnapshotFile::Write(snapshotPath, 
+		snapshotHeader, snapshotBodies, stateRecorder.GetRecordedData(), 
+		snapshotError);
+
+	if(snapshotSize == 0)
+	{
+		LOG_ERROR(Physics, "Could not save the snapshot: %s", 
+			snapshotError.c_str());
+		return "Error: Could not save the snapshot: " + snapshotError;
+	}
+
+	const double saveDurationMs = std::chrono::duration<double, std::milli>
+		(std::chrono::steady_clock::now() - saveStartTime).count();
+
+	char saveReport[256];
+	snprintf(saveReport, sizeof(saveReport), "Snapshot saved with %zu bodies"
+		" at step %u (%zu bytes) in %.3f ms.", snapshotBodies.size(), 
+		stepPhysicsCounter, snapshotSize, saveDurationMs);
+
+	LOG_INFO(Physics, "%s", saveReport);
+	return saveReport;
+}
+
+std::string PhysicsServiceImpl::LoadSnapshot(std::string_view snapshotName)
+{
+	if(!WorldSnapshotFile::IsValidName(snapshotName))
+	{
+		return "Error: Invalid snapshot name: " + std::string(snapshotName);
+	}
+
+	const auto loadStartTime = std::chrono::steady_clock::now();
+
+	// The snapshot is checked before the current physics system is touched,
+	// so an invalid one keeps it running
+	const std::string snapshotPath = 
+		serviceConfig.snapshotDirectory + "/" + std::string(snapshotName);
+
+	WorldSnapshotFile snapshotFile;
+	std::string snapshotError;
+	if(!snapshotFile.Open(snapshotPath, snapshotError))
+	{
+		LOG_WARNING(Physics, "Could not load the snapshot: %s", 
+			snapshotError.c_str());
+		return "Error: Could not load the snapshot: " + snapshotError;
+	}
+
+	const WorldSnapshotHeader& snapshotHeader = snapshotFile.GetHeader();
+
+	// The world needs room for every body the saved world had room for
+	PhysicsServiceConfig snapshotConfig = serviceConfig;
+	snapshotConfig.maxBodies = std::max(snapshotConfig.maxBodies, 
+		snapshotHeader.maxBodies);
+
+	if(!snapshotConfig.Validate(snapshotError))
+	{
+		LOG_WARNING(Physics, "Invalid snapshot config: %s", 
+			snapshotError.c_str());
+		return "Error: Could not load the snapshot. Invalid config: " 
+			+ snapshotError;
+	}
+
+	if(bIsInitialized)
+	{
+		ClearPhysicsSystem();
+	}
+
+	CreatePhysicsSystem(snapshotConfig);
+
+	// Create the bodies on their saved place, so the broad phase is built 
+	// once and right. The tracked bodies are created first, so they are 
+	// added to the registry on their saved order
+	std::vector<BodyCreationInfo> snapshotBodiesCreationInfo;
+	snapshotBodiesCreationInfo.resize(snapshotHeader.bodyCount);
+
+	WorldSnapshotBody snapshotBody;
+	for(std::uint32_t i = 0; i < snapshotHeader.bodyCount; i++)
+	{
+		snapshotFile.GetBody(i, snapshotBody);
+
+		BodyCreationInfo& bodyCreationInfo = snapshotBodiesCreationInfo[i];
+		bodyCreationInfo.shapeType = snapshotBody.shapeType;
+		bodyCreationInfo.bodyId = snapshotBody.bodyId;
+		bodyCreationInfo.bodyType = snapshotBody.bodyType;
+		bodyCreationInfo.initialPosition = RVec3(snapshotBody.positionX, 
+			snapshotBody.positionY, snapshotBody.positionZ);
+	}
+
+	const size_t snapshotBodiesCount = 
+		AddNewBodiesToPhysicsWorld(snapshotBodiesCreationInfo);
+
+	for(std::uint32_t i = 0; i < snapshotHeader.bodyCount; i++)
+	{
+		snapshotFile.GetBody(i, snapshotBody);
+
+		if(bodyRuntimeData.HasBodyData(snapshotBody.bodyId))
+		{
+			bodyRuntimeData.SetOwnerRegion(snapshotBody.bodyId, 
+				snapshotBody.ownerRegion);
+		}
+	}
+
+	const auto bodiesCreatedTime = std::chrono::steady_clock::now();
+
+	// Restore the rest of the world's state, read in place from the mapped
+	// snapshot. Jolt refuses it if the bodies do not match the saved ones
+	WorldSnapshotStateRecorder stateRecorder(snapshotFile.GetPhysicsState());
+
+	if(snapshotBodiesCount != snapshotHeader.bodyCount
+		|| !physics_system->RestoreState(stateRecorder) 
+		|| stateRecorder.IsFailed())
+	{
+		LOG_ERROR(Physics, "The snapshot's physics state could not be "
+			"restored (%zu of %u bodies created).", snapshotBodiesCount, 
+			snapshotHeader.bodyCount);
+
+		// The world is half restored, so it is not kept
+		ClearPhysicsSystem();
+		return "Error: Could not load the snapshot. Its physics state could "
+			"not be restored.";
+	}
+
+	stepPhysicsCounter = snapshotHeader.stepNumber;
+
+	StartSimulation(snapshotConfig);
+
+	const auto loadEndTime = std::chrono::steady_clock::now();
+
+	const double loadDurationMs = std::chrono::duration<double, std::milli>
+		(loadEndTime - loadStartTime).count();
+	const double stateRestoreDurationMs = 
+		std::chrono::duration<double, std::milli>
+		(loadEndTime - bodiesCreatedTime).count();
+
+	char loadReport[256];
+	snprintf(loadReport, sizeof(loadReport), "Snapshot loaded with %zu "
+		"bodies at step %u in %.3f ms (%.3f ms restoring the physics state).",
+		snapshotBodiesCount, stepPhysicsCounter, loadDurationMs, 
+		stateRestoreDurationMs);
+
+	LOG_INFO(Physics, "%s", loadReport);
+	return loadReport;
 }
@@ -3,7 +3,10 @@
 
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 #include <vector>
+#include <utility>
+#include <string_view>
 
 #include "BPLayerInterfaceImpl.h"
 #include "MyBodyActivationListener.h"
@@ -11,24 +14,46 @@
 #include "ObjectLayerPairFilterImpl.h"
 #include "ObjectVsBroadPhaseLayerFilterImpl.h"
 #include "BodyRuntimeData.h"
+#include "PhysicsServiceConfig.h"
+#include "WorkStealingJobSystem.h"
+#include "AdaptiveTempAllocator.h"
+#include "StepMeasurements.h"
+#include "PhaseProfiler.h"
+#include "BodyCreationInfo.h"
+#include "BodyRegistry.h"
+#include "ShapeCache.h"
+#include "BodyStepState.h"
+#include "BodyStateArrays.h"
+#include "PhysicsStateSnapshot.h"
+#include "PhysicsUpdateWorker.h"
+#include "WorldSnapshot.h"
+#include "BodyMigrationBlob.h"
+#include "ClientInterest.h"
+#include "ClientActiveSet.h"
+#include "../Serialization/ByteBufferWriter.h"
+#include "../Serialization/StepResponseWriter.h"
+#include "../Serialization/StateDeltaHistory.h"
+#include "../Serialization/TextRecordParser.h"
+#include "../Logging/ServiceLogger.h"
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
-#include <Jolt/Physics/StateRecorderImpl.h>
 
 // Disable common warnings triggered by Jolt, you can use 
 // JPH_SUPPRESS_WARNING_PUSH / JPH_SUPPRESS_WARNING_POP to store and restore 
 // the warning state
 JPH_SUPPRESS_WARNINGS
 
+class PhysicsWorldHost;
+struct ClientConnectionSettings;
+
 /**
 * This class extends a JoltPhysics implementation. Thus, contains the logic
 * and data behind the physics service server. This will implement the physics
@@ -49,17 +74,342 @@ public:
     * bodyType; Id_2; posX_2; posY_2; posZ_2\n
     * ...
     * MessageEnd"
+    * 
+    * Every body is created first and then inserted on the physics world as a
+    * batch (see "AddNewBodiesToPhysicsWorld()").
+    * 
+    * The service's config (see "SetServiceConfig()") may be overridden for 
+    * this initialization by "config;key=value" lines, e.g. 
+    * "config;maxBodies=50000" (see "PhysicsServiceConfig"). Only the world's
+    * capacities, solver and temp allocator settings may be given (see 
+    * "PhysicsServiceConfig::SetInitKeyValuePair()"). The resulting config is
+    * validated first, and if it is invalid, the current physics system is 
+    * kept as it is.
+    * 
+    * @return The initialization report, with the number of created bodies
+    * and how long the initialization took, or the config error
     */
-    void InitPhysicsSystem(const std::string initializationActorsInfo);
+    std::string InitPhysicsSystem(std::string_view initializationActorsInfo);
 
     /** 
     * Steps the current physics system simulation by one frame.
     * 
     * @return The step physics simulation result. This will send each actor's
     * Id, position and rotation of the current physics system state back to
-    * the client.
+    * the client. The reference is valid until the next step
     */
-    std::string StepPhysicsSimulation();
+    const std::string& StepPhysicsSimulation();
+
+    /** 
+    * Steps the current physics system simulation by one frame and encodes the
+    * result on the binary step response format. This is the binary 
+    * counterpart of "StepPhysicsSimulation()".
+    * 
+    * The response is written into a reusable byte buffer with the following
+    * little-endian layout:
+    * 
+    * uint32 stepNumber
+    * uint32 bodyCount
+    * bodyCount * {
+    *     uint32 bodyId
+    *     float posX, posY, posZ
+    *     float rotX, rotY, rotZ (euler angles)
+    *     float linearVelocityX, linearVelocityY, linearVelocityZ
+    *     float angularVelocityX, angularVelocityY, angularVelocityZ
+    *     uint8 bodyType (0: primary, 1: clone)
+    * }
+    * 
+    * If quantization settings are given, the body records are quantized 
+    * (see "StepResponseWriter::AppendBodyRecordAsQuantized()") and the 
+    * layout is:
+    * 
+    * uint32 stepNumber
+    * uint32 bodyCount
+    * uint8 bodyIdBits
+    * bodyCount * quantized body record, bit packed and padded with 0 bits to
+    * a whole byte
+    * 
+    * Every other binary step response (e.g. the active set one) takes the
+    * same quantization settings, and has its body records and header 
+    * encoded the same way.
+    * 
+    * If a delta history is also given, the quantized states are delta 
+    * compressed against the client's last acknowledged step (see 
+    * "StateDeltaHistory" for the layout). Only the full step responses
+    * (this one and the pipelined one) are delta compressed, as the active
+    * set and interest ones already skip the bodies the client does not
+    * need.
+    * 
+    * @param quantizationSettings The client's quantization settings, if the
+    * body records should be quantized
+    * @param deltaHistory The client's delta history, if the quantized 
+    * states should be delta compressed
+    * 
+    * @return The binary step physics simulation result. The reference is
+    * valid until the next step
+    */
+    const std::string& StepPhysicsSimulationBinary
+        (const StateQuantizationSettings* quantizationSettings = nullptr,
+        StateDeltaHistory* deltaHistory = nullptr);
+
+    /** 
+    * Steps the current physics system simulation by one frame and reports 
+    * only the active set of bodies. A body is reported if it is active and 
+    * its state changed beyond the given epsilon since it was last reported 
+    * to the client, or if it went to sleep, was added or had its type 
+    * updated. Sleeping bodies that did not change are not reported at all.
+    * 
+    * Besides the body records, the response carries the bodies that woke up
+    * and that went to sleep since the client's last response, so the client
+    * can resume and freeze their interpolation. A body that went to sleep is
+    * always reported with its final state.
+    * 
+    * The client is subscribed to the world's events on its first active set
+    * step (see "AddActiveSetClient()"), so its first response has every 
+    * body.
+    * 
+    * The text response has a record line per reported body (same as 
+    * "StepPhysicsSimulation()"), followed by a "wake;id" line per body that
+    * woke up and a "sleep;id" line per body that went to sleep.
+    * 
+    * The binary response has the following little-endian layout:
+    * 
+    * uint32 stepNumber
+    * uint32 bodyRecordCount
+    * bodyRecordCount * body record (see "StepPhysicsSimulationBinary()")
+    * uint32 wokeUpCount
+    * wokeUpCount * uint32 bodyId
+    * uint32 wentToSleepCount
+    * wentToSleepCount * uint32 bodyId
+    * 
+    * @param clientActiveSet The client's reported states and pending events
+    * @param bUseBinaryFormat True to encode the response on the binary 
+    * format and false to use the text format
+    * @param changeEpsilon The maximum difference on any position, rotation 
+    * or velocity component for an active body not to be reported
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized (see 
+    * "StepPhysicsSimulationBinary()")
+    * 
+    * @return The active set step physics simulation result. The reference is
+    * valid until the next step
+    */
+    const std::string& StepPhysicsSimulationActiveSet
+        (ClientActiveSet& clientActiveSet, bool bUseBinaryFormat, 
+        float changeEpsilon, 
+        const StateQuantizationSettings* quantizationSettings = nullptr);
+
+    /** 
+    * Subscribes a client on the active set step response mode to this 
+    * world's events (see "ClientActiveSet"). Every body tracked by the 
+    * service is marked as changed for it, so its next response has every 
+    * body. Subscribing a client twice has no effect.
+    * 
+    * @param clientActiveSet The client's active set. Must be unsubscribed 
+    * before it is destroyed
+    */
+    void AddActiveSetClient(ClientActiveSet* clientActiveSet);
+
+    /** 
+    * Unsubscribes a client from this world's events (e.g. it left the active
+    * set mode or disconnected), and resets its active set.
+    * 
+    * @param clientActiveSet The client's active set
+    */
+    void RemoveActiveSetClient(ClientActiveSet* clientActiveSet);
+
+    /** 
+    * Steps the current physics system simulation by one frame and reports
+    * only the bodies inside a client's regions of interest. The bodies
+    * inside are queried on the broad phase after the step, so the response's
+    * cost depends on the bodies the client is interested in, not on the
+    * world's size.
+    * 
+    * Besides the body records, the response carries the bodies that entered
+    * and that left the client's regions since its last step, so the client
+    * can spawn and despawn them. A body that was removed from the physics
+    * world leaves the regions.
+    * 
+    * The text response has a record line per body inside (same as
+    * "StepPhysicsSimulation()"), followed by an "enter;id" line per body
+    * that entered and a "leave;id" line per body that left.
+    * 
+    * The binary response has the following little-endian layout:
+    * 
+    * uint32 stepNumber
+    * uint32 bodyRecordCount
+    * bodyRecordCount * body record (see "StepPhysicsSimulationBinary()")
+    * uint32 enteredCount
+    * enteredCount * uint32 bodyId
+    * uint32 leftCount
+    * leftCount * uint32 bodyId
+    * 
+    * The broad phase can't be queried while a physics step runs, so these
+    * steps are never pipelined.
+    * 
+    * @param clientInterest The client's regions of interest, which keep the
+    * bodies inside them between the client's steps
+    * @param bUseBinaryFormat True to encode the response on the binary
+    * format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized (see 
+    * "StepPhysicsSimulationBinary()")
+    * 
+    * @return The interest step physics simulation result. The reference is
+    * valid until the next step
+    */
+    const std::string& StepPhysicsSimulationInterest
+        (ClientInterest& clientInterest, bool bUseBinaryFormat, 
+        const StateQuantizationSettings* quantizationSettings = nullptr);
+
+    /** 
+    * Steps the current physics system simulation on the pipelined mode. The
+    * response reports the state captured after the physics step started by
+    * the previous pipelined step. Before serializing it, the next physics 
+    * step is started on a worker thread (and thus on the job system), so 
+    * the physics step runs while this response is serialized and sent.
+    * 
+    * Each physics step writes a state snapshot into the back buffer of a 
+    * double buffer, while the responses are serialized from the front one.
+    * The responses are the same as on the full step response mode (see 
+    * "StepPhysicsSimulation()" and "StepPhysicsSimulationBinary()"), but 
+    * changes made through the service between steps (e.g. adding a body)
+    * are only reported one step later. On the first pipelined step there is
+    * no step in flight, so the physics system is stepped right away.
+    * 
+    * @param bUseBinaryFormat True to encode the response on the binary 
+    * format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized (see 
+    * "StepPhysicsSimulationBinary()")
+    * @param deltaHistory The client's delta history, if the quantized 
+    * states should be delta compressed (see "StepPhysicsSimulationBinary()")
+    * 
+    * @return The step physics simulation result. The reference is valid 
+    * until the next step
+    */
+    const std::string& StepPhysicsSimulationPipelined(bool bUseBinaryFormat,
+        const StateQuantizationSettings* quantizationSettings = nullptr,
+        StateDeltaHistory* deltaHistory = nullptr);
+
+    /** 
+    * Enables or disables the pipelined stepping. When disabled, the physics
+    * step in flight (if any) is finished. As that step was already taken, 
+    * the next step response skips one step number.
+    * 
+    * @param bEnablePipelinedStepping True to enable the pipelined stepping
+    * 
+    * @see StepPhysicsSimulationPipelined
+    */
+    void SetPipelinedStepping(bool bEnablePipelinedStepping);
+
+    /** 
+    * Claims the world's step authority for a client, if no client has it.
+    * Only the client with the step authority advances the world on its 
+    * steps. Every other client sharing the world is a spectator, and is 
+    * served the latest step's state instead (see 
+    * "WriteLatestStepResponse()"), so it does not step the world too.
+    * 
+    * @param client The client's connection settings, or null for a caller
+    * without a connection (e.g. the debug simulation), which always steps 
+    * the world
+    * 
+    * @return True if the client has the step authority
+    */
+    bool ClaimStepAuthority(const ClientConnectionSettings* client);
+
+    /** 
+    * Gives the world's step authority to a client, taking it from the client
+    * that had it (see "SetStepAuthority").
+    * 
+    * @param client The client's connection settings
+    */
+    void SetStepAuthority(const ClientConnectionSettings* client);
+
+    /** 
+    * Releases the world's step authority, if the client has it (e.g. it 
+    * disconnected). The next client to step the world claims it.
+    * 
+    * @param client The client's connection settings
+    */
+    void ReleaseStepAuthority(const ClientConnectionSettings* client);
+
+    /** 
+    * Writes the full step response of the latest step, without stepping the
+    * world. Used to serve the spectators of the world (see 
+    * "ClaimStepAuthority()"). If a pipelined step is in flight, the response
+    * has the state of the last pipelined step response.
+    * 
+    * @param bUseBinaryFormat True to encode the response on the binary 
+    * format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized (see 
+    * "StepPhysicsSimulationBinary()")
+    * @param deltaHistory The client's delta history, if the quantized 
+    * states should be delta compressed (see "StepPhysicsSimulationBinary()")
+    * 
+    * @return The step response. The reference is valid until the next step
+    */
+    const std::string& WriteLatestStepResponse(bool bUseBinaryFormat,
+        const StateQuantizationSettings* quantizationSettings = nullptr,
+        StateDeltaHistory* deltaHistory = nullptr);
+
+    /** 
+    * Writes the active set step response of a client from the world's 
+    * current state, without stepping it (see 
+    * "StepPhysicsSimulationActiveSet()" for the response).
+    * 
+    * @param clientActiveSet The client's reported states and pending events
+    * @param bUseBinaryFormat True to encode the response on the binary 
+    * format and false to use the text format
+    * @param changeEpsilon The maximum difference on any position, rotation 
+    * or velocity component for an active body not to be reported
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized
+    * 
+    * @return The active set step response. The reference is valid until the
+    * next step
+    */
+    const std::string& WriteActiveSetStepResponse
+        (ClientActiveSet& clientActiveSet, bool bUseBinaryFormat, 
+        float changeEpsilon, 
+        const StateQuantizationSettings* quantizationSettings = nullptr);
+
+    /** 
+    * Writes the interest step response of a client from the world's current
+    * state, without stepping it (see "StepPhysicsSimulationInterest()" for 
+    * the response).
+    * 
+    * @param clientInterest The client's regions of interest
+    * @param bUseBinaryFormat True to encode the response on the binary
+    * format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized
+    * 
+    * @return The interest step response. The reference is valid until the
+    * next step
+    */
+    const std::string& WriteInterestStepResponse
+        (ClientInterest& clientInterest, bool bUseBinaryFormat, 
+        const StateQuantizationSettings* quantizationSettings = nullptr);
+
+    /** 
+    * @return The bits of the body IDs on the quantized body records, which
+    * depend on the physics system's max bodies
+    */
+    std::uint32_t GetQuantizedBodyIdBits() const;
+
+    /** @return True if the pipelined stepping is enabled */
+    bool IsPipelinedSteppingEnabled() const 
+    { 
+        return bIsPipelinedSteppingEnabled; 
+    }
+
+    /** 
+    * @return True if the physics system is initialized. It is not before the
+    * first "Init", nor after a failed snapshot load
+    */
+    bool IsInitialized() const { return bIsInitialized; }
 
     /** 
     * Clears the current physics system. This will shut the created physics
@@ -98,9 +448,179 @@ public:
     */
     std::string AddNewFloorToPhysicsSystem(const BodyID newBodyId, 
         const RVec3 newBodyInitialPosition);
+
+    /** 
+    * Adds a batch of new bodies to the physics world. Every body is created
+    * first, and then the bodies of each object layer are inserted on the 
+    * broad phase at once (through "AddBodiesPrepare" and 
+    * "AddBodiesFinalize"), which is much cheaper than adding them one by one.
+    * If the batch is large enough, the broad phase is optimized afterwards.
+    * 
+    * @param bodiesCreationInfo The info of each body to add
+    * @param outBodiesErrors If given, the error of each body, on the same
+    * order as the bodies' info. Empty if the body was added
+    * 
+    * @return The number of bodies added. Bodies that could not be created 
+    * (e.g. their ID is already in use) are skipped
+    * 
+    * @see SetBroadPhaseOptimizationBodyThreshold
+    */
+    size_t AddNewBodiesToPhysicsWorld
+        (const std::vector<BodyCreationInfo>& bodiesCreationInfo,
+        std::vector<std::string>* outBodiesErrors = nullptr);
+
+    /** 
+    * Sets the minimum number of bodies on a batch for the broad phase to be 
+    * optimized after the batch is added.
+    * 
+    * @param newBroadPhaseOptimizationBodyThreshold The minimum number of 
+    * bodies. 0 disables the broad phase optimization
+    */
+    void SetBroadPhaseOptimizationBodyThreshold
+        (size_t newBroadPhaseOptimizationBodyThreshold);
+
+    /** 
+    * Sets the service's config, which every following initialization uses
+    * (see "InitPhysicsSystem()"). The config should be validated first.
+    * 
+    * @param newServiceConfig The service's config
+    */
+    void SetServiceConfig(const PhysicsServiceConfig& newServiceConfig);
+
+    /** @return The service's config */
+    const PhysicsServiceConfig& GetServiceConfig() const 
+    { 
+        return serviceConfig; 
+    }
+
+    /** 
+    * Sets the host of this physics world (see "PhysicsWorldHost"). If the
+    * host shares its resources, every following initialization uses the 
+    * shared job system instead of creating one, and each physics step takes
+    * a temp allocator from the shared pool. Must be called before the first
+    * initialization.
+    * 
+    * @param newWorldHost The host of this world
+    * @param newWorldId The ID of this world on the host
+    */
+    void SetWorldHost(PhysicsWorldHost* newWorldHost, 
+        std::uint32_t newWorldId);
+
+    /** @return The host of this world, or null if it is not hosted */
+    PhysicsWorldHost* GetWorldHost() const { return worldHost; }
+
+    /** @return The ID of this world on its host */
+    std::uint32_t GetWorldId() const { return worldId; }
+
+    /** The resources taken by a physics world, since its measures reset */
+    struct WorldCostMeasures
+    {
+        /** Flag that indicates if the physics system is initialized */
+        bool bIsInitialized = false;
+
+        /** The bodies tracked by the service */
+        size_t bodyCount = 0;
+
+        /** The measured physics steps */
+        std::uint64_t stepCount = 0;
+
+        /** The steps' mean and 99th percentile time, in nanoseconds */
+        double stepTimeMeanNanoseconds = 0.0;
+        std::uint64_t stepTimeP99Nanoseconds = 0;
+
+        /** The summed time of the steps, in nanoseconds */
+        double stepTimeTotalNanoseconds = 0.0;
+
+        /** The peak usage of the temp allocator on any step, in bytes */
+        std::uint64_t tempAllocatorPeakBytes = 0;
+
+        /** 
+        * The estimated memory footprint of the physics system, without the
+        * resources shared with other worlds, in bytes
+        */
+        std::uint64_t memoryFootprintBytes = 0;
+    };
+
+    /** 
+    * Gets the resources taken by this world, for its host's world costs 
+    * report (see "PhysicsWorldHost::GetWorldCostsReport()"). Waits for the
+    * pipelined physics step in flight (if any).
+    * 
+    * @return The world's cost measures
+    */
+    WorldCostMeasures GetWorldCostMeasures();
+
+    /** 
+    * @param worldConfig The config of the physics system
+    * 
+    * @return The settings of a temp allocator for the physics system
+    */
+    static AdaptiveTempAllocator::Settings GetTempAllocatorSettings
+        (const PhysicsServiceConfig& worldConfig);
+
+    /** 
+    * @param worldConfig The config of the physics system
+    * 
+    * @return The settings of the phase profiler for the physics system, 
+    * which dumps the profile of its slow steps
+    */
+    static PhaseProfiler::Settings GetPhaseProfilerSettings
+        (const PhysicsServiceConfig& worldConfig);
+
+    /** 
+    * @param worldConfig The config of the physics system
+    * 
+    * @return The settings of a job system for the physics system
+    */
+    static WorkStealingJobSystem::Settings GetJobSystemSettings
+        (const PhysicsServiceConfig& worldConfig);
     
-    /** */
-    std::string GetSimulationMeasures() const;
+    /** 
+    * Gets the measures of the steps since the initialization (or the last
+    * reset), a "name;value" line per measure:
+    * - stepCount, and the step times' mean, p50, p90, p99, p999 and max (in
+    * microseconds, e.g. "stepTimeP99Us;1234.567")
+    * - The same times of the step responses' serialization (e.g. 
+    * "serializationTimeP99Us;12.345")
+    * - The temp allocator's peak usage, capacity and overflows
+    * - The job system's executed and stolen jobs, and the workers' sleeps
+    * 
+    * If the world's host shares its resources (see "SetWorldHost()"), the
+    * capacity and overflows are the temp allocator pool's, and the job 
+    * system's counters are the shared job system's. These are summed over
+    * every world, so they are not reset.
+    * 
+    * Optionally followed by "recentSteps;N" and the N most recent steps, 
+    * from the oldest, as "stepNumber;durationUs;tempAllocatorPeakBytes".
+    * 
+    * @param bResetOnRead If the measures should be reset after they are read
+    * @param bIncludeRecentSamples If the most recent steps should be included
+    * 
+    * @return The simulation measures
+    */
+    std::string GetSimulationMeasures(bool bResetOnRead = false, 
+        bool bIncludeRecentSamples = false);
+
+    /** 
+    * Gets the time of each phase of the physics update since the 
+    * initialization (or the last reset), from the slowest (see 
+    * "PhaseProfiler::GetReport()"). On the phase profiling build, it is 
+    * followed by "broadPhaseStats;N" and the N lines of the broad phase's 
+    * query stats since the initialization. Otherwise, it only has 
+    * "phaseProfiling;disabled".
+    * 
+    * It starts with "phaseProfileScope;world", or with 
+    * "phaseProfileScope;process" when the worlds share their resources: 
+    * their phases can't be told apart, so they are gathered by the world's
+    * host for the whole process (see "PhysicsWorldHost"), and the phase 
+    * times are only reset by a reset on read.
+    * 
+    * @param bResetOnRead If the phase times should be reset after they are
+    * read
+    * 
+    * @return The phase profile
+    */
+    std::string GetPhaseProfile(bool bResetOnRead = false);
 
     /** 
     * Removes a Body from the current running physics world. Thus, this body
@@ -114,6 +634,21 @@ public:
     */
     std::string RemoveBodyByID(const BodyID bodyToRemoveID);
 
+    /** 
+    * Removes a batch of bodies from the current running physics world. The
+    * bodies are removed from the broad phase at once (through 
+    * "RemoveBodies") and destroyed.
+    * 
+    * @param bodiesToRemoveIDs The BodyIDs of the bodies to remove
+    * @param outBodiesErrors If given, the error of each body, on the same 
+    * order as the BodyIDs. Empty if the body was removed
+    * 
+    * @return The number of bodies removed. Bodies that are not on the 
+    * physics world (or repeated on the batch) are skipped
+    */
+    size_t RemoveBodiesByID(const std::vector<BodyID>& bodiesToRemoveIDs,
+        std::vector<std::string>* outBodiesErrors = nullptr);
+
     /** 
     * Updates a given body type. The parameters should give the BodyID from 
     * the target body and the new body type.
@@ -125,7 +660,257 @@ public:
     */
     std::string UpdateBodyType(BodyID bodyIdToUpdate, EBodyType newBodyType);
 
+    /** 
+    * Updates the type of a batch of bodies.
+    * 
+    * @param bodyTypeUpdates The BodyID of each target body and its new type
+    * @param outBodiesErrors If given, the error of each update, on the same
+    * order as the updates. Empty if the body type was updated
+    * 
+    * @return The number of bodies updated. Bodies that are not on the 
+    * physics world or not tracked by the service are skipped
+    */
+    size_t UpdateBodiesType
+        (const std::vector<std::pair<BodyID, EBodyType>>& bodyTypeUpdates,
+        std::vector<std::string>* outBodiesErrors = nullptr);
+
+    /** 
+    * Exports bodies into a body migration blob (see "BodyMigrationBlob"),
+    * so they can be handed off to another service exactly as they are. The
+    * blob has each body's Jolt state and runtime data.
+    * 
+    * @param bodyIdsToExport The BodyIDs of the bodies to export
+    * @param bRemoveExportedBodies If the bodies should be removed from the
+    * physics world once exported (i.e. they are handed off)
+    * @param outBlob The blob with every exported body
+    * @param outError The error, if any body is not on the physics world or
+    * is repeated. No body is exported nor removed then
+    * 
+    * @return True if the bodies were exported
+    */
+    bool ExportBodies(const std::vector<BodyID>& bodyIdsToExport, 
+        bool bRemoveExportedBodies, std::string& outBlob, 
+        std::string& outError);
+
+    /** 
+    * Imports the bodies of a body migration blob (see "ExportBodies()").
+    * Each body is created with its ID, gets its exported Jolt state and 
+    * runtime data, and the bodies are inserted on the physics world as a 
+    * batch. The bodies that were sleeping are not activated.
+    * 
+    * Jolt's contact cache is shared by the world's bodies, so it is not 
+    * handed off: the imported bodies build their contacts on their first 
+    * step.
+    * 
+    * @param blob The body migration blob
+    * @param outBodiesErrors The error of each body, on the blob's order. 
+    * Empty if the body was imported
+    * @param outError The error, if the blob is not valid. No body is 
+    * imported then
+    * 
+    * @return The number of bodies imported
+    */
+    size_t ImportBodies(std::string_view blob, 
+        std::vector<std::string>& outBodiesErrors, std::string& outError);
+
+    /** 
+    * Saves the whole world into a snapshot file on the config's snapshot 
+    * directory (see "WorldSnapshotFile"): every body on the physics world 
+    * with its runtime data, the step counter and Jolt's physics state 
+    * (rotations, velocities, sleep states, contact cache...).
+    * 
+    * @param snapshotName The snapshot's file name
+    * 
+    * @return The save report, with the number of bodies and how long the
+    * save took, or the error
+    */
+    std::string SaveSnapshot(std::string_view snapshotName);
+
+    /** 
+    * Replaces the physics system with the world saved on a snapshot file 
+    * (see "SaveSnapshot()"). The physics system is created with the 
+    * service's config, with room for at least the saved world's bodies. The
+    * saved bodies are created on their saved place as a batch, and then 
+    * Jolt's physics state is restored, read in place from the memory-mapped
+    * file. The steps continue from the saved step counter.
+    * 
+    * The snapshot is checked first, and if it is invalid, the current 
+    * physics system is kept as it is.
+    * 
+    * @param snapshotName The snapshot's file name
+    * 
+    * @return The load report, with the number of bodies and how long the 
+    * load took, or the error
+    */
+    std::string LoadSnapshot(std::string_view snapshotName);
+
 private:
+    /** 
+    * Checks if a line of the initialization info is a config line.
+    * 
+    * @param initInfoLine The line of the initialization info
+    * 
+    * @return True if the line starts with "initConfigLinePrefix"
+    */
+    static bool IsInitConfigLine(std::string_view initInfoLine);
+
+    /** 
+    * @return True if the world's host shares its job system and temp 
+    * allocators (see "SetWorldHost()")
+    */
+    bool UsesSharedResources() const;
+
+    /** 
+    * Creates the physics system, without any body, along with its temp 
+    * allocator, job system (unless the world's host shares them) and 
+    * listeners.
+    * 
+    * @param worldConfig The config of the physics system, already validated
+    */
+    void CreatePhysicsSystem(const PhysicsServiceConfig& worldConfig);
+
+    /** 
+    * Resets the measures and the activation events once the physics 
+    * system's bodies are created, and flags it as initialized.
+    * 
+    * @param worldConfig The config of the physics system
+    */
+    void StartSimulation(const PhysicsServiceConfig& worldConfig);
+
+    /** 
+    * Updates the physics system by one frame. This will also measure the
+    * time the update took and increase the step counter.
+    */
+    void UpdatePhysicsSystem();
+
+    /** 
+    * Waits for the pipelined physics step in flight (if any). This must be
+    * called before accessing the physics world from the service's thread,
+    * as the pipelined physics steps run on a worker thread.
+    */
+    void WaitForPipelinedUpdate();
+
+    /** 
+    * Waits for the pipelined physics step in flight (if any) and drops its
+    * snapshot, as it will not be reported. Called when stepping the physics
+    * system on any other mode.
+    */
+    void FinishPipelinedStepping();
+
+    /** 
+    * Captures the state of every body tracked by the service.
+    * 
+    * @param outSnapshot The snapshot to capture the state into. Its body 
+    * states are reused, so no allocation happens once it has grown to the
+    * world's size
+    */
+    void CapturePhysicsStateSnapshot(PhysicsStateSnapshot& outSnapshot) const;
+
+    /** 
+    * Extracts the state of the given bodies after a physics step, in a 
+    * single pass and without taking any body lock. Must not be called while
+    * a physics step is running on another thread.
+    * 
+    * @param bodyIdsToExtract The BodyIDs of the bodies to extract
+    * @param bodyIdsToExtractCount The number of bodies to extract
+    * @param outBodyStates The arrays to extract the states into. Only the 
+    * bodies on the physics world and tracked by the service (i.e. with 
+    * runtime data) are extracted
+    */
+    void ExtractBodyStates(const BodyID* bodyIdsToExtract, 
+        size_t bodyIdsToExtractCount, BodyStateArrays& outBodyStates) const;
+
+    /** 
+    * Writes the full step response (i.e. every body's record) from the
+    * extracted body states.
+    * 
+    * @param bodyStates The body states to write the response from
+    * @param stepNumber The step number to write on the binary header
+    * @param bUseBinaryFormat True to encode the response on the binary 
+    * format and false to use the text format
+    * @param quantizationSettings The client's quantization settings, if the
+    * binary body records should be quantized
+    * @param deltaHistory The client's delta history, if the quantized 
+    * states should be delta compressed
+    * @param outStepResponse The buffer to write the response into
+    */
+    void WriteFullStepResponse(const BodyStateArrays& bodyStates, 
+        std::uint32_t stepNumber, bool bUseBinaryFormat, 
+        const StateQuantizationSettings* quantizationSettings,
+        StateDeltaHistory* deltaHistory, std::string& outStepResponse) const;
+
+    /** 
+    * Records how long a step response took to be written, on the step 
+    * measurements (see "StepMeasurements::RecordSerialization()").
+    * 
+    * @param serializationStartTime When the response started to be written
+    */
+    void RecordSerializationTime
+        (std::chrono::steady_clock::time_point serializationStartTime);
+
+    /** 
+    * Marks a body to be reported on the next active set step response of
+    * every subscribed client, even if it is sleeping (e.g. it was just added
+    * or its type was updated).
+    * 
+    * @param bodyId The BodyID of the changed body
+    */
+    void MarkBodyChangedForActiveSet(const BodyID bodyId);
+
+    /** 
+    * Moves the activation events recorded since the last call to every 
+    * subscribed client (see "AddActiveSetClient()"). Called on the service's
+    * thread after each step, so the recorded events do not pile up.
+    */
+    void DispatchActivationEvents();
+
+    /** 
+    * Creates a sphere body, without adding it to the physics world. The 
+    * sphere is tracked by the service (i.e. has runtime data) right away.
+    * 
+    * @param sphereCreationInfo The info of the sphere to create
+    * 
+    * @return The created body or nullptr if it could not be created
+    */
+    Body* CreateSphereBody(const BodyCreationInfo& sphereCreationInfo);
+
+    /** 
+    * Creates a floor body, without adding it to the physics world.
+    * 
+    * @param floorCreationInfo The info of the floor to create
+    * 
+    * @return The created body or nullptr if it could not be created
+    */
+    Body* CreateFloorBody(const BodyCreationInfo& floorCreationInfo);
+
+    /** @return The sphere bodies' shape, shared through the shape cache */
+    ShapeRefC GetSphereBodyShape();
+
+    /** 
+    * @return The floor bodies' shape, shared through the shape cache. Null if
+    * it could not be created
+    */
+    ShapeRefC GetFloorBodyShape();
+
+    /** 
+    * Adds a batch of created bodies to the physics world with a single broad
+    * phase update.
+    * 
+    * @param bodyIdsToAdd The IDs of the bodies to add. May be reordered
+    * @param activationMode If the bodies should be activated when added
+    */
+    void AddBodiesInBatch(BodyIDVector& bodyIdsToAdd, 
+        EActivation activationMode);
+
+    /** 
+    * Rebuilds the broad phase tree after a batch of bodies was added, if 
+    * the batch is large enough (see 
+    * "SetBroadPhaseOptimizationBodyThreshold()").
+    * 
+    * @param addedBodiesCount The number of bodies on the batch
+    */
+    void OptimizeBroadPhaseAfterBatch(size_t addedBodiesCount);
+
     // Callback for traces, connect this to your own trace function if you 
     // have one
     static void TraceImpl(const char *inFMT, ...)
@@ -137,8 +922,8 @@ private:
         vsnprintf(buffer, sizeof(buffer), inFMT, list);
         va_end(list);
 
-        // Print to the TTY
-        cout << buffer << endl;
+        // Log the trace
+        LOG_INFO(Physics, "%s", buffer);
     }
 
 #ifdef JPH_ENABLE_ASSERTS
@@ -147,9 +932,10 @@ private:
     static bool AssertFailedImpl(const char *inExpression, 
         const char *inMessage, const char *inFile, uint inLine)
     { 
-        // Print to the TTY
-        cout << inFile << ":" << inLine << ": (" << inExpression << ") " 
-            << (inMessage != nullptr? inMessage : "") << endl;
+        // Log the failure and make sure it is written before breaking
+        LOG_ERROR(Physics, "%s:%u: (%s) %s", inFile, inLine, inExpression, 
+            inMessage != nullptr? inMessage : "");
+        ServiceLogger::Get().Flush();
 
         // Breakpoint
         return true;
@@ -158,8 +944,8 @@ private:
 #endif // JPH_ENABLE_ASSERTS
 
 public:
-	TempAllocator* temp_allocator = nullptr;
-	JobSystem* job_system = nullptr;
+	AdaptiveTempAllocator* temp_allocator = nullptr;
+	WorkStealingJobSystem* job_system = nullptr;
 
     /**
     * Create mapping table from object layer to broadphase layer
@@ -195,11 +981,62 @@ public:
 	MyContactListener* contact_listener = nullptr;
 
     /** 
-    * The list of BodyID from all the bodies on the current running physics
-    * system. Used to query each body location and rotation on each physics
-    * step
+    * The registry of the BodyIDs from all the bodies tracked by the service
+    * on the current running physics system. Used to query each body location
+    * and rotation on each physics step
+    */
+    BodyRegistry bodyRegistry;
+
+    /** 
+    * The runtime data of the bodies tracked by the service, indexed by the
+    * body's index
+    */
+    BodyRuntimeData bodyRuntimeData;
+
+    /** The shapes shared by the bodies on the current physics system */
+    ShapeCache shapeCache;
+
+    /** 
+    * The service's config. Each initialization may override it through the
+    * initialization info
+    */
+    PhysicsServiceConfig serviceConfig;
+
+    /** The host of this world, if it is hosted (see "SetWorldHost()") */
+    PhysicsWorldHost* worldHost = nullptr;
+
+    /** The ID of this world on its host */
+    std::uint32_t worldId = 0;
+
+    /** 
+    * The estimated memory footprint of the current physics system, without
+    * the resources shared with other worlds
+    */
+    std::uint64_t worldMemoryFootprintBytes = 0;
+
+    /** The prefix of the config lines on the initialization info */
+    static constexpr std::string_view initConfigLinePrefix = "config;";
+
+    /** 
+    * The minimum number of bodies on a batch for the broad phase to be 
+    * optimized after the batch is added. 0 disables the optimization
+    */
+    size_t broadPhaseOptimizationBodyThreshold = 1000;
+
+    /** The moving bodies of the batch being added (reused per batch) */
+    BodyIDVector batchMovingBodyIds;
+
+    /** The non moving bodies of the batch being added (reused per batch) */
+    BodyIDVector batchNonMovingBodyIds;
+
+    /** The bodies of the batch being removed (reused per batch) */
+    BodyIDVector batchRemovedBodyIds;
+
+    /** 
+    * Flags if the body on the same index is on the batch being removed. 
+    * Every flag is cleared once the batch is removed
     */
-    std::vector<BodyID> BodyIdList;
+    std::vector<bool> batchRemovedBodyFlags;
 
     /** Flag that indicates if the physics system is initialized */
     bool bIsInitialized = false;
@@ -211,10 +1048,116 @@ public:
     std::uint32_t stepPhysicsCounter = 0;
 
     /** 
-    * The current physics step time measure without communication overhead.
-    * Used to test the overall system
+    * The measures of the physics steps (without communication overhead) 
+    * since the initialization or the last reset. Used to test the overall 
+    * system
+    */
+    StepMeasurements stepMeasurements;
+
+    /** 
+    * The time of each phase of the physics steps since the initialization
+    * or the last reset. Only measured on the phase profiling build, and not
+    * used when the worlds share their resources (see "PhysicsWorldHost")
+    */
+    PhaseProfiler phaseProfiler;
+
+    /** 
+    * The body states extracted on the last (non pipelined) step. Reused 
+    * between steps, so no allocation happens once it has grown to the 
+    * world's size.
+    */
+    BodyStateArrays stepBodyStates;
+
+    /** 
+    * The byte buffer the binary step response is written into. This is
+    * reused between steps so that no allocation happens once it has grown to
+    * the world's size.
+    */
+    std::string binaryStepResponseBuffer;
+
+    /** 
+    * The buffer the text step response is written into. Reused between 
+    * steps, as the binary step response buffer.
+    */
+    std::string textStepResponseBuffer;
+
+    /** The size in bytes of the binary step response header */
+    static constexpr size_t binaryStepResponseHeaderSize = 8;
+
+    /** 
+    * The byte buffer the active set step response is written into. Reused
+    * between steps, as the binary step response buffer.
+    */
+    std::string activeSetStepResponseBuffer;
+
+    /** 
+    * The clients subscribed to the world's events on the active set step 
+    * response mode. Each one keeps its own reported states and pending 
+    * events, so no client takes another's.
+    */
+    std::vector<ClientActiveSet*> activeSetClients;
+
+    /** The bodies to report on the active set response (reused per step) */
+    BodyIDVector activeSetCandidateBodyIds;
+
+    /** 
+    * The bodies that woke up since the events were last dispatched (reused
+    * per step)
+    */
+    std::vector<BodyID> activeSetWokeUpBodyIds;
+
+    /** 
+    * The bodies that went to sleep since the events were last dispatched 
+    * (reused per step)
+    */
+    std::vector<BodyID> activeSetWentToSleepBodyIds;
+
+    /** 
+    * The byte buffer the interest step response is written into. Reused
+    * between steps, as the binary step response buffer.
+    */
+    std::string interestStepResponseBuffer;
+
+    /** Flag that indicates if the pipelined stepping is enabled */
+    bool bIsPipelinedSteppingEnabled = false;
+
+    /** 
+    * Flag that indicates if a pipelined physics step was started and its
+    * snapshot was not reported yet
+    */
+    bool bIsPipelinedSnapshotPending = false;
+
+    /** The worker thread that runs the pipelined physics steps */
+    PhysicsUpdateWorker pipelinedUpdateWorker;
+
+    /** 
+    * The double buffered state snapshots of the pipelined stepping. The
+    * front snapshot is serialized on the service's thread while the back one
+    * is written by the physics step in flight.
+    */
+    PhysicsStateSnapshot pipelinedSnapshots[2];
+
+    /** The index of the front snapshot on "pipelinedSnapshots" */
+    size_t pipelinedFrontSnapshotIndex = 0;
+
+    /** 
+    * The byte buffer the pipelined step response is written into. Reused
+    * between steps, as the binary step response buffer.
+    */
+    std::string pipelinedStepResponseBuffer;
+
+    /** 
+    * The client that advances the world on its steps, or null if no client
+    * has claimed it yet (see "ClaimStepAuthority()")
+    */
+    const ClientConnectionSettings* stepAuthorityClient = nullptr;
+
+    /** 
+    * The byte buffer the spectators' step responses are written into (see
+    * "WriteLatestStepResponse()"). Reused between steps, as the binary step
+    * response buffer.
     */
-	std::string physicsStepSimulationTimeMeasure = "";
+    std::string latestStepResponseBuffer;
 };
 
 #endif
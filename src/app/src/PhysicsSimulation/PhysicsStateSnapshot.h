@@ -0,0 +1,25 @@
+#ifndef PHYSICSSTATESNAPSHOT_H
+#define PHYSICSSTATESNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "BodyStateArrays.h"
+
+/** 
+* An immutable capture of the physics world's reported state right after a
+* physics step. The pipelined stepping serializes the step responses from a
+* snapshot, so the next physics step can already run on the live world.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationPipelined
+*/
+struct PhysicsStateSnapshot
+{
+    /** The step number the snapshot was captured on */
+    std::uint32_t stepNumber = 0;
+
+    /** The state of every body tracked by the service */
+    BodyStateArrays bodyStates;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "PhysicsUpdateWorker.h"
+
+PhysicsUpdateWorker::~PhysicsUpdateWorker()
+{
+    Stop();
+}
+
+void PhysicsUpdateWorker::StartUpdate(std::function<void()> updateTask)
+{
+    // Only one update may be in flight
+    WaitForUpdate();
+
+    // Create the worker thread on the first update
+    if(!workerThread.joinable())
+    {
+        bShouldStop = false;
+        workerThread = std::thread(&PhysicsUpdateWorker::RunWorkerLoop, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> workerLock(workerMutex);
+        pendingUpdateTask = std::move(updateTask);
+        bHasPendingUpdate = true;
+        bIsUpdateInFlight = true;
+    }
+
+    workerCondition.notify_all();
+}
+
+void PhysicsUpdateWorker::WaitForUpdate()
+{
+    std::unique_lock<std::mutex> workerLock(workerMutex);
+    workerCondition.wait(workerLock, [this] { return !bIsUpdateInFlight; });
+}
+
+bool PhysicsUpdateWorker::IsUpdateInFlight()
+{
+    std::lock_guard<std::mutex> workerLock(workerMutex);
+    return bIsUpdateInFlight;
+}
+
+void PhysicsUpdateWorker::Stop()
+{
+    if(!workerThread.joinable())
+    {
+        return;
+    }
+
+    WaitForUpdate();
+
+    {
+        std::lock_guard<std::mutex> workerLock(workerMutex);
+        bShouldStop = true;
+    }
+
+    workerCondition.notify_all();
+    workerThread.join();
+}
+
+void PhysicsUpdateWorker::RunWorkerLoop()
+{
+    std::unique_lock<std::mutex> workerLock(workerMutex);
+    while(true)
+    {
+        // Sleep until there is an update to run or we should exit
+        workerCondition.wait(workerLock, 
+            [this] { return bHasPendingUpdate || bShouldStop; });
+
+        if(bShouldStop && !bHasPendingUpdate)
+        {
+            return;
+        }
+
+        std::function<void()> updateTask = std::move(pendingUpdateTask);
+        bHasPendingUpdate = false;
+
+        // Run the update without holding the lock, so the service's thread
+        // can check on it
+        workerLock.unlock();
+        updateTask();
+        workerLock.lock();
+
+        bIsUpdateInFlight = false;
+        workerCondition.notify_all();
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef PHYSICSUPDATEWORKER_H
+#define PHYSICSUPDATEWORKER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/** 
+* A worker thread that runs a physics update in the background. This is used
+* by the pipelined stepping, so the next physics update runs (and dispatches
+* its jobs to the job system) while the previous step's response is serialized
+* and sent on the service's thread.
+*
+* Only one update may be in flight at a time. Starting an update while another
+* one is in flight waits for the in flight one first.
+*
+* @see PhysicsServiceImpl::StepPhysicsSimulationPipelined
+*/
+class PhysicsUpdateWorker
+{
+public:
+    /** Stops the worker thread, waiting for any update in flight */
+    ~PhysicsUpdateWorker();
+
+    /** 
+    * Starts running the given update on the worker thread. The worker thread
+    * is created on the first call.
+    * 
+    * @param updateTask The update to run
+    */
+    void StartUpdate(std::function<void()> updateTask);
+
+    /** Waits until the update in flight (if any) finishes */
+    void WaitForUpdate();
+
+    /** @return True if an update was started and has not finished yet */
+    bool IsUpdateInFlight();
+
+    /** 
+    * Stops the worker thread, waiting for any update in flight. The worker
+    * thread is created again on the next "StartUpdate()" call.
+    */
+    void Stop();
+
+private:
+    /** The worker thread's loop. Runs each started update until stopped */
+    void RunWorkerLoop();
+
+private:
+    /** The worker thread. Only created once an update is started */
+    std::thread workerThread;
+
+    /** Protects the worker's state below */
+    std::mutex workerMutex;
+
+    /** Signals the worker and the waiting threads of state changes */
+    std::condition_variable workerCondition;
+
+    /** The update the worker should run next */
+    std::function<void()> pendingUpdateTask;
+
+    /** Flag that indicates if "pendingUpdateTask" was not taken yet */
+    bool bHasPendingUpdate = false;
+
+    /** Flag that indicates if an update was started and did not finish */
+    bool bIsUpdateInFlight = false;
+
+    /** Flag that asks the worker thread to exit */
+    bool bShouldStop = false;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "PhysicsWorldHost.h"
+#include "PhysicsServiceImpl.h"
+#include "../Logging/ServiceLogger.h"
+
+#include <cstdio>
+
+PhysicsWorldHost::~PhysicsWorldHost()
+{
+    // The worlds go first, as their steps may use the shared resources
+    worlds.clear();
+}
+
+void PhysicsWorldHost::CreateWorlds
+    (const PhysicsServiceConfig& serviceConfig)
+{
+    // A single world keeps creating its own resources, with the config of
+    // each initialization
+    if(serviceConfig.worldCount > 1)
+    {
+        sharedJobSystem = std::make_unique<WorkStealingJobSystem>
+            (PhysicsServiceImpl::GetJobSystemSettings(serviceConfig));
+        tempAllocatorSettings =
+            PhysicsServiceImpl::GetTempAllocatorSettings(serviceConfig);
+        sharedPhaseProfiler.SetSettings
+            (PhysicsServiceImpl::GetPhaseProfilerSettings(serviceConfig));
+    }
+
+    worlds.reserve(serviceConfig.worldCount);
+    for(std::uint32_t worldId = 0; worldId < serviceConfig.worldCount;
+        worldId++)
+    {
+        std::unique_ptr<PhysicsServiceImpl>& world =
+            worlds.emplace_back(std::make_unique<PhysicsServiceImpl>());
+        world->SetServiceConfig(serviceConfig);
+        world->SetWorldHost(this, worldId);
+    }
+
+    LOG_INFO(Physics, "Hosting %u physics worlds (shared resources: %s).",
+        serviceConfig.worldCount, IsSharingResources() ? "yes" : "no");
+}
+
+PhysicsServiceImpl* PhysicsWorldHost::GetWorld(std::uint32_t worldId) const
+{
+    return worldId < worlds.size() ? worlds[worldId].get() : nullptr;
+}
+
+AdaptiveTempAllocator* PhysicsWorldHost::AcquireTempAllocator()
+{
+    std::lock_guard<std::mutex> poolLock(tempAllocatorPoolMutex);
+
+    if(freeTempAllocators.empty())
+    {
+        // More steps run at once than ever before. The new allocator maps
+        // its buffer here, so this only happens while the pool warms up
+        tempAllocators.push_back(std::make_unique<AdaptiveTempAllocator>
+            (tempAllocatorSettings));
+
+        LOG_DEBUG(Physics, "Temp allocator pool grown to %zu allocators.",
+            tempAllocators.size());
+
+        return tempAllocators.back().get();
+    }
+
+    AdaptiveTempAllocator* tempAllocator = freeTempAllocators.back();
+    freeTempAllocators.pop_back();
+    return tempAllocator;
+}
+
+void PhysicsWorldHost::ReleaseTempAllocator
+    (AdaptiveTempAllocator* tempAllocator)
+{
+    std::lock_guard<std::mutex> poolLock(tempAllocatorPoolMutex);
+    freeTempAllocators.push_back(tempAllocator);
+}
+
+PhysicsWorldHost::TempAllocatorPoolStats
+    PhysicsWorldHost::GetTempAllocatorPoolStats() const
+{
+    std::lock_guard<std::mutex> poolLock(tempAllocatorPoolMutex);
+
+    TempAllocatorPoolStats poolStats;
+    poolStats.allocatorCount = tempAllocators.size();
+    poolStats.allocatorsInUse =
+        tempAllocators.size() - freeTempAllocators.size();
+
+    for(const AdaptiveTempAllocator* tempAllocator : freeTempAllocators)
+    {
+        poolStats.capacityBytes += tempAllocator->GetCapacity();
+        poolStats.overflowCount += tempAllocator->GetOverflowCount();
+    }
+
+    return poolStats;
+}
+
+void PhysicsWorldHost::EndPhaseProfilerStep(std::uint32_t stepNumber,
+    std::uint64_t stepDurationNanoseconds)
+{
+    std::lock_guard<std::mutex> phaseProfilerLock(phaseProfilerMutex);
+    sharedPhaseProfiler.EndStep(stepNumber, stepDurationNanoseconds);
+}
+
+std::string PhysicsWorldHost::GetPhaseProfilerReport(bool bResetOnRead)
+{
+    std::lock_guard<std::mutex> phaseProfilerLock(phaseProfilerMutex);
+
+    std::string phaseProfilerReport = sharedPhaseProfiler.GetReport();
+    if(bResetOnRead)
+    {
+        sharedPhaseProfiler.Reset();
+    }
+
+    return phaseProfilerReport;
+}
+
+std::string PhysicsWorldHost::GetWorldCostsReport() const
+{
+    // Waiting for each world's step in flight also leaves the pool's
+    // allocators free, so the pool's totals cover all of them
+    std::vector<PhysicsServiceImpl::WorldCostMeasures> worldCosts;
+    worldCosts.reserve(worlds.size());
+
+    double allWorldsStepTimeNanoseconds = 0.0;
+    for(const std::unique_ptr<PhysicsServiceImpl>& world : worlds)
+    {
+        worldCosts.push_back(world->GetWorldCostMeasures());
+        allWorldsStepTimeNanoseconds +=
+            worldCosts.back().stepTimeTotalNanoseconds;
+    }
+
+    char reportLine[256];
+    std::string worldCostsReport;
+
+    const auto appendCount = [&](const char* measureName,
+        std::uint64_t measure)
+    {
+        std::snprintf(reportLine, sizeof(reportLine), "%s;%llu\n",
+            measureName, static_cast<unsigned long long>(measure));
+        worldCostsReport += reportLine;
+    };
+
+    appendCount("worldCount", worlds.size());
+    appendCount("sharedResources", IsSharingResources() ? 1 : 0);
+
+    if(IsSharingResources())
+    {
+        const WorkStealingJobSystem::Stats jobSystemStats =
+            sharedJobSystem->GetStats();
+        appendCount("jobWorkerThreads", static_cast<std::uint64_t>
+            (sharedJobSystem->GetWorkerThreadCount()));
+        appendCount("jobsExecuted", jobSystemStats.executedJobs);
+        appendCount("jobsStolen", jobSystemStats.stolenJobs);
+
+        const TempAllocatorPoolStats poolStats = GetTempAllocatorPoolStats();
+        appendCount("tempAllocatorPoolSize", poolStats.allocatorCount);
+        appendCount("tempAllocatorPoolInUse", poolStats.allocatorsInUse);
+        appendCount("tempAllocatorPoolCapacityBytes",
+            poolStats.capacityBytes);
+        appendCount("tempAllocatorPoolOverflows", poolStats.overflowCount);
+    }
+
+    for(size_t worldId = 0; worldId < worldCosts.size(); worldId++)
+    {
+        const PhysicsServiceImpl::WorldCostMeasures& worldCost =
+            worldCosts[worldId];
+        const double stepTimeShare = allWorldsStepTimeNanoseconds > 0.0
+            ? worldCost.stepTimeTotalNanoseconds
+            / allWorldsStepTimeNanoseconds : 0.0;
+
+        std::snprintf(reportLine, sizeof(reportLine),
+            "world;%zu;%d;%zu;%llu;%.3f;%.3f;%.3f;%.4f;%llu;%llu\n", worldId,
+            worldCost.bIsInitialized ? 1 : 0, worldCost.bodyCount,
+            static_cast<unsigned long long>(worldCost.stepCount),
+            worldCost.stepTimeMeanNanoseconds / 1000.0,
+            static_cast<double>(worldCost.stepTimeP99Nanoseconds) / 1000.0,
+            worldCost.stepTimeTotalNanoseconds / 1000000.0, stepTimeShare,
+            static_cast<unsigned long long>(worldCost.tempAllocatorPeakBytes),
+            static_cast<unsigned long long>(worldCost.memoryFootprintBytes));
+        worldCostsReport += reportLine;
+    }
+
+    return worldCostsReport;
+}
@@ -0,0 +1,189 @@
+#ifndef PHYSICSWORLDHOST_H
+#define PHYSICSWORLDHOST_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PhysicsServiceConfig.h"
+#include "WorkStealingJobSystem.h"
+#include "AdaptiveTempAllocator.h"
+#include "PhaseProfiler.h"
+
+class PhysicsServiceImpl;
+
+/**
+* Hosts the physics worlds of the service, each one a physics service
+* implementation addressed by its world ID (from 0 to the config's
+* "worldCount" - 1). Each world has its own physics system, bodies and
+* measures, but when there is more than one they share:
+* - A job system, created from the service config, so the worlds do not
+* oversubscribe the CPUs with a job system each. The physics steps of
+* independent worlds may run at once (e.g. on their pipelined update
+* workers), spreading their jobs over the same workers.
+* - A pool of temp allocators. Each physics step takes one for its duration
+* (see "AcquireTempAllocator()"), so there are only as many allocators as
+* steps that ran at once, instead of one per world.
+* - A phase profiler. Jolt's profile scopes are process wide and the jobs of
+* every world run on the same workers, so the phases can't be told apart by
+* world. Every world's steps are gathered on the one profiler, which reports
+* the phases of the whole process.
+*
+* A single world keeps its own job system and temp allocator, created by
+* each initialization with its own config.
+*/
+class PhysicsWorldHost final
+{
+public:
+    /** Deletes the worlds, and then the resources they share */
+    ~PhysicsWorldHost();
+
+    /**
+    * Creates the worlds, and the resources they share if there is more than
+    * one. Every world takes the given config as its service config (see
+    * "PhysicsServiceImpl::SetServiceConfig()").
+    *
+    * @param serviceConfig The (validated) physics service config, with the
+    * number of worlds to host
+    */
+    void CreateWorlds(const PhysicsServiceConfig& serviceConfig);
+
+    /** @return The number of hosted worlds */
+    size_t GetWorldCount() const { return worlds.size(); }
+
+    /**
+    * @param worldId The world's ID
+    *
+    * @return The world with the given ID, or null if there is none
+    */
+    PhysicsServiceImpl* GetWorld(std::uint32_t worldId) const;
+
+    /** @return True if the worlds share a job system and temp allocators */
+    bool IsSharingResources() const { return sharedJobSystem != nullptr; }
+
+    /** @return The shared job system, or null if resources are not shared */
+    WorkStealingJobSystem* GetSharedJobSystem() const
+    {
+        return sharedJobSystem.get();
+    }
+
+    /**
+    * Takes a temp allocator from the pool for a physics step, creating a new
+    * one if every allocator is in use. The allocator that was released last
+    * is taken first, as its buffer is the most likely to be warm. Thread
+    * safe, as the worlds may step on their own threads.
+    *
+    * @return The temp allocator, owned by the pool
+    */
+    AdaptiveTempAllocator* AcquireTempAllocator();
+
+    /**
+    * Gives a temp allocator back to the pool once its step finished (see
+    * "AdaptiveTempAllocator::OnStepFinished()"). Thread safe.
+    *
+    * @param tempAllocator The temp allocator taken from the pool
+    */
+    void ReleaseTempAllocator(AdaptiveTempAllocator* tempAllocator);
+
+    /** The totals of the temp allocator pool */
+    struct TempAllocatorPoolStats
+    {
+        /** The allocators on the pool */
+        size_t allocatorCount = 0;
+
+        /** The allocators in use by a physics step */
+        size_t allocatorsInUse = 0;
+
+        /** The summed capacity of the allocators not in use, in bytes */
+        std::uint64_t capacityBytes = 0;
+
+        /** The summed overflows of the allocators not in use */
+        std::uint64_t overflowCount = 0;
+    };
+
+    /**
+    * Gets the totals of the temp allocator pool. The allocators in use by a
+    * physics step are only counted, as they change during the step. Thread
+    * safe.
+    *
+    * @return The temp allocator pool's totals
+    */
+    TempAllocatorPoolStats GetTempAllocatorPoolStats() const;
+
+    /**
+    * Gathers the phase times of a world's step on the shared phase profiler
+    * (see "PhaseProfiler::EndStep()"). Thread safe.
+    *
+    * @param stepNumber The step's number, for the dumps
+    * @param stepDurationNanoseconds How long the step took
+    */
+    void EndPhaseProfilerStep(std::uint32_t stepNumber,
+        std::uint64_t stepDurationNanoseconds);
+
+    /**
+    * Gets the phase measures of every world's steps (see 
+    * "PhaseProfiler::GetReport()"). Thread safe.
+    *
+    * @param bResetOnRead If the phase times should be reset after they are
+    * read
+    *
+    * @return The process wide phase measures
+    */
+    std::string GetPhaseProfilerReport(bool bResetOnRead);
+
+    /**
+    * Gets the resources each world takes, so their cost is visible. The
+    * report starts with "name;value" lines of the shared resources:
+    * - worldCount and sharedResources (1 if the worlds share them)
+    * - The job system's workers and executed, stolen jobs (summed over
+    * every world, as the jobs are not told apart)
+    * - The temp allocator pool's size, allocators in use, capacity and
+    * overflows
+    *
+    * Followed by a line per world, as "world;worldId;initialized;bodyCount;
+    * stepCount;stepTimeMeanUs;stepTimeP99Us;stepTimeTotalMs;stepTimeShare;
+    * tempAllocatorPeakBytes;memoryFootprintBytes", where the step time share
+    * is the world's fraction of the step time of every world (i.e. of the
+    * time the shared job system worked for the worlds). The measures are
+    * since each world's initialization or its last measures reset (see
+    * "PhysicsServiceImpl::GetSimulationMeasures()").
+    *
+    * Waits for the pipelined steps in flight, so it must be called from the
+    * thread the worlds are handled on.
+    *
+    * @return The world costs report
+    */
+    std::string GetWorldCostsReport() const;
+
+private:
+    /** The job system shared by the worlds, if there is more than one */
+    std::unique_ptr<WorkStealingJobSystem> sharedJobSystem;
+
+    /** The settings of the temp allocators on the pool */
+    AdaptiveTempAllocator::Settings tempAllocatorSettings;
+
+    /** Guards the temp allocator pool */
+    mutable std::mutex tempAllocatorPoolMutex;
+
+    /** Guards the shared phase profiler */
+    std::mutex phaseProfilerMutex;
+
+    /** The phase profiler of every world, if there is more than one */
+    PhaseProfiler sharedPhaseProfiler;
+
+    /** Every temp allocator on the pool */
+    std::vector<std::unique_ptr<AdaptiveTempAllocator>> tempAllocators;
+
+    /** The temp allocators on the pool not in use by any step */
+    std::vector<AdaptiveTempAllocator*> freeTempAllocators;
+
+    /**
+    * The hosted worlds, by their world ID. Declared last, so they are
+    * deleted before the resources they share
+    */
+    std::vector<std::unique_ptr<PhysicsServiceImpl>> worlds;
+};
+
+#endif
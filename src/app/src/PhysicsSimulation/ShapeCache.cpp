@@ -0,0 +1,64 @@
+#include "ShapeCache.h"
+
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+
+ShapeRefC ShapeCache::GetSphereShape(float radius)
+{
+    ShapeCacheKey shapeKey;
+    shapeKey.shapeType = ECachedShapeType::Sphere;
+    shapeKey.shapeParams[0] = radius;
+
+    auto cachedShapeIt = cachedShapes.find(shapeKey);
+    if(cachedShapeIt != cachedShapes.end())
+    {
+        hitCount++;
+        return cachedShapeIt->second;
+    }
+
+    missCount++;
+
+    ShapeRefC sphereShape = new SphereShape(radius);
+    cachedShapes.emplace(shapeKey, sphereShape);
+
+    return sphereShape;
+}
+
+ShapeRefC ShapeCache::GetBoxShape(Vec3Arg halfExtent)
+{
+    ShapeCacheKey shapeKey;
+    shapeKey.shapeType = ECachedShapeType::Box;
+    shapeKey.shapeParams[0] = halfExtent.GetX();
+    shapeKey.shapeParams[1] = halfExtent.GetY();
+    shapeKey.shapeParams[2] = halfExtent.GetZ();
+
+    auto cachedShapeIt = cachedShapes.find(shapeKey);
+    if(cachedShapeIt != cachedShapes.end())
+    {
+        hitCount++;
+        return cachedShapeIt->second;
+    }
+
+    missCount++;
+
+    // Create the shape through its settings, so invalid half extents are
+    // reported instead of asserting
+    BoxShapeSettings boxShapeSettings(halfExtent);
+    ShapeSettings::ShapeResult boxShapeResult = boxShapeSettings.Create();
+    if(boxShapeResult.HasError())
+    {
+        return nullptr;
+    }
+
+    ShapeRefC boxShape = boxShapeResult.Get();
+    cachedShapes.emplace(shapeKey, boxShape);
+
+    return boxShape;
+}
+
+void ShapeCache::Clear()
+{
+    cachedShapes.clear();
+    hitCount = 0;
+    missCount = 0;
+}
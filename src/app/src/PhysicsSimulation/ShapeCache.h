@@ -0,0 +1,112 @@
+#ifndef SHAPECACHE_H
+#define SHAPECACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+using namespace JPH;
+
+/**
+* The cache of the shapes used by the bodies on the physics world. Almost 
+* every body shares one of a handful of shapes, so instead of creating a shape
+* per body, the shapes are created once per type and parameters and shared
+* (they are ref-counted) by every body that uses them.
+*
+* The cache keeps a reference to every shape it created, so it must be cleared
+* before the physics system is destroyed.
+*/
+class ShapeCache final
+{
+public:
+    /**
+    * Gets the sphere shape with the given radius, creating it if it is not
+    * on the cache yet.
+    *
+    * @param radius The sphere's radius
+    *
+    * @return The shared sphere shape
+    */
+    ShapeRefC GetSphereShape(float radius);
+
+    /**
+    * Gets the box shape with the given half extent, creating it if it is not
+    * on the cache yet.
+    *
+    * @param halfExtent The box's half extent
+    *
+    * @return The shared box shape, or null if the shape could not be created
+    */
+    ShapeRefC GetBoxShape(Vec3Arg halfExtent);
+
+    /** Releases every shape on the cache */
+    void Clear();
+
+    /** @return The number of shapes on the cache */
+    size_t size() const { return cachedShapes.size(); }
+
+    /** @return The number of shape requests served from the cache */
+    std::uint64_t GetHitCount() const { return hitCount; }
+
+    /** @return The number of shape requests that created a new shape */
+    std::uint64_t GetMissCount() const { return missCount; }
+
+private:
+    /** The type of a cached shape */
+    enum class ECachedShapeType : std::uint32_t
+    {
+        Sphere,
+        Box
+    };
+
+    /** The key of a cached shape: its type and creation parameters */
+    struct ShapeCacheKey
+    {
+        ECachedShapeType shapeType = ECachedShapeType::Sphere;
+        float shapeParams[3] {};
+
+        bool operator==(const ShapeCacheKey& other) const
+        {
+            return shapeType == other.shapeType 
+                && std::memcmp(shapeParams, other.shapeParams, 
+                sizeof(shapeParams)) == 0;
+        }
+    };
+
+    /** Hashes a shape cache key from its type and parameters' bits */
+    struct ShapeCacheKeyHasher
+    {
+        size_t operator()(const ShapeCacheKey& key) const
+        {
+            size_t keyHash = std::hash<std::uint32_t>()
+                (static_cast<std::uint32_t>(key.shapeType));
+
+            for(const float shapeParam : key.shapeParams)
+            {
+                std::uint32_t shapeParamBits = 0;
+                std::memcpy(&shapeParamBits, &shapeParam, sizeof(shapeParam));
+
+                keyHash ^= std::hash<std::uint32_t>()(shapeParamBits) 
+                    + 0x9e3779b9 + (keyHash << 6) + (keyHash >> 2);
+            }
+
+            return keyHash;
+        }
+    };
+
+    /** The cached shapes, by their type and parameters */
+    std::unordered_map<ShapeCacheKey, ShapeRefC, ShapeCacheKeyHasher> 
+        cachedShapes;
+
+    /** The number of shape requests served from the cache */
+    std::uint64_t hitCount = 0;
+
+    /** The number of shape requests that created a new shape */
+    std::uint64_t missCount = 0;
+};
+
+#endif
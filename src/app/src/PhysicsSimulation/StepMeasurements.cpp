@@ -0,0 +1,48 @@
+#include "StepMeasurements.h"
+
+#include <algorithm>
+
+void StepMeasurements::RecordStep(std::uint32_t stepNumber,
+    std::uint64_t durationNanoseconds, std::uint64_t tempAllocatorPeakBytes)
+{
+    stepTimeHistogram.Record(durationNanoseconds);
+
+    this->tempAllocatorPeakBytes = std::max(this->tempAllocatorPeakBytes,
+        tempAllocatorPeakBytes);
+
+    // Overwrite the oldest step once the ring buffer is full
+    StepMeasurementSample& sample = recentSamples[nextRecentSampleIndex];
+    sample.stepNumber = stepNumber;
+    sample.durationNanoseconds = durationNanoseconds;
+    sample.tempAllocatorPeakBytes = tempAllocatorPeakBytes;
+
+    nextRecentSampleIndex = (nextRecentSampleIndex + 1) % recentSampleCapacity;
+    recentSampleCount = std::min(recentSampleCount + 1, recentSampleCapacity);
+}
+
+void StepMeasurements::RecordSerialization(std::uint64_t durationNanoseconds)
+{
+    serializationTimeHistogram.Record(durationNanoseconds);
+}
+
+void StepMeasurements::Reset()
+{
+    stepTimeHistogram.Reset();
+    serializationTimeHistogram.Reset();
+    nextRecentSampleIndex = 0;
+    recentSampleCount = 0;
+    tempAllocatorPeakBytes = 0;
+}
+
+const StepMeasurementSample& StepMeasurements::GetRecentSample
+    (std::size_t sampleIndex) const
+{
+    // The oldest step is right after the newest one once the ring buffer
+    // is full, and at the start otherwise
+    const std::size_t oldestSampleIndex =
+        (nextRecentSampleIndex + recentSampleCapacity - recentSampleCount)
+        % recentSampleCapacity;
+
+    return recentSamples[(oldestSampleIndex + sampleIndex)
+        % recentSampleCapacity];
+}
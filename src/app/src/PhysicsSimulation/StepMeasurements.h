@@ -0,0 +1,109 @@
+#ifndef STEPMEASUREMENTS_H
+#define STEPMEASUREMENTS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "StepTimeHistogram.h"
+
+/** The measures of a single physics step */
+struct StepMeasurementSample
+{
+    /** The step's number */
+    std::uint32_t stepNumber = 0;
+
+    /** How long the physics update took, in nanoseconds */
+    std::uint64_t durationNanoseconds = 0;
+
+    /** The temp allocator's peak usage on the step, in bytes */
+    std::uint64_t tempAllocatorPeakBytes = 0;
+};
+
+/**
+* The measures of the physics steps since the last reset: a histogram of the
+* step times (for their percentiles) and a ring buffer of the most recent
+* steps' measures. The memory is fixed, so recording a step never allocates,
+* however long the session runs.
+*/
+class StepMeasurements final
+{
+public:
+    /** The number of recent steps kept */
+    static constexpr std::size_t recentSampleCapacity = 1024;
+
+    /**
+    * Records the measures of a step.
+    *
+    * @param stepNumber The step's number
+    * @param durationNanoseconds How long the physics update took
+    * @param tempAllocatorPeakBytes The temp allocator's peak usage on the
+    * step
+    */
+    void RecordStep(std::uint32_t stepNumber,
+        std::uint64_t durationNanoseconds,
+        std::uint64_t tempAllocatorPeakBytes);
+
+    /**
+    * Records how long a step response took to be written (the extraction of
+    * the body states and their encoding). The responses may be written on
+    * another thread than the steps (see "SetStepPipelining"), so these 
+    * measures are kept apart from the steps' ones.
+    *
+    * @param durationNanoseconds How long the response took to be written
+    */
+    void RecordSerialization(std::uint64_t durationNanoseconds);
+
+    /** Removes every recorded measure */
+    void Reset();
+
+    /** @return The histogram of the step times */
+    const StepTimeHistogram& GetStepTimeHistogram() const
+    {
+        return stepTimeHistogram;
+    }
+
+    /** @return The histogram of the step responses' serialization times */
+    const StepTimeHistogram& GetSerializationTimeHistogram() const
+    {
+        return serializationTimeHistogram;
+    }
+
+    /** @return The temp allocator's peak usage on any step, in bytes */
+    std::uint64_t GetTempAllocatorPeakBytes() const
+    {
+        return tempAllocatorPeakBytes;
+    }
+
+    /** @return The number of recent steps kept */
+    std::size_t GetRecentSampleCount() const { return recentSampleCount; }
+
+    /**
+    * @param sampleIndex The recent step's index, from the oldest (0) to
+    * the newest ("GetRecentSampleCount()" - 1)
+    *
+    * @return The measures of a recent step
+    */
+    const StepMeasurementSample& GetRecentSample(std::size_t sampleIndex) const;
+
+private:
+    /** The histogram of the step times */
+    StepTimeHistogram stepTimeHistogram;
+
+    /** The histogram of the step responses' serialization times */
+    StepTimeHistogram serializationTimeHistogram;
+
+    /** The ring buffer of the recent steps' measures */
+    std::array<StepMeasurementSample, recentSampleCapacity> recentSamples {};
+
+    /** The position the next step is recorded on */
+    std::size_t nextRecentSampleIndex = 0;
+
+    /** The number of recent steps on the ring buffer */
+    std::size_t recentSampleCount = 0;
+
+    /** The temp allocator's peak usage on any step */
+    std::uint64_t tempAllocatorPeakBytes = 0;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "StepTimeHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+void StepTimeHistogram::Record(std::uint64_t durationNanoseconds)
+{
+    counts[GetCounterIndex(durationNanoseconds)]++;
+    totalCount++;
+    valueSum += durationNanoseconds;
+    maxValue = std::max(maxValue, durationNanoseconds);
+}
+
+void StepTimeHistogram::Merge(const StepTimeHistogram& otherHistogram)
+{
+    for(std::uint32_t i = 0; i < counterCount; i++)
+    {
+        counts[i] += otherHistogram.counts[i];
+    }
+
+    totalCount += otherHistogram.totalCount;
+    valueSum += otherHistogram.valueSum;
+    maxValue = std::max(maxValue, otherHistogram.maxValue);
+}
+
+void StepTimeHistogram::Reset()
+{
+    counts.fill(0);
+    totalCount = 0;
+    valueSum = 0;
+    maxValue = 0;
+}
+
+double StepTimeHistogram::GetMean() const
+{
+    if(totalCount == 0)
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(valueSum) / static_cast<double>(totalCount);
+}
+
+std::uint64_t StepTimeHistogram::GetValueAtPercentile(double percentile) const
+{
+    if(totalCount == 0)
+    {
+        return 0;
+    }
+
+    // The number of values at or below the percentile (at least one)
+    const double clampedPercentile = std::clamp(percentile, 0.0, 100.0);
+    const std::uint64_t targetCount = std::max<std::uint64_t>(1,
+        static_cast<std::uint64_t>(std::ceil(clampedPercentile / 100.0
+        * static_cast<double>(totalCount))));
+
+    std::uint64_t accumulatedCount = 0;
+    for(std::uint32_t i = 0; i < counterCount; i++)
+    {
+        accumulatedCount += counts[i];
+        if(accumulatedCount >= targetCount)
+        {
+            return std::min(GetCounterHighestValue(i), maxValue);
+        }
+    }
+
+    return maxValue;
+}
+
+std::uint32_t StepTimeHistogram::GetCounterIndex(std::uint64_t value)
+{
+    // The first bucket counts each value
+    if(value < subBucketCount)
+    {
+        return static_cast<std::uint32_t>(value);
+    }
+
+    // The next buckets count ranges of values as wide as 2^shift, so each
+    // value's top "subBucketBits" bits pick its sub-bucket
+    const std::uint32_t mostSignificantBit =
+        63 - static_cast<std::uint32_t>(__builtin_clzll(value));
+    const std::uint32_t shift = mostSignificantBit - subBucketBits + 1;
+    const std::uint32_t subBucketIndex =
+        static_cast<std::uint32_t>(value >> shift);
+
+    return subBucketCount + (shift - 1) * subBucketHalfCount
+        + (subBucketIndex - subBucketHalfCount);
+}
+
+std::uint64_t StepTimeHistogram::GetCounterHighestValue
+    (std::uint32_t counterIndex)
+{
+    if(counterIndex < subBucketCount)
+    {
+        return counterIndex;
+    }
+
+    const std::uint32_t bucketOffset = counterIndex - subBucketCount;
+    const std::uint32_t shift = bucketOffset / subBucketHalfCount + 1;
+    const std::uint64_t subBucketIndex =
+        bucketOffset % subBucketHalfCount + subBucketHalfCount;
+
+    // The last bucket's top range ends past 64 bits
+    if(shift + subBucketBits >= 64 && subBucketIndex == subBucketCount - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    return ((subBucketIndex + 1) << shift) - 1;
+}
@@ -0,0 +1,92 @@
+#ifndef STEPTIMEHISTOGRAM_H
+#define STEPTIMEHISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+/**
+* A fixed memory histogram of durations (in nanoseconds), in the style of an
+* HDR histogram: each power of 2 is split into the same number of linear
+* sub-buckets, so every recorded value keeps the same relative precision
+* (under 1%) from nanoseconds to hours. Recording a value is a few integer
+* operations on a fixed array, so it never allocates.
+*/
+class StepTimeHistogram final
+{
+public:
+    /**
+    * Records a duration.
+    *
+    * @param durationNanoseconds The duration, in nanoseconds
+    */
+    void Record(std::uint64_t durationNanoseconds);
+
+    /**
+    * Adds every duration recorded on another histogram (e.g. one recorded
+    * by another thread).
+    *
+    * @param otherHistogram The histogram to add the durations of
+    */
+    void Merge(const StepTimeHistogram& otherHistogram);
+
+    /** Removes every recorded duration */
+    void Reset();
+
+    /** @return The number of recorded durations */
+    std::uint64_t GetCount() const { return totalCount; }
+
+    /** @return The longest recorded duration, in nanoseconds */
+    std::uint64_t GetMax() const { return maxValue; }
+
+    /** @return The mean of the recorded durations, in nanoseconds */
+    double GetMean() const;
+
+    /**
+    * Gets the duration at a percentile of the recorded durations. As the
+    * durations are bucketed, this is the largest duration of the bucket the
+    * percentile falls on (never larger than the longest recorded one).
+    *
+    * @param percentile The percentile, from 0 to 100 (e.g. 99.9)
+    *
+    * @return The duration at the percentile, in nanoseconds, or 0 if there
+    * is no recorded duration
+    */
+    std::uint64_t GetValueAtPercentile(double percentile) const;
+
+private:
+    /** The bits of the linear sub-buckets of each power of 2 */
+    static constexpr std::uint32_t subBucketBits = 7;
+
+    /** The number of sub-buckets on the first bucket */
+    static constexpr std::uint32_t subBucketCount = 1u << subBucketBits;
+
+    /**
+    * The number of sub-buckets on the other buckets (the lower half is
+    * covered by the previous bucket)
+    */
+    static constexpr std::uint32_t subBucketHalfCount = subBucketCount / 2;
+
+    /** The number of counters, enough for any 64 bit value */
+    static constexpr std::uint32_t counterCount =
+        subBucketCount + (64 - subBucketBits) * subBucketHalfCount;
+
+    /** @return The counter of a value */
+    static std::uint32_t GetCounterIndex(std::uint64_t value);
+
+    /** @return The largest value counted on a counter */
+    static std::uint64_t GetCounterHighestValue(std::uint32_t counterIndex);
+
+    /** The number of values on each counter */
+    std::array<std::uint64_t, counterCount> counts {};
+
+    /** The number of recorded values */
+    std::uint64_t totalCount = 0;
+
+    /** The sum of the recorded values */
+    std::uint64_t valueSum = 0;
+
+    /** The largest recorded value */
+    std::uint64_t maxValue = 0;
+};
+
+#endif
@@ -0,0 +1,457 @@
+#include "WorkStealingJobSystem.h"
+#include "../Logging/ServiceLogger.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include <Jolt/Core/Profiler.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    /** The job system owning the calling thread, if it is a worker */
+    thread_local const WorkStealingJobSystem* currentThreadJobSystem = nullptr;
+
+    /** The calling thread's worker index, if it is a worker */
+    thread_local int currentThreadWorkerIndex = -1;
+
+    /** The time to wait for a free job when the job pool is exhausted */
+    constexpr std::chrono::microseconds freeJobWaitTime { 100 };
+}
+
+WorkStealingJobSystem::WorkStealingJobSystem(const Settings& settings)
+    : JobSystemWithBarrier(settings.maxBarriers),
+    settings(settings),
+    workerCount(settings.workerThreadCount > 0 ? settings.workerThreadCount
+        : 0)
+{
+    jobs.Init(settings.maxJobs, settings.maxJobs);
+
+    workers.reset(new Worker[workerCount]);
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers[i].dequeJobs.resize(settings.maxJobs, nullptr);
+    }
+
+    // Only start the threads once every worker exists, as they steal from
+    // each other
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers[i].thread = std::thread(&WorkStealingJobSystem::RunWorker,
+            this, i, GetWorkerCpu(i));
+    }
+}
+
+WorkStealingJobSystem::~WorkStealingJobSystem()
+{
+    {
+        std::lock_guard<std::mutex> sleepLock(sleepMutex);
+        bShouldQuit.store(true);
+    }
+    sleepCondition.notify_all();
+
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers[i].thread.join();
+    }
+
+    // Drop the references of the jobs that were never taken from the deques
+    for(int i = 0; i < workerCount; i++)
+    {
+        while(Job* job = PopOldestJob(workers[i]))
+        {
+            job->Release();
+        }
+    }
+}
+
+int WorkStealingJobSystem::GetMaxConcurrency() const
+{
+    // The thread waiting on a barrier runs jobs too
+    return workerCount + 1;
+}
+
+JobSystem::JobHandle WorkStealingJobSystem::CreateJob(const char* jobName,
+    ColorArg color, const JobFunction& jobFunction, uint32 numDependencies)
+{
+    JPH_PROFILE_FUNCTION();
+
+    // Wait until a job is freed if the pool is exhausted
+    uint32 jobIndex;
+    for(;;)
+    {
+        jobIndex = jobs.ConstructObject(jobName, color, this, jobFunction,
+            numDependencies);
+        if(jobIndex != FixedSizeFreeList<Job>::cInvalidObjectIndex)
+        {
+            break;
+        }
+
+        LOG_WARNING(Physics, "No physics jobs available. Consider raising "
+            "maxPhysicsJobs.");
+        std::this_thread::sleep_for(freeJobWaitTime);
+    }
+
+    Job* job = &jobs.Get(jobIndex);
+
+    // Take a handle before queueing, as the job may complete right away
+    JobHandle jobHandle(job);
+
+    if(numDependencies == 0)
+    {
+        QueueJob(job);
+    }
+
+    return jobHandle;
+}
+
+WorkStealingJobSystem::Stats WorkStealingJobSystem::GetStats() const
+{
+    Stats stats;
+    for(int i = 0; i < workerCount; i++)
+    {
+        const Stats workerStats = GetWorkerStats(i);
+        stats.executedJobs += workerStats.executedJobs;
+        stats.stolenJobs += workerStats.stolenJobs;
+        stats.failedSteals += workerStats.failedSteals;
+        stats.idleSleeps += workerStats.idleSleeps;
+        stats.idleSleepMicroseconds += workerStats.idleSleepMicroseconds;
+    }
+
+    return stats;
+}
+
+WorkStealingJobSystem::Stats WorkStealingJobSystem::GetWorkerStats
+    (int workerIndex) const
+{
+    const Worker& worker = workers[workerIndex];
+
+    Stats stats;
+    stats.executedJobs = worker.executedJobs.load(std::memory_order_relaxed);
+    stats.stolenJobs = worker.stolenJobs.load(std::memory_order_relaxed);
+    stats.failedSteals = worker.failedSteals.load(std::memory_order_relaxed);
+    stats.idleSleeps = worker.idleSleeps.load(std::memory_order_relaxed);
+    stats.idleSleepMicroseconds =
+        worker.idleSleepMicroseconds.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void WorkStealingJobSystem::ResetStats()
+{
+    for(int i = 0; i < workerCount; i++)
+    {
+        Worker& worker = workers[i];
+        worker.executedJobs.store(0, std::memory_order_relaxed);
+        worker.stolenJobs.store(0, std::memory_order_relaxed);
+        worker.failedSteals.store(0, std::memory_order_relaxed);
+        worker.idleSleeps.store(0, std::memory_order_relaxed);
+        worker.idleSleepMicroseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string WorkStealingJobSystem::GetStatsReport() const
+{
+    const Stats stats = GetStats();
+
+    char report[256];
+    std::snprintf(report, sizeof(report), "Job system: %d workers, %llu jobs "
+        "executed, %llu stolen, %llu failed steals, %llu idle sleeps "
+        "(%.1f ms asleep).", workerCount,
+        static_cast<unsigned long long>(stats.executedJobs),
+        static_cast<unsigned long long>(stats.stolenJobs),
+        static_cast<unsigned long long>(stats.failedSteals),
+        static_cast<unsigned long long>(stats.idleSleeps),
+        static_cast<double>(stats.idleSleepMicroseconds) / 1000.0);
+
+    return report;
+}
+
+bool WorkStealingJobSystem::SetCurrentThreadAffinity(int cpuIndex)
+{
+#ifdef __linux__
+    if(cpuIndex < 0 || cpuIndex >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuIndex, &cpuSet);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)
+        == 0;
+#else
+    (void)cpuIndex;
+    return false;
+#endif
+}
+
+void WorkStealingJobSystem::QueueJob(Job* job)
+{
+    // Without workers, the jobs are run by the thread waiting on their
+    // barrier
+    if(workerCount == 0)
+    {
+        return;
+    }
+
+    PushJob(GetQueueingWorker(), job);
+    WakeUpWorkers(1);
+}
+
+void WorkStealingJobSystem::QueueJobs(Job** jobsToQueue, uint jobCount)
+{
+    if(workerCount == 0)
+    {
+        return;
+    }
+
+    // A worker keeps the jobs it queues, and an outside thread spreads them
+    // over the workers
+    for(uint i = 0; i < jobCount; i++)
+    {
+        PushJob(GetQueueingWorker(), jobsToQueue[i]);
+    }
+
+    WakeUpWorkers(jobCount);
+}
+
+void WorkStealingJobSystem::FreeJob(Job* job)
+{
+    jobs.DestructObject(job);
+}
+
+void WorkStealingJobSystem::RunWorker(int workerIndex, int workerCpu)
+{
+    currentThreadJobSystem = this;
+    currentThreadWorkerIndex = workerIndex;
+
+    char workerName[32];
+    std::snprintf(workerName, sizeof(workerName), "PhysicsWorker%d",
+        workerIndex);
+
+#ifdef __linux__
+    // Thread names are limited to 15 characters
+    pthread_setname_np(pthread_self(), 
+        std::string(workerName).substr(0, 15).c_str());
+#endif
+
+    if(workerCpu >= 0 && !SetCurrentThreadAffinity(workerCpu))
+    {
+        LOG_WARNING(Physics, "Could not pin %s to CPU %d.", workerName,
+            workerCpu);
+    }
+
+    JPH_PROFILE_THREAD_START(workerName);
+
+    Worker& worker = workers[workerIndex];
+    std::uint32_t idleSpins = 0;
+
+    while(!bShouldQuit.load(std::memory_order_acquire))
+    {
+        Job* job = PopNewestJob(worker);
+        if(!job)
+        {
+            job = StealJob(workerIndex);
+        }
+
+        if(job)
+        {
+            // A job a barrier already ran is only released
+            job->Execute();
+            job->Release();
+
+            worker.executedJobs.fetch_add(1, std::memory_order_relaxed);
+            idleSpins = 0;
+            continue;
+        }
+
+        // Spin for a while before sleeping, as the physics update queues its
+        // jobs in quick bursts
+        if(idleSpins < settings.idleSpinCount)
+        {
+            idleSpins++;
+            std::this_thread::yield();
+            continue;
+        }
+
+        SleepUntilJobsAreQueued(worker);
+        idleSpins = 0;
+    }
+
+    JPH_PROFILE_THREAD_END();
+}
+
+void WorkStealingJobSystem::PushJob(Worker& worker, Job* job)
+{
+    // The deque holds a reference to the job
+    job->AddRef();
+
+    {
+        std::lock_guard<std::mutex> dequeLock(worker.dequeMutex);
+
+        // The deque is as large as the job pool, so it never overflows
+        const std::uint32_t dequeMask =
+            static_cast<std::uint32_t>(worker.dequeJobs.size()) - 1;
+        worker.dequeJobs[worker.dequeTail & dequeMask] = job;
+        worker.dequeTail++;
+    }
+
+    queuedJobCount.fetch_add(1);
+}
+
+JobSystem::Job* WorkStealingJobSystem::PopNewestJob(Worker& worker)
+{
+    std::lock_guard<std::mutex> dequeLock(worker.dequeMutex);
+
+    if(worker.dequeHead == worker.dequeTail)
+    {
+        return nullptr;
+    }
+
+    const std::uint32_t dequeMask =
+        static_cast<std::uint32_t>(worker.dequeJobs.size()) - 1;
+    worker.dequeTail--;
+    queuedJobCount.fetch_sub(1);
+
+    return worker.dequeJobs[worker.dequeTail & dequeMask];
+}
+
+JobSystem::Job* WorkStealingJobSystem::PopOldestJob(Worker& worker)
+{
+    std::lock_guard<std::mutex> dequeLock(worker.dequeMutex);
+
+    if(worker.dequeHead == worker.dequeTail)
+    {
+        return nullptr;
+    }
+
+    const std::uint32_t dequeMask =
+        static_cast<std::uint32_t>(worker.dequeJobs.size()) - 1;
+    Job* job = worker.dequeJobs[worker.dequeHead & dequeMask];
+    worker.dequeHead++;
+    queuedJobCount.fetch_sub(1);
+
+    return job;
+}
+
+JobSystem::Job* WorkStealingJobSystem::StealJob(int thiefIndex)
+{
+    Worker& thief = workers[thiefIndex];
+
+    // Nothing to steal, so the deques are not locked in vain
+    if(queuedJobCount.load(std::memory_order_relaxed) <= 0)
+    {
+        return nullptr;
+    }
+
+    // Start on the next worker, so the thieves do not all go for the same
+    // victim
+    for(int i = 1; i < workerCount; i++)
+    {
+        Worker& victim = workers[(thiefIndex + i) % workerCount];
+        if(Job* job = PopOldestJob(victim))
+        {
+            thief.stolenJobs.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    thief.failedSteals.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+WorkStealingJobSystem::Worker& WorkStealingJobSystem::GetQueueingWorker()
+{
+    if(currentThreadJobSystem == this)
+    {
+        return workers[currentThreadWorkerIndex];
+    }
+
+    const std::uint32_t workerIndex = nextQueueingWorker.fetch_add(1,
+        std::memory_order_relaxed) % static_cast<std::uint32_t>(workerCount);
+    return workers[workerIndex];
+}
+
+void WorkStealingJobSystem::WakeUpWorkers(uint newJobCount)
+{
+    // The sleeping count is raised before a worker checks for jobs, and the
+    // job count is raised before this check, so either the worker sees the
+    // jobs or this sees the worker
+    if(sleepingWorkerCount.load() == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> sleepLock(sleepMutex);
+    if(newJobCount == 1)
+    {
+        sleepCondition.notify_one();
+    }
+    else
+    {
+        sleepCondition.notify_all();
+    }
+}
+
+void WorkStealingJobSystem::SleepUntilJobsAreQueued(Worker& worker)
+{
+    const auto sleepStartTime = std::chrono::steady_clock::now();
+
+    {
+        std::unique_lock<std::mutex> sleepLock(sleepMutex);
+        sleepingWorkerCount.fetch_add(1);
+
+        sleepCondition.wait(sleepLock, [this]()
+        {
+            return bShouldQuit.load() || queuedJobCount.load() > 0;
+        });
+
+        sleepingWorkerCount.fetch_sub(1);
+    }
+
+    const auto sleepEndTime = std::chrono::steady_clock::now();
+
+    worker.idleSleeps.fetch_add(1, std::memory_order_relaxed);
+    worker.idleSleepMicroseconds.fetch_add(static_cast<std::uint64_t>
+        (std::chrono::duration_cast<std::chrono::microseconds>
+        (sleepEndTime - sleepStartTime).count()), std::memory_order_relaxed);
+}
+
+int WorkStealingJobSystem::GetWorkerCpu(int workerIndex) const
+{
+    if(!settings.bPinWorkerThreads)
+    {
+        return -1;
+    }
+
+    const int cpuCount = static_cast<int>(std::thread::hardware_concurrency());
+    if(cpuCount <= 0)
+    {
+        return -1;
+    }
+
+    // Walk the CPUs from the first worker's, skipping the excluded one
+    // (unless it is the only one)
+    int cpuIndex = settings.firstWorkerCpu % cpuCount;
+    int workersOnPreviousCpus = 0;
+    for(;;)
+    {
+        if(cpuIndex != settings.excludedCpu || cpuCount == 1)
+        {
+            if(workersOnPreviousCpus == workerIndex)
+            {
+                return cpuIndex;
+            }
+
+            workersOnPreviousCpus++;
+        }
+
+        cpuIndex = (cpuIndex + 1) % cpuCount;
+    }
+}
@@ -0,0 +1,244 @@
+#ifndef WORKSTEALINGJOBSYSTEM_H
+#define WORKSTEALINGJOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+
+using namespace JPH;
+
+/**
+* The job system running the physics jobs. Each worker thread owns a deque of
+* jobs: it runs its own jobs newest first (the jobs a job queues are likely
+* to use the same data), and when its deque is empty it steals the oldest
+* jobs of the other workers. Jobs queued from outside the workers (e.g. by
+* the thread updating the physics system) are spread over the workers'
+* deques, so there is no single shared queue to contend on.
+*
+* An idle worker spins for a while before it sleeps, so the short gaps
+* between the physics update's jobs do not pay for a wake up. The workers
+* may be pinned to CPUs, skipping the CPU of the network thread (see
+* "SetCurrentThreadAffinity()"), and they count how long they idle and how
+* many jobs they steal (see "GetStats()").
+*/
+class WorkStealingJobSystem final : public JobSystemWithBarrier
+{
+public:
+    /** The job system's settings */
+    struct Settings
+    {
+        /** The max amount of jobs alive at once. Must be a power of 2 */
+        std::uint32_t maxJobs = cMaxPhysicsJobs;
+
+        /** The max amount of barriers */
+        std::uint32_t maxBarriers = cMaxPhysicsBarriers;
+
+        /** The number of worker threads (0 runs every job on the barriers) */
+        int workerThreadCount = 0;
+
+        /** If the worker threads are pinned to a CPU each */
+        bool bPinWorkerThreads = false;
+
+        /** The CPU the first worker is pinned to (the next ones follow) */
+        int firstWorkerCpu = 0;
+
+        /** The CPU no worker is pinned to (e.g. the network thread's), or -1 */
+        int excludedCpu = -1;
+
+        /** How many times an idle worker looks for jobs before it sleeps */
+        std::uint32_t idleSpinCount = 256;
+    };
+
+    /** The counters of the workers, since creation or the last reset */
+    struct Stats
+    {
+        /** The jobs taken from the deques */
+        std::uint64_t executedJobs = 0;
+
+        /** The jobs taken from other workers' deques */
+        std::uint64_t stolenJobs = 0;
+
+        /** The steal attempts that found every other deque empty */
+        std::uint64_t failedSteals = 0;
+
+        /** The times the workers went to sleep for lack of jobs */
+        std::uint64_t idleSleeps = 0;
+
+        /** The time the workers slept, in microseconds */
+        std::uint64_t idleSleepMicroseconds = 0;
+    };
+
+    /**
+    * Creates the job system and starts its worker threads.
+    *
+    * @param settings The job system's settings
+    */
+    explicit WorkStealingJobSystem(const Settings& settings);
+
+    /** Stops and joins the worker threads */
+    ~WorkStealingJobSystem() override;
+
+    int GetMaxConcurrency() const override;
+
+    JobHandle CreateJob(const char* jobName, ColorArg color,
+        const JobFunction& jobFunction, uint32 numDependencies = 0) override;
+
+    /** @return The number of worker threads */
+    int GetWorkerThreadCount() const { return workerCount; }
+
+    /** @return The counters of every worker, summed */
+    Stats GetStats() const;
+
+    /**
+    * @param workerIndex The worker's index
+    *
+    * @return The counters of a worker
+    */
+    Stats GetWorkerStats(int workerIndex) const;
+
+    /** Resets the counters of every worker */
+    void ResetStats();
+
+    /** @return A report (single line) with the workers' summed counters */
+    std::string GetStatsReport() const;
+
+    /**
+    * Pins the calling thread to a CPU. Only supported on Linux.
+    *
+    * @param cpuIndex The CPU to pin the thread to
+    *
+    * @return True if the thread was pinned
+    */
+    static bool SetCurrentThreadAffinity(int cpuIndex);
+
+protected:
+    void QueueJob(Job* job) override;
+    void QueueJobs(Job** jobs, uint jobCount) override;
+    void FreeJob(Job* job) override;
+
+private:
+    /**
+    * A worker thread and its deque. The deque is a ring buffer as large as
+    * the max amount of jobs, so it never fills up: the owner pushes and pops
+    * at the tail, and the thieves pop at the head.
+    */
+    struct alignas(64) Worker
+    {
+        /** Protects the deque */
+        std::mutex dequeMutex;
+
+        /** The deque's ring buffer */
+        std::vector<Job*> dequeJobs;
+
+        /** The deque's oldest job position (stolen first) */
+        std::uint32_t dequeHead = 0;
+
+        /** The deque's position past the newest job (run first) */
+        std::uint32_t dequeTail = 0;
+
+        /** The worker's counters (only written by the worker) */
+        std::atomic<std::uint64_t> executedJobs {0};
+        std::atomic<std::uint64_t> stolenJobs {0};
+        std::atomic<std::uint64_t> failedSteals {0};
+        std::atomic<std::uint64_t> idleSleeps {0};
+        std::atomic<std::uint64_t> idleSleepMicroseconds {0};
+
+        /** The worker's thread */
+        std::thread thread;
+    };
+
+    /**
+    * The worker thread's loop: runs its own jobs, steals the others' when it
+    * has none and sleeps when there is no job at all.
+    *
+    * @param workerIndex The worker's index
+    * @param workerCpu The CPU to pin the worker to, or -1
+    */
+    void RunWorker(int workerIndex, int workerCpu);
+
+    /**
+    * Pushes a job on a worker's deque. The job's reference is taken.
+    *
+    * @param worker The worker to push the job to
+    * @param job The job to push
+    */
+    void PushJob(Worker& worker, Job* job);
+
+    /** @return The newest job of a worker's deque, or null if it is empty */
+    Job* PopNewestJob(Worker& worker);
+
+    /** @return The oldest job of a worker's deque, or null if it is empty */
+    Job* PopOldestJob(Worker& worker);
+
+    /**
+    * Steals the oldest job of another worker.
+    *
+    * @param thiefIndex The index of the worker stealing
+    *
+    * @return The stolen job, or null if every other deque is empty
+    */
+    Job* StealJob(int thiefIndex);
+
+    /**
+    * @return The worker to queue a job on: the calling worker itself, or
+    * the next worker in turn for a thread outside the job system
+    */
+    Worker& GetQueueingWorker();
+
+    /**
+    * Wakes up sleeping workers for newly queued jobs.
+    *
+    * @param newJobCount The number of jobs queued
+    */
+    void WakeUpWorkers(uint newJobCount);
+
+    /**
+    * Sleeps until there are queued jobs or the job system quits.
+    *
+    * @param worker The sleeping worker
+    */
+    void SleepUntilJobsAreQueued(Worker& worker);
+
+    /** @return The CPU to pin a worker to, following the settings */
+    int GetWorkerCpu(int workerIndex) const;
+
+    /** The pool of jobs */
+    FixedSizeFreeList<Job> jobs;
+
+    /** The job system's settings */
+    Settings settings;
+
+    /** The number of worker threads */
+    int workerCount = 0;
+
+    /** The workers */
+    std::unique_ptr<Worker[]> workers;
+
+    /** The number of jobs on the deques */
+    std::atomic<std::int64_t> queuedJobCount {0};
+
+    /** The next worker to queue a job from outside the job system on */
+    std::atomic<std::uint32_t> nextQueueingWorker {0};
+
+    /** The number of sleeping workers */
+    std::atomic<int> sleepingWorkerCount {0};
+
+    /** The mutex and condition the workers sleep on */
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    /** Flag to stop the workers */
+    std::atomic<bool> bShouldQuit {false};
+};
+
+#endif
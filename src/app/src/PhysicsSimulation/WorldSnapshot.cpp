@@ -0,0 +1,316 @@
+#include "WorldSnapshot.h"
+#include "../Serialization/ByteBufferReader.h"
+#include "../Serialization/ByteBufferWriter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+    * Writes every byte of a buffer to a file.
+    *
+    * @return False if the write failed
+    */
+    bool WriteAll(int fileDescriptor, std::string_view data)
+    {
+        size_t writtenBytes = 0;
+        while(writtenBytes < data.size())
+        {
+            const ssize_t writeReturnValue = write(fileDescriptor,
+                data.data() + writtenBytes, data.size() - writtenBytes);
+            if(writeReturnValue == -1)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            writtenBytes += static_cast<size_t>(writeReturnValue);
+        }
+
+        return true;
+    }
+
+    /** @return The error of the last failed system call on a file */
+    std::string GetFileError(const char* operation, const std::string& path)
+    {
+        return std::string(operation) + " " + path + " failed with error: "
+            + strerror(errno);
+    }
+}
+
+void WorldSnapshotStateRecorder::WriteBytes(const void* inData,
+    size_t inNumBytes)
+{
+    recordedData.append(static_cast<const char*>(inData), inNumBytes);
+}
+
+void WorldSnapshotStateRecorder::ReadBytes(void* outData, size_t inNumBytes)
+{
+    if(bIsFailed || inNumBytes > dataToRead.size() - readPosition)
+    {
+        // Jolt checks the failure after restoring, so the values read past
+        // the end are only zeroed
+        bIsFailed = true;
+        std::memset(outData, 0, inNumBytes);
+        return;
+    }
+
+    std::memcpy(outData, dataToRead.data() + readPosition, inNumBytes);
+    readPosition += inNumBytes;
+}
+
+WorldSnapshotFile::~WorldSnapshotFile()
+{
+    Close();
+}
+
+size_t WorldSnapshotFile::Write(const std::string& snapshotPath,
+    const WorldSnapshotHeader& header,
+    const std::vector<WorldSnapshotBody>& bodies,
+    std::string_view physicsState, std::string& outError)
+{
+    // The header and the bodies are encoded first, and the physics state is
+    // written straight from the recorder's buffer
+    std::string headerAndBodies;
+    headerAndBodies.reserve(headerSize + bodies.size() * bodyRecordSize);
+
+    headerAndBodies += fileMagic;
+    ByteBufferWriter::AppendUInt32(headerAndBodies, fileVersion);
+    ByteBufferWriter::AppendUInt32(headerAndBodies, header.stepNumber);
+    ByteBufferWriter::AppendUInt32(headerAndBodies, header.maxBodies);
+    ByteBufferWriter::AppendUInt32(headerAndBodies,
+        static_cast<std::uint32_t>(bodies.size()));
+    ByteBufferWriter::AppendUInt32(headerAndBodies, 0);
+    ByteBufferWriter::AppendUInt64(headerAndBodies, physicsState.size());
+
+    for(const WorldSnapshotBody& body : bodies)
+    {
+        ByteBufferWriter::AppendUInt32(headerAndBodies,
+            body.bodyId.GetIndexAndSequenceNumber());
+        ByteBufferWriter::AppendUInt8(headerAndBodies,
+            static_cast<std::uint8_t>(body.shapeType));
+        ByteBufferWriter::AppendUInt8(headerAndBodies,
+            static_cast<std::uint8_t>(body.bodyType));
+        ByteBufferWriter::AppendUInt8(headerAndBodies, 0);
+        ByteBufferWriter::AppendUInt8(headerAndBodies, 0);
+        ByteBufferWriter::AppendUInt32(headerAndBodies, body.ownerRegion);
+        ByteBufferWriter::AppendFloat(headerAndBodies, body.positionX);
+        ByteBufferWriter::AppendFloat(headerAndBodies, body.positionY);
+        ByteBufferWriter::AppendFloat(headerAndBodies, body.positionZ);
+    }
+
+    // Write a temporary file and rename it over the snapshot once it is on
+    // disk, so the previous snapshot survives a crash while saving
+    const std::string temporaryPath = snapshotPath + ".tmp";
+
+    const int fileDescriptor = open(temporaryPath.c_str(),
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fileDescriptor == -1)
+    {
+        outError = GetFileError("open", temporaryPath);
+        return 0;
+    }
+
+    if(!WriteAll(fileDescriptor, headerAndBodies)
+        || !WriteAll(fileDescriptor, physicsState))
+    {
+        outError = GetFileError("write", temporaryPath);
+        close(fileDescriptor);
+        unlink(temporaryPath.c_str());
+        return 0;
+    }
+
+    if(fsync(fileDescriptor) == -1)
+    {
+        outError = GetFileError("fsync", temporaryPath);
+        close(fileDescriptor);
+        unlink(temporaryPath.c_str());
+        return 0;
+    }
+
+    close(fileDescriptor);
+
+    if(rename(temporaryPath.c_str(), snapshotPath.c_str()) == -1)
+    {
+        outError = GetFileError("rename", temporaryPath);
+        unlink(temporaryPath.c_str());
+        return 0;
+    }
+
+    return headerAndBodies.size() + physicsState.size();
+}
+
+bool WorldSnapshotFile::Open(const std::string& snapshotPath,
+    std::string& outError)
+{
+    Close();
+
+    const int fileDescriptor = open(snapshotPath.c_str(),
+        O_RDONLY | O_CLOEXEC);
+    if(fileDescriptor == -1)
+    {
+        outError = GetFileError("open", snapshotPath);
+        return false;
+    }
+
+    struct stat fileStat {};
+    if(fstat(fileDescriptor, &fileStat) == -1)
+    {
+        outError = GetFileError("fstat", snapshotPath);
+        close(fileDescriptor);
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+    if(fileSize < headerSize)
+    {
+        outError = snapshotPath + " is too small to be a snapshot";
+        close(fileDescriptor);
+        return false;
+    }
+
+    // The whole file is read once, from the start, so its pages are faulted
+    // in up front instead of one by one while it is decoded
+    int mapFlags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    mapFlags |= MAP_POPULATE;
+#endif
+
+    void* newMappedData = mmap(nullptr, fileSize, PROT_READ, mapFlags,
+        fileDescriptor, 0);
+
+    // The mapping keeps its own reference to the file
+    close(fileDescriptor);
+
+    if(newMappedData == MAP_FAILED)
+    {
+        outError = GetFileError("mmap", snapshotPath);
+        return false;
+    }
+
+    mappedData = newMappedData;
+    mappedSize = fileSize;
+    madvise(mappedData, mappedSize, MADV_SEQUENTIAL);
+
+    const char* fileData = static_cast<const char*>(mappedData);
+    if(std::string_view(fileData, fileMagic.size()) != fileMagic)
+    {
+        outError = snapshotPath + " is not a snapshot";
+        Close();
+        return false;
+    }
+
+    std::uint32_t version = 0;
+    std::uint32_t reserved = 0;
+    const char* headerField = fileData + fileMagic.size();
+    headerField = ByteBufferReader::ReadUInt32(headerField, version);
+    headerField = ByteBufferReader::ReadUInt32(headerField,
+        header.stepNumber);
+    headerField = ByteBufferReader::ReadUInt32(headerField, header.maxBodies);
+    headerField = ByteBufferReader::ReadUInt32(headerField, header.bodyCount);
+    headerField = ByteBufferReader::ReadUInt32(headerField, reserved);
+    ByteBufferReader::ReadUInt64(headerField, header.physicsStateSize);
+
+    if(version != fileVersion)
+    {
+        outError = snapshotPath + " has the snapshot version "
+            + std::to_string(version) + ", expected "
+            + std::to_string(fileVersion);
+        Close();
+        return false;
+    }
+
+    // Check the size before any body is decoded, so a truncated file is
+    // refused as a whole
+    const std::uint64_t bodiesSize =
+        static_cast<std::uint64_t>(header.bodyCount) * bodyRecordSize;
+    if(header.physicsStateSize > mappedSize
+        || headerSize + bodiesSize + header.physicsStateSize != mappedSize)
+    {
+        outError = snapshotPath + " has " + std::to_string(mappedSize)
+            + " bytes, which does not match its header";
+        Close();
+        return false;
+    }
+
+    physicsState = std::string_view(fileData + headerSize + bodiesSize,
+        static_cast<size_t>(header.physicsStateSize));
+
+    return true;
+}
+
+void WorldSnapshotFile::Close()
+{
+    if(mappedData)
+    {
+        munmap(mappedData, mappedSize);
+    }
+
+    mappedData = nullptr;
+    mappedSize = 0;
+    header = WorldSnapshotHeader();
+    physicsState = std::string_view();
+}
+
+void WorldSnapshotFile::GetBody(std::uint32_t bodyIndex,
+    WorldSnapshotBody& outBody) const
+{
+    const char* bodyRecord = static_cast<const char*>(mappedData)
+        + headerSize + static_cast<size_t>(bodyIndex) * bodyRecordSize;
+
+    std::uint32_t bodyIdValue = 0;
+    std::uint8_t shapeType = 0;
+    std::uint8_t bodyType = 0;
+    bodyRecord = ByteBufferReader::ReadUInt32(bodyRecord, bodyIdValue);
+    bodyRecord = ByteBufferReader::ReadUInt8(bodyRecord, shapeType);
+    bodyRecord = ByteBufferReader::ReadUInt8(bodyRecord, bodyType);
+    bodyRecord += 2;
+    bodyRecord = ByteBufferReader::ReadUInt32(bodyRecord,
+        outBody.ownerRegion);
+    bodyRecord = ByteBufferReader::ReadFloat(bodyRecord, outBody.positionX);
+    bodyRecord = ByteBufferReader::ReadFloat(bodyRecord, outBody.positionY);
+    ByteBufferReader::ReadFloat(bodyRecord, outBody.positionZ);
+
+    outBody.bodyId = BodyID(bodyIdValue);
+    outBody.shapeType = shapeType == static_cast<std::uint8_t>
+        (EBodyShapeType::Floor) ? EBodyShapeType::Floor
+        : EBodyShapeType::Sphere;
+    outBody.bodyType = bodyType == EBodyType::Clone ? EBodyType::Clone
+        : EBodyType::Primary;
+}
+
+bool WorldSnapshotFile::IsValidName(std::string_view snapshotName)
+{
+    if(snapshotName.empty() || snapshotName.size() > 255
+        || snapshotName[0] == '.')
+    {
+        return false;
+    }
+
+    for(const char nameCharacter : snapshotName)
+    {
+        const bool bIsValidCharacter =
+            (nameCharacter >= 'a' && nameCharacter <= 'z')
+            || (nameCharacter >= 'A' && nameCharacter <= 'Z')
+            || (nameCharacter >= '0' && nameCharacter <= '9')
+            || nameCharacter == '.' || nameCharacter == '_'
+            || nameCharacter == '-';
+        if(!bIsValidCharacter)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
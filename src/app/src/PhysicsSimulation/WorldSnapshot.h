@@ -0,0 +1,238 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/StateRecorder.h>
+
+#include "BodyCreationInfo.h"
+
+using namespace JPH;
+
+/** The world-wide values of a world snapshot */
+struct WorldSnapshotHeader
+{
+    /** The step physics counter when the snapshot was taken */
+    std::uint32_t stepNumber = 0;
+
+    /** The max bodies of the physics system the snapshot was taken from */
+    std::uint32_t maxBodies = 0;
+
+    /** The number of bodies on the snapshot */
+    std::uint32_t bodyCount = 0;
+
+    /** The size in bytes of the physics state (see "GetPhysicsState()") */
+    std::uint64_t physicsStateSize = 0;
+};
+
+/**
+* A body on a world snapshot: what is needed to create it again on the same
+* place, with the service's data about it. Everything else (rotation,
+* velocities, sleep state...) is on the snapshot's physics state.
+*/
+struct WorldSnapshotBody
+{
+    /** The body's ID, with its sequence number */
+    BodyID bodyId;
+
+    /** The body's shape, which also gives its motion type and layer */
+    EBodyShapeType shapeType = EBodyShapeType::Sphere;
+
+    /** The body's type (meaningful for the bodies tracked by the service) */
+    EBodyType bodyType = EBodyType::Primary;
+
+    /** The region that owns the body */
+    std::uint32_t ownerRegion = 0;
+
+    /** The body's position */
+    float positionX = 0.f;
+    float positionY = 0.f;
+    float positionZ = 0.f;
+};
+
+/**
+* A Jolt state recorder over a byte buffer. When recording, the state is
+* appended to its own buffer. When restoring, the state is read in place
+* from the given bytes (e.g. a memory-mapped snapshot file), so it is never
+* copied.
+*/
+class WorldSnapshotStateRecorder final : public StateRecorder
+{
+public:
+    /** Creates a recorder that records into its own buffer */
+    WorldSnapshotStateRecorder() = default;
+
+    /**
+    * Creates a recorder that restores from the given bytes.
+    *
+    * @param newDataToRead The recorded state. Must outlive the recorder
+    */
+    explicit WorldSnapshotStateRecorder(std::string_view newDataToRead)
+        : dataToRead(newDataToRead)
+    {
+    }
+
+    void WriteBytes(const void* inData, size_t inNumBytes) override;
+
+    void ReadBytes(void* outData, size_t inNumBytes) override;
+
+    bool IsEOF() const override
+    {
+        return readPosition >= dataToRead.size();
+    }
+
+    bool IsFailed() const override { return bIsFailed; }
+
+    /** @return The recorded state */
+    const std::string& GetRecordedData() const { return recordedData; }
+
+    /** Clears the recorded state, keeping its buffer's capacity */
+    void ClearRecordedData() { recordedData.clear(); }
+
+private:
+    /** The recorded state, when recording */
+    std::string recordedData;
+
+    /** The state to restore from, when restoring */
+    std::string_view dataToRead;
+
+    /** The position of the next byte to read on "dataToRead" */
+    size_t readPosition = 0;
+
+    /** Flags if more bytes were read than there were to restore */
+    bool bIsFailed = false;
+};
+
+/**
+* A world snapshot file. It has the following little-endian layout:
+*
+* char magic[4] ("JPSS")
+* uint32 version
+* uint32 stepNumber
+* uint32 maxBodies
+* uint32 bodyCount
+* uint32 reserved (0)
+* uint64 physicsStateSize
+* bodyCount * {
+*     uint32 bodyId (index and sequence number)
+*     uint8 shapeType (0: sphere, 1: floor)
+*     uint8 bodyType (0: primary, 1: clone)
+*     uint16 reserved (0)
+*     uint32 ownerRegion
+*     float posX, posY, posZ
+* }
+* physicsStateSize bytes of physics state
+*
+* The tracked bodies go first, on the body registry's order. The physics
+* state is the one saved by "PhysicsSystem::SaveState()", so it is only
+* valid for the same Jolt build (version and precision) that saved it.
+*
+* The file is written to a temporary file first and renamed over the
+* snapshot, so a crash while saving never leaves a partial snapshot behind.
+* It is read through a read-only memory mapping, and the bodies and the
+* physics state are decoded in place.
+*/
+class WorldSnapshotFile final
+{
+public:
+    WorldSnapshotFile() = default;
+    ~WorldSnapshotFile();
+
+    WorldSnapshotFile(const WorldSnapshotFile&) = delete;
+    WorldSnapshotFile& operator=(const WorldSnapshotFile&) = delete;
+
+    /**
+    * Writes a snapshot file.
+    *
+    * @param snapshotPath The snapshot file's path
+    * @param header The snapshot's header. Its body count and physics state
+    * size are taken from the given bodies and physics state
+    * @param bodies The snapshot's bodies
+    * @param physicsState The physics state, saved through a
+    * "WorldSnapshotStateRecorder"
+    * @param outError The error, if the file could not be written
+    *
+    * @return The size in bytes of the written file, or 0 on error
+    */
+    static size_t Write(const std::string& snapshotPath,
+        const WorldSnapshotHeader& header,
+        const std::vector<WorldSnapshotBody>& bodies,
+        std::string_view physicsState, std::string& outError);
+
+    /**
+    * Maps a snapshot file and checks its header and size.
+    *
+    * @param snapshotPath The snapshot file's path
+    * @param outError The error, if the file could not be mapped or is not a
+    * snapshot of this version
+    *
+    * @return True if opened
+    */
+    bool Open(const std::string& snapshotPath, std::string& outError);
+
+    /** Unmaps the snapshot file, if open */
+    void Close();
+
+    /** @return The open snapshot's header */
+    const WorldSnapshotHeader& GetHeader() const { return header; }
+
+    /**
+    * Decodes a body of the open snapshot.
+    *
+    * @param bodyIndex The body's position on the snapshot, below the
+    * header's body count
+    * @param outBody The decoded body
+    */
+    void GetBody(std::uint32_t bodyIndex, WorldSnapshotBody& outBody) const;
+
+    /**
+    * @return The open snapshot's physics state, a view on the mapped file
+    * valid until it is closed
+    */
+    std::string_view GetPhysicsState() const { return physicsState; }
+
+    /** @return The size in bytes of the open snapshot file */
+    size_t GetFileSize() const { return mappedSize; }
+
+    /**
+    * Checks if a snapshot name is valid. Snapshots are files on the
+    * service's snapshot directory, so their names may only have letters,
+    * digits, '.', '_' and '-', and can't start with '.'.
+    *
+    * @param snapshotName The snapshot's name
+    *
+    * @return True if the name is valid
+    */
+    static bool IsValidName(std::string_view snapshotName);
+
+    /** The first bytes of every snapshot file */
+    static constexpr std::string_view fileMagic = "JPSS";
+
+    /** The version of the snapshot file's layout */
+    static constexpr std::uint32_t fileVersion = 1;
+
+    /** The size in bytes of the snapshot file's header */
+    static constexpr size_t headerSize = 32;
+
+    /** The size in bytes of a body on the snapshot file */
+    static constexpr size_t bodyRecordSize = 24;
+
+private:
+    /** The mapped snapshot file, or null */
+    void* mappedData = nullptr;
+
+    /** The size in bytes of the mapped snapshot file */
+    size_t mappedSize = 0;
+
+    /** The open snapshot's header */
+    WorldSnapshotHeader header;
+
+    /** The open snapshot's physics state, on the mapped file */
+    std::string_view physicsState;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "Base64.h"
+
+#include <cstdint>
+
+namespace
+{
+    /** The character of each 6 bit value */
+    constexpr char encodingTable[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    /** The value of the characters that are not on the base64 alphabet */
+    constexpr std::uint8_t invalidCharacterValue = 0xFF;
+
+    /** @return The 6 bit value of a character, or "invalidCharacterValue" */
+    std::uint8_t GetCharacterValue(char character)
+    {
+        if(character >= 'A' && character <= 'Z')
+        {
+            return static_cast<std::uint8_t>(character - 'A');
+        }
+        if(character >= 'a' && character <= 'z')
+        {
+            return static_cast<std::uint8_t>(character - 'a' + 26);
+        }
+        if(character >= '0' && character <= '9')
+        {
+            return static_cast<std::uint8_t>(character - '0' + 52);
+        }
+        if(character == '+')
+        {
+            return 62;
+        }
+        if(character == '/')
+        {
+            return 63;
+        }
+
+        return invalidCharacterValue;
+    }
+}
+
+void Base64::Append(std::string& buffer, std::string_view data)
+{
+    buffer.reserve(buffer.size() + (data.size() + 2) / 3 * 4);
+
+    const unsigned char* dataBytes =
+        reinterpret_cast<const unsigned char*>(data.data());
+
+    size_t i = 0;
+    for(; i + 3 <= data.size(); i += 3)
+    {
+        const std::uint32_t group = (static_cast<std::uint32_t>
+            (dataBytes[i]) << 16) | (static_cast<std::uint32_t>
+            (dataBytes[i + 1]) << 8) | dataBytes[i + 2];
+
+        buffer += encodingTable[(group >> 18) & 0x3F];
+        buffer += encodingTable[(group >> 12) & 0x3F];
+        buffer += encodingTable[(group >> 6) & 0x3F];
+        buffer += encodingTable[group & 0x3F];
+    }
+
+    // The last 1 or 2 bytes are padded with '='
+    const size_t remainingBytes = data.size() - i;
+    if(remainingBytes > 0)
+    {
+        std::uint32_t group = static_cast<std::uint32_t>(dataBytes[i]) << 16;
+        if(remainingBytes == 2)
+        {
+            group |= static_cast<std::uint32_t>(dataBytes[i + 1]) << 8;
+        }
+
+        buffer += encodingTable[(group >> 18) & 0x3F];
+        buffer += encodingTable[(group >> 12) & 0x3F];
+        buffer += remainingBytes == 2 ? encodingTable[(group >> 6) & 0x3F]
+            : '=';
+        buffer += '=';
+    }
+}
+
+bool Base64::Decode(std::string_view text, std::string& outData)
+{
+    outData.clear();
+    outData.reserve(text.size() / 4 * 3);
+
+    std::uint32_t group = 0;
+    size_t groupCharacterCount = 0;
+    size_t paddingCount = 0;
+
+    for(const char character : text)
+    {
+        if(character == ' ' || character == '\t' || character == '\r'
+            || character == '\n')
+        {
+            continue;
+        }
+
+        if(character == '=')
+        {
+            // Padding only completes the last group
+            if(groupCharacterCount < 2)
+            {
+                return false;
+            }
+
+            paddingCount++;
+            group <<= 6;
+        }
+        else
+        {
+            const std::uint8_t characterValue = GetCharacterValue(character);
+            if(characterValue == invalidCharacterValue || paddingCount > 0)
+            {
+                return false;
+            }
+
+            group = (group << 6) | characterValue;
+        }
+
+        groupCharacterCount++;
+        if(groupCharacterCount < 4)
+        {
+            continue;
+        }
+
+        outData += static_cast<char>((group >> 16) & 0xFF);
+        if(paddingCount < 2)
+        {
+            outData += static_cast<char>((group >> 8) & 0xFF);
+        }
+        if(paddingCount < 1)
+        {
+            outData += static_cast<char>(group & 0xFF);
+        }
+
+        group = 0;
+        groupCharacterCount = 0;
+
+        // Nothing may follow a padded group
+        if(paddingCount > 0)
+        {
+            paddingCount = 3;
+        }
+    }
+
+    return groupCharacterCount == 0;
+}
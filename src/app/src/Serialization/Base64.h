@@ -0,0 +1,32 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <string>
+#include <string_view>
+
+/**
+* Base64 (RFC 4648, with padding) encoding of binary data, so it can be sent
+* as text on the delimited messages, which can't carry arbitrary bytes.
+*/
+namespace Base64
+{
+    /**
+    * Appends the base64 text of some data to the given buffer.
+    *
+    * @param buffer The buffer to append the text to
+    * @param data The data to encode
+    */
+    void Append(std::string& buffer, std::string_view data);
+
+    /**
+    * Decodes a base64 text. Whitespace (e.g. line breaks) is skipped.
+    *
+    * @param text The text to decode
+    * @param outData The decoded data
+    *
+    * @return True if the text is valid base64 and false otherwise
+    */
+    bool Decode(std::string_view text, std::string& outData);
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef BITWRITER_H
+#define BITWRITER_H
+
+#include <cstdint>
+#include <string>
+
+/**
+* Appends values of any bit width (up to 32 bits) to a byte buffer, as a
+* continuous little-endian bit stream: each value's bits go from its least
+* significant one, and the first bits of the stream are the least
+* significant bits of its first byte. The bytes are appended to the buffer
+* as soon as they are complete.
+*/
+class BitWriter final
+{
+public:
+    /**
+    * Creates a bit writer appending to the given buffer.
+    *
+    * @param newBuffer The buffer to append to. Must outlive the writer
+    */
+    explicit BitWriter(std::string& newBuffer)
+        : buffer(newBuffer)
+    {
+    }
+
+    /**
+    * Writes the lowest bits of an unsigned value.
+    *
+    * @param value The value to write. Its bits above the bit count are
+    * ignored
+    * @param bitCount The number of bits to write, up to 32
+    */
+    void WriteBits(std::uint32_t value, std::uint32_t bitCount)
+    {
+        const std::uint64_t valueMask = (std::uint64_t(1) << bitCount) - 1;
+        pendingBits |= (value & valueMask) << pendingBitCount;
+        pendingBitCount += bitCount;
+
+        while(pendingBitCount >= 8)
+        {
+            buffer += static_cast<char>(pendingBits & 0xFF);
+            pendingBits >>= 8;
+            pendingBitCount -= 8;
+        }
+    }
+
+    /**
+    * Writes a signed value as a two's complement value of the given width.
+    * The value must fit on the bit count.
+    *
+    * @param value The value to write
+    * @param bitCount The number of bits to write, up to 32
+    */
+    void WriteSignedBits(std::int32_t value, std::uint32_t bitCount)
+    {
+        WriteBits(static_cast<std::uint32_t>(value), bitCount);
+    }
+
+    /** Appends the pending bits (if any) as a last byte padded with 0s */
+    void Flush()
+    {
+        if(pendingBitCount > 0)
+        {
+            buffer += static_cast<char>(pendingBits & 0xFF);
+        }
+
+        pendingBits = 0;
+        pendingBitCount = 0;
+    }
+
+private:
+    /** The buffer the complete bytes are appended to */
+    std::string& buffer;
+
+    /** The bits written but not appended yet, from the lowest bit */
+    std::uint64_t pendingBits = 0;
+
+    /** The number of bits on "pendingBits", always below 8 between writes */
+    std::uint32_t pendingBitCount = 0;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef BYTEBUFFERREADER_H
+#define BYTEBUFFERREADER_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+* Helpers to read the little-endian primitives written by "ByteBufferWriter"
+* from a byte buffer. Values are read byte by byte, so they do not depend on
+* the host's endianness nor on the source's alignment.
+*
+* The "Read" functions read from a source with enough bytes left (the caller
+* checks the buffer's size first) and return the position right after the
+* read value.
+*/
+namespace ByteBufferReader
+{
+    /** Reads a uint8 at the given source */
+    inline const char* ReadUInt8(const char* source, std::uint8_t& outValue)
+    {
+        outValue = static_cast<std::uint8_t>(source[0]);
+        return source + 1;
+    }
+
+    /** Reads a little-endian uint32 at the given source */
+    inline const char* ReadUInt32(const char* source, std::uint32_t& outValue)
+    {
+        const unsigned char* sourceBytes =
+            reinterpret_cast<const unsigned char*>(source);
+        outValue = static_cast<std::uint32_t>(sourceBytes[0])
+            | (static_cast<std::uint32_t>(sourceBytes[1]) << 8)
+            | (static_cast<std::uint32_t>(sourceBytes[2]) << 16)
+            | (static_cast<std::uint32_t>(sourceBytes[3]) << 24);
+        return source + 4;
+    }
+
+    /** Reads a little-endian uint64 at the given source */
+    inline const char* ReadUInt64(const char* source, std::uint64_t& outValue)
+    {
+        std::uint32_t lowBits = 0;
+        std::uint32_t highBits = 0;
+        source = ReadUInt32(source, lowBits);
+        source = ReadUInt32(source, highBits);
+        outValue = static_cast<std::uint64_t>(lowBits)
+            | (static_cast<std::uint64_t>(highBits) << 32);
+        return source;
+    }
+
+    /** Reads a little-endian IEEE-754 float at the given source */
+    inline const char* ReadFloat(const char* source, float& outValue)
+    {
+        std::uint32_t valueBits = 0;
+        source = ReadUInt32(source, valueBits);
+        std::memcpy(&outValue, &valueBits, sizeof(outValue));
+        return source;
+    }
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef BYTEBUFFERWRITER_H
+#define BYTEBUFFERWRITER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+* Helpers to write little-endian primitives into a byte buffer. The buffers
+* are plain std::string objects, so they can be handed to the socket server as
+* any other handler response. Values are written byte by byte, so the wire
+* format does not depend on the host's endianness.
+*
+* The "Write" functions write into an already sized buffer and return the
+* position right after the written value. The "Append" functions grow the
+* given buffer.
+*/
+namespace ByteBufferWriter
+{
+    /** Writes a uint8 at the given destination */
+    inline char* WriteUInt8(char* destination, std::uint8_t value)
+    {
+        destination[0] = static_cast<char>(value);
+        return destination + 1;
+    }
+
+    /** Writes a little-endian uint32 at the given destination */
+    inline char* WriteUInt32(char* destination, std::uint32_t value)
+    {
+        destination[0] = static_cast<char>(value & 0xFF);
+        destination[1] = static_cast<char>((value >> 8) & 0xFF);
+        destination[2] = static_cast<char>((value >> 16) & 0xFF);
+        destination[3] = static_cast<char>((value >> 24) & 0xFF);
+        return destination + 4;
+    }
+
+    /** Writes a little-endian IEEE-754 float at the given destination */
+    inline char* WriteFloat(char* destination, float value)
+    {
+        std::uint32_t valueBits = 0;
+        std::memcpy(&valueBits, &value, sizeof(valueBits));
+        return WriteUInt32(destination, valueBits);
+    }
+
+    /** Appends a uint8 to the end of the given buffer */
+    inline void AppendUInt8(std::string& buffer, std::uint8_t value)
+    {
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    /** Appends a little-endian uint32 to the end of the given buffer */
+    inline void AppendUInt32(std::string& buffer, std::uint32_t value)
+    {
+        char valueBytes[4];
+        WriteUInt32(valueBytes, value);
+        buffer.append(valueBytes, sizeof(valueBytes));
+    }
+
+    /** Appends a little-endian uint64 to the end of the given buffer */
+    inline void AppendUInt64(std::string& buffer, std::uint64_t value)
+    {
+        AppendUInt32(buffer, static_cast<std::uint32_t>(value));
+        AppendUInt32(buffer, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    /** Appends a little-endian float to the end of the given buffer */
+    inline void AppendFloat(std::string& buffer, float value)
+    {
+        char valueBytes[4];
+        WriteFloat(valueBytes, value);
+        buffer.append(valueBytes, sizeof(valueBytes));
+    }
+}
+
+#endif
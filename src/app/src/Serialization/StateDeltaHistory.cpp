@@ -0,0 +1,315 @@
+#include "StateDeltaHistory.h"
+#include "BitWriter.h"
+#include "ByteBufferWriter.h"
+
+#include <algorithm>
+
+namespace
+{
+    /** The fields of a quantized body state, one per change mask bit */
+    constexpr std::uint32_t deltaFieldCount = 14;
+
+    /** The fields sent as is when they change, instead of as a difference */
+    constexpr std::uint32_t bodyTypeField = 0;
+    constexpr std::uint32_t rotationLargestComponentField = 4;
+
+    /** The widths of the size classes below the field's own width */
+    constexpr std::uint32_t deltaSizeClassBits[3] = { 4, 8, 16 };
+
+    /** Gets a state's fields, on the change mask's order */
+    void GetFieldValues(const QuantizedBodyState& state,
+        std::int32_t (&outValues)[deltaFieldCount])
+    {
+        outValues[0] = static_cast<std::int32_t>(state.bodyType);
+        outValues[4] = static_cast<std::int32_t>
+            (state.rotationLargestComponent);
+
+        for(size_t i = 0; i < 3; i++)
+        {
+            outValues[1 + i] = state.position[i];
+            outValues[5 + i] = state.rotation[i];
+            outValues[8 + i] = state.linearVelocity[i];
+            outValues[11 + i] = state.angularVelocity[i];
+        }
+    }
+
+    /** Gets the bits of each field, on the change mask's order */
+    void GetFieldBits(const StateQuantizationSettings& settings,
+        std::uint32_t (&outBits)[deltaFieldCount])
+    {
+        outBits[0] = 1;
+        outBits[4] = 2;
+
+        for(size_t i = 0; i < 3; i++)
+        {
+            outBits[1 + i] = settings.positionBits;
+            outBits[5 + i] = settings.rotationBits;
+            outBits[8 + i] = settings.linearVelocityBits;
+            outBits[11 + i] = settings.angularVelocityBits;
+        }
+    }
+
+    /**
+    * @return The width of a size class for a field of the given bits. The
+    * difference of two such values always fits on one more bit, which is
+    * the last size class's width
+    */
+    std::uint32_t GetSizeClassBits(std::uint32_t sizeClass,
+        std::uint32_t fieldBits)
+    {
+        return sizeClass < 3
+            ? std::min(deltaSizeClassBits[sizeClass], fieldBits + 1)
+            : fieldBits + 1;
+    }
+
+    /** Writes a difference zigzag encoded, after its size class */
+    void WriteFieldDelta(BitWriter& bitWriter, std::int32_t delta,
+        std::uint32_t fieldBits)
+    {
+        const std::uint32_t zigzagDelta =
+            (static_cast<std::uint32_t>(delta) << 1)
+            ^ static_cast<std::uint32_t>(delta >> 31);
+
+        std::uint32_t sizeClass = 0;
+        while(sizeClass < 3
+            && zigzagDelta >> GetSizeClassBits(sizeClass, fieldBits) != 0)
+        {
+            sizeClass++;
+        }
+
+        bitWriter.WriteBits(sizeClass, 2);
+        bitWriter.WriteBits(zigzagDelta,
+            GetSizeClassBits(sizeClass, fieldBits));
+    }
+
+    /**
+    * Writes a delta body record (see "StateDeltaHistory"), unless the state
+    * is the same as the baseline one.
+    *
+    * @return True if the record was written
+    */
+    bool WriteDeltaBodyRecord(BitWriter& bitWriter,
+        const std::uint32_t (&fieldBits)[deltaFieldCount],
+        std::uint32_t bodyIdBits, const QuantizedBodyState& baselineState,
+        const QuantizedBodyState& state, bool bWriteIfUnchanged)
+    {
+        std::int32_t baselineValues[deltaFieldCount];
+        std::int32_t values[deltaFieldCount];
+        GetFieldValues(baselineState, baselineValues);
+        GetFieldValues(state, values);
+
+        std::uint32_t changeMask = 0;
+        for(std::uint32_t field = 0; field < deltaFieldCount; field++)
+        {
+            if(values[field] != baselineValues[field])
+            {
+                changeMask |= std::uint32_t(1) << field;
+            }
+        }
+
+        if(changeMask == 0 && !bWriteIfUnchanged)
+        {
+            return false;
+        }
+
+        bitWriter.WriteBits(state.bodyId, bodyIdBits);
+        bitWriter.WriteBits(changeMask, deltaFieldCount);
+
+        for(std::uint32_t field = 0; field < deltaFieldCount; field++)
+        {
+            if((changeMask & (std::uint32_t(1) << field)) == 0)
+            {
+                continue;
+            }
+
+            if(field == bodyTypeField
+                || field == rotationLargestComponentField)
+            {
+                bitWriter.WriteBits(static_cast<std::uint32_t>
+                    (values[field]), fieldBits[field]);
+                continue;
+            }
+
+            // The quantized values have at most 31 bits, so their
+            // difference always fits on 32 bits
+            const std::int32_t delta = static_cast<std::int32_t>
+                (static_cast<std::int64_t>(values[field])
+                - baselineValues[field]);
+            WriteFieldDelta(bitWriter, delta, fieldBits[field]);
+        }
+
+        return true;
+    }
+}
+
+bool StateDeltaHistory::AcknowledgeStep(std::uint32_t stepNumber)
+{
+    if(bHasAcknowledgedStep && stepNumber <= lastAcknowledgedStepNumber)
+    {
+        return false;
+    }
+
+    // Steps that were never sent (or are too old) can't be a baseline
+    if(!FindFrame(stepNumber))
+    {
+        return false;
+    }
+
+    bHasAcknowledgedStep = true;
+    lastAcknowledgedStepNumber = stepNumber;
+    return true;
+}
+
+void StateDeltaHistory::Reset()
+{
+    // The frames' arrays keep their capacity
+    for(StepFrame& frame : frames)
+    {
+        frame.bIsValid = false;
+    }
+
+    bHasWrittenSteps = false;
+    bHasAcknowledgedStep = false;
+}
+
+void StateDeltaHistory::WriteStepResponse
+    (const StateQuantizationSettings& settings, std::uint32_t bodyIdBits,
+    const BodyStateArrays& bodyStates, std::uint32_t stepNumber,
+    std::string& outStepResponse)
+{
+    // The step numbers identify the frames, so a step older than the last
+    // one would make them ambiguous. The records also depend on the body ID
+    // bits
+    if(bHasWrittenSteps && (stepNumber < lastWrittenStepNumber
+        || bodyIdBits != historyBodyIdBits))
+    {
+        Reset();
+    }
+
+    // The last step written again (e.g. a spectator polling before the world
+    // is stepped) re-sends its frame, which the client may already have
+    // acknowledged
+    const bool bIsResentStep = bHasWrittenSteps
+        && stepNumber == lastWrittenStepNumber;
+
+    // Find the baseline before the new frame may take its place. A frame
+    // can't be its own baseline, as that is how keyframes are told apart
+    const StepFrame* baselineFrame = nullptr;
+    if(bHasAcknowledgedStep && stepNumber != lastAcknowledgedStepNumber
+        && stepNumber - lastAcknowledgedStepNumber < historySize)
+    {
+        baselineFrame = FindFrame(lastAcknowledgedStepNumber);
+    }
+
+    // Quantize the step into its frame, sorted by body ID so it can be
+    // walked along the baseline
+    StepFrame& frame = frames[stepNumber % historySize];
+    if(!bIsResentStep)
+    {
+        frame.stepNumber = stepNumber;
+        frame.bIsValid = true;
+        frame.bodyStates.resize(bodyStates.size());
+        for(size_t i = 0; i < bodyStates.size(); i++)
+        {
+            StateQuantization::QuantizeBodyState(settings, bodyStates, i,
+                frame.bodyStates[i]);
+        }
+
+        std::sort(frame.bodyStates.begin(), frame.bodyStates.end(),
+            [](const QuantizedBodyState& a, const QuantizedBodyState& b)
+            { return a.bodyId < b.bodyId; });
+    }
+
+    bHasWrittenSteps = true;
+    lastWrittenStepNumber = stepNumber;
+    historyBodyIdBits = bodyIdBits;
+
+    // Write the header: step number, body count, body ID bits and baseline
+    // step number (the step number itself on a keyframe)
+    outStepResponse.clear();
+    ByteBufferWriter::AppendUInt32(outStepResponse, stepNumber);
+    ByteBufferWriter::AppendUInt32(outStepResponse,
+        static_cast<std::uint32_t>(frame.bodyStates.size()));
+    ByteBufferWriter::AppendUInt8(outStepResponse,
+        static_cast<std::uint8_t>(bodyIdBits));
+    ByteBufferWriter::AppendUInt32(outStepResponse,
+        baselineFrame ? baselineFrame->stepNumber : stepNumber);
+
+    if(!baselineFrame)
+    {
+        BitWriter recordBitWriter(outStepResponse);
+        for(const QuantizedBodyState& state : frame.bodyStates)
+        {
+            StateQuantization::WriteQuantizedBodyState(recordBitWriter,
+                settings, bodyIdBits, state);
+        }
+        recordBitWriter.Flush();
+
+        return;
+    }
+
+    // The counts are only known once the records are written, so their
+    // place is kept before them
+    const size_t countsPosition = outStepResponse.size();
+    outStepResponse.resize(countsPosition + 8);
+
+    std::uint32_t fieldBits[deltaFieldCount];
+    GetFieldBits(settings, fieldBits);
+
+    // The bodies that are not on the baseline are encoded against a state
+    // with every field at 0, and always written so the client adds them
+    const QuantizedBodyState zeroState;
+    const std::vector<QuantizedBodyState>& baselineStates =
+        baselineFrame->bodyStates;
+    size_t baselineIndex = 0;
+    std::uint32_t changedBodyCount = 0;
+    removedBodyIds.clear();
+
+    BitWriter recordBitWriter(outStepResponse);
+    for(const QuantizedBodyState& state : frame.bodyStates)
+    {
+        // Every baseline body before this one was removed
+        while(baselineIndex < baselineStates.size()
+            && baselineStates[baselineIndex].bodyId < state.bodyId)
+        {
+            removedBodyIds.push_back(baselineStates[baselineIndex].bodyId);
+            baselineIndex++;
+        }
+
+        const bool bIsOnBaseline = baselineIndex < baselineStates.size()
+            && baselineStates[baselineIndex].bodyId == state.bodyId;
+        const QuantizedBodyState& baselineState = bIsOnBaseline
+            ? baselineStates[baselineIndex++] : zeroState;
+
+        if(WriteDeltaBodyRecord(recordBitWriter, fieldBits, bodyIdBits,
+            baselineState, state, !bIsOnBaseline))
+        {
+            changedBodyCount++;
+        }
+    }
+
+    for(; baselineIndex < baselineStates.size(); baselineIndex++)
+    {
+        removedBodyIds.push_back(baselineStates[baselineIndex].bodyId);
+    }
+
+    for(const std::uint32_t removedBodyId : removedBodyIds)
+    {
+        recordBitWriter.WriteBits(removedBodyId, bodyIdBits);
+    }
+    recordBitWriter.Flush();
+
+    char* countsWritePosition = outStepResponse.data() + countsPosition;
+    countsWritePosition = ByteBufferWriter::WriteUInt32(countsWritePosition,
+        changedBodyCount);
+    ByteBufferWriter::WriteUInt32(countsWritePosition,
+        static_cast<std::uint32_t>(removedBodyIds.size()));
+}
+
+const StateDeltaHistory::StepFrame* StateDeltaHistory::FindFrame
+    (std::uint32_t stepNumber) const
+{
+    const StepFrame& frame = frames[stepNumber % historySize];
+    return frame.bIsValid && frame.stepNumber == stepNumber ? &frame
+        : nullptr;
+}
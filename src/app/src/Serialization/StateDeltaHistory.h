@@ -0,0 +1,139 @@
+#ifndef STATEDELTAHISTORY_H
+#define STATEDELTAHISTORY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StateQuantization.h"
+#include "../PhysicsSimulation/BodyStateArrays.h"
+
+/**
+* The quantized states sent to a client on its last step responses, used to
+* delta compress its next ones on the "delta" step response format. The
+* client acknowledges the step numbers it received, and each step response
+* only carries the changes since the last acknowledged step (the baseline).
+*
+* The response is little-endian, with the following layout:
+*
+* uint32 stepNumber
+* uint32 bodyCount
+* uint8 bodyIdBits
+* uint32 baselineStepNumber
+*
+* If the baseline step number is the step number, the response is a keyframe,
+* followed by the same bit packed records as the quantized format (see
+* "StepResponseWriter::AppendBodyRecordAsQuantized()"). Otherwise, it is
+* followed by:
+*
+* uint32 changedBodyCount
+* uint32 removedBodyCount
+* changedBodyCount * delta body record
+* removedBodyCount * bodyId (bodyIdBits bits)
+*
+* Where the records and IDs are bit packed and padded with 0 bits to a whole
+* byte. The bodies not on a delta response are the same as on the baseline.
+* A delta body record is:
+*
+* bodyId (bodyIdBits bits)
+* changeMask (14 bits)
+* A field per bit set on the change mask
+*
+* The change mask's bits are, from the lowest: bodyType, posX, posY, posZ,
+* rotationLargestComponent, the three rotation components, linearVelocityX,
+* Y and Z, and angularVelocityX, Y and Z. The body type and the largest
+* rotation component are sent as is (1 and 2 bits). Every other field is the
+* difference with its baseline value, zigzag encoded (0, -1, 1, -2, 2...)
+* with a 2 bits size class before it, giving its width: 4, 8, 16 bits or
+* the field's bits plus 1 (the first three are never wider than the last
+* one). A body that is not on the baseline is encoded against a state with
+* every field at 0.
+*
+* The deltas are computed on the quantized values, so they are exact: the
+* client gets the same values it would on the quantized format.
+*/
+class StateDeltaHistory final
+{
+public:
+    /**
+    * Acknowledges a step response received by the client, which becomes
+    * the baseline of the next responses. Only steps on the history and
+    * newer than the last acknowledged one are taken.
+    *
+    * @param stepNumber The step number of the received response
+    *
+    * @return True if the step is the new baseline
+    */
+    bool AcknowledgeStep(std::uint32_t stepNumber);
+
+    /** Forgets every step and acknowledgement, so the next is a keyframe */
+    void Reset();
+
+    /**
+    * Writes a step response delta compressed against the last acknowledged
+    * step, or a keyframe if there is none or if it is too old (not on the
+    * history anymore). The step's quantized states are kept on the history.
+    *
+    * @param settings The client's quantization settings. The history must
+    * be reset if they change
+    * @param bodyIdBits The bits of the body IDs on the current world
+    * @param bodyStates The body states to write the response from
+    * @param stepNumber The step number of the response. If it is the last
+    * step on the history, its kept states are sent again. If it is older
+    * (e.g. a snapshot was loaded), the history is reset
+    * @param outStepResponse The buffer to write the response into
+    */
+    void WriteStepResponse(const StateQuantizationSettings& settings,
+        std::uint32_t bodyIdBits, const BodyStateArrays& bodyStates,
+        std::uint32_t stepNumber, std::string& outStepResponse);
+
+    /**
+    * The steps kept on the history. A baseline this many steps older than
+    * the step being written is too old, and a keyframe is sent instead
+    */
+    static constexpr std::uint32_t historySize = 32;
+
+private:
+    /** The quantized states sent on a step response */
+    struct StepFrame
+    {
+        /** The step number of the response */
+        std::uint32_t stepNumber = 0;
+
+        /** Flag that indicates if the frame holds a sent step */
+        bool bIsValid = false;
+
+        /** The states of every body on the response, sorted by body ID */
+        std::vector<QuantizedBodyState> bodyStates;
+    };
+
+    /** @return The frame of the given step, or null if it is not kept */
+    const StepFrame* FindFrame(std::uint32_t stepNumber) const;
+
+    /**
+    * The sent steps, each on the "stepNumber % historySize" index. The
+    * frames' arrays are reused, so no allocation happens once they have
+    * grown to the world's size
+    */
+    StepFrame frames[historySize];
+
+    /** Flag that indicates if any step was written since the last reset */
+    bool bHasWrittenSteps = false;
+
+    /** The step number of the last written step */
+    std::uint32_t lastWrittenStepNumber = 0;
+
+    /** The body ID bits of the steps on the history */
+    std::uint32_t historyBodyIdBits = 0;
+
+    /** Flag that indicates if the client acknowledged any step */
+    bool bHasAcknowledgedStep = false;
+
+    /** The last step acknowledged by the client */
+    std::uint32_t lastAcknowledgedStepNumber = 0;
+
+    /** The bodies removed since the baseline (reused per step) */
+    std::vector<std::uint32_t> removedBodyIds;
+};
+
+#endif
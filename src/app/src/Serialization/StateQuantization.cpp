@@ -0,0 +1,361 @@
+#include "StateQuantization.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+namespace
+{
+    /** The largest rotation quaternion component besides the largest one */
+    constexpr double maxSmallestThreeComponent = 0.70710678118654752;
+
+    bool ParseQuantizationValue(std::string_view value,
+        std::uint32_t& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd;
+    }
+
+    bool ParseQuantizationValue(std::string_view value, float& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd
+            && std::isfinite(outValue);
+    }
+
+    bool ParseQuantizationValue(std::string_view value, double& outValue)
+    {
+        const char* valueEnd = value.data() + value.size();
+        const auto [parseEnd, parseError] = std::from_chars(value.data(),
+            valueEnd, outValue);
+
+        return parseError == std::errc() && parseEnd == valueEnd
+            && std::isfinite(outValue);
+    }
+
+    /** Sets a quantization value from its text */
+    using QuantizationValueSetter =
+        bool (*)(StateQuantizationSettings&, std::string_view);
+
+    /** A quantization key and the setter of its value */
+    struct QuantizationKey
+    {
+        std::string_view key;
+        QuantizationValueSetter setValue;
+    };
+
+    /** Every quantization key */
+    const QuantizationKey quantizationKeys[] =
+    {
+        { "originX", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value, settings.originX); } },
+        { "originY", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value, settings.originY); } },
+        { "originZ", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value, settings.originZ); } },
+        { "positionPrecision", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value,
+                settings.positionPrecision); } },
+        { "positionBits", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value, settings.positionBits); } },
+        { "rotationBits", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value, settings.rotationBits); } },
+        { "maxLinearVelocity", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value,
+                settings.maxLinearVelocity); } },
+        { "linearVelocityBits", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value,
+                settings.linearVelocityBits); } },
+        { "maxAngularVelocity", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value,
+                settings.maxAngularVelocity); } },
+        { "angularVelocityBits", [](StateQuantizationSettings& settings,
+            std::string_view value)
+            { return ParseQuantizationValue(value,
+                settings.angularVelocityBits); } }
+    };
+
+    /** @return The largest magnitude, in steps, of a signed value */
+    std::int32_t GetMaxLevel(std::uint32_t bits)
+    {
+        return static_cast<std::int32_t>((std::uint32_t(1) << (bits - 1)) - 1);
+    }
+
+    /**
+    * Quantizes a value to the nearest step, clamped to the values encodable
+    * on the given bits. The range is symmetric, so 0 is always exact.
+    */
+    std::int32_t QuantizeToSteps(double value, double stepSize,
+        std::uint32_t bits)
+    {
+        const double steps = std::round(value / stepSize);
+        if(std::isnan(steps))
+        {
+            return 0;
+        }
+
+        const std::int32_t maxLevel = GetMaxLevel(bits);
+        if(steps <= -maxLevel)
+        {
+            return -maxLevel;
+        }
+
+        if(steps >= maxLevel)
+        {
+            return maxLevel;
+        }
+
+        return static_cast<std::int32_t>(steps);
+    }
+
+    /** @return The step of a value on the [-range, range] range */
+    double GetStepSize(double range, std::uint32_t bits)
+    {
+        return range / static_cast<double>(GetMaxLevel(bits));
+    }
+
+    /** Appends a "name;value" line to the report */
+    void AppendBound(std::string& report, const char* name, double value)
+    {
+        char boundLine[128];
+        std::snprintf(boundLine, sizeof(boundLine), "%s;%.9g\n", name,
+            value);
+        report += boundLine;
+    }
+}
+
+bool StateQuantizationSettings::SetValue(std::string_view key,
+    std::string_view value, std::string& outError)
+{
+    for(const QuantizationKey& quantizationKey : quantizationKeys)
+    {
+        if(quantizationKey.key != key)
+        {
+            continue;
+        }
+
+        if(!quantizationKey.setValue(*this, value))
+        {
+            outError = "Invalid value for \"" + std::string(key) + "\": "
+                + std::string(value);
+            return false;
+        }
+
+        return true;
+    }
+
+    outError = "Unknown quantization key: " + std::string(key);
+    return false;
+}
+
+bool StateQuantizationSettings::Validate(std::string& outError) const
+{
+    const std::pair<const char*, std::uint32_t> bitWidths[] =
+    {
+        { "positionBits", positionBits },
+        { "rotationBits", rotationBits },
+        { "linearVelocityBits", linearVelocityBits },
+        { "angularVelocityBits", angularVelocityBits }
+    };
+
+    for(const auto& [bitWidthName, bitWidth] : bitWidths)
+    {
+        if(bitWidth < minQuantizedBits || bitWidth > maxQuantizedBits)
+        {
+            outError = std::string(bitWidthName) + " must be between "
+                + std::to_string(minQuantizedBits) + " and "
+                + std::to_string(maxQuantizedBits);
+            return false;
+        }
+    }
+
+    if(!(positionPrecision > 0.f))
+    {
+        outError = "positionPrecision must be positive";
+        return false;
+    }
+
+    if(!(maxLinearVelocity > 0.f) || !(maxAngularVelocity > 0.f))
+    {
+        outError = "maxLinearVelocity and maxAngularVelocity must be "
+            "positive";
+        return false;
+    }
+
+    return true;
+}
+
+std::string StateQuantizationSettings::GetErrorBoundsReport
+    (std::uint32_t bodyIdBits) const
+{
+    // A value is rounded to its nearest step, so it is off by half a step at
+    // most
+    const double rotationComponentErrorBound =
+        GetStepSize(maxSmallestThreeComponent, rotationBits) / 2.0;
+
+    // The largest component is rebuilt from the other three. It is at least
+    // 1/2, so its error is 3 times theirs at most, and the quaternions are
+    // off by sqrt(3 + 9) times it. A rotation's angle is twice that
+    const double rotationAngleErrorBound =
+        2.0 * std::sqrt(12.0) * rotationComponentErrorBound;
+
+    std::string report;
+    AppendBound(report, "positionErrorBound", positionPrecision / 2.0);
+    AppendBound(report, "positionRange",
+        static_cast<double>(positionPrecision) * GetMaxLevel(positionBits));
+    AppendBound(report, "rotationComponentErrorBound",
+        rotationComponentErrorBound);
+    AppendBound(report, "rotationAngleErrorBound", rotationAngleErrorBound);
+    AppendBound(report, "linearVelocityErrorBound",
+        GetStepSize(maxLinearVelocity, linearVelocityBits) / 2.0);
+    AppendBound(report, "angularVelocityErrorBound",
+        GetStepSize(maxAngularVelocity, angularVelocityBits) / 2.0);
+    AppendBound(report, "bodyIdBits", bodyIdBits);
+    AppendBound(report, "recordBits", GetRecordBitCount(bodyIdBits));
+
+    return report;
+}
+
+std::uint32_t StateQuantizationSettings::GetRecordBitCount
+    (std::uint32_t bodyIdBits) const
+{
+    // The body ID and type, the position, the largest rotation component's
+    // index and the other three, and the velocities
+    return bodyIdBits + 1 + 3 * positionBits + 2 + 3 * rotationBits
+        + 3 * linearVelocityBits + 3 * angularVelocityBits;
+}
+
+std::uint32_t StateQuantization::GetBodyIdBits(std::uint32_t maxBodies)
+{
+    // The body indices go up to "maxBodies - 1"
+    std::uint32_t bodyIdBits = 1;
+    while(bodyIdBits < 32 && (maxBodies - 1) >> bodyIdBits != 0)
+    {
+        bodyIdBits++;
+    }
+
+    return bodyIdBits;
+}
+
+void StateQuantization::QuantizeBodyState
+    (const StateQuantizationSettings& settings,
+    const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays,
+    QuantizedBodyState& outState)
+{
+    const size_t i = bodyIndexOnArrays;
+
+    outState.bodyId = bodyStates.bodyIds[i].GetIndex();
+    outState.bodyType = static_cast<std::uint32_t>(bodyStates.bodyTypes[i]);
+
+    // Positions, as fixed-point values relative to the origin
+    outState.position[0] = QuantizeToSteps(bodyStates.positionX[i]
+        - settings.originX, settings.positionPrecision, settings.positionBits);
+    outState.position[1] = QuantizeToSteps(bodyStates.positionY[i]
+        - settings.originY, settings.positionPrecision, settings.positionBits);
+    outState.position[2] = QuantizeToSteps(bodyStates.positionZ[i]
+        - settings.originZ, settings.positionPrecision, settings.positionBits);
+
+    // Rotation, as its smallest three components. The largest one is
+    // rebuilt from them, as the quaternion is normalized, and it is made
+    // positive (the negated quaternion is the same rotation), so its sign
+    // is not sent
+    const float rotation[4] = { bodyStates.rotationQuatX[i],
+        bodyStates.rotationQuatY[i], bodyStates.rotationQuatZ[i],
+        bodyStates.rotationQuatW[i] };
+
+    std::uint32_t largestComponent = 0;
+    for(std::uint32_t component = 1; component < 4; component++)
+    {
+        if(std::abs(rotation[component])
+            > std::abs(rotation[largestComponent]))
+        {
+            largestComponent = component;
+        }
+    }
+
+    const double rotationSign = rotation[largestComponent] < 0.f ? -1.0 : 1.0;
+    const double rotationStepSize = GetStepSize(maxSmallestThreeComponent,
+        settings.rotationBits);
+
+    outState.rotationLargestComponent = largestComponent;
+    std::uint32_t smallComponent = 0;
+    for(std::uint32_t component = 0; component < 4; component++)
+    {
+        if(component == largestComponent)
+        {
+            continue;
+        }
+
+        outState.rotation[smallComponent++] = QuantizeToSteps(rotationSign
+            * rotation[component], rotationStepSize, settings.rotationBits);
+    }
+
+    // Velocities, on their [-max, max] ranges
+    const double linearVelocityStepSize = GetStepSize
+        (settings.maxLinearVelocity, settings.linearVelocityBits);
+    outState.linearVelocity[0] = QuantizeToSteps(bodyStates.linearVelocityX[i],
+        linearVelocityStepSize, settings.linearVelocityBits);
+    outState.linearVelocity[1] = QuantizeToSteps(bodyStates.linearVelocityY[i],
+        linearVelocityStepSize, settings.linearVelocityBits);
+    outState.linearVelocity[2] = QuantizeToSteps(bodyStates.linearVelocityZ[i],
+        linearVelocityStepSize, settings.linearVelocityBits);
+
+    const double angularVelocityStepSize = GetStepSize
+        (settings.maxAngularVelocity, settings.angularVelocityBits);
+    outState.angularVelocity[0] = QuantizeToSteps
+        (bodyStates.angularVelocityX[i], angularVelocityStepSize,
+        settings.angularVelocityBits);
+    outState.angularVelocity[1] = QuantizeToSteps
+        (bodyStates.angularVelocityY[i], angularVelocityStepSize,
+        settings.angularVelocityBits);
+    outState.angularVelocity[2] = QuantizeToSteps
+        (bodyStates.angularVelocityZ[i], angularVelocityStepSize,
+        settings.angularVelocityBits);
+}
+
+void StateQuantization::WriteQuantizedBodyState(BitWriter& bitWriter,
+    const StateQuantizationSettings& settings, std::uint32_t bodyIdBits,
+    const QuantizedBodyState& state)
+{
+    bitWriter.WriteBits(state.bodyId, bodyIdBits);
+    bitWriter.WriteBits(state.bodyType, 1);
+
+    for(const std::int32_t positionComponent : state.position)
+    {
+        bitWriter.WriteSignedBits(positionComponent, settings.positionBits);
+    }
+
+    bitWriter.WriteBits(state.rotationLargestComponent, 2);
+    for(const std::int32_t rotationComponent : state.rotation)
+    {
+        bitWriter.WriteSignedBits(rotationComponent, settings.rotationBits);
+    }
+
+    for(const std::int32_t linearVelocityComponent : state.linearVelocity)
+    {
+        bitWriter.WriteSignedBits(linearVelocityComponent,
+            settings.linearVelocityBits);
+    }
+
+    for(const std::int32_t angularVelocityComponent : state.angularVelocity)
+    {
+        bitWriter.WriteSignedBits(angularVelocityComponent,
+            settings.angularVelocityBits);
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef STATEQUANTIZATION_H
+#define STATEQUANTIZATION_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "BitWriter.h"
+#include "../PhysicsSimulation/BodyStateArrays.h"
+
+/**
+* The precision of the quantized step response format (see
+* "StepResponseWriter::AppendBodyRecordAsQuantized()"), negotiated by each
+* client. Every value defaults to a record of about 20 bytes.
+*
+* The values are given as "key=value" pairs, whose keys are the names of the
+* fields below (e.g. "positionPrecision=0.05" or "rotationBits=10").
+*/
+struct StateQuantizationSettings
+{
+    /**
+    * Sets a value from its text.
+    *
+    * @param key The value's key (e.g. "positionBits")
+    * @param value The value's text
+    * @param outError The error, if the key is unknown or the value could not
+    * be parsed
+    *
+    * @return True if the value was set
+    */
+    bool SetValue(std::string_view key, std::string_view value,
+        std::string& outError);
+
+    /**
+    * Checks if every value can be encoded: the bit widths are between
+    * "minQuantizedBits" and "maxQuantizedBits", and the precision and the
+    * velocity ranges are positive.
+    *
+    * @param outError The error, with the first invalid value
+    *
+    * @return True if the settings are valid
+    */
+    bool Validate(std::string& outError) const;
+
+    /**
+    * Gets the largest error of each quantized value, a "name;value" line per
+    * bound: positionErrorBound and positionRange (the largest distance from
+    * the origin encoded without clamping), rotationComponentErrorBound and
+    * rotationAngleErrorBound (in radians, to first order),
+    * linearVelocityErrorBound, angularVelocityErrorBound, bodyIdBits and
+    * recordBits. Values outside the ranges are clamped, so the bounds only
+    * hold inside them.
+    *
+    * @param bodyIdBits The bits of the body IDs on the current world (see
+    * "StateQuantization::GetBodyIdBits()")
+    *
+    * @return The error bounds report
+    */
+    std::string GetErrorBoundsReport(std::uint32_t bodyIdBits) const;
+
+    /**
+    * @param bodyIdBits The bits of the body IDs on the current world
+    *
+    * @return The size in bits of a quantized body record
+    */
+    std::uint32_t GetRecordBitCount(std::uint32_t bodyIdBits) const;
+
+    /**
+    * The origin the positions are encoded relative to. Each client sets the
+    * origin of the region it simulates, so its bodies are near it
+    */
+    double originX = 0.0;
+    double originY = 0.0;
+    double originZ = 0.0;
+
+    /** The size of a position step (i.e. twice the position error bound) */
+    float positionPrecision = 0.1f;
+
+    /** The bits of each position component */
+    std::uint32_t positionBits = 20;
+
+    /**
+    * The bits of each of the three smallest rotation quaternion components
+    * (the index of the largest one takes 2 more bits)
+    */
+    std::uint32_t rotationBits = 9;
+
+    /** The largest linear velocity component encoded without clamping */
+    float maxLinearVelocity = 5000.f;
+
+    /** The bits of each linear velocity component */
+    std::uint32_t linearVelocityBits = 10;
+
+    /** The largest angular velocity component encoded without clamping */
+    float maxAngularVelocity = 50.f;
+
+    /** The bits of each angular velocity component */
+    std::uint32_t angularVelocityBits = 8;
+
+    /** The fewest bits accepted for a quantized value */
+    static constexpr std::uint32_t minQuantizedBits = 2;
+
+    /** The most bits accepted for a quantized value */
+    static constexpr std::uint32_t maxQuantizedBits = 31;
+};
+
+/** A body's state quantized with a client's quantization settings */
+struct QuantizedBodyState
+{
+    /** The body's index */
+    std::uint32_t bodyId = 0;
+
+    /** The body's type (0: primary, 1: clone) */
+    std::uint32_t bodyType = 0;
+
+    /** The position relative to the origin, in position steps */
+    std::int32_t position[3] = {};
+
+    /** The index (x, y, z, w) of the rotation's largest component */
+    std::uint32_t rotationLargestComponent = 0;
+
+    /** The rotation's other three components, on their order */
+    std::int32_t rotation[3] = {};
+
+    /** The linear velocity, in linear velocity steps */
+    std::int32_t linearVelocity[3] = {};
+
+    /** The angular velocity, in angular velocity steps */
+    std::int32_t angularVelocity[3] = {};
+};
+
+/**
+* Quantizes the body states sent on the quantized step response format:
+* fixed-point positions relative to an origin, smallest-three rotation
+* quaternions and velocities of a given bit width.
+*/
+namespace StateQuantization
+{
+    /**
+    * @param maxBodies The max amount of bodies on the physics system
+    *
+    * @return The bits needed to encode any body index of the physics system
+    */
+    std::uint32_t GetBodyIdBits(std::uint32_t maxBodies);
+
+    /**
+    * Quantizes a body's state. Values outside the encodable ranges are
+    * clamped.
+    *
+    * @param settings The quantization settings
+    * @param bodyStates The extracted body states
+    * @param bodyIndexOnArrays The position of the body to quantize on the
+    * body states' arrays
+    * @param outState The quantized state
+    */
+    void QuantizeBodyState(const StateQuantizationSettings& settings,
+        const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays,
+        QuantizedBodyState& outState);
+
+    /**
+    * Writes a quantized body state as a quantized body record (see
+    * "StepResponseWriter::AppendBodyRecordAsQuantized()").
+    *
+    * @param bitWriter The bit writer to write the record with
+    * @param settings The quantization settings the state was quantized with
+    * @param bodyIdBits The bits of the body IDs on the current world
+    * @param state The quantized state
+    */
+    void WriteQuantizedBodyState(BitWriter& bitWriter,
+        const StateQuantizationSettings& settings, std::uint32_t bodyIdBits,
+        const QuantizedBodyState& state);
+}
+
+#endif
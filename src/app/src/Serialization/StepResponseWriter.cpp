@@ -0,0 +1,76 @@
+#include "StepResponseWriter.h"
+#include "ByteBufferWriter.h"
+
+void StepResponseWriter::AppendBodyRecordAsText(std::string& buffer, 
+    const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays)
+{
+    const size_t i = bodyIndexOnArrays;
+
+    buffer += std::to_string(bodyStates.bodyIds[i].GetIndex()) + ";";
+
+    buffer += std::to_string(bodyStates.positionX[i]) + ";" 
+        + std::to_string(bodyStates.positionY[i]) + ";" 
+        + std::to_string(bodyStates.positionZ[i]) + ";";
+
+    buffer += std::to_string(bodyStates.rotationX[i]) + ";" 
+        + std::to_string(bodyStates.rotationY[i]) + ";" 
+        + std::to_string(bodyStates.rotationZ[i]) + ";";
+
+    buffer += std::to_string(bodyStates.linearVelocityX[i]) + ";" 
+        + std::to_string(bodyStates.linearVelocityY[i]) + ";" 
+        + std::to_string(bodyStates.linearVelocityZ[i]) + ";" 
+        + std::to_string(bodyStates.angularVelocityX[i]) + ";" 
+        + std::to_string(bodyStates.angularVelocityY[i]) + ";" 
+        + std::to_string(bodyStates.angularVelocityZ[i]) + '\n';
+}
+
+char* StepResponseWriter::WriteBodyRecordAsBinary(char* destination, 
+    const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays)
+{
+    const size_t i = bodyIndexOnArrays;
+
+    destination = ByteBufferWriter::WriteUInt32(destination, 
+        bodyStates.bodyIds[i].GetIndex());
+
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        static_cast<float>(bodyStates.positionX[i]));
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        static_cast<float>(bodyStates.positionY[i]));
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        static_cast<float>(bodyStates.positionZ[i]));
+
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.rotationX[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.rotationY[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.rotationZ[i]);
+
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.linearVelocityX[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.linearVelocityY[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.linearVelocityZ[i]);
+
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.angularVelocityX[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.angularVelocityY[i]);
+    destination = ByteBufferWriter::WriteFloat(destination, 
+        bodyStates.angularVelocityZ[i]);
+
+    return ByteBufferWriter::WriteUInt8(destination, 
+        static_cast<std::uint8_t>(bodyStates.bodyTypes[i]));
+}
+
+void StepResponseWriter::AppendBodyRecordAsQuantized(BitWriter& bitWriter, 
+    const StateQuantizationSettings& settings, std::uint32_t bodyIdBits,
+    const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays)
+{
+    QuantizedBodyState quantizedState;
+    StateQuantization::QuantizeBodyState(settings, bodyStates, 
+        bodyIndexOnArrays, quantizedState);
+    StateQuantization::WriteQuantizedBodyState(bitWriter, settings, 
+        bodyIdBits, quantizedState);
+}
@@ -0,0 +1,92 @@
+#ifndef STEPRESPONSEWRITER_H
+#define STEPRESPONSEWRITER_H
+
+#include <string>
+#include "BitWriter.h"
+#include "StateQuantization.h"
+#include "../PhysicsSimulation/BodyStateArrays.h"
+
+/**
+* Encoders for the body records sent on the step physics responses. Every step
+* response mode (full or active set) uses these, so a body record looks the
+* same whatever mode the client has negotiated. The records are read from the
+* body state arrays extracted on each step.
+*/
+namespace StepResponseWriter
+{
+    /** The size in bytes of a body record on the binary format */
+    constexpr size_t binaryBodyRecordSize = 53;
+
+    /** 
+    * Appends a body record to the given buffer on the text format. The
+    * record is a line with ";" separated values:
+    * 
+    * "id;posX;posY;posZ;rotX;rotY;rotZ;linVelX;linVelY;linVelZ;angVelX;
+    * angVelY;angVelZ\n"
+    * 
+    * @param buffer The buffer to append the record to
+    * @param bodyStates The extracted body states
+    * @param bodyIndexOnArrays The position of the body to write on the 
+    * body states' arrays
+    */
+    void AppendBodyRecordAsText(std::string& buffer, 
+        const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays);
+
+    /** 
+    * Writes a body record on the binary format. The record is packed and
+    * little-endian:
+    * 
+    * uint32 bodyId
+    * float posX, posY, posZ
+    * float rotX, rotY, rotZ (euler angles)
+    * float linearVelocityX, linearVelocityY, linearVelocityZ
+    * float angularVelocityX, angularVelocityY, angularVelocityZ
+    * uint8 bodyType (0: primary, 1: clone)
+    * 
+    * @param destination Where to write the record. Must have at least 
+    * "binaryBodyRecordSize" bytes available
+    * @param bodyStates The extracted body states
+    * @param bodyIndexOnArrays The position of the body to write on the 
+    * body states' arrays
+    * 
+    * @return The position right after the written record
+    */
+    char* WriteBodyRecordAsBinary(char* destination, 
+        const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays);
+
+    /** 
+    * Writes a body record on the quantized format. The records are bit
+    * packed one after another (see "BitWriter"), with the bit widths of the
+    * client's quantization settings:
+    * 
+    * bodyIdBits bodyId
+    * 1 bit bodyType (0: primary, 1: clone)
+    * 3 * positionBits position, in position steps from the origin
+    * 2 bits index (x, y, z, w) of the rotation quaternion's largest 
+    * component
+    * 3 * rotationBits the other quaternion components, on their order, with
+    * the largest component made positive
+    * 3 * linearVelocityBits linear velocity
+    * 3 * angularVelocityBits angular velocity
+    * 
+    * Every value but the body ID, type and largest component index is a 
+    * signed (two's complement) number of steps. The steps are 
+    * positionPrecision for the positions, and the component's range divided
+    * by (2^(bits - 1) - 1) for the rest, where the ranges are 1/sqrt(2) for 
+    * the quaternion components and the max velocities for the velocities.
+    * The quaternion's largest component is sqrt(1 - the others' squares).
+    * 
+    * @param bitWriter The bit writer to write the record with
+    * @param settings The client's quantization settings
+    * @param bodyIdBits The bits of the body IDs on the current world (see
+    * "StateQuantization::GetBodyIdBits()")
+    * @param bodyStates The extracted body states
+    * @param bodyIndexOnArrays The position of the body to write on the 
+    * body states' arrays
+    */
+    void AppendBodyRecordAsQuantized(BitWriter& bitWriter, 
+        const StateQuantizationSettings& settings, std::uint32_t bodyIdBits,
+        const BodyStateArrays& bodyStates, size_t bodyIndexOnArrays);
+}
+
+#endif
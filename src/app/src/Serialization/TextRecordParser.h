@@ -0,0 +1,88 @@
+#ifndef TEXTRECORDPARSER_H
+#define TEXTRECORDPARSER_H
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+/**
+* Helpers to parse the ";" separated records of the text messages (e.g. the
+* bodies of "Init" and "AddBody"). Every message reads its fields with the
+* same rules: the blanks around each field are ignored, and a numeric field
+* must hold a single number, with nothing else on it. Numbers are parsed with
+* std::from_chars, so a malformed field is reported and never throws.
+*/
+namespace TextRecordParser
+{
+    /** @return The field without the blanks (spaces, tabs, "\r") around it */
+    inline std::string_view TrimField(std::string_view field)
+    {
+        const size_t valueStartPos = field.find_first_not_of(" \t\r");
+        if(valueStartPos == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+
+        return field.substr(valueStartPos,
+            field.find_last_not_of(" \t\r") - valueStartPos + 1);
+    }
+
+    /**
+    * Splits a record into its ";" separated fields. The blanks around each
+    * field are trimmed, and a trailing ";" does not start a new field.
+    *
+    * @param record The record to split
+    * @param outFields The record's fields. Views on the record
+    */
+    inline void SplitRecordIntoFields(std::string_view record,
+        std::vector<std::string_view>& outFields)
+    {
+        outFields.clear();
+
+        size_t fieldStartPos = 0;
+        while(fieldStartPos <= record.size())
+        {
+            size_t fieldEndPos = record.find(';', fieldStartPos);
+            if(fieldEndPos == std::string_view::npos)
+            {
+                fieldEndPos = record.size();
+            }
+
+            const std::string_view field = TrimField(record.substr
+                (fieldStartPos, fieldEndPos - fieldStartPos));
+
+            // A trailing ";" does not start a new field
+            if(fieldEndPos == record.size() && field.empty())
+            {
+                break;
+            }
+
+            outFields.push_back(field);
+            fieldStartPos = fieldEndPos + 1;
+        }
+    }
+
+    /**
+    * Parses a numeric field. The blanks around the value are ignored.
+    *
+    * @param field The field to parse
+    * @param outValue The parsed value
+    *
+    * @return True if the whole field is a valid number and false otherwise
+    */
+    template<typename TValue>
+    bool ParseNumberField(std::string_view field, TValue& outValue)
+    {
+        field = TrimField(field);
+
+        const char* fieldEnd = field.data() + field.size();
+        const auto [parseEnd, parseError] = std::from_chars(field.data(),
+            fieldEnd, outValue);
+
+        return !field.empty() && parseError == std::errc()
+            && parseEnd == fieldEnd;
+    }
+}
+
+#endif